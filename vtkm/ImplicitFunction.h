@@ -943,6 +943,23 @@ public:
   {
     return this->Variant.CastAndCall(detail::ImplicitFunctionGradientFunctor{}, point);
   }
+
+  /// @brief Returns true if the multiplexer currently holds the given implicit function type.
+  template <typename FunctionType>
+  VTKM_EXEC_CONT bool IsType() const
+  {
+    return this->Variant.template IsType<FunctionType>();
+  }
+
+  /// @brief Returns the implicit function held by the multiplexer.
+  ///
+  /// The multiplexer must hold a function of the given type, which can be checked with
+  /// `IsType()`.
+  template <typename FunctionType>
+  VTKM_EXEC_CONT const FunctionType& Get() const
+  {
+    return this->Variant.template Get<FunctionType>();
+  }
 };
 
 //============================================================================
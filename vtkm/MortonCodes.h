@@ -0,0 +1,75 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_MortonCodes_h
+#define vtk_m_MortonCodes_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+
+namespace vtkm
+{
+
+/// \brief Spreads the lowest 10 bits of `x` so that there are 2 zero bits between each.
+///
+VTKM_EXEC_CONT inline vtkm::UInt32 MortonExpandBits32(vtkm::UInt32 x32)
+{
+  x32 = (x32 | (x32 << 16)) & 0x030000FF;
+  x32 = (x32 | (x32 << 8)) & 0x0300F00F;
+  x32 = (x32 | (x32 << 4)) & 0x030C30C3;
+  x32 = (x32 | (x32 << 2)) & 0x09249249;
+  return x32;
+}
+
+/// \brief Spreads the lowest 21 bits of `x` so that there are 2 zero bits between each.
+///
+VTKM_EXEC_CONT inline vtkm::UInt64 MortonExpandBits64(vtkm::UInt32 x)
+{
+  vtkm::UInt64 x64 = x & 0x1FFFFF;
+  x64 = (x64 | x64 << 32) & 0x1F00000000FFFF;
+  x64 = (x64 | x64 << 16) & 0x1F0000FF0000FF;
+  x64 = (x64 | x64 << 8) & 0x100F00F00F00F00F;
+  x64 = (x64 | x64 << 4) & 0x10c30c30c30c30c3;
+  x64 = (x64 | x64 << 2) & 0x1249249249249249;
+  return x64;
+}
+
+/// \brief Returns the 30 bit Morton code of a point in the unit cube.
+///
+/// Each coordinate is quantized to 10 bits. Coordinates outside of [0, 1] are clamped.
+///
+VTKM_EXEC_CONT inline vtkm::UInt32 MortonCode32(const vtkm::Vec3f_32& unitPoint)
+{
+  vtkm::UInt32 code = 0;
+  for (vtkm::IdComponent i = 0; i < 3; ++i)
+  {
+    vtkm::Float32 x = vtkm::Min(vtkm::Max(unitPoint[i] * 1024.0f, 0.0f), 1023.0f);
+    code |= vtkm::MortonExpandBits32(static_cast<vtkm::UInt32>(x)) << i;
+  }
+  return code;
+}
+
+/// \brief Returns the 63 bit Morton code of a point in the unit cube.
+///
+/// Each coordinate is quantized to 21 bits. Coordinates outside of [0, 1] are clamped.
+///
+VTKM_EXEC_CONT inline vtkm::UInt64 MortonCode64(const vtkm::Vec3f_32& unitPoint)
+{
+  vtkm::UInt64 code = 0;
+  for (vtkm::IdComponent i = 0; i < 3; ++i)
+  {
+    vtkm::Float32 x = vtkm::Min(vtkm::Max(unitPoint[i] * 2097152.0f, 0.0f), 2097151.0f);
+    code |= vtkm::MortonExpandBits64(static_cast<vtkm::UInt32>(x)) << i;
+  }
+  return code;
+}
+
+} // namespace vtkm
+
+#endif //vtk_m_MortonCodes_h
@@ -0,0 +1,851 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#include <vtkm/cont/CellLocatorBoundingVolumeHierarchy.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Logging.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+#include <vtkm/Math.h>
+
+namespace
+{
+
+using NodeType = vtkm::exec::CellLocatorBoundingVolumeHierarchyNode;
+
+// Number of bins along each axis used to evaluate the surface area heuristic.
+constexpr vtkm::IdComponent NUM_BINS = 8;
+
+// Number of consecutive cells binned (and later partitioned) by one thread.
+constexpr vtkm::Id CHUNK_SIZE = 1024;
+
+// Maximum depth of the binary tree. Once collapsed, the 4-wide tree has half as many levels.
+// A traversal pushes at most 3 siblings per level plus the 4 children of the deepest node,
+// which keeps it within `NodeType::StackSize`.
+constexpr vtkm::IdComponent MAX_DEPTH = 40;
+VTKM_STATIC_ASSERT(3 * (MAX_DEPTH / 2 - 1) + NodeType::Width <= NodeType::StackSize);
+
+struct Box
+{
+  vtkm::Vec3f Min;
+  vtkm::Vec3f Max;
+
+  VTKM_EXEC_CONT static Box Empty()
+  {
+    return { vtkm::Vec3f(vtkm::Infinity<vtkm::FloatDefault>()),
+             vtkm::Vec3f(vtkm::NegativeInfinity<vtkm::FloatDefault>()) };
+  }
+
+  VTKM_EXEC_CONT void Include(const vtkm::Vec3f& point)
+  {
+    this->Min = vtkm::Min(this->Min, point);
+    this->Max = vtkm::Max(this->Max, point);
+  }
+
+  VTKM_EXEC_CONT void Include(const Box& box)
+  {
+    this->Min = vtkm::Min(this->Min, box.Min);
+    this->Max = vtkm::Max(this->Max, box.Max);
+  }
+
+  VTKM_EXEC_CONT vtkm::FloatDefault HalfArea() const
+  {
+    vtkm::Vec3f d = this->Max - this->Min;
+    return (d[0] * d[1]) + (d[1] * d[2]) + (d[2] * d[0]);
+  }
+};
+
+struct BoxUnion
+{
+  VTKM_EXEC_CONT Box operator()(const Box& a, const Box& b) const
+  {
+    Box result = a;
+    result.Include(b);
+    return result;
+  }
+};
+
+struct PointToBox
+{
+  VTKM_EXEC_CONT Box operator()(const vtkm::Vec3f& point) const { return { point, point }; }
+};
+
+// The cells whose centroids fall in one bin of one axis.
+struct Bin
+{
+  vtkm::Id Count;
+  Box Bounds;
+  Box Centroids;
+};
+
+// A contiguous range of cells that becomes one node of the binary tree.
+struct Segment
+{
+  vtkm::Id Start;
+  vtkm::Id Count;
+  vtkm::Id Node;
+  Box Bounds;
+  Box Centroids;
+};
+
+// How a segment is split. An axis of -1 makes the segment a leaf. An axis of 3 splits the
+// segment in half by index, which is used when all centroids coincide.
+struct Split
+{
+  vtkm::IdComponent Axis;
+  vtkm::IdComponent Bin;
+  vtkm::Id LeftCount;
+  Box LeftBounds;
+  Box LeftCentroids;
+  Box RightBounds;
+  Box RightCentroids;
+};
+
+// A node of the binary tree before it is collapsed. The children of an internal node are at
+// `Left` and `Left + 1`. A leaf has a `Left` of -1 and holds the cells in [Start, Start+Count).
+struct BinaryNode
+{
+  Box Bounds;
+  vtkm::Id Left;
+  vtkm::Id Start;
+  vtkm::Id Count;
+  vtkm::IdComponent Depth;
+};
+
+VTKM_EXEC inline vtkm::IdComponent ComputeBin(const vtkm::Vec3f& centroid,
+                                              const Box& centroidBounds,
+                                              vtkm::IdComponent axis)
+{
+  vtkm::FloatDefault extent = centroidBounds.Max[axis] - centroidBounds.Min[axis];
+  if (!(extent > 0))
+  {
+    return 0;
+  }
+  vtkm::FloatDefault fraction = (centroid[axis] - centroidBounds.Min[axis]) / extent;
+  auto bin = static_cast<vtkm::IdComponent>(static_cast<vtkm::FloatDefault>(NUM_BINS) * fraction);
+  return vtkm::Max(vtkm::IdComponent(0), vtkm::Min(bin, NUM_BINS - 1));
+}
+
+VTKM_EXEC inline bool GoesLeft(const Segment& segment,
+                               const Split& split,
+                               const vtkm::Vec3f& centroid,
+                               vtkm::Id index)
+{
+  if (split.Axis == 3)
+  {
+    return (index - segment.Start) < split.LeftCount;
+  }
+  return ComputeBin(centroid, segment.Centroids, split.Axis) < split.Bin;
+}
+
+class ComputeCellBounds : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+  using ControlSignature = void(CellSetIn cellset,
+                                FieldInPoint coords,
+                                FieldOutCell bounds,
+                                FieldOutCell centroid);
+  using ExecutionSignature = void(_2, _3, _4);
+
+  template <typename PointsVecType>
+  VTKM_EXEC void operator()(const PointsVecType& points, Box& bounds, vtkm::Vec3f& centroid) const
+  {
+    bounds = Box::Empty();
+    vtkm::IdComponent numPoints = points.GetNumberOfComponents();
+    for (vtkm::IdComponent i = 0; i < numPoints; ++i)
+    {
+      bounds.Include(vtkm::Vec3f(points[i]));
+    }
+    centroid = (bounds.Min + bounds.Max) * vtkm::FloatDefault(0.5);
+  }
+};
+
+class CountChunks : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn segment, FieldOut numChunks);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_EXEC void operator()(const Segment& segment, vtkm::Id& numChunks) const
+  {
+    numChunks = (segment.Count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  }
+};
+
+VTKM_EXEC inline vtkm::Id2 ChunkRange(const Segment& segment,
+                                      vtkm::Id chunk,
+                                      vtkm::Id firstChunkOfSegment)
+{
+  vtkm::Id first = segment.Start + (chunk - firstChunkOfSegment) * CHUNK_SIZE;
+  return { first, vtkm::Min(first + CHUNK_SIZE, segment.Start + segment.Count) };
+}
+
+class BinChunks : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunkSegment,
+                                WholeArrayIn segments,
+                                WholeArrayIn chunkOffsets,
+                                WholeArrayIn bounds,
+                                WholeArrayIn centroids,
+                                WholeArrayOut bins);
+  using ExecutionSignature = void(InputIndex, _1, _2, _3, _4, _5, _6);
+
+  template <typename SegmentPortal,
+            typename OffsetPortal,
+            typename BoundsPortal,
+            typename CentroidPortal,
+            typename BinPortal>
+  VTKM_EXEC void operator()(vtkm::Id chunk,
+                            vtkm::Id segmentIndex,
+                            const SegmentPortal& segments,
+                            const OffsetPortal& chunkOffsets,
+                            const BoundsPortal& bounds,
+                            const CentroidPortal& centroids,
+                            const BinPortal& bins) const
+  {
+    const Segment segment = segments.Get(segmentIndex);
+    vtkm::Id2 range = ChunkRange(segment, chunk, chunkOffsets.Get(segmentIndex));
+
+    Bin local[3][NUM_BINS];
+    for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+    {
+      for (vtkm::IdComponent b = 0; b < NUM_BINS; ++b)
+      {
+        local[axis][b] = { 0, Box::Empty(), Box::Empty() };
+      }
+    }
+
+    for (vtkm::Id i = range[0]; i < range[1]; ++i)
+    {
+      vtkm::Vec3f centroid = centroids.Get(i);
+      Box box = bounds.Get(i);
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        Bin& bin = local[axis][ComputeBin(centroid, segment.Centroids, axis)];
+        ++bin.Count;
+        bin.Bounds.Include(box);
+        bin.Centroids.Include(centroid);
+      }
+    }
+
+    vtkm::Id outIndex = chunk * 3 * NUM_BINS;
+    for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+    {
+      for (vtkm::IdComponent b = 0; b < NUM_BINS; ++b)
+      {
+        bins.Set(outIndex++, local[axis][b]);
+      }
+    }
+  }
+};
+
+class ChooseSplit : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn segment,
+                                FieldIn firstChunk,
+                                FieldIn numChunks,
+                                WholeArrayIn bins,
+                                FieldOut split,
+                                FieldOut isSplit);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  VTKM_CONT ChooseSplit(vtkm::IdComponent maxLeafSize, vtkm::IdComponent depth)
+    : MaxLeafSize(maxLeafSize)
+    , Depth(depth)
+  {
+  }
+
+  template <typename BinPortal>
+  VTKM_EXEC void operator()(const Segment& segment,
+                            vtkm::Id firstChunk,
+                            vtkm::Id numChunks,
+                            const BinPortal& bins,
+                            Split& split,
+                            vtkm::Id& isSplit) const
+  {
+    split.Axis = -1;
+    isSplit = 0;
+    if ((segment.Count <= this->MaxLeafSize) || (this->Depth >= MAX_DEPTH - 1))
+    {
+      return;
+    }
+
+    vtkm::FloatDefault bestCost = vtkm::Infinity<vtkm::FloatDefault>();
+    vtkm::Id bestBalance = segment.Count;
+    for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+    {
+      // Gather the bins of all chunks in the segment.
+      Bin merged[NUM_BINS];
+      for (vtkm::IdComponent b = 0; b < NUM_BINS; ++b)
+      {
+        merged[b] = { 0, Box::Empty(), Box::Empty() };
+      }
+      for (vtkm::Id chunk = firstChunk; chunk < firstChunk + numChunks; ++chunk)
+      {
+        vtkm::Id binIndex = (chunk * 3 + axis) * NUM_BINS;
+        for (vtkm::IdComponent b = 0; b < NUM_BINS; ++b)
+        {
+          Bin bin = bins.Get(binIndex + b);
+          merged[b].Count += bin.Count;
+          merged[b].Bounds.Include(bin.Bounds);
+          merged[b].Centroids.Include(bin.Centroids);
+        }
+      }
+
+      // Sweep from the right to get the cost of everything right of each split...
+      vtkm::FloatDefault rightCost[NUM_BINS];
+      Box right = Box::Empty();
+      vtkm::Id rightCount = 0;
+      for (vtkm::IdComponent b = NUM_BINS - 1; b > 0; --b)
+      {
+        right.Include(merged[b].Bounds);
+        rightCount += merged[b].Count;
+        // (An empty box has an infinite area, so do not multiply it by zero.)
+        rightCost[b] =
+          (rightCount > 0) ? static_cast<vtkm::FloatDefault>(rightCount) * right.HalfArea() : 0;
+      }
+
+      // ...then sweep from the left to evaluate each split.
+      Box left = Box::Empty();
+      vtkm::Id leftCount = 0;
+      for (vtkm::IdComponent b = 1; b < NUM_BINS; ++b)
+      {
+        left.Include(merged[b - 1].Bounds);
+        leftCount += merged[b - 1].Count;
+        if ((leftCount == 0) || (leftCount == segment.Count))
+        {
+          continue;
+        }
+        vtkm::FloatDefault cost =
+          static_cast<vtkm::FloatDefault>(leftCount) * left.HalfArea() + rightCost[b];
+        vtkm::Id balance = vtkm::Abs(segment.Count - 2 * leftCount);
+        if ((cost < bestCost) || ((cost == bestCost) && (balance < bestBalance)))
+        {
+          bestCost = cost;
+          bestBalance = balance;
+          split.Axis = axis;
+          split.Bin = b;
+          split.LeftCount = leftCount;
+        }
+      }
+    }
+
+    if (split.Axis < 0)
+    {
+      // All of the centroids are in the same place. Split the cells in half.
+      split.Axis = 3;
+      split.LeftCount = segment.Count / 2;
+      split.LeftBounds = split.RightBounds = segment.Bounds;
+      split.LeftCentroids = split.RightCentroids = segment.Centroids;
+    }
+    else
+    {
+      // Recompute the child boxes for the chosen axis.
+      split.LeftBounds = split.LeftCentroids = Box::Empty();
+      split.RightBounds = split.RightCentroids = Box::Empty();
+      for (vtkm::Id chunk = firstChunk; chunk < firstChunk + numChunks; ++chunk)
+      {
+        vtkm::Id binIndex = (chunk * 3 + split.Axis) * NUM_BINS;
+        for (vtkm::IdComponent b = 0; b < NUM_BINS; ++b)
+        {
+          Bin bin = bins.Get(binIndex + b);
+          if (b < split.Bin)
+          {
+            split.LeftBounds.Include(bin.Bounds);
+            split.LeftCentroids.Include(bin.Centroids);
+          }
+          else
+          {
+            split.RightBounds.Include(bin.Bounds);
+            split.RightCentroids.Include(bin.Centroids);
+          }
+        }
+      }
+    }
+    isSplit = 1;
+  }
+
+private:
+  vtkm::IdComponent MaxLeafSize;
+  vtkm::IdComponent Depth;
+};
+
+class WriteNodes : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn segment,
+                                FieldIn split,
+                                FieldIn splitIndex,
+                                WholeArrayIn cellIds,
+                                WholeArrayInOut nodes,
+                                WholeArrayInOut leafCellIds,
+                                WholeArrayOut childSegments);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  VTKM_CONT WriteNodes(vtkm::Id firstChildNode, vtkm::IdComponent depth)
+    : FirstChildNode(firstChildNode)
+    , Depth(depth)
+  {
+  }
+
+  template <typename CellIdPortal,
+            typename NodePortal,
+            typename LeafCellIdPortal,
+            typename SegmentPortal>
+  VTKM_EXEC void operator()(const Segment& segment,
+                            const Split& split,
+                            vtkm::Id splitIndex,
+                            const CellIdPortal& cellIds,
+                            const NodePortal& nodes,
+                            const LeafCellIdPortal& leafCellIds,
+                            const SegmentPortal& childSegments) const
+  {
+    BinaryNode node{ segment.Bounds, -1, segment.Start, segment.Count, this->Depth };
+    if (split.Axis < 0)
+    {
+      // The cells of a leaf do not move any more. Record them in their final place.
+      for (vtkm::Id i = segment.Start; i < segment.Start + segment.Count; ++i)
+      {
+        leafCellIds.Set(i, cellIds.Get(i));
+      }
+    }
+    else
+    {
+      node.Left = this->FirstChildNode + 2 * splitIndex;
+      childSegments.Set(
+        2 * splitIndex,
+        { segment.Start, split.LeftCount, node.Left, split.LeftBounds, split.LeftCentroids });
+      childSegments.Set(2 * splitIndex + 1,
+                        { segment.Start + split.LeftCount,
+                          segment.Count - split.LeftCount,
+                          node.Left + 1,
+                          split.RightBounds,
+                          split.RightCentroids });
+    }
+    nodes.Set(segment.Node, node);
+  }
+
+private:
+  vtkm::Id FirstChildNode;
+  vtkm::IdComponent Depth;
+};
+
+class CountLeft : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunkSegment,
+                                WholeArrayIn segments,
+                                WholeArrayIn splits,
+                                WholeArrayIn chunkOffsets,
+                                WholeArrayIn centroids,
+                                FieldOut leftCount);
+  using ExecutionSignature = void(InputIndex, _1, _2, _3, _4, _5, _6);
+
+  template <typename SegmentPortal,
+            typename SplitPortal,
+            typename OffsetPortal,
+            typename CentroidPortal>
+  VTKM_EXEC void operator()(vtkm::Id chunk,
+                            vtkm::Id segmentIndex,
+                            const SegmentPortal& segments,
+                            const SplitPortal& splits,
+                            const OffsetPortal& chunkOffsets,
+                            const CentroidPortal& centroids,
+                            vtkm::Id& leftCount) const
+  {
+    leftCount = 0;
+    const Split split = splits.Get(segmentIndex);
+    if (split.Axis < 0)
+    {
+      return;
+    }
+    const Segment segment = segments.Get(segmentIndex);
+    vtkm::Id2 range = ChunkRange(segment, chunk, chunkOffsets.Get(segmentIndex));
+    for (vtkm::Id i = range[0]; i < range[1]; ++i)
+    {
+      if (GoesLeft(segment, split, centroids.Get(i), i))
+      {
+        ++leftCount;
+      }
+    }
+  }
+};
+
+class MoveCells : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunkSegment,
+                                FieldIn leftOffset,
+                                WholeArrayIn segments,
+                                WholeArrayIn splits,
+                                WholeArrayIn chunkOffsets,
+                                WholeArrayIn cellIds,
+                                WholeArrayIn bounds,
+                                WholeArrayIn centroids,
+                                WholeArrayOut newCellIds,
+                                WholeArrayOut newBounds,
+                                WholeArrayOut newCentroids);
+  using ExecutionSignature = void(InputIndex, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11);
+
+  template <typename SegmentPortal,
+            typename SplitPortal,
+            typename OffsetPortal,
+            typename InIdPortal,
+            typename InBoundsPortal,
+            typename InCentroidPortal,
+            typename OutIdPortal,
+            typename OutBoundsPortal,
+            typename OutCentroidPortal>
+  VTKM_EXEC void operator()(vtkm::Id chunk,
+                            vtkm::Id segmentIndex,
+                            vtkm::Id leftOffset,
+                            const SegmentPortal& segments,
+                            const SplitPortal& splits,
+                            const OffsetPortal& chunkOffsets,
+                            const InIdPortal& cellIds,
+                            const InBoundsPortal& bounds,
+                            const InCentroidPortal& centroids,
+                            const OutIdPortal& newCellIds,
+                            const OutBoundsPortal& newBounds,
+                            const OutCentroidPortal& newCentroids) const
+  {
+    const Split split = splits.Get(segmentIndex);
+    if (split.Axis < 0)
+    {
+      return;
+    }
+    const Segment segment = segments.Get(segmentIndex);
+    vtkm::Id2 range = ChunkRange(segment, chunk, chunkOffsets.Get(segmentIndex));
+
+    // The cells before this chunk in the segment that go right come after all the left cells.
+    vtkm::Id leftIndex = segment.Start + leftOffset;
+    vtkm::Id rightIndex = segment.Start + split.LeftCount + (range[0] - segment.Start - leftOffset);
+    for (vtkm::Id i = range[0]; i < range[1]; ++i)
+    {
+      vtkm::Vec3f centroid = centroids.Get(i);
+      vtkm::Id dest = GoesLeft(segment, split, centroid, i) ? leftIndex++ : rightIndex++;
+      newCellIds.Set(dest, cellIds.Get(i));
+      newBounds.Set(dest, bounds.Get(i));
+      newCentroids.Set(dest, centroid);
+    }
+  }
+};
+
+class ClassifyNodes : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn node, FieldOut isWide, FieldOut isLeaf);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_EXEC void operator()(const BinaryNode& node, vtkm::Id& isWide, vtkm::Id& isLeaf) const
+  {
+    // Internal nodes at odd depths are absorbed into their parents.
+    isLeaf = (node.Left < 0) ? 1 : 0;
+    isWide = ((node.Left >= 0) && (node.Depth % 2 == 0)) ? 1 : 0;
+  }
+};
+
+class CollapseNodes : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn node,
+                                FieldIn wideIndex,
+                                FieldIn leafIndex,
+                                WholeArrayIn nodes,
+                                WholeArrayIn wideIndices,
+                                WholeArrayIn leafIndices,
+                                WholeArrayOut wideNodes,
+                                WholeArrayOut leaves);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8);
+
+  template <typename NodePortal,
+            typename IndexPortal,
+            typename WideNodePortal,
+            typename LeafPortal>
+  VTKM_EXEC void operator()(const BinaryNode& node,
+                            vtkm::Id wideIndex,
+                            vtkm::Id leafIndex,
+                            const NodePortal& nodes,
+                            const IndexPortal& wideIndices,
+                            const IndexPortal& leafIndices,
+                            const WideNodePortal& wideNodes,
+                            const LeafPortal& leaves) const
+  {
+    if (node.Left < 0)
+    {
+      leaves.Set(leafIndex, vtkm::Id2(node.Start, node.Count));
+      return;
+    }
+    if (node.Depth % 2 != 0)
+    {
+      return;
+    }
+
+    // The children of the wide node are the children of the binary node, except that
+    // internal children are replaced by their own children.
+    NodeType wideNode;
+    vtkm::IdComponent slot = 0;
+    for (vtkm::Id childIndex = node.Left; childIndex < node.Left + 2; ++childIndex)
+    {
+      const BinaryNode child = nodes.Get(childIndex);
+      if (child.Left < 0)
+      {
+        SetSlot(wideNode, slot++, child, -leafIndices.Get(childIndex) - 2);
+      }
+      else
+      {
+        for (vtkm::Id grandchildIndex = child.Left; grandchildIndex < child.Left + 2;
+             ++grandchildIndex)
+        {
+          const BinaryNode grandchild = nodes.Get(grandchildIndex);
+          SetSlot(wideNode,
+                  slot++,
+                  grandchild,
+                  (grandchild.Left < 0) ? -leafIndices.Get(grandchildIndex) - 2
+                                        : wideIndices.Get(grandchildIndex));
+        }
+      }
+    }
+    for (; slot < NodeType::Width; ++slot)
+    {
+      BinaryNode empty{ Box::Empty(), -1, 0, 0, 0 };
+      SetSlot(wideNode, slot, empty, -1);
+    }
+    wideNodes.Set(wideIndex, wideNode);
+  }
+
+  VTKM_EXEC static void SetSlot(NodeType& wideNode,
+                                vtkm::IdComponent slot,
+                                const BinaryNode& child,
+                                vtkm::Id childIndex)
+  {
+    wideNode.MinX[slot] = child.Bounds.Min[0];
+    wideNode.MinY[slot] = child.Bounds.Min[1];
+    wideNode.MinZ[slot] = child.Bounds.Min[2];
+    wideNode.MaxX[slot] = child.Bounds.Max[0];
+    wideNode.MaxY[slot] = child.Bounds.Max[1];
+    wideNode.MaxZ[slot] = child.Bounds.Max[2];
+    wideNode.Child[slot] = childIndex;
+  }
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+
+//----------------------------------------------------------------------------
+void CellLocatorBoundingVolumeHierarchy::Build()
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorBoundingVolumeHierarchy::Build");
+
+  vtkm::cont::Invoker invoke;
+
+  auto cellset = this->GetCellSet();
+  const auto& coords = this->GetCoordinates();
+  vtkm::Id numCells = cellset.GetNumberOfCells();
+
+  this->Nodes.ReleaseResources();
+  this->Leaves.ReleaseResources();
+  this->CellIds.Allocate(numCells);
+  if (numCells == 0)
+  {
+    return;
+  }
+
+  // Bounds and centroids of every cell, in the order of the cells of the current segments.
+  vtkm::cont::ArrayHandle<Box> bounds;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> centroids;
+  vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+  invoke(ComputeCellBounds{}, cellset, coords, bounds, centroids);
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(numCells), cellIds);
+
+  vtkm::cont::ArrayHandle<Box> newBounds;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> newCentroids;
+  vtkm::cont::ArrayHandle<vtkm::Id> newCellIds;
+  newBounds.Allocate(numCells);
+  newCentroids.Allocate(numCells);
+  newCellIds.Allocate(numCells);
+
+  vtkm::cont::ArrayHandle<Segment> segments;
+  segments.Allocate(1);
+  segments.WritePortal().Set(
+    0,
+    { 0,
+      numCells,
+      0,
+      vtkm::cont::Algorithm::Reduce(bounds, Box::Empty(), BoxUnion{}),
+      vtkm::cont::Algorithm::Reduce(vtkm::cont::make_ArrayHandleTransform(centroids, PointToBox{}),
+                                    Box::Empty(),
+                                    BoxUnion{}) });
+
+  // Build the binary tree one level at a time. Each level splits all of its segments at once.
+  vtkm::cont::ArrayHandle<BinaryNode> binaryNodes;
+  binaryNodes.Allocate(1);
+  vtkm::Id numBinaryNodes = 1;
+  for (vtkm::IdComponent depth = 0; segments.GetNumberOfValues() > 0; ++depth)
+  {
+    // Break the segments into chunks of cells that are processed by one thread each.
+    vtkm::cont::ArrayHandle<vtkm::Id> numChunks;
+    invoke(CountChunks{}, segments, numChunks);
+    vtkm::cont::ArrayHandle<vtkm::Id> chunkOffsets;
+    vtkm::Id totalChunks = vtkm::cont::Algorithm::ScanExclusive(numChunks, chunkOffsets);
+    vtkm::cont::ArrayHandle<vtkm::Id> chunkEnds;
+    vtkm::cont::Algorithm::ScanInclusive(numChunks, chunkEnds);
+    vtkm::cont::ArrayHandle<vtkm::Id> chunkSegments;
+    vtkm::cont::Algorithm::UpperBounds(
+      chunkEnds, vtkm::cont::ArrayHandleIndex(totalChunks), chunkSegments);
+
+    // Bin the centroids and pick the split with the lowest surface area heuristic.
+    vtkm::cont::ArrayHandle<Bin> bins;
+    bins.Allocate(totalChunks * 3 * NUM_BINS);
+    invoke(BinChunks{}, chunkSegments, segments, chunkOffsets, bounds, centroids, bins);
+    vtkm::cont::ArrayHandle<Split> splits;
+    vtkm::cont::ArrayHandle<vtkm::Id> isSplit;
+    invoke(ChooseSplit{ this->MaxLeafSize, depth },
+           segments,
+           chunkOffsets,
+           numChunks,
+           bins,
+           splits,
+           isSplit);
+    bins.ReleaseResources();
+
+    vtkm::cont::ArrayHandle<vtkm::Id> splitIndices;
+    vtkm::Id numSplits = vtkm::cont::Algorithm::ScanExclusive(isSplit, splitIndices);
+
+    binaryNodes.Allocate(numBinaryNodes + 2 * numSplits, vtkm::CopyFlag::On);
+    vtkm::cont::ArrayHandle<Segment> childSegments;
+    childSegments.Allocate(2 * numSplits);
+    invoke(WriteNodes{ numBinaryNodes, depth },
+           segments,
+           splits,
+           splitIndices,
+           cellIds,
+           binaryNodes,
+           this->CellIds,
+           childSegments);
+
+    if (numSplits > 0)
+    {
+      // Partition the cells of each split segment into its two children.
+      vtkm::cont::ArrayHandle<vtkm::Id> leftCounts;
+      invoke(CountLeft{}, chunkSegments, segments, splits, chunkOffsets, centroids, leftCounts);
+      vtkm::cont::ArrayHandle<vtkm::Id> leftOffsets;
+      vtkm::cont::Algorithm::ScanExclusiveByKey(chunkSegments, leftCounts, leftOffsets);
+      invoke(MoveCells{},
+             chunkSegments,
+             leftOffsets,
+             segments,
+             splits,
+             chunkOffsets,
+             cellIds,
+             bounds,
+             centroids,
+             newCellIds,
+             newBounds,
+             newCentroids);
+      std::swap(cellIds, newCellIds);
+      std::swap(bounds, newBounds);
+      std::swap(centroids, newCentroids);
+    }
+
+    numBinaryNodes += 2 * numSplits;
+    segments = childSegments;
+  }
+
+  // Collapse the binary tree into a 4-wide tree.
+  vtkm::cont::ArrayHandle<vtkm::Id> isWide;
+  vtkm::cont::ArrayHandle<vtkm::Id> isLeaf;
+  invoke(ClassifyNodes{}, binaryNodes, isWide, isLeaf);
+  vtkm::cont::ArrayHandle<vtkm::Id> wideIndices;
+  vtkm::cont::ArrayHandle<vtkm::Id> leafIndices;
+  vtkm::Id numWide = vtkm::cont::Algorithm::ScanExclusive(isWide, wideIndices);
+  vtkm::Id numLeaves = vtkm::cont::Algorithm::ScanExclusive(isLeaf, leafIndices);
+
+  // A tree that is a single leaf still gets a root node to start the search from.
+  this->Nodes.Allocate(vtkm::Max(numWide, vtkm::Id(1)));
+  this->Leaves.Allocate(numLeaves);
+  invoke(CollapseNodes{},
+         binaryNodes,
+         wideIndices,
+         leafIndices,
+         binaryNodes,
+         wideIndices,
+         leafIndices,
+         this->Nodes,
+         this->Leaves);
+  if (numWide == 0)
+  {
+    BinaryNode root = binaryNodes.ReadPortal().Get(0);
+    NodeType node;
+    CollapseNodes::SetSlot(node, 0, root, -2);
+    BinaryNode empty{ Box::Empty(), -1, 0, 0, 0 };
+    for (vtkm::IdComponent slot = 1; slot < NodeType::Width; ++slot)
+    {
+      CollapseNodes::SetSlot(node, slot, empty, -1);
+    }
+    this->Nodes.WritePortal().Set(0, node);
+  }
+}
+
+//----------------------------------------------------------------------------
+struct CellLocatorBoundingVolumeHierarchy::MakeExecObject
+{
+  template <typename CellSetType>
+  VTKM_CONT void operator()(const CellSetType& cellSet,
+                            vtkm::cont::DeviceAdapterId device,
+                            vtkm::cont::Token& token,
+                            const CellLocatorBoundingVolumeHierarchy& self,
+                            ExecObjType& execObject) const
+  {
+    using CellStructureType = CellSetContToExec<CellSetType>;
+    execObject = vtkm::exec::CellLocatorBoundingVolumeHierarchy<CellStructureType>(
+      self.Nodes, self.Leaves, self.CellIds, cellSet, self.GetCoordinates(), device, token);
+  }
+};
+
+CellLocatorBoundingVolumeHierarchy::ExecObjType
+CellLocatorBoundingVolumeHierarchy::PrepareForExecution(vtkm::cont::DeviceAdapterId device,
+                                                        vtkm::cont::Token& token) const
+{
+  this->Update();
+  ExecObjType execObject;
+  vtkm::cont::CastAndCall(this->GetCellSet(), MakeExecObject{}, device, token, *this, execObject);
+  return execObject;
+}
+
+//----------------------------------------------------------------------------
+void CellLocatorBoundingVolumeHierarchy::PrintSummary(std::ostream& out) const
+{
+  out << "MaxLeafSize: " << this->MaxLeafSize << "\n";
+  out << "Input CellSet: \n";
+  this->GetCellSet().PrintSummary(out);
+  out << "Input Coordinates: \n";
+  this->GetCoordinates().PrintSummary(out);
+  out << "LookupStructure:\n";
+  out << "  Nodes: " << this->Nodes.GetNumberOfValues() << "\n";
+  out << "  Leaves:\n";
+  vtkm::cont::printSummary_ArrayHandle(this->Leaves, out);
+  out << "  CellIds:\n";
+  vtkm::cont::printSummary_ArrayHandle(this->CellIds, out);
+}
+}
+} // vtkm::cont
@@ -0,0 +1,94 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_CellLocatorBoundingVolumeHierarchy_h
+#define vtk_m_cont_CellLocatorBoundingVolumeHierarchy_h
+
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/ArrayHandle.h>
+
+#include <vtkm/cont/internal/CellLocatorBase.h>
+
+#include <vtkm/exec/CellLocatorBoundingVolumeHierarchy.h>
+#include <vtkm/exec/CellLocatorMultiplexer.h>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief A locator that uses a bounding volume hierarchy built with the surface area heuristic.
+///
+/// `CellLocatorBoundingVolumeHierarchy` groups the cells of the mesh into a tree of axis
+/// aligned bounding boxes. The tree is built top down. Each group of cells is split in two by
+/// binning the centroids of the cells along each axis and choosing the bin boundary that
+/// minimizes the surface area heuristic (SAH). Because the splits adapt to the shape of the
+/// cells rather than to a grid, the locator holds up well on meshes with highly anisotropic
+/// or very unevenly sized cells, which degrade `CellLocatorTwoLevel`.
+///
+/// The binary tree is collapsed into a 4-wide tree for searching. The child bounding boxes of
+/// each node are stored as a structure of arrays so that a point is tested against all of
+/// them at once.
+///
+/// Each level of the tree is built in parallel across all of the cells in that level, so the
+/// build scales to large meshes.
+///
+class VTKM_CONT_EXPORT CellLocatorBoundingVolumeHierarchy
+  : public vtkm::cont::internal::CellLocatorBase<CellLocatorBoundingVolumeHierarchy>
+{
+  using Superclass = vtkm::cont::internal::CellLocatorBase<CellLocatorBoundingVolumeHierarchy>;
+
+  template <typename CellSetCont>
+  using CellSetContToExec =
+    typename CellSetCont::template ExecConnectivityType<vtkm::TopologyElementTagCell,
+                                                        vtkm::TopologyElementTagPoint>;
+
+public:
+  using SupportedCellSets = VTKM_DEFAULT_CELL_SET_LIST;
+
+  using CellExecObjectList = vtkm::ListTransform<SupportedCellSets, CellSetContToExec>;
+  using CellLocatorExecList =
+    vtkm::ListTransform<CellExecObjectList, vtkm::exec::CellLocatorBoundingVolumeHierarchy>;
+
+  using ExecObjType = vtkm::ListApply<CellLocatorExecList, vtkm::exec::CellLocatorMultiplexer>;
+  using LastCell = typename ExecObjType::LastCell;
+
+  /// Get/Set the number of cells at or below which a group of cells is no longer split.
+  ///
+  void SetMaxLeafSize(vtkm::IdComponent maxLeafSize)
+  {
+    this->MaxLeafSize = maxLeafSize;
+    this->SetModified();
+  }
+  vtkm::IdComponent GetMaxLeafSize() const { return this->MaxLeafSize; }
+
+  void PrintSummary(std::ostream& out) const;
+
+  ExecObjType PrepareForExecution(vtkm::cont::DeviceAdapterId device,
+                                  vtkm::cont::Token& token) const;
+
+private:
+  friend Superclass;
+  VTKM_CONT void Build();
+
+  vtkm::IdComponent MaxLeafSize = 4;
+
+  vtkm::cont::ArrayHandle<vtkm::exec::CellLocatorBoundingVolumeHierarchyNode> Nodes;
+  vtkm::cont::ArrayHandle<vtkm::Id2> Leaves;
+  vtkm::cont::ArrayHandle<vtkm::Id> CellIds;
+
+  struct MakeExecObject;
+};
+
+}
+} // vtkm::cont
+
+#endif // vtk_m_cont_CellLocatorBoundingVolumeHierarchy_h
@@ -9,17 +9,98 @@
 //============================================================================
 #include <vtkm/cont/CellLocatorGeneral.h>
 
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCartesianProduct.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellLocatorBoundingVolumeHierarchy.h>
 #include <vtkm/cont/CellLocatorRectilinearGrid.h>
 #include <vtkm/cont/CellLocatorTwoLevel.h>
 #include <vtkm/cont/CellLocatorUniformGrid.h>
 #include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/MortonCodes.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
 
 namespace
 {
 
+// Number of consecutive (Morton sorted) points searched by one thread with a shared hint.
+constexpr vtkm::Id FIND_CELLS_GROUP_SIZE = 16;
+
+class ComputeMortonCodes : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn point, FieldOut code);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_CONT ComputeMortonCodes(const vtkm::Bounds& bounds)
+    : Origin(static_cast<vtkm::Float32>(bounds.X.Min),
+             static_cast<vtkm::Float32>(bounds.Y.Min),
+             static_cast<vtkm::Float32>(bounds.Z.Min))
+  {
+    vtkm::Vec3f_64 length(bounds.X.Length(), bounds.Y.Length(), bounds.Z.Length());
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      this->InvLength[i] = (length[i] > 0) ? static_cast<vtkm::Float32>(1.0 / length[i]) : 0.0f;
+    }
+  }
+
+  VTKM_EXEC void operator()(const vtkm::Vec3f& point, vtkm::UInt64& code) const
+  {
+    code = vtkm::MortonCode64((vtkm::Vec3f_32(point) - this->Origin) * this->InvLength);
+  }
+
+private:
+  vtkm::Vec3f_32 Origin;
+  vtkm::Vec3f_32 InvLength;
+};
+
+class FindCellsInGroup : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn groupIndex,
+                                WholeArrayIn sortedToOriginal,
+                                WholeArrayIn points,
+                                ExecObject locator,
+                                WholeArrayOut cellIds,
+                                WholeArrayOut pcoords);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  template <typename IndexPortal,
+            typename PointPortal,
+            typename LocatorType,
+            typename CellIdPortal,
+            typename PCoordPortal>
+  VTKM_EXEC void operator()(vtkm::Id groupIndex,
+                            const IndexPortal& sortedToOriginal,
+                            const PointPortal& points,
+                            const LocatorType& locator,
+                            const CellIdPortal& cellIds,
+                            const PCoordPortal& pcoords) const
+  {
+    vtkm::Id begin = groupIndex * FIND_CELLS_GROUP_SIZE;
+    vtkm::Id end = vtkm::Min(begin + FIND_CELLS_GROUP_SIZE, sortedToOriginal.GetNumberOfValues());
+    typename LocatorType::LastCell lastCell;
+    for (vtkm::Id sortedIndex = begin; sortedIndex < end; ++sortedIndex)
+    {
+      vtkm::Id index = sortedToOriginal.Get(sortedIndex);
+      vtkm::Id cellId;
+      vtkm::Vec3f pcoord;
+      if (locator.FindCell(points.Get(index), cellId, pcoord, lastCell) != vtkm::ErrorCode::Success)
+      {
+        cellId = -1;
+      }
+      cellIds.Set(index, cellId);
+      pcoords.Set(index, pcoord);
+    }
+  }
+};
+
 template <typename LocatorImplType, typename LocatorVariantType>
 void BuildForType(vtkm::cont::CellLocatorGeneral& locator, LocatorVariantType& locatorVariant)
 {
@@ -62,6 +143,10 @@ VTKM_CONT void CellLocatorGeneral::Build()
   {
     BuildForType<vtkm::cont::CellLocatorRectilinearGrid>(*this, this->LocatorImpl);
   }
+  else if (this->UnstructuredLocator == UnstructuredLocatorType::BoundingVolumeHierarchy)
+  {
+    BuildForType<vtkm::cont::CellLocatorBoundingVolumeHierarchy>(*this, this->LocatorImpl);
+  }
   else
   {
     BuildForType<vtkm::cont::CellLocatorTwoLevel>(*this, this->LocatorImpl);
@@ -87,5 +172,39 @@ CellLocatorGeneral::ExecObjType CellLocatorGeneral::PrepareForExecution(
   return this->LocatorImpl.CastAndCall(PrepareFunctor{}, device, token);
 }
 
+void CellLocatorGeneral::FindCells(const vtkm::cont::UnknownArrayHandle& points,
+                                   vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+                                   vtkm::cont::ArrayHandle<vtkm::Vec3f>& parametricCoords) const
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorGeneral::FindCells");
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> pointArray;
+  vtkm::cont::ArrayCopyShallowIfPossible(points, pointArray);
+  vtkm::Id numberOfPoints = pointArray.GetNumberOfValues();
+
+  vtkm::cont::Invoker invoke;
+
+  // Order the points along a Morton curve over the bounds of the mesh. Points outside of
+  // the mesh are clamped to its boundary, which is good enough to keep them together.
+  vtkm::cont::ArrayHandle<vtkm::UInt64> codes;
+  invoke(ComputeMortonCodes{ this->GetCoordinates().GetBounds() }, pointArray, codes);
+  vtkm::cont::ArrayHandle<vtkm::Id> sortedToOriginal;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(numberOfPoints), sortedToOriginal);
+  vtkm::cont::Algorithm::SortByKey(codes, sortedToOriginal);
+  codes.ReleaseResources();
+
+  // Search the points in sorted order, scattering the results back to the original order.
+  cellIds.Allocate(numberOfPoints);
+  parametricCoords.Allocate(numberOfPoints);
+  vtkm::Id numberOfGroups = (numberOfPoints + FIND_CELLS_GROUP_SIZE - 1) / FIND_CELLS_GROUP_SIZE;
+  invoke(FindCellsInGroup{},
+         vtkm::cont::ArrayHandleIndex(numberOfGroups),
+         sortedToOriginal,
+         pointArray,
+         *this,
+         cellIds,
+         parametricCoords);
+}
+
 }
 } // vtkm::cont
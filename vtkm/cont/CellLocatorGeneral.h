@@ -10,9 +10,11 @@
 #ifndef vtk_m_cont_CellLocatorGeneral_h
 #define vtk_m_cont_CellLocatorGeneral_h
 
+#include <vtkm/cont/CellLocatorBoundingVolumeHierarchy.h>
 #include <vtkm/cont/CellLocatorRectilinearGrid.h>
 #include <vtkm/cont/CellLocatorTwoLevel.h>
 #include <vtkm/cont/CellLocatorUniformGrid.h>
+#include <vtkm/cont/UnknownArrayHandle.h>
 
 #include <vtkm/exec/CellLocatorMultiplexer.h>
 
@@ -46,21 +48,57 @@ class VTKM_CONT_EXPORT CellLocatorGeneral
 public:
   using ContLocatorList = vtkm::List<vtkm::cont::CellLocatorUniformGrid,
                                      vtkm::cont::CellLocatorRectilinearGrid,
-                                     vtkm::cont::CellLocatorTwoLevel>;
+                                     vtkm::cont::CellLocatorTwoLevel,
+                                     vtkm::cont::CellLocatorBoundingVolumeHierarchy>;
 
   using ExecLocatorList =
     vtkm::List<vtkm::cont::internal::ExecutionObjectType<vtkm::cont::CellLocatorUniformGrid>,
                vtkm::cont::internal::ExecutionObjectType<vtkm::cont::CellLocatorRectilinearGrid>,
-               vtkm::cont::internal::ExecutionObjectType<vtkm::cont::CellLocatorTwoLevel>>;
+               vtkm::cont::internal::ExecutionObjectType<vtkm::cont::CellLocatorTwoLevel>,
+               vtkm::cont::internal::ExecutionObjectType<
+                 vtkm::cont::CellLocatorBoundingVolumeHierarchy>>;
 
   using ExecObjType = vtkm::ListApply<ExecLocatorList, vtkm::exec::CellLocatorMultiplexer>;
   using LastCell = typename ExecObjType::LastCell;
 
+  /// The types of locator that can be used for meshes that are not uniform or rectilinear.
+  enum struct UnstructuredLocatorType
+  {
+    TwoLevel,
+    BoundingVolumeHierarchy
+  };
+
+  /// Get/Set the type of locator used for meshes that are not uniform or rectilinear.
+  ///
+  /// The default `TwoLevel` builds quickly and works well for most meshes. The
+  /// `BoundingVolumeHierarchy` is slower to build but handles meshes with highly anisotropic
+  /// or very unevenly sized cells much better.
+  ///
+  void SetUnstructuredLocatorType(UnstructuredLocatorType type)
+  {
+    this->UnstructuredLocator = type;
+    this->SetModified();
+  }
+  UnstructuredLocatorType GetUnstructuredLocatorType() const { return this->UnstructuredLocator; }
+
   VTKM_CONT ExecObjType PrepareForExecution(vtkm::cont::DeviceAdapterId device,
                                             vtkm::cont::Token& token) const;
 
+  /// \brief Finds the cells containing a batch of points.
+  ///
+  /// This is an alternative to calling `FindCell` from a worklet when the points are in no
+  /// particular order. The points are first sorted along a Morton curve. They are then
+  /// searched in this spatially coherent order in small groups, each of which passes a
+  /// `LastCell` hint from one point to the next. The results are written back in the order of
+  /// `points`. Points outside of the mesh get a cell id of -1.
+  ///
+  VTKM_CONT void FindCells(const vtkm::cont::UnknownArrayHandle& points,
+                           vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+                           vtkm::cont::ArrayHandle<vtkm::Vec3f>& parametricCoords) const;
+
 private:
   vtkm::cont::ListAsVariant<ContLocatorList> LocatorImpl;
+  UnstructuredLocatorType UnstructuredLocator = UnstructuredLocatorType::TwoLevel;
 
   friend Superclass;
   VTKM_CONT void Build();
@@ -11,8 +11,11 @@
 
 #include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleConcatenate.h>
 #include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleDiscard.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/internal/CellLocatorRefit.h>
 
 #include <vtkm/cont/Invoker.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -347,6 +350,13 @@ namespace cont
 ///
 VTKM_CONT void CellLocatorTwoLevel::Build()
 {
+  this->LastBuildWasRefit =
+    this->GetOnlyCoordinatesModified() && (this->RefitThreshold > 0) && this->Refit();
+  if (this->LastBuildWasRefit)
+  {
+    return;
+  }
+
   VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorTwoLevel::Build");
 
   vtkm::cont::Invoker invoke;
@@ -419,6 +429,19 @@ VTKM_CONT void CellLocatorTwoLevel::Build()
 
   // 9: Total number of unique (cell, bin) pairs (for pre-allocating arrays)
   vtkm::Id numPairsL2 = vtkm::cont::Algorithm::ScanExclusive(binCounts, binCounts);
+  if (this->RefitThreshold > 0)
+  {
+    // Remember the bins of each cell so that the structure can be refit later.
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandleConcatenate(
+        binCounts, vtkm::cont::make_ArrayHandleConstant(numPairsL2, 1)),
+      this->CellBinOffsets);
+  }
+  else
+  {
+    this->CellBinOffsets.ReleaseResources();
+    this->CellBins.ReleaseResources();
+  }
 
   // 10: For each cell, find the l2 bins they intersect
   binIds.Allocate(numPairsL2);
@@ -433,6 +456,10 @@ VTKM_CONT void CellLocatorTwoLevel::Build()
          binIds,
          this->CellIds);
   binCounts.ReleaseResources();
+  if (this->RefitThreshold > 0)
+  {
+    vtkm::cont::ArrayCopy(binIds, this->CellBins);
+  }
 
   // 11: From above, find the cells that each l2 bin intersects
   vtkm::cont::Algorithm::SortByKey(binIds, this->CellIds);
@@ -454,6 +481,79 @@ VTKM_CONT void CellLocatorTwoLevel::Build()
   invoke(GenerateBinsL2{}, bins, cellsStart, cellsPerBin, this->CellStartIndex, this->CellCount);
 }
 
+//----------------------------------------------------------------------------
+/// Updates the lookup structure for moved points, keeping the grids of the last build
+///
+VTKM_CONT bool CellLocatorTwoLevel::Refit()
+{
+  auto cellset = this->GetCellSet();
+  const auto& coords = this->GetCoordinates();
+  vtkm::Id numberOfCells = cellset.GetNumberOfCells();
+  if (this->CellBinOffsets.GetNumberOfValues() != numberOfCells + 1)
+  {
+    return false;
+  }
+
+  // The grids are not changed, so all points must still be inside the top level grid.
+  auto bounds = coords.GetBounds();
+  FloatVec3 gridMin = this->TopLevel.Origin;
+  FloatVec3 gridMax = gridMin + (this->TopLevel.BinSize * FloatVec3(this->TopLevel.Dimensions));
+  if ((bounds.X.Min < gridMin[0]) || (bounds.Y.Min < gridMin[1]) || (bounds.Z.Min < gridMin[2]) ||
+      (bounds.X.Max > gridMax[0]) || (bounds.Y.Max > gridMax[1]) || (bounds.Z.Max > gridMax[2]))
+  {
+    return false;
+  }
+
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorTwoLevel::Refit");
+
+  vtkm::cont::Invoker invoke;
+
+  // 1: For each cell, find the l2 bins they now intersect
+  vtkm::cont::ArrayHandle<vtkm::Id> binCounts;
+  CountBinsL2 countL2(this->TopLevel);
+  invoke(countL2, cellset, coords, this->LeafDimensions, binCounts);
+
+  vtkm::Id numPairsL2 = vtkm::cont::Algorithm::ScanExclusive(binCounts, binCounts);
+  vtkm::cont::ArrayHandle<vtkm::Id> newCellBinOffsets;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConcatenate(
+                          binCounts, vtkm::cont::make_ArrayHandleConstant(numPairsL2, 1)),
+                        newCellBinOffsets);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> newCellBins;
+  newCellBins.Allocate(numPairsL2);
+  vtkm::cont::ArrayHandleDiscard<vtkm::Id> discardCellIds;
+  discardCellIds.Allocate(numPairsL2);
+  FindBinsL2 findL2(this->TopLevel);
+  invoke(findL2,
+         cellset,
+         coords,
+         this->LeafDimensions,
+         this->LeafStartIndex,
+         binCounts,
+         newCellBins,
+         discardCellIds);
+  binCounts.ReleaseResources();
+
+  // 2: Sort the cells that changed bins and merge them with the others
+  auto maxChangedCells =
+    static_cast<vtkm::Id>(this->RefitThreshold * static_cast<vtkm::FloatDefault>(numberOfCells));
+  if (!vtkm::cont::internal::RefitCellBins(this->CellBinOffsets,
+                                           this->CellBins,
+                                           newCellBinOffsets,
+                                           newCellBins,
+                                           maxChangedCells,
+                                           this->CellStartIndex,
+                                           this->CellCount,
+                                           this->CellIds))
+  {
+    return false;
+  }
+
+  this->CellBinOffsets = newCellBinOffsets;
+  this->CellBins = newCellBins;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 struct CellLocatorTwoLevel::MakeExecObject
 {
@@ -84,6 +84,29 @@ public:
   }
   vtkm::FloatDefault GetDensityL2() const { return this->DensityL2; }
 
+  /// Get/Set the maximum fraction of cells that may change bins when refitting.
+  ///
+  /// When this is positive, the locator remembers the bins overlapped by each cell. If
+  /// afterward only the coordinates are replaced (with `SetCoordinates`) and the points stay
+  /// within the top level grid, the search structure is refit rather than rebuilt. The bins of
+  /// every cell are recomputed, but only the cells whose bins changed are sorted. All other
+  /// entries are copied over in a single pass. If more than this fraction of the cells changed
+  /// bins, the structure is rebuilt from scratch. Remembering the bins of each cell takes
+  /// about as much memory as the search structure itself. The default of 0 disables
+  /// refitting.
+  ///
+  void SetRefitThreshold(vtkm::FloatDefault fraction)
+  {
+    this->RefitThreshold = fraction;
+    this->SetModified();
+  }
+  vtkm::FloatDefault GetRefitThreshold() const { return this->RefitThreshold; }
+
+  /// Returns true if the search structure was refit rather than built from scratch the
+  /// last time it was updated.
+  ///
+  bool GetLastBuildWasRefit() const { return this->LastBuildWasRefit; }
+
   void PrintSummary(std::ostream& out) const;
 
   ExecObjType PrepareForExecution(vtkm::cont::DeviceAdapterId device,
@@ -92,8 +115,11 @@ public:
 private:
   friend Superclass;
   VTKM_CONT void Build();
+  VTKM_CONT bool Refit();
 
   vtkm::FloatDefault DensityL1, DensityL2;
+  vtkm::FloatDefault RefitThreshold = 0.0f;
+  bool LastBuildWasRefit = false;
 
   vtkm::internal::cl_uniform_bins::Grid TopLevel;
   vtkm::cont::ArrayHandle<vtkm::internal::cl_uniform_bins::DimVec3> LeafDimensions;
@@ -102,6 +128,10 @@ private:
   vtkm::cont::ArrayHandle<vtkm::Id> CellCount;
   vtkm::cont::ArrayHandle<vtkm::Id> CellIds;
 
+  // Leaf bins overlapped by each cell (grouped by cell). Only kept when refitting is enabled.
+  vtkm::cont::ArrayHandle<vtkm::Id> CellBinOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> CellBins;
+
   struct MakeExecObject;
 };
 
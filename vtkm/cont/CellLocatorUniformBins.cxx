@@ -8,10 +8,14 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandleGroupVecVariable.h>
+#include <vtkm/cont/ArrayHandleOffsetsToNumComponents.h>
+#include <vtkm/cont/ArrayHandleView.h>
 #include <vtkm/cont/CellLocatorUniformBins.h>
 #include <vtkm/cont/ConvertNumComponentsToOffsets.h>
 #include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/internal/CellLocatorRefit.h>
 #include <vtkm/worklet/WorkletMapField.h>
 #include <vtkm/worklet/WorkletMapTopology.h>
 
@@ -161,6 +165,64 @@ private:
   vtkm::Vec3f Origin;
 };
 
+// Same as RecordBinsPerCell, but only lists the bins of each cell. Used when refitting.
+class ListBinsPerCell : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+  using ControlSignature = void(CellSetIn cellset,
+                                FieldInPoint coords,
+                                FieldInCell start,
+                                WholeArrayOut binsPerCell);
+  using ExecutionSignature = void(_2, _3, _4);
+  using InputDomain = _1;
+
+  ListBinsPerCell(const vtkm::Vec3f& origin,
+                  const vtkm::Vec3f& invSpacing,
+                  const vtkm::Id3& dims,
+                  const vtkm::Id3& maxCellIds)
+    : Dims(dims)
+    , InvSpacing(invSpacing)
+    , MaxCellIds(maxCellIds)
+    , Origin(origin)
+  {
+  }
+
+  template <typename PointsVecType, typename ResultArrayType>
+  VTKM_EXEC void operator()(const PointsVecType& points,
+                            const vtkm::Id& start,
+                            ResultArrayType& binsPerCell) const
+  {
+    vtkm::Id3 idx000, idx111;
+    MinMaxIndicesForCellPoints(
+      points, this->Origin, this->InvSpacing, this->MaxCellIds, idx000, idx111);
+
+    vtkm::Id cnt = 0;
+    vtkm::Id sliceStart = ComputeFlatIndex(idx000, this->Dims);
+    for (vtkm::Id k = idx000[2]; k <= idx111[2]; k++)
+    {
+      vtkm::Id shaftStart = sliceStart;
+      for (vtkm::Id j = idx000[1]; j <= idx111[1]; j++)
+      {
+        vtkm::Id flatIdx = shaftStart;
+        for (vtkm::Id i = idx000[0]; i <= idx111[0]; i++)
+        {
+          binsPerCell.Set(start + cnt, flatIdx);
+          ++flatIdx;
+          ++cnt;
+        }
+        shaftStart += this->Dims[0];
+      }
+      sliceStart += this->Dims[0] * this->Dims[1];
+    }
+  }
+
+private:
+  vtkm::Id3 Dims;
+  vtkm::Vec3f InvSpacing;
+  vtkm::Id3 MaxCellIds;
+  vtkm::Vec3f Origin;
+};
+
 } //namespace detail
 
 
@@ -172,6 +234,13 @@ VTKM_CONT void CellLocatorUniformBins::Build()
   if (this->UniformDims[0] <= 0 || this->UniformDims[1] <= 0 || this->UniformDims[2] <= 0)
     throw vtkm::cont::ErrorBadValue("Grid dimensions of CellLocatorUniformBins must be > 0");
 
+  this->LastBuildWasRefit =
+    this->GetOnlyCoordinatesModified() && (this->RefitThreshold > 0) && this->Refit();
+  if (this->LastBuildWasRefit)
+  {
+    return;
+  }
+
   VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorUniformBins::Build");
 
   this->MaxCellIds = (vtkm::Max(this->UniformDims - vtkm::Id3(1), vtkm::Id3(0)));
@@ -273,6 +342,18 @@ VTKM_CONT void CellLocatorUniformBins::Build()
     this->Origin, this->InvSpacing, this->UniformDims, this->MaxCellIds);
   invoker(recordBinsPerCell, cellset, coords, binOffset, binsPerCell, cids, cellCount);
 
+  if (this->RefitThreshold > 0)
+  {
+    // Remember the bins of each cell so that the structure can be refit later.
+    vtkm::cont::ConvertNumComponentsToOffsets(binCountsPerCell, this->CellBinOffsets);
+    vtkm::cont::ArrayCopy(binsPerCell, this->CellBins);
+  }
+  else
+  {
+    this->CellBinOffsets.ReleaseResources();
+    this->CellBins.ReleaseResources();
+  }
+
   //Step 4:
   // binsPerCell is the overlapping bins for each cell.
   // We want to sort CellIds by the bin ID.  SortByKey does this.
@@ -285,6 +366,78 @@ VTKM_CONT void CellLocatorUniformBins::Build()
     cids, vtkm::cont::ConvertNumComponentsToOffsets(cellCount));
 }
 
+//----------------------------------------------------------------------------
+/// Updates the lookup structure for moved points, keeping the grid of the last build
+///
+VTKM_CONT bool CellLocatorUniformBins::Refit()
+{
+  auto cellset = this->GetCellSet();
+  const auto& coords = this->GetCoordinates();
+  vtkm::Id numberOfCells = cellset.GetNumberOfCells();
+  if (this->CellBinOffsets.GetNumberOfValues() != numberOfCells + 1)
+  {
+    return false;
+  }
+
+  // The grid is not changed, so all points must still be inside of it.
+  auto bounds = coords.GetBounds();
+  if ((bounds.X.Min < this->Origin[0]) || (bounds.Y.Min < this->Origin[1]) ||
+      (bounds.Z.Min < this->Origin[2]) || (bounds.X.Max > this->MaxPoint[0]) ||
+      (bounds.Y.Max > this->MaxPoint[1]) || (bounds.Z.Max > this->MaxPoint[2]))
+  {
+    return false;
+  }
+
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "CellLocatorUniformBins::Refit");
+
+  vtkm::cont::Invoker invoker;
+  vtkm::Id totalNumBins = this->UniformDims[0] * this->UniformDims[1] * this->UniformDims[2];
+
+  // 1: Find the bins each cell now overlaps (same as steps 1-3 of Build).
+  vtkm::cont::ArrayHandle<vtkm::Id> binCountsPerCell;
+  CountCellBins countCellBins(this->Origin, this->InvSpacing, this->MaxCellIds);
+  invoker(countCellBins, cellset, coords, binCountsPerCell);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> binOffset;
+  auto num = vtkm::cont::Algorithm::ScanExclusive(binCountsPerCell, binOffset);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> newCellBins;
+  newCellBins.Allocate(num);
+  ListBinsPerCell listBinsPerCell(
+    this->Origin, this->InvSpacing, this->UniformDims, this->MaxCellIds);
+  invoker(listBinsPerCell, cellset, coords, binOffset, newCellBins);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> newCellBinOffsets;
+  vtkm::cont::ConvertNumComponentsToOffsets(binCountsPerCell, newCellBinOffsets);
+
+  // 2: Sort the cells that changed bins and merge them with the others.
+  vtkm::cont::ArrayHandle<vtkm::Id> binStarts, binCounts;
+  const auto& offsets = this->CellIds.GetOffsetsArray();
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleView(offsets, 0, totalNumBins), binStarts);
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleOffsetsToNumComponents(offsets), binCounts);
+  vtkm::cont::ArrayHandle<vtkm::Id> binCellIds = this->CellIds.GetComponentsArray();
+
+  auto maxChangedCells =
+    static_cast<vtkm::Id>(this->RefitThreshold * static_cast<vtkm::FloatDefault>(numberOfCells));
+  if (!vtkm::cont::internal::RefitCellBins(this->CellBinOffsets,
+                                           this->CellBins,
+                                           newCellBinOffsets,
+                                           newCellBins,
+                                           maxChangedCells,
+                                           binStarts,
+                                           binCounts,
+                                           binCellIds))
+  {
+    return false;
+  }
+
+  this->CellIds = vtkm::cont::make_ArrayHandleGroupVecVariable(
+    binCellIds, vtkm::cont::ConvertNumComponentsToOffsets(binCounts));
+  this->CellBinOffsets = newCellBinOffsets;
+  this->CellBins = newCellBins;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 struct CellLocatorUniformBins::MakeExecObject
 {
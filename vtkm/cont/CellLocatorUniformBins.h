@@ -59,6 +59,29 @@ public:
   void SetDims(const vtkm::Id3& dims) { this->UniformDims = dims; }
   vtkm::Id3 GetDims() const { return this->UniformDims; }
 
+  /// Get/Set the maximum fraction of cells that may change bins when refitting.
+  ///
+  /// When this is positive, the locator remembers the bins overlapped by each cell. If
+  /// afterward only the coordinates are replaced (with `SetCoordinates`) and the points stay
+  /// within the bounds of the grid, the search structure is refit rather than rebuilt. The bins of
+  /// every cell are recomputed, but only the cells whose bins changed are sorted. All other
+  /// entries are copied over in a single pass. If more than this fraction of the cells changed
+  /// bins, the structure is rebuilt from scratch. Remembering the bins of each cell takes
+  /// about as much memory as the search structure itself. The default of 0 disables
+  /// refitting.
+  ///
+  void SetRefitThreshold(vtkm::FloatDefault fraction)
+  {
+    this->RefitThreshold = fraction;
+    this->SetModified();
+  }
+  vtkm::FloatDefault GetRefitThreshold() const { return this->RefitThreshold; }
+
+  /// Returns true if the search structure was refit rather than built from scratch the
+  /// last time it was updated.
+  ///
+  bool GetLastBuildWasRefit() const { return this->LastBuildWasRefit; }
+
   void PrintSummary(std::ostream& out) const;
 
 public:
@@ -68,7 +91,10 @@ public:
 private:
   friend Superclass;
   VTKM_CONT void Build();
+  VTKM_CONT bool Refit();
 
+  vtkm::FloatDefault RefitThreshold = 0.0f;
+  bool LastBuildWasRefit = false;
   vtkm::Vec3f InvSpacing;
   vtkm::Vec3f MaxPoint;
   vtkm::Vec3f Origin;
@@ -80,6 +106,10 @@ private:
 
   vtkm::cont::ArrayHandleGroupVecVariable<CellIdArrayType, CellIdOffsetArrayType> CellIds;
 
+  // Bins overlapped by each cell (grouped by cell). Only kept when refitting is enabled.
+  vtkm::cont::ArrayHandle<vtkm::Id> CellBinOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> CellBins;
+
   struct MakeExecObject;
 };
 
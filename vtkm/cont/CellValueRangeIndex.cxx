@@ -0,0 +1,365 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#include <vtkm/cont/CellValueRangeIndex.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ConvertNumComponentsToOffsets.h>
+#include <vtkm/cont/DefaultTypes.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vtkm
+{
+namespace cont
+{
+
+namespace internal
+{
+
+// Cells are laid out as a 3D grid (padded with dimensions of 1) and grouped into bricks.
+struct CellBlockLayout
+{
+  vtkm::Id3 CellDimensions;
+  vtkm::Id3 BlockDimensions;
+  vtkm::Id3 NumberOfBlocks;
+
+  VTKM_CONT CellBlockLayout(const vtkm::Id3& cellDimensions, const vtkm::Id3& blockDimensions)
+    : CellDimensions(cellDimensions)
+    , BlockDimensions(blockDimensions)
+  {
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      this->NumberOfBlocks[d] =
+        (cellDimensions[d] + blockDimensions[d] - 1) / vtkm::Max(blockDimensions[d], vtkm::Id(1));
+    }
+  }
+
+  VTKM_EXEC_CONT vtkm::Id GetTotalNumberOfBlocks() const
+  {
+    return this->NumberOfBlocks[0] * this->NumberOfBlocks[1] * this->NumberOfBlocks[2];
+  }
+
+  VTKM_EXEC vtkm::Id3 GetBlockStart(vtkm::Id blockId) const
+  {
+    vtkm::Id3 blockIndex(blockId % this->NumberOfBlocks[0],
+                         (blockId / this->NumberOfBlocks[0]) % this->NumberOfBlocks[1],
+                         blockId / (this->NumberOfBlocks[0] * this->NumberOfBlocks[1]));
+    return blockIndex * this->BlockDimensions;
+  }
+
+  VTKM_EXEC vtkm::Id3 GetBlockExtent(const vtkm::Id3& start) const
+  {
+    return vtkm::Min(this->BlockDimensions, this->CellDimensions - start);
+  }
+
+  VTKM_EXEC vtkm::Id GetNumberOfCells(vtkm::Id blockId) const
+  {
+    vtkm::Id3 extent = this->GetBlockExtent(this->GetBlockStart(blockId));
+    return extent[0] * extent[1] * extent[2];
+  }
+
+  // Calls functor(cellId) for every cell in the block in increasing order of cell id.
+  template <typename Functor>
+  VTKM_EXEC void ForEachCell(vtkm::Id blockId, Functor&& functor) const
+  {
+    vtkm::Id3 start = this->GetBlockStart(blockId);
+    vtkm::Id3 extent = this->GetBlockExtent(start);
+    for (vtkm::Id k = start[2]; k < start[2] + extent[2]; ++k)
+    {
+      for (vtkm::Id j = start[1]; j < start[1] + extent[1]; ++j)
+      {
+        vtkm::Id rowStart = (k * this->CellDimensions[1] + j) * this->CellDimensions[0];
+        for (vtkm::Id i = start[0]; i < start[0] + extent[0]; ++i)
+        {
+          functor(rowStart + i);
+        }
+      }
+    }
+  }
+};
+
+class ComputeBlockRangesWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockId,
+                                WholeCellSetIn<Cell, Point> cellSet,
+                                WholeArrayIn field,
+                                FieldOut range);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  VTKM_CONT ComputeBlockRangesWorklet(const CellBlockLayout& layout, bool pointField)
+    : Layout(layout)
+    , PointField(pointField)
+  {
+  }
+
+  template <typename CellSetType, typename FieldPortal>
+  VTKM_EXEC void operator()(vtkm::Id blockId,
+                            const CellSetType& cellSet,
+                            const FieldPortal& field,
+                            vtkm::Vec2f_64& range) const
+  {
+    range = { vtkm::Infinity64(), vtkm::NegativeInfinity64() };
+    auto addValue = [&](vtkm::Id index) {
+      vtkm::Float64 value = static_cast<vtkm::Float64>(field.Get(index));
+      range[0] = vtkm::Min(range[0], value);
+      range[1] = vtkm::Max(range[1], value);
+    };
+    this->Layout.ForEachCell(blockId, [&](vtkm::Id cellId) {
+      if (this->PointField)
+      {
+        auto indices = cellSet.GetIndices(cellId);
+        for (vtkm::IdComponent i = 0; i < indices.GetNumberOfComponents(); ++i)
+        {
+          addValue(indices[i]);
+        }
+      }
+      else
+      {
+        addValue(cellId);
+      }
+    });
+  }
+
+private:
+  CellBlockLayout Layout;
+  bool PointField;
+};
+
+struct BlockOverlapsRange
+{
+  vtkm::Float64 Min;
+  vtkm::Float64 Max;
+
+  VTKM_EXEC_CONT bool operator()(const vtkm::Vec2f_64& blockRange) const
+  {
+    return (blockRange[0] <= this->Max) && (blockRange[1] >= this->Min);
+  }
+};
+
+class BlockHoldsAnyValueWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockRange, WholeArrayIn sortedValues, FieldOut holds);
+  using ExecutionSignature = _3(_1, _2);
+
+  template <typename ValuesPortal>
+  VTKM_EXEC bool operator()(const vtkm::Vec2f_64& blockRange, const ValuesPortal& values) const
+  {
+    // Find the first value that is not below the block.
+    vtkm::Id low = 0;
+    vtkm::Id high = values.GetNumberOfValues();
+    while (low < high)
+    {
+      vtkm::Id mid = (low + high) / 2;
+      if (values.Get(mid) < blockRange[0])
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    return (low < values.GetNumberOfValues()) && (values.Get(low) <= blockRange[1]);
+  }
+};
+
+class CountBlockCellsWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockId, FieldOut numCells);
+  using ExecutionSignature = _2(_1);
+
+  VTKM_CONT explicit CountBlockCellsWorklet(const CellBlockLayout& layout)
+    : Layout(layout)
+  {
+  }
+
+  VTKM_EXEC vtkm::IdComponent operator()(vtkm::Id blockId) const
+  {
+    return static_cast<vtkm::IdComponent>(this->Layout.GetNumberOfCells(blockId));
+  }
+
+private:
+  CellBlockLayout Layout;
+};
+
+class ListBlockCellsWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockId, FieldOut cellIds);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_CONT explicit ListBlockCellsWorklet(const CellBlockLayout& layout)
+    : Layout(layout)
+  {
+  }
+
+  template <typename CellIdsVecType>
+  VTKM_EXEC void operator()(vtkm::Id blockId, CellIdsVecType& cellIds) const
+  {
+    vtkm::IdComponent index = 0;
+    this->Layout.ForEachCell(blockId, [&](vtkm::Id cellId) { cellIds[index++] = cellId; });
+  }
+
+private:
+  CellBlockLayout Layout;
+};
+
+} // namespace internal
+
+void CellValueRangeIndex::Update()
+{
+  if (this->Modified)
+  {
+    this->Build();
+    this->Modified = false;
+  }
+}
+
+void CellValueRangeIndex::Build()
+{
+  if (!this->Field.IsPointField() && !this->Field.IsCellField())
+  {
+    throw vtkm::cont::ErrorBadValue("CellValueRangeIndex needs a point or cell field.");
+  }
+  if (this->BlockSize < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("CellValueRangeIndex block size must be positive.");
+  }
+
+  // Structured cells are grouped into bricks. Other cells are grouped into runs of ids.
+  vtkm::IdComponent dimensions = 1;
+  if (this->CellSet.IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    this->CellDimensions =
+      this->CellSet.AsCellSet<vtkm::cont::CellSetStructured<3>>().GetCellDimensions();
+    dimensions = 3;
+  }
+  else if (this->CellSet.IsType<vtkm::cont::CellSetStructured<2>>())
+  {
+    vtkm::Id2 cellDims =
+      this->CellSet.AsCellSet<vtkm::cont::CellSetStructured<2>>().GetCellDimensions();
+    this->CellDimensions = { cellDims[0], cellDims[1], 1 };
+    dimensions = 2;
+  }
+  else
+  {
+    this->CellDimensions = { this->CellSet.GetNumberOfCells(), 1, 1 };
+  }
+  vtkm::Id edge = std::max(
+    vtkm::Id(1),
+    static_cast<vtkm::Id>(std::round(std::pow(this->BlockSize, 1.0 / dimensions))));
+  this->BlockDimensions = { edge, (dimensions > 1) ? edge : 1, (dimensions > 2) ? edge : 1 };
+
+  internal::CellBlockLayout layout(this->CellDimensions, this->BlockDimensions);
+  vtkm::cont::ArrayHandleIndex blockIds(layout.GetTotalNumberOfBlocks());
+  internal::ComputeBlockRangesWorklet worklet(layout, this->Field.IsPointField());
+
+  const vtkm::cont::UnknownArrayHandle& data = this->Field.GetData();
+  bool resolved = false;
+  auto resolveType = [&](auto baseComponent) {
+    using T = decltype(baseComponent);
+    if (resolved || !data.IsBaseComponentType<T>())
+    {
+      return;
+    }
+    resolved = true;
+    auto component = data.ExtractComponent<T>(0);
+    this->CellSet.CastAndCallForTypes<VTKM_DEFAULT_CELL_SET_LIST>([&](const auto& cellSet) {
+      vtkm::cont::Invoker{}(worklet, blockIds, cellSet, component, this->BlockRanges);
+    });
+  };
+  vtkm::ListForEach(resolveType, vtkm::TypeListScalarAll{});
+  if (!resolved)
+  {
+    throw vtkm::cont::ErrorBadValue("CellValueRangeIndex could not resolve the field type.");
+  }
+}
+
+vtkm::cont::ArrayHandle<vtkm::Id> CellValueRangeIndex::FindCandidateCells(
+  const vtkm::Range& range)
+{
+  this->Update();
+
+  vtkm::cont::ArrayHandle<vtkm::Id> blockIds;
+  vtkm::cont::Algorithm::CopyIf(vtkm::cont::ArrayHandleIndex(this->GetNumberOfBlocks()),
+                                this->BlockRanges,
+                                blockIds,
+                                internal::BlockOverlapsRange{ range.Min, range.Max });
+  return this->ExpandBlocks(blockIds);
+}
+
+vtkm::cont::ArrayHandle<vtkm::Id> CellValueRangeIndex::FindCandidateCells(
+  const std::vector<vtkm::Float64>& values)
+{
+  this->Update();
+
+  std::vector<vtkm::Float64> sortedValues(values);
+  std::sort(sortedValues.begin(), sortedValues.end());
+
+  vtkm::cont::ArrayHandle<bool> holdsValue;
+  vtkm::cont::Invoker{}(internal::BlockHoldsAnyValueWorklet{},
+                        this->BlockRanges,
+                        vtkm::cont::make_ArrayHandle(sortedValues, vtkm::CopyFlag::Off),
+                        holdsValue);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> blockIds;
+  vtkm::cont::Algorithm::CopyIf(
+    vtkm::cont::ArrayHandleIndex(this->GetNumberOfBlocks()), holdsValue, blockIds);
+  return this->ExpandBlocks(blockIds);
+}
+
+vtkm::cont::ArrayHandle<vtkm::Id> CellValueRangeIndex::ExpandBlocks(
+  const vtkm::cont::ArrayHandle<vtkm::Id>& blockIds) const
+{
+  internal::CellBlockLayout layout(this->CellDimensions, this->BlockDimensions);
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> numCells;
+  invoke(internal::CountBlockCellsWorklet{ layout }, blockIds, numCells);
+
+  vtkm::Id totalCells;
+  vtkm::cont::ArrayHandle<vtkm::Id> offsets =
+    vtkm::cont::ConvertNumComponentsToOffsets(numCells, totalCells);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+  cellIds.Allocate(totalCells);
+  invoke(internal::ListBlockCellsWorklet{ layout },
+         blockIds,
+         vtkm::cont::make_ArrayHandleGroupVecVariable(cellIds, offsets));
+
+  // A brick spanning several rows of cells interleaves its cell ids with its neighbors.
+  if ((this->BlockDimensions[1] > 1) || (this->BlockDimensions[2] > 1))
+  {
+    vtkm::cont::Algorithm::Sort(cellIds);
+  }
+  return cellIds;
+}
+
+void CellValueRangeIndex::PrintSummary(std::ostream& out) const
+{
+  out << "CellValueRangeIndex" << std::endl;
+  out << "  Field: " << this->Field.GetName() << std::endl;
+  out << "  Cell Dimensions: " << this->CellDimensions << std::endl;
+  out << "  Block Dimensions: " << this->BlockDimensions << std::endl;
+  out << "  Number of Blocks: " << this->GetNumberOfBlocks() << std::endl;
+}
+
+}
+} // namespace vtkm::cont
@@ -0,0 +1,125 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_CellValueRangeIndex_h
+#define vtk_m_cont_CellValueRangeIndex_h
+
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <vtkm/Range.h>
+#include <vtkm/Types.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/Field.h>
+#include <vtkm/cont/UnknownCellSet.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief An index of the range of a scalar field over blocks of cells.
+///
+/// `CellValueRangeIndex` groups the cells of a mesh into small blocks and records the
+/// minimum and maximum value of a field over each block. `FindCandidateCells` uses these
+/// ranges to find the cells that may hold given values without visiting every cell. Every
+/// cell holding one of the values is returned, but some of the returned cells may not hold
+/// any of them.
+///
+/// The index is meant to be built once for a mesh and field and then queried many times, for
+/// example to contour or threshold the same field at many different values. The blocks of a
+/// structured cell set are bricks of neighboring cells. The blocks of any other cell set are
+/// runs of consecutive cells. The field can be associated with either points or cells. Only
+/// the first component of a field with multiple components is indexed.
+///
+/// The index does not notice changes to the values of the field or to the cells. Call
+/// `SetField` or `SetCellSet` again (or `SetModified`) after changing them.
+///
+class VTKM_CONT_EXPORT CellValueRangeIndex
+{
+public:
+  /// Specify the cells to index.
+  void SetCellSet(const vtkm::cont::UnknownCellSet& cellSet)
+  {
+    this->CellSet = cellSet;
+    this->SetModified();
+  }
+  const vtkm::cont::UnknownCellSet& GetCellSet() const { return this->CellSet; }
+
+  /// Specify the field to index. It must be associated with either points or cells.
+  void SetField(const vtkm::cont::Field& field)
+  {
+    this->Field = field;
+    this->SetModified();
+  }
+  const vtkm::cont::Field& GetField() const { return this->Field; }
+
+  /// Specify the approximate number of cells in each block. Smaller blocks find fewer cells
+  /// that do not hold the requested values, but take more memory and time to search.
+  void SetBlockSize(vtkm::IdComponent blockSize)
+  {
+    this->BlockSize = blockSize;
+    this->SetModified();
+  }
+  vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
+
+  /// Rebuild the index the next time it is used.
+  void SetModified() { this->Modified = true; }
+  bool GetModified() const { return this->Modified; }
+
+  /// Build the index if anything changed since it was last built. Copies of an index share
+  /// the index that was built before they were copied.
+  VTKM_CONT void Update();
+
+  /// Get the number of blocks the cells are grouped into.
+  VTKM_CONT vtkm::Id GetNumberOfBlocks() const { return this->BlockRanges.GetNumberOfValues(); }
+
+  /// Get the minimum and maximum value of the field over each block.
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Vec2f_64>& GetBlockRanges() const
+  {
+    return this->BlockRanges;
+  }
+
+  /// \brief Find the cells that may have a value in the given range.
+  ///
+  /// The ids of the cells are returned in increasing order.
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> FindCandidateCells(const vtkm::Range& range);
+
+  /// \brief Find the cells that may cross any of the given values.
+  ///
+  /// A block is searched only if one of the values is within the range of the block. This
+  /// finds far fewer cells than searching for the range that holds all of the values. The
+  /// ids of the cells are returned in increasing order.
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> FindCandidateCells(
+    const std::vector<vtkm::Float64>& values);
+
+  VTKM_CONT void PrintSummary(std::ostream& out) const;
+
+private:
+  VTKM_CONT void Build();
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> ExpandBlocks(
+    const vtkm::cont::ArrayHandle<vtkm::Id>& blockIds) const;
+
+  vtkm::cont::UnknownCellSet CellSet;
+  vtkm::cont::Field Field;
+  vtkm::IdComponent BlockSize = 64;
+  bool Modified = true;
+
+  // The cells are laid out as a grid of CellDimensions. Blocks are bricks of BlockDimensions
+  // cells within this grid.
+  vtkm::Id3 CellDimensions = { 0, 1, 1 };
+  vtkm::Id3 BlockDimensions = { 1, 1, 1 };
+  vtkm::cont::ArrayHandle<vtkm::Vec2f_64> BlockRanges;
+};
+
+}
+} // namespace vtkm::cont
+
+#endif // vtk_m_cont_CellValueRangeIndex_h
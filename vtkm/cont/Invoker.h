@@ -13,7 +13,22 @@
 #include <vtkm/worklet/internal/MaskBase.h>
 #include <vtkm/worklet/internal/ScatterBase.h>
 
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/Token.h>
 #include <vtkm/cont/TryExecute.h>
+#include <vtkm/cont/arg/TransportTagArrayIn.h>
+#include <vtkm/cont/arg/TransportTagKeyedValuesIn.h>
+#include <vtkm/cont/arg/TransportTagTopologyFieldIn.h>
+#include <vtkm/cont/arg/TransportTagWholeArrayIn.h>
+
+#include <vtkm/internal/FunctionInterface.h>
+
+#include <vtkmstd/integer_sequence.h>
+
+#include <future>
+#include <memory>
 
 #define PACT_DEBUG 0
 
@@ -28,6 +43,128 @@ template <typename T>
 using scatter_or_mask = std::integral_constant<bool,
                                                vtkm::worklet::internal::is_mask<T>::value ||
                                                  vtkm::worklet::internal::is_scatter<T>::value>;
+
+// Reserves a place for `token` in the access queue of every ArrayHandle argument. Other
+// arguments (scatters, masks, cell sets, execution objects) are ignored. They are still
+// protected by the token when the invoke prepares them, but their access is not ordered.
+template <typename T>
+VTKM_CONT void AsyncEnqueueArgument(std::true_type, const vtkm::cont::Token& token, const T& array)
+{
+  array.Enqueue(token);
+}
+template <typename T>
+VTKM_CONT void AsyncEnqueueArgument(std::false_type, const vtkm::cont::Token&, const T&)
+{
+}
+
+template <typename... Args>
+VTKM_CONT void AsyncEnqueueArguments(const vtkm::cont::Token& token, const Args&... args)
+{
+  (void)token;
+  auto doEnqueue = { 0,
+                     (AsyncEnqueueArgument(
+                        typename vtkm::cont::internal::ArrayHandleCheck<Args>::type{}, token, args),
+                      0)... };
+  (void)doEnqueue;
+}
+
+// Transports that only read their argument. Every other ArrayHandle argument is assumed
+// to be written.
+template <typename TransportTag>
+struct AsyncIsReadOnlyTransport : std::false_type
+{
+};
+template <>
+struct AsyncIsReadOnlyTransport<vtkm::cont::arg::TransportTagArrayIn> : std::true_type
+{
+};
+template <>
+struct AsyncIsReadOnlyTransport<vtkm::cont::arg::TransportTagWholeArrayIn> : std::true_type
+{
+};
+template <typename TopologyElementTag>
+struct AsyncIsReadOnlyTransport<vtkm::cont::arg::TransportTagTopologyFieldIn<TopologyElementTag>>
+  : std::true_type
+{
+};
+template <>
+struct AsyncIsReadOnlyTransport<vtkm::cont::arg::TransportTagKeyedValuesIn> : std::true_type
+{
+};
+
+// Number of scatter and mask objects given before the arguments of the ControlSignature.
+template <typename... Args>
+struct AsyncNumLeadingArguments : std::integral_constant<std::size_t, 0>
+{
+};
+template <typename T, typename... Args>
+struct AsyncNumLeadingArguments<T, Args...>
+  : std::integral_constant<std::size_t,
+                           scatter_or_mask<vtkm::internal::remove_cvref<T>>::value
+                             ? 1 + AsyncNumLeadingArguments<Args...>::value
+                             : 0>
+{
+};
+
+// Finds whether the argument at `ArgIndex` of an invoke is only read by the worklet. The
+// leading scatter and mask arguments have no entry in the ControlSignature.
+template <typename Worklet,
+          std::size_t NumLeading,
+          std::size_t ArgIndex,
+          bool IsLeading = (ArgIndex < NumLeading)>
+struct AsyncArgumentIsReadOnly : std::false_type
+{
+};
+template <typename Worklet, std::size_t NumLeading, std::size_t ArgIndex>
+struct AsyncArgumentIsReadOnly<Worklet, NumLeading, ArgIndex, false>
+  : AsyncIsReadOnlyTransport<typename vtkm::ListAt<
+      typename vtkm::internal::detail::FunctionSigInfo<
+        typename Worklet::ControlSignature>::Parameters,
+      static_cast<vtkm::IdComponent>(ArgIndex - NumLeading)>::TransportTag>
+{
+};
+
+// Waits until `token` gets its turn in the access queue of an ArrayHandle argument and
+// attaches it to the array's buffers. Once attached, the invoke can prepare the array with
+// the same token without waiting again, so the array is never looked at (e.g. for its size)
+// before the previous invoke writing it has finished.
+template <typename IsReadOnly, typename T>
+VTKM_CONT void AsyncAttachArgument(std::true_type, IsReadOnly, vtkm::cont::Token& token, const T& array)
+{
+  for (const vtkm::cont::internal::Buffer& buffer : array.GetBuffers())
+  {
+    if (IsReadOnly::value)
+    {
+      buffer.WaitToRead(token);
+    }
+    else
+    {
+      buffer.WaitToWrite(token);
+    }
+  }
+}
+template <typename IsReadOnly, typename T>
+VTKM_CONT void AsyncAttachArgument(std::false_type, IsReadOnly, vtkm::cont::Token&, const T&)
+{
+}
+
+template <typename Worklet, typename... Args, std::size_t... Indices>
+VTKM_CONT void AsyncAttachArguments(vtkmstd::index_sequence<Indices...>,
+                                    vtkm::cont::Token& token,
+                                    const Args&... args)
+{
+  (void)token;
+  constexpr std::size_t numLeading = AsyncNumLeadingArguments<Args...>::value;
+  auto doAttach = {
+    0,
+    (AsyncAttachArgument(typename vtkm::cont::internal::ArrayHandleCheck<Args>::type{},
+                         AsyncArgumentIsReadOnly<Worklet, numLeading, Indices>{},
+                         token,
+                         args),
+     0)...
+  };
+  (void)doAttach;
+}
 }
 
 /// \brief Allows launching any worklet without a dispatcher.
@@ -76,6 +213,10 @@ struct Invoker
     std::cout << "Invoker1\n";
     DispatcherType dispatcher(worklet, scatterOrMask);
     dispatcher.SetDevice(this->DeviceId);
+    if (this->ExternalToken != nullptr)
+    {
+      dispatcher.SetToken(*this->ExternalToken);
+    }
     dispatcher.Invoke(std::forward<Args>(args)...);
   }
 
@@ -101,6 +242,10 @@ struct Invoker
     std::cout << "Invoker2\n";
     DispatcherType dispatcher(worklet, scatterOrMaskA, scatterOrMaskB);
     dispatcher.SetDevice(this->DeviceId);
+    if (this->ExternalToken != nullptr)
+    {
+      dispatcher.SetToken(*this->ExternalToken);
+    }
     dispatcher.Invoke(std::forward<Args>(args)...);
   }
 
@@ -131,6 +276,10 @@ struct Invoker
     std::cout << "Invoker3.3\n";
     #endif
     dispatcher.SetDevice(this->DeviceId);
+    if (this->ExternalToken != nullptr)
+    {
+      dispatcher.SetToken(*this->ExternalToken);
+    }
     #if PACT_DEBUG
     std::cout << "Invoker3.4\n";
     #endif
@@ -141,12 +290,79 @@ struct Invoker
     #endif
   }
 
+  /// Launch the worklet asynchronously and return a future for its completion.
+  ///
+  /// The arguments are the same as for `operator()`. The worklet is run on its own
+  /// thread, so independent worklets launched with `Async` can overlap with each other
+  /// and with the calling thread.
+  ///
+  /// Before returning, `Async` reserves a place in the access queue of every `ArrayHandle`
+  /// argument (see `ArrayHandle::Enqueue`). Thus, accesses to the same array happen in the
+  /// order they were issued on the calling thread: a worklet reading an array waits for a
+  /// previously launched worklet writing it, whereas worklets only reading the array run
+  /// concurrently. All `Async` calls sharing arrays should be issued from the same thread.
+  ///
+  /// The control environment does not take part in this ordering. Call `get` (or `wait`) on
+  /// the returned future before using the output arrays outside of other `Async` calls.
+  ///
+  /// Errors raised by the worklet are reported when calling `get` on the returned future.
+  ///
+  template <typename Worklet, typename... Args>
+  inline std::future<void> Async(Worklet&& worklet, Args&&... args) const
+  {
+    std::shared_ptr<vtkm::cont::Token> token = std::make_shared<vtkm::cont::Token>();
+    detail::AsyncEnqueueArguments(*token, args...);
+
+    // The runtime device tracker is local to each thread. The task copies the state of the
+    // caller's tracker, and the caller waits for the copy before it can go on to change it.
+    // The promise is shared with the task so that it outlives the call to `set_value`.
+    const vtkm::cont::RuntimeDeviceTracker* callerTracker = &vtkm::cont::GetRuntimeDeviceTracker();
+    std::shared_ptr<std::promise<void>> started = std::make_shared<std::promise<void>>();
+    std::future<void> startedFuture = started->get_future();
+
+    std::future<void> result = std::async(
+      std::launch::async,
+      [token, callerTracker, started](vtkm::cont::DeviceAdapterId device,
+                                      vtkm::internal::remove_cvref<Worklet> asyncWorklet,
+                                      vtkm::internal::remove_cvref<Args>... asyncArgs) {
+        auto& tracker = vtkm::cont::GetRuntimeDeviceTracker();
+        tracker.CopyStateFrom(*callerTracker);
+        started->set_value();
+        tracker.SetThreadFriendlyMemAlloc(true);
+
+        vtkm::cont::Invoker invoke(device);
+        invoke.ExternalToken = token.get();
+        try
+        {
+          // Take our turn on every array before the invoke looks at any of them. This also
+          // unblocks the queues behind us should the invoke fail before preparing an array.
+          detail::AsyncAttachArguments<vtkm::internal::remove_cvref<Worklet>>(
+            vtkmstd::make_index_sequence<sizeof...(Args)>{}, *token, asyncArgs...);
+          invoke(asyncWorklet, asyncArgs...);
+          vtkm::cont::Algorithm::Synchronize();
+        }
+        catch (...)
+        {
+          token->DetachFromAll();
+          throw;
+        }
+        token->DetachFromAll();
+      },
+      this->DeviceId,
+      std::forward<Worklet>(worklet),
+      std::forward<Args>(args)...);
+
+    startedFuture.wait();
+    return result;
+  }
+
   /// Get the device adapter that this Invoker is bound too
   ///
   vtkm::cont::DeviceAdapterId GetDevice() const { return DeviceId; }
 
 private:
   vtkm::cont::DeviceAdapterId DeviceId;
+  vtkm::cont::Token* ExternalToken = nullptr;
 };
 }
 }
@@ -21,7 +21,9 @@
 
 #include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ConvertNumComponentsToOffsets.h>
 #include <vtkm/cont/Invoker.h>
 #include <vtkm/worklet/WorkletMapField.h>
 
@@ -63,6 +65,76 @@ private:
   vtkm::Vec3f Dxdydz;
 };
 
+class FindKNearestWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn queryPoint,
+                                ExecObject locator,
+                                FieldOut neighborIds,
+                                FieldOut distances2);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  template <typename Locator, typename IdVecType, typename DistanceVecType>
+  VTKM_EXEC void operator()(const vtkm::Vec3f& queryPoint,
+                            const Locator& locator,
+                            IdVecType& neighborIds,
+                            DistanceVecType& distances2) const
+  {
+    locator.FindKNearestNeighbors(
+      queryPoint, neighborIds.GetNumberOfComponents(), neighborIds, distances2);
+  }
+};
+
+class CountWithinRadiusWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn queryPoint, ExecObject locator, FieldOut count);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_CONT CountWithinRadiusWorklet(vtkm::FloatDefault radius)
+    : Radius(radius)
+  {
+  }
+
+  template <typename Locator>
+  VTKM_EXEC void operator()(const vtkm::Vec3f& queryPoint,
+                            const Locator& locator,
+                            vtkm::IdComponent& count) const
+  {
+    count = locator.CountWithinRadius(queryPoint, this->Radius);
+  }
+
+private:
+  vtkm::FloatDefault Radius;
+};
+
+class FindWithinRadiusWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn queryPoint,
+                                ExecObject locator,
+                                FieldOut neighborIds,
+                                FieldOut distances2);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  VTKM_CONT FindWithinRadiusWorklet(vtkm::FloatDefault radius)
+    : Radius(radius)
+  {
+  }
+
+  template <typename Locator, typename IdVecType, typename DistanceVecType>
+  VTKM_EXEC void operator()(const vtkm::Vec3f& queryPoint,
+                            const Locator& locator,
+                            IdVecType& neighborIds,
+                            DistanceVecType& distances2) const
+  {
+    locator.FindWithinRadius(queryPoint, this->Radius, neighborIds, distances2);
+  }
+
+private:
+  vtkm::FloatDefault Radius;
+};
+
 } // vtkm::cont::internal
 
 void PointLocatorSparseGrid::Build()
@@ -103,6 +175,68 @@ void PointLocatorSparseGrid::Build()
   vtkm::cont::Algorithm::LowerBounds(cellIds, cell_ids_counting, this->CellLower);
 }
 
+void PointLocatorSparseGrid::FindKNearestNeighbors(
+  const vtkm::cont::UnknownArrayHandle& queryPoints,
+  vtkm::IdComponent k,
+  vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+  vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances2)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "PointLocatorSparseGrid::FindKNearestNeighbors");
+
+  this->Update();
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  vtkm::cont::ArrayCopyShallowIfPossible(queryPoints, points);
+
+  vtkm::IdComponent count = static_cast<vtkm::IdComponent>(
+    vtkm::Min(static_cast<vtkm::Id>(vtkm::Max(k, 0)), this->GetCoordinates().GetNumberOfValues()));
+
+  // Every query point has the same number of neighbors, so the offsets are known up front.
+  vtkm::Id numNeighbors = points.GetNumberOfValues() * count;
+  vtkm::cont::ArrayCopy(
+    vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, count, points.GetNumberOfValues() + 1), offsets);
+
+  vtkm::cont::Invoker invoke;
+  neighborIds.Allocate(numNeighbors);
+  distances2.Allocate(numNeighbors);
+  invoke(internal::FindKNearestWorklet{},
+         points,
+         *this,
+         vtkm::cont::make_ArrayHandleGroupVecVariable(neighborIds, offsets),
+         vtkm::cont::make_ArrayHandleGroupVecVariable(distances2, offsets));
+}
+
+void PointLocatorSparseGrid::FindWithinRadius(
+  const vtkm::cont::UnknownArrayHandle& queryPoints,
+  vtkm::FloatDefault radius,
+  vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+  vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances2)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "PointLocatorSparseGrid::FindWithinRadius");
+
+  this->Update();
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  vtkm::cont::ArrayCopyShallowIfPossible(queryPoints, points);
+
+  // Count the neighbors, scan the counts into offsets, and then fill in the neighbors.
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> counts;
+  invoke(internal::CountWithinRadiusWorklet{ radius }, points, *this, counts);
+  vtkm::Id numNeighbors;
+  vtkm::cont::ConvertNumComponentsToOffsets(counts, offsets, numNeighbors);
+
+  neighborIds.Allocate(numNeighbors);
+  distances2.Allocate(numNeighbors);
+  invoke(internal::FindWithinRadiusWorklet{ radius },
+         points,
+         *this,
+         vtkm::cont::make_ArrayHandleGroupVecVariable(neighborIds, offsets),
+         vtkm::cont::make_ArrayHandleGroupVecVariable(distances2, offsets));
+}
+
 vtkm::exec::PointLocatorSparseGrid PointLocatorSparseGrid::PrepareForExecution(
   vtkm::cont::DeviceAdapterId device,
   vtkm::cont::Token& token) const
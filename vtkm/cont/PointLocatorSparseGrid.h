@@ -10,6 +10,7 @@
 #ifndef vtk_m_cont_PointLocatorSparseGrid_h
 #define vtk_m_cont_PointLocatorSparseGrid_h
 
+#include <vtkm/cont/UnknownArrayHandle.h>
 #include <vtkm/cont/internal/PointLocatorBase.h>
 #include <vtkm/exec/PointLocatorSparseGrid.h>
 
@@ -71,6 +72,33 @@ public:
 
   const vtkm::Id3& GetNumberOfBins() const { return this->Dims; }
 
+  /// \brief Finds the `k` nearest points to each of a batch of query points.
+  ///
+  /// The results are in compressed sparse row form. The neighbors of query point `i` are at
+  /// indices `offsets[i]` to `offsets[i+1]-1` of `neighborIds`, sorted from nearest to farthest.
+  /// The squared distances to them are in the same place in `distances2`. Every query point
+  /// gets `k` neighbors, or all of the points if there are fewer than `k`.
+  ///
+  VTKM_CONT void FindKNearestNeighbors(const vtkm::cont::UnknownArrayHandle& queryPoints,
+                                       vtkm::IdComponent k,
+                                       vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+                                       vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+                                       vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances2);
+
+  /// \brief Finds all points within `radius` of each of a batch of query points.
+  ///
+  /// The results are in compressed sparse row form. The neighbors of query point `i` are at
+  /// indices `offsets[i]` to `offsets[i+1]-1` of `neighborIds`, in no particular order. The
+  /// squared distances to them are in the same place in `distances2`. The neighbors are
+  /// counted in a first pass so that the output can be allocated exactly, and then found
+  /// again in a second pass to fill it.
+  ///
+  VTKM_CONT void FindWithinRadius(const vtkm::cont::UnknownArrayHandle& queryPoints,
+                                  vtkm::FloatDefault radius,
+                                  vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+                                  vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+                                  vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances2);
+
   VTKM_CONT
   vtkm::exec::PointLocatorSparseGrid PrepareForExecution(vtkm::cont::DeviceAdapterId device,
                                                          vtkm::cont::Token& token) const;
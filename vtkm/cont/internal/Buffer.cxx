@@ -427,6 +427,8 @@ struct VTKM_NEVER_EXPORT BufferHelper
     if (!queue.empty() && queue.front() == token)
     {
       queue.pop_front();
+      // The next token in the queue might be able to share the buffer with us.
+      internals->ConditionVariable.notify_all();
     }
   }
 
@@ -450,6 +452,8 @@ struct VTKM_NEVER_EXPORT BufferHelper
     if (!queue.empty() && queue.front() == token)
     {
       queue.pop_front();
+      // The next token in the queue might be able to share the buffer with us.
+      internals->ConditionVariable.notify_all();
     }
   }
 
@@ -947,6 +951,18 @@ void Buffer::Enqueue(const vtkm::cont::Token& token) const
   detail::BufferHelper::Enqueue(this->Internals, lock, token);
 }
 
+void Buffer::WaitToRead(vtkm::cont::Token& token) const
+{
+  LockType lock = this->Internals->GetLock();
+  detail::BufferHelper::WaitToRead(this->Internals, lock, token);
+}
+
+void Buffer::WaitToWrite(vtkm::cont::Token& token) const
+{
+  LockType lock = this->Internals->GetLock();
+  detail::BufferHelper::WaitToWrite(this->Internals, lock, token);
+}
+
 void Buffer::DeepCopyFrom(const vtkm::cont::internal::Buffer& src) const
 {
   // A Token should not be declared within the scope of a lock. when the token goes out of scope
@@ -252,6 +252,18 @@ public:
   ///
   VTKM_CONT void Enqueue(const vtkm::cont::Token& token) const;
 
+  /// @{
+  /// \brief Wait for access to the buffer and attach the given token to it.
+  ///
+  /// These methods block the same way `ReadPointerDevice` and `WritePointerDevice` do
+  /// (honoring the place in the queue reserved with `Enqueue`), but they do not allocate or
+  /// move any memory. Once they return, the state of the buffer (such as its size) is final
+  /// for as long as `token` is attached, and `token` can then be used to get pointers.
+  ///
+  VTKM_CONT void WaitToRead(vtkm::cont::Token& token) const;
+  VTKM_CONT void WaitToWrite(vtkm::cont::Token& token) const;
+  /// @}
+
   /// @{
   /// \brief Copies the data from the provided buffer into this buffer.
   ///
@@ -36,6 +36,7 @@ class VTKM_ALWAYS_EXPORT CellLocatorBase : public vtkm::cont::ExecutionObjectBas
   vtkm::cont::UnknownCellSet CellSet;
   vtkm::cont::CoordinateSystem Coords;
   mutable bool Modified = true;
+  mutable bool OnlyCoordinatesModified = false;
 
 public:
   const vtkm::cont::UnknownCellSet& GetCellSet() const { return this->CellSet; }
@@ -50,8 +51,10 @@ public:
 
   void SetCoordinates(const vtkm::cont::CoordinateSystem& coords)
   {
+    bool onlyCoordinates = !this->Modified || this->OnlyCoordinatesModified;
     this->Coords = coords;
     this->SetModified();
+    this->OnlyCoordinatesModified = onlyCoordinates;
   }
 
   void Update() const
@@ -60,12 +63,22 @@ public:
     {
       static_cast<Derived*>(const_cast<CellLocatorBase*>(this))->Build();
       this->Modified = false;
+      this->OnlyCoordinatesModified = false;
     }
   }
 
 protected:
-  void SetModified() { this->Modified = true; }
+  void SetModified()
+  {
+    this->Modified = true;
+    this->OnlyCoordinatesModified = false;
+  }
   bool GetModified() const { return this->Modified; }
+
+  /// Returns true if the only change since the last build is a call to `SetCoordinates`.
+  /// Locators can use this to update their search structure for moved points rather than
+  /// building it from scratch. This is always false before the first build.
+  bool GetOnlyCoordinatesModified() const { return this->OnlyCoordinatesModified; }
 };
 
 }
@@ -0,0 +1,272 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#include <vtkm/cont/internal/CellLocatorRefit.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace
+{
+
+// Flags the cells whose list of bins differs between the old and new structure.
+struct FindChangedCells : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn cellId,
+                                WholeArrayIn oldOffsets,
+                                WholeArrayIn oldBins,
+                                WholeArrayIn newOffsets,
+                                WholeArrayIn newBins,
+                                FieldOut changed,
+                                FieldOut numChangedBins);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  template <typename OffsetsPortal, typename BinsPortal>
+  VTKM_EXEC void operator()(vtkm::Id cellId,
+                            const OffsetsPortal& oldOffsets,
+                            const BinsPortal& oldBins,
+                            const OffsetsPortal& newOffsets,
+                            const BinsPortal& newBins,
+                            vtkm::Id& changed,
+                            vtkm::Id& numChangedBins) const
+  {
+    vtkm::Id oldStart = oldOffsets.Get(cellId);
+    vtkm::Id newStart = newOffsets.Get(cellId);
+    vtkm::Id count = newOffsets.Get(cellId + 1) - newStart;
+
+    changed = (count != (oldOffsets.Get(cellId + 1) - oldStart)) ? 1 : 0;
+    for (vtkm::Id i = 0; (changed == 0) && (i < count); ++i)
+    {
+      if (oldBins.Get(oldStart + i) != newBins.Get(newStart + i))
+      {
+        changed = 1;
+      }
+    }
+    numChangedBins = (changed != 0) ? count : 0;
+  }
+};
+
+// Writes the (bin, cell) pairs of the cells that changed bins.
+struct RecordChangedCells : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn cellId,
+                                FieldIn changed,
+                                FieldIn outputOffset,
+                                WholeArrayIn newOffsets,
+                                WholeArrayIn newBins,
+                                WholeArrayOut pairBins,
+                                WholeArrayOut pairCells);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  template <typename OffsetsPortal, typename BinsPortal, typename OutPortal>
+  VTKM_EXEC void operator()(vtkm::Id cellId,
+                            vtkm::Id changed,
+                            vtkm::Id outputOffset,
+                            const OffsetsPortal& newOffsets,
+                            const BinsPortal& newBins,
+                            const OutPortal& pairBins,
+                            const OutPortal& pairCells) const
+  {
+    if (changed == 0)
+    {
+      return;
+    }
+    vtkm::Id start = newOffsets.Get(cellId);
+    vtkm::Id count = newOffsets.Get(cellId + 1) - start;
+    for (vtkm::Id i = 0; i < count; ++i)
+    {
+      pairBins.Set(outputOffset + i, newBins.Get(start + i));
+      pairCells.Set(outputOffset + i, cellId);
+    }
+  }
+};
+
+// For each bin, counts the old cells that stay plus the cells that moved in.
+struct CountMergedBin : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn binStart,
+                                FieldIn binCount,
+                                FieldIn addedBegin,
+                                FieldIn addedEnd,
+                                WholeArrayIn binCellIds,
+                                WholeArrayIn changed,
+                                FieldOut newCount);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  template <typename CellIdsPortal, typename ChangedPortal>
+  VTKM_EXEC void operator()(vtkm::Id binStart,
+                            vtkm::Id binCount,
+                            vtkm::Id addedBegin,
+                            vtkm::Id addedEnd,
+                            const CellIdsPortal& binCellIds,
+                            const ChangedPortal& changed,
+                            vtkm::Id& newCount) const
+  {
+    newCount = addedEnd - addedBegin;
+    for (vtkm::Id i = binStart; i < binStart + binCount; ++i)
+    {
+      if (changed.Get(binCellIds.Get(i)) == 0)
+      {
+        ++newCount;
+      }
+    }
+  }
+};
+
+struct FillMergedBin : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn binStart,
+                                FieldIn binCount,
+                                FieldIn addedBegin,
+                                FieldIn addedEnd,
+                                FieldIn newStart,
+                                WholeArrayIn binCellIds,
+                                WholeArrayIn changed,
+                                WholeArrayIn addedCells,
+                                WholeArrayOut newBinCellIds);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9);
+
+  template <typename CellIdsPortal, typename ChangedPortal, typename OutPortal>
+  VTKM_EXEC void operator()(vtkm::Id binStart,
+                            vtkm::Id binCount,
+                            vtkm::Id addedBegin,
+                            vtkm::Id addedEnd,
+                            vtkm::Id newStart,
+                            const CellIdsPortal& binCellIds,
+                            const ChangedPortal& changed,
+                            const CellIdsPortal& addedCells,
+                            const OutPortal& newBinCellIds) const
+  {
+    vtkm::Id out = newStart;
+    for (vtkm::Id i = binStart; i < binStart + binCount; ++i)
+    {
+      vtkm::Id cellId = binCellIds.Get(i);
+      if (changed.Get(cellId) == 0)
+      {
+        newBinCellIds.Set(out++, cellId);
+      }
+    }
+    for (vtkm::Id i = addedBegin; i < addedEnd; ++i)
+    {
+      newBinCellIds.Set(out++, addedCells.Get(i));
+    }
+  }
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+bool RefitCellBins(const vtkm::cont::ArrayHandle<vtkm::Id>& cellBinOffsets,
+                   const vtkm::cont::ArrayHandle<vtkm::Id>& cellBins,
+                   const vtkm::cont::ArrayHandle<vtkm::Id>& newCellBinOffsets,
+                   const vtkm::cont::ArrayHandle<vtkm::Id>& newCellBins,
+                   vtkm::Id maxChangedCells,
+                   vtkm::cont::ArrayHandle<vtkm::Id>& binStarts,
+                   vtkm::cont::ArrayHandle<vtkm::Id>& binCounts,
+                   vtkm::cont::ArrayHandle<vtkm::Id>& binCellIds)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "RefitCellBins");
+
+  vtkm::Id numberOfCells = newCellBinOffsets.GetNumberOfValues() - 1;
+  VTKM_ASSERT(cellBinOffsets.GetNumberOfValues() == numberOfCells + 1);
+  vtkm::cont::Invoker invoke;
+
+  // 1: Find the cells that no longer overlap the same bins.
+  vtkm::cont::ArrayHandle<vtkm::Id> changed;
+  vtkm::cont::ArrayHandle<vtkm::Id> changedOffsets;
+  invoke(FindChangedCells{},
+         vtkm::cont::ArrayHandleIndex(numberOfCells),
+         cellBinOffsets,
+         cellBins,
+         newCellBinOffsets,
+         newCellBins,
+         changed,
+         changedOffsets);
+  vtkm::Id numberOfChangedCells = vtkm::cont::Algorithm::Reduce(changed, vtkm::Id(0));
+  if (numberOfChangedCells > maxChangedCells)
+  {
+    return false;
+  }
+  if (numberOfChangedCells == 0)
+  {
+    return true;
+  }
+
+  // 2: Collect the (bin, cell) pairs of the changed cells. Only these get sorted.
+  vtkm::Id numberOfPairs = vtkm::cont::Algorithm::ScanExclusive(changedOffsets, changedOffsets);
+  vtkm::cont::ArrayHandle<vtkm::Id> addedBins;
+  vtkm::cont::ArrayHandle<vtkm::Id> addedCells;
+  addedBins.Allocate(numberOfPairs);
+  addedCells.Allocate(numberOfPairs);
+  invoke(RecordChangedCells{},
+         vtkm::cont::ArrayHandleIndex(numberOfCells),
+         changed,
+         changedOffsets,
+         newCellBinOffsets,
+         newCellBins,
+         addedBins,
+         addedCells);
+  changedOffsets.ReleaseResources();
+  vtkm::cont::Algorithm::SortByKey(addedBins, addedCells);
+
+  // 3: Find the range of added cells for each bin.
+  vtkm::Id numberOfBins = binStarts.GetNumberOfValues();
+  vtkm::cont::ArrayHandle<vtkm::Id> addedBegin;
+  vtkm::cont::ArrayHandle<vtkm::Id> addedEnd;
+  vtkm::cont::Algorithm::LowerBounds(
+    addedBins, vtkm::cont::ArrayHandleIndex(numberOfBins), addedBegin);
+  vtkm::cont::Algorithm::UpperBounds(
+    addedBins, vtkm::cont::ArrayHandleIndex(numberOfBins), addedEnd);
+  addedBins.ReleaseResources();
+
+  // 4: Merge the old cells that stay in each bin with the cells that moved in.
+  vtkm::cont::ArrayHandle<vtkm::Id> newCounts;
+  invoke(CountMergedBin{},
+         binStarts,
+         binCounts,
+         addedBegin,
+         addedEnd,
+         binCellIds,
+         changed,
+         newCounts);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> newStarts;
+  vtkm::Id numberOfEntries = vtkm::cont::Algorithm::ScanExclusive(newCounts, newStarts);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> newBinCellIds;
+  newBinCellIds.Allocate(numberOfEntries);
+  invoke(FillMergedBin{},
+         binStarts,
+         binCounts,
+         addedBegin,
+         addedEnd,
+         newStarts,
+         binCellIds,
+         changed,
+         addedCells,
+         newBinCellIds);
+
+  binStarts = newStarts;
+  binCounts = newCounts;
+  binCellIds = newBinCellIds;
+  return true;
+}
+
+}
+}
+} // namespace vtkm::cont::internal
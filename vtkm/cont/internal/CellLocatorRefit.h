@@ -0,0 +1,53 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_internal_CellLocatorRefit_h
+#define vtk_m_cont_internal_CellLocatorRefit_h
+
+#include <vtkm/cont/ArrayHandle.h>
+
+#include <vtkm/cont/vtkm_cont_export.h>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief Updates the bins of a binned cell locator after its points have moved.
+///
+/// `cellBinOffsets` and `cellBins` hold the flat ids of the bins overlapped by each cell
+/// (grouped by cell, with `cellBinOffsets` having one more entry than there are cells) as
+/// computed for the current search structure. `newCellBinOffsets` and `newCellBins` hold the
+/// same information for the moved points. The bins must be listed in the same order for
+/// both.
+///
+/// `binStarts`, `binCounts`, and `binCellIds` hold the cells in each bin and are replaced
+/// with the updated structure. Only the (bin, cell) pairs of the cells whose list of bins
+/// changed are sorted. The entries of all other cells are copied over in a single pass, so
+/// no global sort is required.
+///
+/// If more than `maxChangedCells` cells changed bins, nothing is modified and `false` is
+/// returned so that the caller can build the search structure from scratch.
+///
+VTKM_CONT_EXPORT bool RefitCellBins(const vtkm::cont::ArrayHandle<vtkm::Id>& cellBinOffsets,
+                                    const vtkm::cont::ArrayHandle<vtkm::Id>& cellBins,
+                                    const vtkm::cont::ArrayHandle<vtkm::Id>& newCellBinOffsets,
+                                    const vtkm::cont::ArrayHandle<vtkm::Id>& newCellBins,
+                                    vtkm::Id maxChangedCells,
+                                    vtkm::cont::ArrayHandle<vtkm::Id>& binStarts,
+                                    vtkm::cont::ArrayHandle<vtkm::Id>& binCounts,
+                                    vtkm::cont::ArrayHandle<vtkm::Id>& binCellIds);
+
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_CellLocatorRefit_h
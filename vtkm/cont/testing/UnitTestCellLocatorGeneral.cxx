@@ -222,6 +222,46 @@ void TestLastCell(vtkm::cont::CellLocatorGeneral& locator,
   }
 }
 
+void TestFindCells(vtkm::cont::CellLocatorGeneral& locator,
+                   const vtkm::cont::DataSet& dataset,
+                   const vtkm::cont::ArrayHandle<PointType>& points,
+                   const vtkm::cont::ArrayHandle<vtkm::Id>& expCellIds,
+                   const vtkm::cont::ArrayHandle<PointType>& expPCoords)
+{
+  // Add a point outside of the mesh to the end of the batch.
+  vtkm::Id numPoints = points.GetNumberOfValues();
+  vtkm::cont::ArrayHandle<PointType> batch;
+  batch.Allocate(numPoints + 1);
+  {
+    auto inPortal = points.ReadPortal();
+    auto batchPortal = batch.WritePortal();
+    for (vtkm::Id i = 0; i < numPoints; ++i)
+    {
+      batchPortal.Set(i, inPortal.Get(i));
+    }
+    vtkm::Bounds bounds = dataset.GetCoordinateSystem().GetBounds();
+    batchPortal.Set(numPoints, PointType(bounds.MaxCorner()) + PointType(1.0f));
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+  vtkm::cont::ArrayHandle<PointType> pcoords;
+  locator.FindCells(batch, cellIds, pcoords);
+  VTKM_TEST_ASSERT(cellIds.GetNumberOfValues() == numPoints + 1);
+  VTKM_TEST_ASSERT(pcoords.GetNumberOfValues() == numPoints + 1);
+
+  auto cellIdPortal = cellIds.ReadPortal();
+  auto expCellIdsPortal = expCellIds.ReadPortal();
+  auto pcoordsPortal = pcoords.ReadPortal();
+  auto expPCoordsPortal = expPCoords.ReadPortal();
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    VTKM_TEST_ASSERT(cellIdPortal.Get(i) == expCellIdsPortal.Get(i), "Incorrect cell ids");
+    VTKM_TEST_ASSERT(test_equal(pcoordsPortal.Get(i), expPCoordsPortal.Get(i), 1e-3),
+                     "Incorrect parameteric coordinates");
+  }
+  VTKM_TEST_ASSERT(cellIdPortal.Get(numPoints) == -1, "Point outside of mesh was found");
+}
+
 void TestWithDataSet(vtkm::cont::CellLocatorGeneral& locator, const vtkm::cont::DataSet& dataset)
 {
   locator.SetCellSet(dataset.GetCellSet());
@@ -268,6 +308,9 @@ void TestWithDataSet(vtkm::cont::CellLocatorGeneral& locator, const vtkm::cont::
 
   //Call it again using the lastCell just computed to validate.
   TestLastCell(locator, 64, lastCell2, points, expCellIds, pcoords);
+
+  //Test the batched query.
+  TestFindCells(locator, dataset, points, expCellIds, expPCoords);
 }
 
 void TestCellLocatorGeneral()
@@ -279,6 +322,10 @@ void TestCellLocatorGeneral()
   TestWithDataSet(locator, MakeTestDataSetRectilinear());
 
   TestWithDataSet(locator, MakeTestDataSetCurvilinear());
+
+  locator.SetUnstructuredLocatorType(
+    vtkm::cont::CellLocatorGeneral::UnstructuredLocatorType::BoundingVolumeHierarchy);
+  TestWithDataSet(locator, MakeTestDataSetCurvilinear());
 }
 
 } // anonymous namespace
@@ -9,6 +9,7 @@
 //============================================================================
 
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/CellLocatorBoundingVolumeHierarchy.h>
 #include <vtkm/cont/CellLocatorTwoLevel.h>
 #include <vtkm/cont/CellLocatorUniformBins.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
@@ -234,26 +235,18 @@ void TestLastCell(LocatorType& locator,
 }
 
 template <typename LocatorType, vtkm::IdComponent DIMENSIONS>
-void TestCellLocator(LocatorType& locator,
-                     const vtkm::Vec<vtkm::Id, DIMENSIONS>& dim,
-                     vtkm::Id numberOfPoints)
+void TestFindCell(LocatorType& locator,
+                  const vtkm::cont::DataSet& ds,
+                  vtkm::Id numberOfPoints,
+                  vtkm::cont::ArrayHandle<vtkm::Id>& expCellIds,
+                  vtkm::cont::ArrayHandle<PointType>& expPCoords,
+                  vtkm::cont::ArrayHandle<PointType>& points,
+                  vtkm::cont::ArrayHandle<PointType>& pcoords)
 {
-  auto ds = MakeTestDataSet(dim);
-
-  std::cout << "Testing " << DIMENSIONS << "D dataset with " << ds.GetNumberOfCells() << " cells\n";
-
-  locator.SetCellSet(ds.GetCellSet());
-  locator.SetCoordinates(ds.GetCoordinateSystem());
-  locator.Update();
-
-  vtkm::cont::ArrayHandle<vtkm::Id> expCellIds;
-  vtkm::cont::ArrayHandle<PointType> expPCoords;
-  vtkm::cont::ArrayHandle<PointType> points;
   GenerateRandomInput<DIMENSIONS>(ds, numberOfPoints, expCellIds, expPCoords, points);
 
   std::cout << "Finding cells for " << numberOfPoints << " points\n";
   vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
-  vtkm::cont::ArrayHandle<PointType> pcoords;
 
   vtkm::cont::Invoker invoker;
   invoker(FindCellWorklet{}, points, locator, cellIds, pcoords);
@@ -268,6 +261,27 @@ void TestCellLocator(LocatorType& locator,
     VTKM_TEST_ASSERT(test_equal(pcoordsPortal.Get(i), expPCoordsPortal.Get(i), 1e-3),
                      "Incorrect parameteric coordinates");
   }
+}
+
+template <typename LocatorType, vtkm::IdComponent DIMENSIONS>
+void TestCellLocator(LocatorType& locator,
+                     const vtkm::Vec<vtkm::Id, DIMENSIONS>& dim,
+                     vtkm::Id numberOfPoints)
+{
+  auto ds = MakeTestDataSet(dim);
+
+  std::cout << "Testing " << DIMENSIONS << "D dataset with " << ds.GetNumberOfCells() << " cells\n";
+
+  locator.SetCellSet(ds.GetCellSet());
+  locator.SetCoordinates(ds.GetCoordinateSystem());
+  locator.Update();
+
+  vtkm::cont::ArrayHandle<vtkm::Id> expCellIds;
+  vtkm::cont::ArrayHandle<PointType> expPCoords;
+  vtkm::cont::ArrayHandle<PointType> points;
+  vtkm::cont::ArrayHandle<PointType> pcoords;
+  TestFindCell<LocatorType, DIMENSIONS>(
+    locator, ds, numberOfPoints, expCellIds, expPCoords, points, pcoords);
 
   //Test locator using lastCell
 
@@ -288,6 +302,78 @@ void TestCellLocator(LocatorType& locator,
   TestLastCell(locator, numberOfPoints, lastCell2, points, expCellIds, pcoords);
 }
 
+template <typename LocatorType, vtkm::IdComponent DIMENSIONS>
+void TestRefitCase(LocatorType& locator,
+                   vtkm::cont::DataSet& ds,
+                   const vtkm::cont::CoordinateSystem& original,
+                   vtkm::FloatDefault threshold,
+                   vtkm::FloatDefault scale,
+                   bool expectRefit,
+                   vtkm::Id numberOfPoints)
+{
+  std::cout << "Moving points by " << scale << " with refit threshold " << threshold << "\n";
+
+  locator.SetRefitThreshold(threshold);
+  ds.AddCoordinateSystem(original);
+  locator.SetCoordinates(ds.GetCoordinateSystem());
+  locator.Update();
+  VTKM_TEST_ASSERT(!locator.GetLastBuildWasRefit(), "Initial build cannot be a refit");
+
+  // Scale the mesh about its center. The topology stays the same.
+  vtkm::cont::ArrayHandle<PointType> points;
+  vtkm::cont::ArrayCopyShallowIfPossible(original.GetData(), points);
+  PointType center = original.GetBounds().Center();
+  vtkm::cont::ArrayHandle<PointType> movedPoints;
+  movedPoints.Allocate(points.GetNumberOfValues());
+  {
+    auto inPortal = points.ReadPortal();
+    auto outPortal = movedPoints.WritePortal();
+    for (vtkm::Id i = 0; i < inPortal.GetNumberOfValues(); ++i)
+    {
+      outPortal.Set(i, center + scale * (inPortal.Get(i) - center));
+    }
+  }
+  ds.AddCoordinateSystem(vtkm::cont::CoordinateSystem(original.GetName(), movedPoints));
+  locator.SetCoordinates(ds.GetCoordinateSystem());
+  locator.Update();
+  VTKM_TEST_ASSERT(locator.GetLastBuildWasRefit() == expectRefit,
+                   expectRefit ? "Locator was rebuilt instead of refit"
+                               : "Locator was refit instead of rebuilt");
+
+  vtkm::cont::ArrayHandle<vtkm::Id> expCellIds;
+  vtkm::cont::ArrayHandle<PointType> expPCoords;
+  vtkm::cont::ArrayHandle<PointType> queryPoints;
+  vtkm::cont::ArrayHandle<PointType> pcoords;
+  TestFindCell<LocatorType, DIMENSIONS>(
+    locator, ds, numberOfPoints, expCellIds, expPCoords, queryPoints, pcoords);
+}
+
+template <typename LocatorType, vtkm::IdComponent DIMENSIONS>
+void TestCellLocatorRefit(LocatorType& locator,
+                          const vtkm::Vec<vtkm::Id, DIMENSIONS>& dim,
+                          vtkm::Id numberOfPoints)
+{
+  auto ds = MakeTestDataSet(dim);
+  vtkm::cont::CoordinateSystem original = ds.GetCoordinateSystem();
+
+  std::cout << "Testing refit of " << DIMENSIONS << "D dataset with " << ds.GetNumberOfCells()
+            << " cells\n";
+  locator.SetCellSet(ds.GetCellSet());
+
+  // Shrinking the mesh keeps the points within the original bounds, but moves many cells
+  // to different bins.
+  TestRefitCase<LocatorType, DIMENSIONS>(locator, ds, original, 1.0f, 0.8f, true, numberOfPoints);
+
+  // Too many cells change bins for the threshold, so the locator has to be rebuilt.
+  TestRefitCase<LocatorType, DIMENSIONS>(
+    locator, ds, original, 1e-6f, 0.8f, false, numberOfPoints);
+
+  // Growing the mesh moves points outside of the grid, so the locator has to be rebuilt.
+  TestRefitCase<LocatorType, DIMENSIONS>(locator, ds, original, 1.0f, 1.2f, false, numberOfPoints);
+
+  locator.SetRefitThreshold(0.0f);
+}
+
 void TestingCellLocatorUnstructured()
 {
   vtkm::UInt32 seed = static_cast<vtkm::UInt32>(std::time(nullptr));
@@ -301,16 +387,28 @@ void TestingCellLocatorUnstructured()
 
   TestCellLocator(locator2L, vtkm::Id3(8), 512);  // 3D dataset
   TestCellLocator(locator2L, vtkm::Id2(18), 512); // 2D dataset
+  TestCellLocatorRefit(locator2L, vtkm::Id3(8), 512);
+  TestCellLocatorRefit(locator2L, vtkm::Id2(18), 512);
 
   //Test vtkm::cont::CellLocatorUniformBins
   vtkm::cont::CellLocatorUniformBins locatorUB;
   locatorUB.SetDims({ 32, 32, 32 });
   TestCellLocator(locatorUB, vtkm::Id3(8), 512);  // 3D dataset
   TestCellLocator(locatorUB, vtkm::Id2(18), 512); // 2D dataset
+  TestCellLocatorRefit(locatorUB, vtkm::Id3(8), 512);
+  TestCellLocatorRefit(locatorUB, vtkm::Id2(18), 512);
 
   //Test 2D dataset with 2D bins.
   locatorUB.SetDims({ 32, 32, 1 });
   TestCellLocator(locatorUB, vtkm::Id2(18), 512); // 2D dataset
+
+  //Test vtkm::cont::CellLocatorBoundingVolumeHierarchy
+  vtkm::cont::CellLocatorBoundingVolumeHierarchy locatorBVH;
+  TestCellLocator(locatorBVH, vtkm::Id3(8), 512);        // 3D dataset
+  TestCellLocator(locatorBVH, vtkm::Id2(18), 512);       // 2D dataset
+  TestCellLocator(locatorBVH, vtkm::Id3(64, 4, 3), 512); // Long and thin dataset
+  locatorBVH.SetMaxLeafSize(1);
+  TestCellLocator(locatorBVH, vtkm::Id3(8), 512); // 3D dataset with a deep tree
 }
 
 
@@ -0,0 +1,182 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/CellValueRangeIndex.h>
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/testing/MakeTestDataSet.h>
+#include <vtkm/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace
+{
+
+// Computes the range of the field over each cell on the host.
+std::vector<vtkm::Range> CellRanges(const vtkm::cont::DataSet& dataSet, const std::string& name)
+{
+  const vtkm::cont::Field& field = dataSet.GetField(name);
+  vtkm::cont::ArrayHandle<vtkm::Float64> values;
+  vtkm::cont::ArrayCopy(field.GetData(), values);
+  auto valuesPortal = values.ReadPortal();
+
+  const vtkm::cont::UnknownCellSet& cellSet = dataSet.GetCellSet();
+  std::vector<vtkm::Range> ranges(static_cast<std::size_t>(cellSet.GetNumberOfCells()));
+  for (vtkm::Id cellId = 0; cellId < cellSet.GetNumberOfCells(); ++cellId)
+  {
+    vtkm::Range& range = ranges[static_cast<std::size_t>(cellId)];
+    if (field.IsPointField())
+    {
+      std::vector<vtkm::Id> pointIds(
+        static_cast<std::size_t>(cellSet.GetNumberOfPointsInCell(cellId)));
+      cellSet.GetCellPointIds(cellId, pointIds.data());
+      for (vtkm::Id pointId : pointIds)
+      {
+        range.Include(valuesPortal.Get(pointId));
+      }
+    }
+    else
+    {
+      range.Include(valuesPortal.Get(cellId));
+    }
+  }
+  return ranges;
+}
+
+void CheckCandidates(const vtkm::cont::ArrayHandle<vtkm::Id>& candidates,
+                     const std::vector<bool>& expected)
+{
+  std::vector<bool> found(expected.size(), false);
+  auto portal = candidates.ReadPortal();
+  for (vtkm::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+  {
+    vtkm::Id cellId = portal.Get(i);
+    VTKM_TEST_ASSERT((cellId >= 0) && (cellId < static_cast<vtkm::Id>(expected.size())),
+                     "Candidate cell out of range");
+    VTKM_TEST_ASSERT((i == 0) || (portal.Get(i - 1) < cellId), "Candidates not increasing");
+    found[static_cast<std::size_t>(cellId)] = true;
+  }
+  for (std::size_t cellId = 0; cellId < expected.size(); ++cellId)
+  {
+    VTKM_TEST_ASSERT(!expected[cellId] || found[cellId], "Missing candidate cell ", cellId);
+  }
+}
+
+void TestIndex(const vtkm::cont::DataSet& dataSet,
+               const std::string& fieldName,
+               vtkm::IdComponent blockSize,
+               bool expectPruning)
+{
+  std::cout << "  field " << fieldName << ", block size " << blockSize << std::endl;
+
+  vtkm::cont::CellValueRangeIndex index;
+  index.SetCellSet(dataSet.GetCellSet());
+  index.SetField(dataSet.GetField(fieldName));
+  index.SetBlockSize(blockSize);
+  index.Update();
+  VTKM_TEST_ASSERT(index.GetNumberOfBlocks() > 0);
+  VTKM_TEST_ASSERT(!index.GetModified());
+
+  std::vector<vtkm::Range> cellRanges = CellRanges(dataSet, fieldName);
+  vtkm::Range fieldRange;
+  for (const vtkm::Range& range : cellRanges)
+  {
+    fieldRange.Include(range);
+  }
+
+  vtkm::Id numCells = dataSet.GetNumberOfCells();
+  vtkm::Id totalCandidates = 0;
+  for (vtkm::Float64 fraction : { 0.0, 0.1, 0.45, 0.8, 1.0 })
+  {
+    vtkm::Float64 value = fieldRange.Min + fraction * fieldRange.Length();
+    vtkm::Range query(value, value + 0.01 * fieldRange.Length());
+
+    std::vector<bool> expected(cellRanges.size());
+    for (std::size_t cellId = 0; cellId < cellRanges.size(); ++cellId)
+    {
+      expected[cellId] = (cellRanges[cellId].Min <= query.Max) &&
+        (cellRanges[cellId].Max >= query.Min);
+    }
+    vtkm::cont::ArrayHandle<vtkm::Id> candidates = index.FindCandidateCells(query);
+    CheckCandidates(candidates, expected);
+    totalCandidates += candidates.GetNumberOfValues();
+  }
+  if (expectPruning)
+  {
+    VTKM_TEST_ASSERT(totalCandidates < 5 * numCells, "Index did not remove any cells");
+  }
+
+  // Search for several values at once.
+  std::vector<vtkm::Float64> values = { fieldRange.Min + 0.7 * fieldRange.Length(),
+                                        fieldRange.Min + 0.2 * fieldRange.Length(),
+                                        fieldRange.Max + 1.0 };
+  std::vector<bool> expected(cellRanges.size());
+  for (std::size_t cellId = 0; cellId < cellRanges.size(); ++cellId)
+  {
+    for (vtkm::Float64 value : values)
+    {
+      expected[cellId] = expected[cellId] || cellRanges[cellId].Contains(value);
+    }
+  }
+  CheckCandidates(index.FindCandidateCells(values), expected);
+
+  // Nothing is outside of the range of the field.
+  VTKM_TEST_ASSERT(
+    index.FindCandidateCells(vtkm::Range(fieldRange.Max + 1, fieldRange.Max + 2))
+      .GetNumberOfValues() == 0);
+}
+
+vtkm::cont::DataSet MakeWaveDataSet(const vtkm::Id3& dims)
+{
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  std::vector<vtkm::Float32> values;
+  for (vtkm::Id k = 0; k < dims[2]; ++k)
+  {
+    for (vtkm::Id j = 0; j < dims[1]; ++j)
+    {
+      for (vtkm::Id i = 0; i < dims[0]; ++i)
+      {
+        values.push_back(static_cast<vtkm::Float32>(i * i + j * j + k * k));
+      }
+    }
+  }
+  dataSet.AddPointField("wave", values);
+  return dataSet;
+}
+
+void TestCellValueRangeIndex()
+{
+  std::cout << "Structured 3D" << std::endl;
+  vtkm::cont::DataSet wave3D = MakeWaveDataSet({ 21, 17, 13 });
+  TestIndex(wave3D, "wave", 64, true);
+  TestIndex(wave3D, "wave", 8, true);
+  TestIndex(wave3D, "wave", 1, true);
+
+  std::cout << "Structured 2D" << std::endl;
+  vtkm::cont::DataSet wave2D = MakeWaveDataSet({ 40, 33, 1 });
+  TestIndex(wave2D, "wave", 64, true);
+
+  vtkm::cont::testing::MakeTestDataSet maker;
+  std::cout << "Uniform cell field" << std::endl;
+  TestIndex(maker.Make3DUniformDataSet3({ 20, 15, 10 }), "cellvar", 27, false);
+  TestIndex(maker.Make3DUniformDataSet3({ 20, 15, 10 }), "pointvar", 27, false);
+
+  std::cout << "Explicit" << std::endl;
+  TestIndex(maker.Make3DExplicitDataSetZoo(), "pointvar", 4, false);
+  TestIndex(maker.Make3DExplicitDataSetZoo(), "cellvar", 4, false);
+}
+
+} // anonymous namespace
+
+int UnitTestCellValueRangeIndex(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(TestCellValueRangeIndex, argc, argv);
+}
@@ -16,6 +16,7 @@
 
 #include <vtkm/worklet/WorkletMapField.h>
 
+#include <algorithm>
 #include <random>
 
 namespace
@@ -181,9 +182,110 @@ void TestTest()
   VTKM_TEST_ASSERT(passTest, "Uniform Grid NN search result incorrect.");
 }
 
+void TestNeighborQueries()
+{
+  std::default_random_engine dre;
+  std::uniform_real_distribution<vtkm::FloatDefault> dr(0.0f, 10.0f);
+
+  std::vector<vtkm::Vec3f> coordi;
+  for (vtkm::Int32 i = 0; i < 500; i++)
+  {
+    coordi.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  auto coordi_Handle = vtkm::cont::make_ArrayHandle(coordi, vtkm::CopyFlag::Off);
+
+  vtkm::cont::PointLocatorSparseGrid locator;
+  locator.SetCoordinates(vtkm::cont::CoordinateSystem("points", coordi_Handle));
+  locator.SetNumberOfBins({ 8, 8, 8 });
+
+  // Include query points outside of the range of the points.
+  std::vector<vtkm::Vec3f> qcVec;
+  for (vtkm::Int32 i = 0; i < 50; i++)
+  {
+    qcVec.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  qcVec.push_back(vtkm::make_Vec(-3.0f, 5.0f, 5.0f));
+  qcVec.push_back(vtkm::make_Vec(12.0f, 12.0f, 12.0f));
+  auto qc_Handle = vtkm::cont::make_ArrayHandle(qcVec, vtkm::CopyFlag::Off);
+
+  // Brute force squared distances from each query point, sorted.
+  auto bruteForce = [&](const vtkm::Vec3f& qc) {
+    std::vector<vtkm::FloatDefault> distances2;
+    for (const auto& p : coordi)
+    {
+      distances2.push_back(vtkm::MagnitudeSquared(p - qc));
+    }
+    std::sort(distances2.begin(), distances2.end());
+    return distances2;
+  };
+
+  std::cout << "Testing k nearest neighbors" << std::endl;
+  const vtkm::IdComponent k = 20;
+  vtkm::cont::ArrayHandle<vtkm::Id> offsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> neighborIds;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> distances2;
+  locator.FindKNearestNeighbors(qc_Handle, k, offsets, neighborIds, distances2);
+  VTKM_TEST_ASSERT(offsets.GetNumberOfValues() == static_cast<vtkm::Id>(qcVec.size()) + 1);
+  VTKM_TEST_ASSERT(neighborIds.GetNumberOfValues() == static_cast<vtkm::Id>(qcVec.size()) * k);
+  {
+    auto offsetPortal = offsets.ReadPortal();
+    auto idPortal = neighborIds.ReadPortal();
+    auto distancePortal = distances2.ReadPortal();
+    for (std::size_t q = 0; q < qcVec.size(); ++q)
+    {
+      std::vector<vtkm::FloatDefault> expected = bruteForce(qcVec[q]);
+      vtkm::Id offset = offsetPortal.Get(static_cast<vtkm::Id>(q));
+      for (vtkm::IdComponent i = 0; i < k; ++i)
+      {
+        vtkm::Id id = idPortal.Get(offset + i);
+        vtkm::FloatDefault distance2 = distancePortal.Get(offset + i);
+        VTKM_TEST_ASSERT(test_equal(distance2, expected[static_cast<std::size_t>(i)]),
+                         "Wrong k nearest neighbor distance");
+        vtkm::Vec3f neighbor = coordi[static_cast<std::size_t>(id)];
+        VTKM_TEST_ASSERT(test_equal(distance2, vtkm::MagnitudeSquared(neighbor - qcVec[q])),
+                         "Neighbor id does not match distance");
+      }
+    }
+  }
+
+  std::cout << "Testing radius search" << std::endl;
+  const vtkm::FloatDefault radius = 1.5f;
+  locator.FindWithinRadius(qc_Handle, radius, offsets, neighborIds, distances2);
+  VTKM_TEST_ASSERT(offsets.GetNumberOfValues() == static_cast<vtkm::Id>(qcVec.size()) + 1);
+  {
+    auto offsetPortal = offsets.ReadPortal();
+    auto idPortal = neighborIds.ReadPortal();
+    auto distancePortal = distances2.ReadPortal();
+    for (std::size_t q = 0; q < qcVec.size(); ++q)
+    {
+      std::vector<vtkm::FloatDefault> expected = bruteForce(qcVec[q]);
+      auto numExpected =
+        std::upper_bound(expected.begin(), expected.end(), radius * radius) - expected.begin();
+      vtkm::Id begin = offsetPortal.Get(static_cast<vtkm::Id>(q));
+      vtkm::Id end = offsetPortal.Get(static_cast<vtkm::Id>(q + 1));
+      VTKM_TEST_ASSERT(end - begin == numExpected, "Wrong number of points within radius");
+      for (vtkm::Id i = begin; i < end; ++i)
+      {
+        vtkm::Id id = idPortal.Get(i);
+        VTKM_TEST_ASSERT(distancePortal.Get(i) <= radius * radius, "Point outside of radius");
+        VTKM_TEST_ASSERT(test_equal(distancePortal.Get(i),
+                                    vtkm::MagnitudeSquared(coordi[static_cast<std::size_t>(id)] -
+                                                           qcVec[q])),
+                         "Neighbor id does not match distance");
+      }
+    }
+  }
+}
+
+void TestPointLocatorSparseGrid()
+{
+  TestTest();
+  TestNeighborQueries();
+}
+
 } // anonymous namespace
 
 int UnitTestPointLocatorSparseGrid(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(TestTest, argc, argv);
+  return vtkm::cont::testing::Testing::Run(TestPointLocatorSparseGrid, argc, argv);
 }
@@ -0,0 +1,260 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_exec_CellLocatorBoundingVolumeHierarchy_h
+#define vtk_m_exec_CellLocatorBoundingVolumeHierarchy_h
+
+#include <vtkm/exec/CellInside.h>
+#include <vtkm/exec/ParametricCoordinates.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CoordinateSystem.h>
+
+#include <vtkm/Math.h>
+#include <vtkm/TopologyElementTag.h>
+#include <vtkm/Types.h>
+#include <vtkm/VecFromPortalPermute.h>
+
+namespace vtkm
+{
+namespace exec
+{
+
+/// \brief A node of the 4-wide bounding volume hierarchy used by
+/// `CellLocatorBoundingVolumeHierarchy`.
+///
+/// The bounding boxes of the 4 children are stored as a structure of arrays so that a point
+/// can be tested against all of them with the same sequence of operations. A child that is
+/// not negative is the index of another node. A child of -1 is an empty slot. Any other
+/// negative child `c` is the leaf with index `-c - 2`.
+///
+struct CellLocatorBoundingVolumeHierarchyNode
+{
+  static constexpr vtkm::IdComponent Width = 4;
+
+  /// The maximum number of nodes on the traversal stack. The builder limits the depth of the
+  /// hierarchy so that this is never exceeded.
+  static constexpr vtkm::IdComponent StackSize = 64;
+
+  using BoundsVec = vtkm::Vec<vtkm::FloatDefault, Width>;
+
+  BoundsVec MinX;
+  BoundsVec MinY;
+  BoundsVec MinZ;
+  BoundsVec MaxX;
+  BoundsVec MaxY;
+  BoundsVec MaxZ;
+  vtkm::Vec<vtkm::Id, Width> Child;
+};
+
+template <typename CellStructureType>
+class VTKM_ALWAYS_EXPORT CellLocatorBoundingVolumeHierarchy
+{
+private:
+  using NodeType = vtkm::exec::CellLocatorBoundingVolumeHierarchyNode;
+  static constexpr vtkm::IdComponent Width = NodeType::Width;
+
+  template <typename T>
+  using ReadPortal = typename vtkm::cont::ArrayHandle<T>::ReadPortalType;
+
+  using CoordsPortalType =
+    typename vtkm::cont::CoordinateSystem::MultiplexerArrayType::ReadPortalType;
+
+public:
+  template <typename CellSetType>
+  VTKM_CONT CellLocatorBoundingVolumeHierarchy(
+    const vtkm::cont::ArrayHandle<NodeType>& nodes,
+    const vtkm::cont::ArrayHandle<vtkm::Id2>& leaves,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+    const CellSetType& cellSet,
+    const vtkm::cont::CoordinateSystem& coords,
+    vtkm::cont::DeviceAdapterId device,
+    vtkm::cont::Token& token)
+    : Nodes(nodes.PrepareForInput(device, token))
+    , Leaves(leaves.PrepareForInput(device, token))
+    , CellIds(cellIds.PrepareForInput(device, token))
+    , CellSet(cellSet.PrepareForInput(device,
+                                      vtkm::TopologyElementTagCell{},
+                                      vtkm::TopologyElementTagPoint{},
+                                      token))
+    , Coords(coords.GetDataAsMultiplexer().PrepareForInput(device, token))
+  {
+  }
+
+  struct LastCell
+  {
+    vtkm::Id CellId = -1;
+    vtkm::Id LeafIdx = -1;
+  };
+
+  VTKM_EXEC
+  vtkm::ErrorCode FindCell(const vtkm::Vec3f& point,
+                           vtkm::Id& cellId,
+                           vtkm::Vec3f& parametric) const
+  {
+    LastCell lastCell;
+    return this->FindCellImpl(point, cellId, parametric, lastCell);
+  }
+
+  VTKM_EXEC
+  vtkm::ErrorCode FindCell(const vtkm::Vec3f& point,
+                           vtkm::Id& cellId,
+                           vtkm::Vec3f& parametric,
+                           LastCell& lastCell) const
+  {
+    vtkm::Vec3f pc;
+    //See if point is inside the last cell.
+    if ((lastCell.CellId >= 0) && (lastCell.CellId < this->CellSet.GetNumberOfElements()) &&
+        this->PointInCell(point, lastCell.CellId, pc) == vtkm::ErrorCode::Success)
+    {
+      parametric = pc;
+      cellId = lastCell.CellId;
+      return vtkm::ErrorCode::Success;
+    }
+
+    //See if it's in the last leaf.
+    if ((lastCell.LeafIdx >= 0) && (lastCell.LeafIdx < this->Leaves.GetNumberOfValues()) &&
+        this->PointInLeaf(point, lastCell.LeafIdx, cellId, pc) == vtkm::ErrorCode::Success)
+    {
+      parametric = pc;
+      lastCell.CellId = cellId;
+      return vtkm::ErrorCode::Success;
+    }
+
+    //Call the full point search.
+    return this->FindCellImpl(point, cellId, parametric, lastCell);
+  }
+
+private:
+  VTKM_EXEC
+  vtkm::ErrorCode PointInCell(const vtkm::Vec3f& point,
+                              const vtkm::Id& cid,
+                              vtkm::Vec3f& parametric) const
+  {
+    auto indices = this->CellSet.GetIndices(cid);
+    auto pts = vtkm::make_VecFromPortalPermute(&indices, this->Coords);
+    auto cellShape = this->CellSet.GetCellShape(cid);
+
+    // Reject points outside of the bounds of the cell before the (much more expensive)
+    // inversion of the parametric coordinates.
+    vtkm::Vec3f minCoord = pts[0];
+    vtkm::Vec3f maxCoord = pts[0];
+    for (vtkm::IdComponent i = 1; i < pts.GetNumberOfComponents(); ++i)
+    {
+      minCoord = vtkm::Min(minCoord, pts[i]);
+      maxCoord = vtkm::Max(maxCoord, pts[i]);
+    }
+    if ((point[0] < minCoord[0]) || (point[0] > maxCoord[0]) || (point[1] < minCoord[1]) ||
+        (point[1] > maxCoord[1]) || (point[2] < minCoord[2]) || (point[2] > maxCoord[2]))
+    {
+      return vtkm::ErrorCode::CellNotFound;
+    }
+
+    vtkm::Vec3f pc;
+    VTKM_RETURN_ON_ERROR(
+      vtkm::exec::WorldCoordinatesToParametricCoordinates(pts, point, cellShape, pc));
+    if (vtkm::exec::CellInside(pc, cellShape))
+    {
+      parametric = pc;
+      return vtkm::ErrorCode::Success;
+    }
+
+    return vtkm::ErrorCode::CellNotFound;
+  }
+
+  VTKM_EXEC
+  vtkm::ErrorCode PointInLeaf(const vtkm::Vec3f& point,
+                              const vtkm::Id& leafIdx,
+                              vtkm::Id& cellId,
+                              vtkm::Vec3f& parametric) const
+  {
+    vtkm::Id2 range = this->Leaves.Get(leafIdx);
+    for (vtkm::Id i = range[0]; i < range[0] + range[1]; ++i)
+    {
+      vtkm::Id cid = this->CellIds.Get(i);
+      if (this->PointInCell(point, cid, parametric) == vtkm::ErrorCode::Success)
+      {
+        cellId = cid;
+        return vtkm::ErrorCode::Success;
+      }
+    }
+
+    return vtkm::ErrorCode::CellNotFound;
+  }
+
+  VTKM_EXEC
+  vtkm::ErrorCode FindCellImpl(const vtkm::Vec3f& point,
+                               vtkm::Id& cellId,
+                               vtkm::Vec3f& parametric,
+                               LastCell& lastCell) const
+  {
+    cellId = -1;
+    lastCell.CellId = -1;
+    lastCell.LeafIdx = -1;
+
+    if (this->Nodes.GetNumberOfValues() == 0)
+    {
+      return vtkm::ErrorCode::CellNotFound;
+    }
+
+    vtkm::Id stack[NodeType::StackSize];
+    vtkm::IdComponent stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+      const NodeType node = this->Nodes.Get(stack[--stackSize]);
+
+      // Test all of the children at once. The loop has no branches so that the compiler is
+      // free to vectorize it.
+      bool hit[Width];
+      for (vtkm::IdComponent i = 0; i < Width; ++i)
+      {
+        hit[i] = (point[0] >= node.MinX[i]) & (point[0] <= node.MaxX[i]) &
+          (point[1] >= node.MinY[i]) & (point[1] <= node.MaxY[i]) & (point[2] >= node.MinZ[i]) &
+          (point[2] <= node.MaxZ[i]);
+      }
+
+      for (vtkm::IdComponent i = 0; i < Width; ++i)
+      {
+        vtkm::Id child = node.Child[i];
+        if (!hit[i] || (child == -1))
+        {
+          continue;
+        }
+        if (child >= 0)
+        {
+          stack[stackSize++] = child;
+        }
+        else if (this->PointInLeaf(point, -child - 2, cellId, parametric) ==
+                 vtkm::ErrorCode::Success)
+        {
+          lastCell.CellId = cellId;
+          lastCell.LeafIdx = -child - 2;
+          return vtkm::ErrorCode::Success;
+        }
+      }
+    }
+
+    cellId = -1;
+    return vtkm::ErrorCode::CellNotFound;
+  }
+
+  ReadPortal<NodeType> Nodes;
+  ReadPortal<vtkm::Id2> Leaves;
+  ReadPortal<vtkm::Id> CellIds;
+
+  CellStructureType CellSet;
+  CoordsPortalType Coords;
+};
+
+}
+} // vtkm::exec
+
+#endif // vtk_m_exec_CellLocatorBoundingVolumeHierarchy_h
@@ -59,27 +59,103 @@ public:
                                      vtkm::FloatDefault& distance2) const
   {
     //std::cout << "FindNeareastNeighbor: " << queryPoint << std::endl;
-    vtkm::Id3 ijk = (queryPoint - this->Min) / this->Dxdydz;
-    ijk = vtkm::Max(ijk, vtkm::Id3(0));
-    ijk = vtkm::Min(ijk, this->Dims - vtkm::Id3(1));
+    vtkm::Id3 ijk = this->FindBin(queryPoint);
 
-    nearestNeighborId = -1;
-    distance2 = vtkm::Infinity<vtkm::FloatDefault>();
+    NearestNeighborVisitor visitor{ queryPoint, -1, vtkm::Infinity<vtkm::FloatDefault>() };
 
-    this->FindInCell(queryPoint, ijk, nearestNeighborId, distance2);
+    this->VisitBin(ijk, visitor);
 
     // TODO: This might stop looking before the absolute nearest neighbor is found.
     vtkm::Id maxLevel = vtkm::Max(vtkm::Max(this->Dims[0], this->Dims[1]), this->Dims[2]);
     vtkm::Id level;
-    for (level = 1; (nearestNeighborId < 0) && (level < maxLevel); ++level)
+    for (level = 1; (visitor.NearestNeighborId < 0) && (level < maxLevel); ++level)
     {
-      this->FindInBox(queryPoint, ijk, level, nearestNeighborId, distance2);
+      this->VisitBox(ijk, level, visitor);
     }
 
     // Search one more level out. This is still not guaranteed to find the closest point
     // in all cases (past level 2), but it will catch most cases where the closest point
     // is just on the other side of a cell boundary.
-    this->FindInBox(queryPoint, ijk, level, nearestNeighborId, distance2);
+    this->VisitBox(ijk, level, visitor);
+
+    nearestNeighborId = visitor.NearestNeighborId;
+    distance2 = visitor.Distance2;
+  }
+
+  /// \brief Finds the `k` points closest to a query point.
+  ///
+  /// The ids of the closest points are written to `nearestNeighborIds` and their squared
+  /// distances to `distances2`, sorted from nearest to farthest. Both must have at least `k`
+  /// components. Unlike `FindNearestNeighbor`, the search continues until the result is
+  /// guaranteed to be exact. If there are fewer than `k` points, the remaining entries are
+  /// set to -1 and infinity. Returns the number of neighbors found.
+  ///
+  template <typename IdVecType, typename DistanceVecType>
+  VTKM_EXEC vtkm::IdComponent FindKNearestNeighbors(const vtkm::Vec3f& queryPoint,
+                                                    vtkm::IdComponent k,
+                                                    IdVecType& nearestNeighborIds,
+                                                    DistanceVecType& distances2) const
+  {
+    KNearestVisitor<IdVecType, DistanceVecType> visitor{
+      queryPoint, k, 0, nearestNeighborIds, distances2
+    };
+    if (k > 0)
+    {
+      vtkm::Id3 ijk = this->FindBin(queryPoint);
+      this->VisitBin(ijk, visitor);
+
+      vtkm::Id maxLevel = vtkm::Max(vtkm::Max(this->Dims[0], this->Dims[1]), this->Dims[2]);
+      for (vtkm::Id level = 1; level < maxLevel; ++level)
+      {
+        // Every point not yet visited is outside of the box of bins already searched.
+        if (visitor.Count == k)
+        {
+          vtkm::FloatDefault searched = this->SearchedDistance(queryPoint, ijk, level - 1);
+          if (distances2[k - 1] <= searched * searched)
+          {
+            break;
+          }
+        }
+        this->VisitBox(ijk, level, visitor);
+      }
+    }
+
+    for (vtkm::IdComponent i = visitor.Count; i < k; ++i)
+    {
+      nearestNeighborIds[i] = vtkm::Id(-1);
+      distances2[i] = vtkm::Infinity<vtkm::FloatDefault>();
+    }
+    return visitor.Count;
+  }
+
+  /// \brief Counts the points within `radius` of a query point.
+  ///
+  VTKM_EXEC vtkm::IdComponent CountWithinRadius(const vtkm::Vec3f& queryPoint,
+                                                vtkm::FloatDefault radius) const
+  {
+    CountVisitor visitor{ queryPoint, radius * radius, 0 };
+    this->VisitWithinRadius(queryPoint, radius, visitor);
+    return visitor.Count;
+  }
+
+  /// \brief Finds the points within `radius` of a query point.
+  ///
+  /// The ids of the points are written to `neighborIds` and their squared distances to
+  /// `distances2` in no particular order. At most as many points as there are components in
+  /// `neighborIds` are written, so use `CountWithinRadius` to size the output. Returns the
+  /// number of points written.
+  ///
+  template <typename IdVecType, typename DistanceVecType>
+  VTKM_EXEC vtkm::IdComponent FindWithinRadius(const vtkm::Vec3f& queryPoint,
+                                               vtkm::FloatDefault radius,
+                                               IdVecType& neighborIds,
+                                               DistanceVecType& distances2) const
+  {
+    WithinRadiusVisitor<IdVecType, DistanceVecType> visitor{
+      queryPoint, radius * radius, 0, neighborIds, distances2
+    };
+    this->VisitWithinRadius(queryPoint, radius, visitor);
+    return visitor.Count;
   }
 
 private:
@@ -93,10 +169,158 @@ private:
   IdPortalType CellLower;
   IdPortalType CellUpper;
 
-  VTKM_EXEC void FindInCell(const vtkm::Vec3f& queryPoint,
-                            const vtkm::Id3& ijk,
-                            vtkm::Id& nearestNeighborId,
-                            vtkm::FloatDefault& nearestDistance2) const
+  struct NearestNeighborVisitor
+  {
+    vtkm::Vec3f QueryPoint;
+    vtkm::Id NearestNeighborId;
+    vtkm::FloatDefault Distance2;
+
+    VTKM_EXEC void operator()(vtkm::Id pointId, const vtkm::Vec3f& point)
+    {
+      vtkm::FloatDefault distance2 = vtkm::MagnitudeSquared(point - this->QueryPoint);
+      if (distance2 < this->Distance2)
+      {
+        this->NearestNeighborId = pointId;
+        this->Distance2 = distance2;
+      }
+    }
+  };
+
+  template <typename IdVecType, typename DistanceVecType>
+  struct KNearestVisitor
+  {
+    vtkm::Vec3f QueryPoint;
+    vtkm::IdComponent K;
+    vtkm::IdComponent Count;
+    IdVecType& Ids;
+    DistanceVecType& Distances2;
+
+    VTKM_EXEC void operator()(vtkm::Id pointId, const vtkm::Vec3f& point)
+    {
+      vtkm::FloatDefault distance2 = vtkm::MagnitudeSquared(point - this->QueryPoint);
+      if ((this->Count == this->K) && !(distance2 < this->Distances2[this->K - 1]))
+      {
+        return;
+      }
+
+      // Insertion sort into the (short) list of nearest neighbors.
+      vtkm::IdComponent index = vtkm::Min(this->Count, this->K - 1);
+      while ((index > 0) && (distance2 < this->Distances2[index - 1]))
+      {
+        vtkm::Id id = this->Ids[index - 1];
+        vtkm::FloatDefault shifted = this->Distances2[index - 1];
+        this->Ids[index] = id;
+        this->Distances2[index] = shifted;
+        --index;
+      }
+      this->Ids[index] = pointId;
+      this->Distances2[index] = distance2;
+      this->Count = vtkm::Min(this->Count + 1, this->K);
+    }
+  };
+
+  struct CountVisitor
+  {
+    vtkm::Vec3f QueryPoint;
+    vtkm::FloatDefault Radius2;
+    vtkm::IdComponent Count;
+
+    VTKM_EXEC void operator()(vtkm::Id, const vtkm::Vec3f& point)
+    {
+      if (vtkm::MagnitudeSquared(point - this->QueryPoint) <= this->Radius2)
+      {
+        ++this->Count;
+      }
+    }
+  };
+
+  template <typename IdVecType, typename DistanceVecType>
+  struct WithinRadiusVisitor
+  {
+    vtkm::Vec3f QueryPoint;
+    vtkm::FloatDefault Radius2;
+    vtkm::IdComponent Count;
+    IdVecType& Ids;
+    DistanceVecType& Distances2;
+
+    VTKM_EXEC void operator()(vtkm::Id pointId, const vtkm::Vec3f& point)
+    {
+      vtkm::FloatDefault distance2 = vtkm::MagnitudeSquared(point - this->QueryPoint);
+      if ((distance2 <= this->Radius2) && (this->Count < this->Ids.GetNumberOfComponents()))
+      {
+        this->Ids[this->Count] = pointId;
+        this->Distances2[this->Count] = distance2;
+        ++this->Count;
+      }
+    }
+  };
+
+  VTKM_EXEC vtkm::Id3 FindBin(const vtkm::Vec3f& point) const
+  {
+    vtkm::Id3 ijk = (point - this->Min) / this->Dxdydz;
+    ijk = vtkm::Max(ijk, vtkm::Id3(0));
+    ijk = vtkm::Min(ijk, this->Dims - vtkm::Id3(1));
+    return ijk;
+  }
+
+  // Returns how far the query point is from the closest face of the box of bins within `level`
+  // of `center` that is not on the boundary of the grid. Points not in that box of bins are at
+  // least this far away. (Points outside of the range are placed in boundary bins.)
+  VTKM_EXEC vtkm::FloatDefault SearchedDistance(const vtkm::Vec3f& queryPoint,
+                                                const vtkm::Id3& center,
+                                                vtkm::Id level) const
+  {
+    vtkm::FloatDefault distance = vtkm::Infinity<vtkm::FloatDefault>();
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      if (center[d] - level > 0)
+      {
+        vtkm::FloatDefault face =
+          this->Min[d] + static_cast<vtkm::FloatDefault>(center[d] - level) * this->Dxdydz[d];
+        distance = vtkm::Min(distance, queryPoint[d] - face);
+      }
+      if (center[d] + level < this->Dims[d] - 1)
+      {
+        vtkm::FloatDefault face =
+          this->Min[d] + static_cast<vtkm::FloatDefault>(center[d] + level + 1) * this->Dxdydz[d];
+        distance = vtkm::Min(distance, face - queryPoint[d]);
+      }
+    }
+    return vtkm::Max(distance, vtkm::FloatDefault(0));
+  }
+
+  template <typename Visitor>
+  VTKM_EXEC void VisitWithinRadius(const vtkm::Vec3f& queryPoint,
+                                   vtkm::FloatDefault radius,
+                                   Visitor& visitor) const
+  {
+    // Clamp in floating point before converting to avoid overflowing the integers.
+    vtkm::Id3 lower;
+    vtkm::Id3 upper;
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      vtkm::FloatDefault maxBin = static_cast<vtkm::FloatDefault>(this->Dims[d] - 1);
+      vtkm::FloatDefault low = (queryPoint[d] - radius - this->Min[d]) / this->Dxdydz[d];
+      vtkm::FloatDefault high = (queryPoint[d] + radius - this->Min[d]) / this->Dxdydz[d];
+      lower[d] = static_cast<vtkm::Id>(vtkm::Max(vtkm::FloatDefault(0), vtkm::Min(maxBin, low)));
+      upper[d] = static_cast<vtkm::Id>(vtkm::Max(vtkm::FloatDefault(0), vtkm::Min(maxBin, high)));
+    }
+
+    vtkm::Id3 ijk;
+    for (ijk[2] = lower[2]; ijk[2] <= upper[2]; ++ijk[2])
+    {
+      for (ijk[1] = lower[1]; ijk[1] <= upper[1]; ++ijk[1])
+      {
+        for (ijk[0] = lower[0]; ijk[0] <= upper[0]; ++ijk[0])
+        {
+          this->VisitBin(ijk, visitor);
+        }
+      }
+    }
+  }
+
+  template <typename Visitor>
+  VTKM_EXEC void VisitBin(const vtkm::Id3& ijk, Visitor& visitor) const
   {
     vtkm::Id cellId = ijk[0] + (ijk[1] * this->Dims[0]) + (ijk[2] * this->Dims[0] * this->Dims[1]);
     vtkm::Id lower = this->CellLower.Get(cellId);
@@ -104,64 +328,48 @@ private:
     for (vtkm::Id index = lower; index < upper; index++)
     {
       vtkm::Id pointid = this->PointIds.Get(index);
-      vtkm::Vec3f point = this->Coords.Get(pointid);
-      vtkm::FloatDefault distance2 = vtkm::MagnitudeSquared(point - queryPoint);
-      if (distance2 < nearestDistance2)
-      {
-        nearestNeighborId = pointid;
-        nearestDistance2 = distance2;
-      }
+      visitor(pointid, this->Coords.Get(pointid));
     }
   }
 
-  VTKM_EXEC void FindInBox(const vtkm::Vec3f& queryPoint,
-                           const vtkm::Id3& boxCenter,
-                           vtkm::Id level,
-                           vtkm::Id& nearestNeighborId,
-                           vtkm::FloatDefault& nearestDistance2) const
+  template <typename Visitor>
+  VTKM_EXEC void VisitBox(const vtkm::Id3& boxCenter, vtkm::Id level, Visitor& visitor) const
   {
     if ((boxCenter[0] - level) >= 0)
     {
-      this->FindInXPlane(
-        queryPoint, boxCenter - vtkm::Id3(level, 0, 0), level, nearestNeighborId, nearestDistance2);
+      this->VisitXPlane(boxCenter - vtkm::Id3(level, 0, 0), level, visitor);
     }
     if ((boxCenter[0] + level) < this->Dims[0])
     {
-      this->FindInXPlane(
-        queryPoint, boxCenter + vtkm::Id3(level, 0, 0), level, nearestNeighborId, nearestDistance2);
+      this->VisitXPlane(boxCenter + vtkm::Id3(level, 0, 0), level, visitor);
     }
 
     if ((boxCenter[1] - level) >= 0)
     {
-      this->FindInYPlane(
-        queryPoint, boxCenter - vtkm::Id3(0, level, 0), level, nearestNeighborId, nearestDistance2);
+      this->VisitYPlane(boxCenter - vtkm::Id3(0, level, 0), level, visitor);
     }
     if ((boxCenter[1] + level) < this->Dims[1])
     {
-      this->FindInYPlane(
-        queryPoint, boxCenter + vtkm::Id3(0, level, 0), level, nearestNeighborId, nearestDistance2);
+      this->VisitYPlane(boxCenter + vtkm::Id3(0, level, 0), level, visitor);
     }
 
     if ((boxCenter[2] - level) >= 0)
     {
-      this->FindInZPlane(
-        queryPoint, boxCenter - vtkm::Id3(0, 0, level), level, nearestNeighborId, nearestDistance2);
+      this->VisitZPlane(boxCenter - vtkm::Id3(0, 0, level), level, visitor);
     }
     if ((boxCenter[2] + level) < this->Dims[2])
     {
-      this->FindInZPlane(
-        queryPoint, boxCenter + vtkm::Id3(0, 0, level), level, nearestNeighborId, nearestDistance2);
+      this->VisitZPlane(boxCenter + vtkm::Id3(0, 0, level), level, visitor);
     }
   }
 
-  VTKM_EXEC void FindInPlane(const vtkm::Vec3f& queryPoint,
-                             const vtkm::Id3& planeCenter,
-                             const vtkm::Id3& div,
-                             const vtkm::Id3& mod,
-                             const vtkm::Id3& origin,
-                             vtkm::Id numInPlane,
-                             vtkm::Id& nearestNeighborId,
-                             vtkm::FloatDefault& nearestDistance2) const
+  template <typename Visitor>
+  VTKM_EXEC void VisitPlane(const vtkm::Id3& planeCenter,
+                            const vtkm::Id3& div,
+                            const vtkm::Id3& mod,
+                            const vtkm::Id3& origin,
+                            vtkm::Id numInPlane,
+                            Visitor& visitor) const
   {
     for (vtkm::Id index = 0; index < numInPlane; ++index)
     {
@@ -170,16 +378,13 @@ private:
       if ((ijk[0] >= 0) && (ijk[0] < this->Dims[0]) && (ijk[1] >= 0) && (ijk[1] < this->Dims[1]) &&
           (ijk[2] >= 0) && (ijk[2] < this->Dims[2]))
       {
-        this->FindInCell(queryPoint, ijk, nearestNeighborId, nearestDistance2);
+        this->VisitBin(ijk, visitor);
       }
     }
   }
 
-  VTKM_EXEC void FindInXPlane(const vtkm::Vec3f& queryPoint,
-                              const vtkm::Id3& planeCenter,
-                              vtkm::Id level,
-                              vtkm::Id& nearestNeighborId,
-                              vtkm::FloatDefault& nearestDistance2) const
+  template <typename Visitor>
+  VTKM_EXEC void VisitXPlane(const vtkm::Id3& planeCenter, vtkm::Id level, Visitor& visitor) const
   {
     vtkm::Id yWidth = (2 * level) + 1;
     vtkm::Id zWidth = (2 * level) + 1;
@@ -187,15 +392,11 @@ private:
     vtkm::Id3 mod = { 1, yWidth, 1 };
     vtkm::Id3 origin = { 0, -level, -level };
     vtkm::Id numInPlane = yWidth * zWidth;
-    this->FindInPlane(
-      queryPoint, planeCenter, div, mod, origin, numInPlane, nearestNeighborId, nearestDistance2);
+    this->VisitPlane(planeCenter, div, mod, origin, numInPlane, visitor);
   }
 
-  VTKM_EXEC void FindInYPlane(const vtkm::Vec3f& queryPoint,
-                              vtkm::Id3 planeCenter,
-                              vtkm::Id level,
-                              vtkm::Id& nearestNeighborId,
-                              vtkm::FloatDefault& nearestDistance2) const
+  template <typename Visitor>
+  VTKM_EXEC void VisitYPlane(const vtkm::Id3& planeCenter, vtkm::Id level, Visitor& visitor) const
   {
     vtkm::Id xWidth = (2 * level) - 1;
     vtkm::Id zWidth = (2 * level) + 1;
@@ -203,15 +404,11 @@ private:
     vtkm::Id3 mod = { xWidth, 1, 1 };
     vtkm::Id3 origin = { -level + 1, 0, -level };
     vtkm::Id numInPlane = xWidth * zWidth;
-    this->FindInPlane(
-      queryPoint, planeCenter, div, mod, origin, numInPlane, nearestNeighborId, nearestDistance2);
+    this->VisitPlane(planeCenter, div, mod, origin, numInPlane, visitor);
   }
 
-  VTKM_EXEC void FindInZPlane(const vtkm::Vec3f& queryPoint,
-                              vtkm::Id3 planeCenter,
-                              vtkm::Id level,
-                              vtkm::Id& nearestNeighborId,
-                              vtkm::FloatDefault& nearestDistance2) const
+  template <typename Visitor>
+  VTKM_EXEC void VisitZPlane(const vtkm::Id3& planeCenter, vtkm::Id level, Visitor& visitor) const
   {
     vtkm::Id xWidth = (2 * level) - 1;
     vtkm::Id yWidth = (2 * level) - 1;
@@ -219,8 +416,7 @@ private:
     vtkm::Id3 mod = { xWidth, 1, 1 };
     vtkm::Id3 origin = { -level + 1, -level + 1, 0 };
     vtkm::Id numInPlane = xWidth * yWidth;
-    this->FindInPlane(
-      queryPoint, planeCenter, div, mod, origin, numInPlane, nearestNeighborId, nearestDistance2);
+    this->VisitPlane(planeCenter, div, mod, origin, numInPlane, visitor);
   }
 };
 
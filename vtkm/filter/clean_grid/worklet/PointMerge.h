@@ -408,7 +408,9 @@ public:
                             indexNeighborMap);
     }
 
-    this->MergeKeys = vtkm::worklet::Keys<vtkm::Id>(indexNeighborMap);
+    // Every point is grouped with its merged point. The merged points are ordered by their
+    // first appearance, so no sort is needed.
+    this->MergeKeys.BuildArrays(indexNeighborMap, vtkm::worklet::KeysSortType::Hashed);
 
     invoker(BuildPointInputToOutputMap(), this->MergeKeys, this->PointInputToOutputMap);
 
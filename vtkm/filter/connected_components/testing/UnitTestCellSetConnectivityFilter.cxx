@@ -9,6 +9,7 @@
 //============================================================================
 
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/DataSetBuilderExplicit.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/connected_components/CellSetConnectivity.h>
@@ -84,11 +85,34 @@ public:
                      "Wrong number of connected components");
   }
 
+  static void TestSharedEdges()
+  {
+    // Three triangles around one edge and a separate triangle.
+    std::vector<vtkm::Vec3f> coordinates = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 },
+                                             { 0, -1, 0 }, { 0, 0, 1 }, { 5, 0, 0 },
+                                             { 6, 0, 0 }, { 5, 1, 0 } };
+    std::vector<vtkm::UInt8> shapes(4, vtkm::CELL_SHAPE_TRIANGLE);
+    std::vector<vtkm::IdComponent> numIndices(4, 3);
+    std::vector<vtkm::Id> connectivity = { 0, 1, 2, 0, 1, 3, 1, 0, 4, 5, 6, 7 };
+    vtkm::cont::DataSet dataSet =
+      vtkm::cont::DataSetBuilderExplicit::Create(coordinates, shapes, numIndices, connectivity);
+
+    vtkm::filter::connected_components::CellSetConnectivity filter;
+    const vtkm::cont::DataSet output = filter.Execute(dataSet);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> componentArray;
+    output.GetField("component").GetData().AsArrayHandle(componentArray);
+    auto expected = vtkm::cont::make_ArrayHandle<vtkm::Id>({ 0, 0, 0, 1 });
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(componentArray, expected),
+                     "Wrong components for cells sharing an edge");
+  }
+
   void operator()() const
   {
     TestCellSetConnectivity::TestTangleIsosurface();
     TestCellSetConnectivity::TestExplicitDataSet();
     TestCellSetConnectivity::TestUniformDataSet();
+    TestCellSetConnectivity::TestSharedEdges();
   }
 };
 }
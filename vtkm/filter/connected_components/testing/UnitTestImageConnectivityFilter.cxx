@@ -59,9 +59,84 @@ void TestImageConnectivity()
       "Wrong result for ImageConnectivity");
   }
 }
+
+// Labels the image on the host with a flood fill over the 26 neighbors of each pixel.
+// The components are numbered in the order of their first pixel.
+std::vector<vtkm::Id> FloodFill(const std::vector<vtkm::UInt8>& pixels, const vtkm::Id3& dims)
+{
+  std::vector<vtkm::Id> components(pixels.size(), -1);
+  vtkm::Id numComponents = 0;
+  for (std::size_t seed = 0; seed < pixels.size(); ++seed)
+  {
+    if (components[seed] >= 0)
+    {
+      continue;
+    }
+    std::vector<vtkm::Id> stack{ static_cast<vtkm::Id>(seed) };
+    components[seed] = numComponents;
+    while (!stack.empty())
+    {
+      vtkm::Id index = stack.back();
+      stack.pop_back();
+      vtkm::Id3 ijk(index % dims[0], (index / dims[0]) % dims[1], index / (dims[0] * dims[1]));
+      for (vtkm::Id n = 0; n < 27; ++n)
+      {
+        vtkm::Id3 neighbor = ijk + vtkm::Id3(n % 3 - 1, (n / 3) % 3 - 1, n / 9 - 1);
+        if ((neighbor[0] < 0) || (neighbor[0] >= dims[0]) || (neighbor[1] < 0) ||
+            (neighbor[1] >= dims[1]) || (neighbor[2] < 0) || (neighbor[2] >= dims[2]))
+        {
+          continue;
+        }
+        std::size_t neighborIndex =
+          static_cast<std::size_t>((neighbor[2] * dims[1] + neighbor[1]) * dims[0] + neighbor[0]);
+        if ((components[neighborIndex] < 0) && (pixels[neighborIndex] == pixels[seed]))
+        {
+          components[neighborIndex] = numComponents;
+          stack.push_back(static_cast<vtkm::Id>(neighborIndex));
+        }
+      }
+    }
+    ++numComponents;
+  }
+  return components;
+}
+
+void TestImageConnectivityBlocks(const vtkm::Id3& dims)
+{
+  std::cout << "Image of " << dims << " pixels" << std::endl;
+
+  // Sparse pixels of one color in the other so that many small components
+  // cross the boundaries of the blocks.
+  std::vector<vtkm::UInt8> pixels;
+  for (vtkm::Id index = 0; index < dims[0] * dims[1] * dims[2]; ++index)
+  {
+    pixels.push_back(((index * 7919) % 13) < 3 ? 1 : 0);
+  }
+
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  dataSet.AddPointField("color", pixels);
+
+  vtkm::filter::connected_components::ImageConnectivity connectivity;
+  connectivity.SetActiveField("color");
+  const vtkm::cont::DataSet outputData = connectivity.Execute(dataSet);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> resultArrayHandle;
+  outputData.GetField("component").GetData().AsArrayHandle(resultArrayHandle);
+  std::vector<vtkm::Id> componentExpected = FloodFill(pixels, dims);
+  auto expected = vtkm::cont::make_ArrayHandle(componentExpected, vtkm::CopyFlag::Off);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(resultArrayHandle, expected),
+                   "Wrong result for ImageConnectivity");
+}
+
+void TestImageConnectivityFilter()
+{
+  TestImageConnectivity();
+  TestImageConnectivityBlocks(vtkm::Id3(21, 18, 17));
+  TestImageConnectivityBlocks(vtkm::Id3(75, 40, 1));
+}
 }
 
 int UnitTestImageConnectivityFilter(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(TestImageConnectivity, argc, argv);
+  return vtkm::cont::testing::Testing::Run(TestImageConnectivityFilter, argc, argv);
 }
@@ -10,8 +10,12 @@
 #ifndef vtk_m_worklet_connectivity_CellSetConnectivity_h
 #define vtk_m_worklet_connectivity_CellSetConnectivity_h
 
+#include <vtkm/cont/Invoker.h>
 #include <vtkm/filter/connected_components/worklet/CellSetDualGraph.h>
-#include <vtkm/filter/connected_components/worklet/GraphConnectivity.h>
+#include <vtkm/filter/connected_components/worklet/InnerJoin.h>
+#include <vtkm/filter/connected_components/worklet/UnionFind.h>
+#include <vtkm/worklet/Keys.h>
+#include <vtkm/worklet/WorkletReduceByKey.h>
 
 namespace vtkm
 {
@@ -19,21 +23,53 @@ namespace worklet
 {
 namespace connectivity
 {
+namespace detail
+{
+// Unites all the cells that share an edge with the first of them.
+struct EdgeCellsGraft : public vtkm::worklet::WorkletReduceByKey
+{
+  using ControlSignature = void(KeysIn edges, ValuesIn cellIds, AtomicArrayInOut comp);
+  using ExecutionSignature = void(_2, _3);
+
+  template <typename CellIdVecType, typename AtomicCompInOut>
+  VTKM_EXEC void operator()(const CellIdVecType& cellIds, AtomicCompInOut& comp) const
+  {
+    vtkm::Id first = cellIds[0];
+    for (vtkm::IdComponent i = 1; i < cellIds.GetNumberOfComponents(); ++i)
+    {
+      UnionFind::Unite(comp, first, cellIds[i]);
+    }
+  }
+};
+} // vtkm::worklet::connectivity::detail
 
+// Two cells are connected when they share an edge. Rather than building the
+// dual graph of the cells, the cells are grouped by their edges with a hash
+// table and the cells of each group are united directly in a concurrent
+// union-find forest.
 class CellSetConnectivity
 {
 public:
   static void Run(const vtkm::cont::UnknownCellSet& cellSet,
                   vtkm::cont::ArrayHandle<vtkm::Id>& componentArray)
   {
-    vtkm::cont::ArrayHandle<vtkm::Id> numIndicesArray;
-    vtkm::cont::ArrayHandle<vtkm::Id> indexOffsetsArray;
-    vtkm::cont::ArrayHandle<vtkm::Id> connectivityArray;
-
-    // create cell to cell connectivity graph (dual graph)
-    CellSetDualGraph::Run(cellSet, numIndicesArray, indexOffsetsArray, connectivityArray);
-    // find the connected component of the dual graph
-    GraphConnectivity::Run(numIndicesArray, indexOffsetsArray, connectivityArray, componentArray);
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+    vtkm::cont::ArrayHandle<vtkm::Id2> cellEdges;
+    CellSetDualGraph::EdgeToCellConnectivity(cellSet, cellIds, cellEdges);
+
+    vtkm::worklet::Keys<vtkm::Id2> edgeKeys;
+    edgeKeys.BuildArrays(cellEdges, vtkm::worklet::KeysSortType::Hashed);
+
+    // Initialize the parent pointer of each cell to point to the cell itself.
+    vtkm::cont::Algorithm::Copy(vtkm::cont::ArrayHandleIndex(cellSet.GetNumberOfCells()),
+                                componentArray);
+
+    vtkm::cont::Invoker invoke;
+    invoke(detail::EdgeCellsGraft{}, edgeKeys, cellIds, componentArray);
+    invoke(PointerJumping{}, componentArray);
+
+    // renumber connected component to the range of [0, number of components).
+    RenumberRoots::Run(componentArray);
   }
 };
 }
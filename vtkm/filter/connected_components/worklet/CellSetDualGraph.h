@@ -101,6 +101,9 @@ class CellSetDualGraph
 {
   using Algorithm = vtkm::cont::Algorithm;
 
+public:
+  // Lists every edge of every cell together with the id of the cell. An edge
+  // shared by several cells is listed once for each of them.
   static void EdgeToCellConnectivity(const vtkm::cont::UnknownCellSet& cellSet,
                                      vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
                                      vtkm::cont::ArrayHandle<vtkm::Id2>& cellEdges)
@@ -116,7 +119,6 @@ class CellSetDualGraph
     edgeExtractDisp.Invoke(cellSet, cellIds, cellEdges);
   }
 
-public:
   struct degree2
   {
     VTKM_EXEC
@@ -91,7 +91,7 @@ public:
     invoke(PointerJumping{}, componentsOut);
 
     // renumber connected component to the range of [0, number of components).
-    Renumber::Run(componentsOut);
+    RenumberRoots::Run(componentsOut);
   }
 };
 }
@@ -16,7 +16,6 @@
 #include <vtkm/cont/UncertainArrayHandle.h>
 #include <vtkm/cont/UncertainCellSet.h>
 #include <vtkm/worklet/WorkletMapField.h>
-#include <vtkm/worklet/WorkletPointNeighborhood.h>
 
 #include <vtkm/filter/connected_components/worklet/InnerJoin.h>
 #include <vtkm/filter/connected_components/worklet/UnionFind.h>
@@ -31,63 +30,222 @@ namespace connectivity
 namespace detail
 {
 
-class ImageGraft : public vtkm::worklet::WorkletPointNeighborhood
+// Divides an image into bricks of pixels. Each brick is labeled by a single
+// thread so that the pixels it visits stay in cache.
+class ImageBlocks
 {
 public:
-  using ControlSignature = void(CellSetIn,
-                                FieldInNeighborhood neighborComp,
-                                FieldInNeighborhood neighborColor,
-                                AtomicArrayInOut compOut);
-
-  using ExecutionSignature = void(Boundary, _2, _3, _4);
-
-
-  // compOut is a "linear" alias of neighborComp such that we can update component labels
-  template <typename Boundary,
-            typename NeighborComp,
-            typename NeighborColor,
-            typename AtomicCompOut>
-  VTKM_EXEC void operator()(Boundary boundary,
-                            const NeighborComp& neighborComp,
-                            const NeighborColor& neighborColor,
-                            AtomicCompOut& compOut) const
+  VTKM_CONT explicit ImageBlocks(const vtkm::Id3& pointDimensions)
+    : PointDimensions(pointDimensions)
   {
-    auto thisColor = neighborColor.Get(0, 0, 0);
+    if (pointDimensions[2] > 1)
+    {
+      this->BlockDimensions = vtkm::Id3(8, 8, 8);
+    }
+    else if (pointDimensions[1] > 1)
+    {
+      this->BlockDimensions = vtkm::Id3(32, 32, 1);
+    }
+    else
+    {
+      this->BlockDimensions = vtkm::Id3(1024, 1, 1);
+    }
+    this->NumberOfBlocks = (pointDimensions + this->BlockDimensions - vtkm::Id3(1)) /
+      this->BlockDimensions;
+  }
+
+  VTKM_EXEC_CONT vtkm::Id GetNumberOfBlocks() const
+  {
+    return this->NumberOfBlocks[0] * this->NumberOfBlocks[1] * this->NumberOfBlocks[2];
+  }
 
-    auto minIndices = boundary.MinNeighborIndices(1);
-    auto maxIndices = boundary.MaxNeighborIndices(1);
+  // The pixels of the block are in [start, end).
+  VTKM_EXEC void GetBlockExtent(vtkm::Id blockIndex, vtkm::Id3& start, vtkm::Id3& end) const
+  {
+    vtkm::Id3 block(blockIndex % this->NumberOfBlocks[0],
+                    (blockIndex / this->NumberOfBlocks[0]) % this->NumberOfBlocks[1],
+                    blockIndex / (this->NumberOfBlocks[0] * this->NumberOfBlocks[1]));
+    start = block * this->BlockDimensions;
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      end[d] = vtkm::Min(start[d] + this->BlockDimensions[d], this->PointDimensions[d]);
+    }
+  }
 
-    for (int k = minIndices[2]; k <= maxIndices[2]; k++)
+  // Calls functor(index, neighborIndex, neighborIsInBlock) for every pixel of the
+  // block and every neighbor that comes before it in the image. These are the 13
+  // neighbors (4 in 2D, 1 in 1D) preceding the pixel in its 3x3x3 neighborhood,
+  // so every pair of neighbors is visited exactly once over all blocks.
+  template <typename Functor>
+  VTKM_EXEC void ForEachBackwardNeighbor(vtkm::Id blockIndex, Functor& functor) const
+  {
+    const vtkm::Id3& dims = this->PointDimensions;
+    vtkm::Id3 start;
+    vtkm::Id3 end;
+    this->GetBlockExtent(blockIndex, start, end);
+
+    for (vtkm::Id k = start[2]; k < end[2]; ++k)
     {
-      for (int j = minIndices[1]; j <= maxIndices[1]; j++)
+      for (vtkm::Id j = start[1]; j < end[1]; ++j)
       {
-        for (int i = minIndices[0]; i <= maxIndices[0]; i++)
+        for (vtkm::Id i = start[0]; i < end[0]; ++i)
         {
-          if (thisColor == neighborColor.Get(i, j, k))
+          vtkm::Id index = (k * dims[1] + j) * dims[0] + i;
+          for (vtkm::Id n = 0; n < 13; ++n)
           {
-            // We need to reload thisComp and thatComp every iteration since
-            // they might have been changed by Unite(), both as a result of
-            // attaching one tree to the other or as a result of path compaction
-            // in findRoot().
-            auto thisComp = neighborComp.Get(0, 0, 0);
-            auto thatComp = neighborComp.Get(i, j, k);
-
-            // Merge the two components one way or the other, the order will
-            // be resolved by Unite().
-            UnionFind::Unite(compOut, thisComp, thatComp);
+            vtkm::Id3 neighbor(i + n % 3 - 1, j + (n / 3) % 3 - 1, k + n / 9 - 1);
+            if ((neighbor[0] < 0) || (neighbor[0] >= dims[0]) || (neighbor[1] < 0) ||
+                (neighbor[1] >= dims[1]) || (neighbor[2] < 0))
+            {
+              continue;
+            }
+            bool inBlock = (neighbor[0] >= start[0]) && (neighbor[0] < end[0]) &&
+              (neighbor[1] >= start[1]) && (neighbor[1] < end[1]) && (neighbor[2] >= start[2]);
+            functor(index, (neighbor[2] * dims[1] + neighbor[1]) * dims[0] + neighbor[0], inBlock);
           }
         }
       }
     }
   }
+
+private:
+  vtkm::Id3 PointDimensions;
+  vtkm::Id3 BlockDimensions;
+  vtkm::Id3 NumberOfBlocks;
 };
+
+// Labels the pixels of each block considering only the neighbors in the same
+// block. Each block is only touched by its own thread, so the union-find
+// operations do not need to be atomic.
+class ImageBlockGraft : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockIndex, WholeArrayIn color, WholeArrayInOut comp);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_CONT explicit ImageBlockGraft(const ImageBlocks& blocks)
+    : Blocks(blocks)
+  {
+  }
+
+  template <typename ColorPortal, typename CompPortal>
+  struct LinkInBlock
+  {
+    const ColorPortal& Color;
+    CompPortal& Comp;
+
+    // Path halving without atomics.
+    VTKM_EXEC vtkm::Id FindRoot(vtkm::Id index) const
+    {
+      vtkm::Id parent = this->Comp.Get(index);
+      while (parent != index)
+      {
+        vtkm::Id grandparent = this->Comp.Get(parent);
+        this->Comp.Set(index, grandparent);
+        index = grandparent;
+        parent = this->Comp.Get(index);
+      }
+      return index;
+    }
+
+    VTKM_EXEC void operator()(vtkm::Id index, vtkm::Id neighbor, bool inBlock) const
+    {
+      if (inBlock && (this->Color.Get(index) == this->Color.Get(neighbor)))
+      {
+        vtkm::Id root = this->FindRoot(index);
+        vtkm::Id neighborRoot = this->FindRoot(neighbor);
+        // Keep the smaller index as the root, as UnionFind::Unite() does.
+        if (root < neighborRoot)
+        {
+          this->Comp.Set(neighborRoot, root);
+        }
+        else if (neighborRoot < root)
+        {
+          this->Comp.Set(root, neighborRoot);
+        }
+      }
+    }
+  };
+
+  template <typename ColorPortal, typename CompPortal>
+  VTKM_EXEC void operator()(vtkm::Id blockIndex,
+                            const ColorPortal& color,
+                            CompPortal& comp) const
+  {
+    LinkInBlock<ColorPortal, CompPortal> link{ color, comp };
+    this->Blocks.ForEachBackwardNeighbor(blockIndex, link);
+  }
+
+private:
+  ImageBlocks Blocks;
+};
+
+// Merges the labels of neighboring pixels in different blocks after every
+// block has been labeled on its own.
+class ImageBoundaryGraft : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockIndex, WholeArrayIn color, AtomicArrayInOut comp);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_CONT explicit ImageBoundaryGraft(const ImageBlocks& blocks)
+    : Blocks(blocks)
+  {
+  }
+
+  template <typename ColorPortal, typename AtomicCompInOut>
+  struct LinkAcrossBlocks
+  {
+    const ColorPortal& Color;
+    AtomicCompInOut& Comp;
+
+    VTKM_EXEC void operator()(vtkm::Id index, vtkm::Id neighbor, bool inBlock) const
+    {
+      if (!inBlock && (this->Color.Get(index) == this->Color.Get(neighbor)))
+      {
+        UnionFind::Unite(this->Comp, index, neighbor);
+      }
+    }
+  };
+
+  template <typename ColorPortal, typename AtomicCompInOut>
+  VTKM_EXEC void operator()(vtkm::Id blockIndex,
+                            const ColorPortal& color,
+                            AtomicCompInOut& comp) const
+  {
+    LinkAcrossBlocks<ColorPortal, AtomicCompInOut> link{ color, comp };
+    this->Blocks.ForEachBackwardNeighbor(blockIndex, link);
+  }
+
+private:
+  ImageBlocks Blocks;
+};
+
+inline vtkm::Id3 ToPointDimensions3D(vtkm::Id dims)
+{
+  return vtkm::Id3(dims, 1, 1);
+}
+
+inline vtkm::Id3 ToPointDimensions3D(const vtkm::Id2& dims)
+{
+  return vtkm::Id3(dims[0], dims[1], 1);
+}
+
+inline vtkm::Id3 ToPointDimensions3D(const vtkm::Id3& dims)
+{
+  return dims;
+}
 } // namespace detail
 
-// Single pass connected component algorithm from
+// Connected component labeling with the concurrent union-find from
 // Jaiganesh, Jayadharini, and Martin Burtscher.
 // "A high-performance connected components implementation for GPUs."
 // Proceedings of the 27th International Symposium on High-Performance
 // Parallel and Distributed Computing. 2018.
+// The image is split into blocks. The pixels of each block are first labeled
+// sequentially by one thread, then the labels are merged across the block
+// boundaries with atomic operations. Only the pixels on the boundaries of the
+// blocks contend for the atomic updates.
 class ImageConnectivity
 {
   class RunImpl
@@ -100,17 +258,19 @@ class ImageConnectivity
     {
       using Algorithm = vtkm::cont::Algorithm;
 
-      // Initialize the parent pointer to point to the pixel itself. There are other
-      // ways to initialize the parent pointers, for example, a smaller or the minimal
-      // neighbor.
+      // Initialize the parent pointer to point to the pixel itself.
       Algorithm::Copy(vtkm::cont::ArrayHandleIndex(pixels.GetNumberOfValues()), componentsOut);
 
+      detail::ImageBlocks blocks(detail::ToPointDimensions3D(input.GetPointDimensions()));
+      vtkm::cont::ArrayHandleIndex blockIndices(blocks.GetNumberOfBlocks());
+
       vtkm::cont::Invoker invoke;
-      invoke(detail::ImageGraft{}, input, componentsOut, pixels, componentsOut);
+      invoke(detail::ImageBlockGraft{ blocks }, blockIndices, pixels, componentsOut);
+      invoke(detail::ImageBoundaryGraft{ blocks }, blockIndices, pixels, componentsOut);
       invoke(PointerJumping{}, componentsOut);
 
       // renumber connected component to the range of [0, number of components).
-      Renumber::Run(componentsOut);
+      RenumberRoots::Run(componentsOut);
     }
   };
 
@@ -13,6 +13,7 @@
 
 #include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/Invoker.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/ScatterCounting.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -118,6 +119,52 @@ public:
     Algorithm::SortByKey(pixelIdsOut, componentsInOut);
   }
 };
+
+// Renumbers the output of UnionFind to the range of [0, number of components)
+// like Renumber does, but without sorting. It expects every entry to point
+// directly at its root, as left by PointerJumping. UnionFind::Unite() always
+// attaches the larger root to the smaller one, so each root is the smallest
+// index in its component and numbering the roots in index order with a scan
+// gives the same numbers as sorting the unique roots.
+class RenumberRoots
+{
+public:
+  struct IsRoot : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldIn comp, FieldOut isRoot);
+    using ExecutionSignature = void(WorkIndex, _1, _2);
+
+    VTKM_EXEC void operator()(vtkm::Id index, vtkm::Id comp, vtkm::Id& isRoot) const
+    {
+      isRoot = (comp == index) ? 1 : 0;
+    }
+  };
+
+  struct Relabel : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldInOut comp, WholeArrayIn rootNumbers);
+    using ExecutionSignature = void(_1, _2);
+
+    template <typename InPortalType>
+    VTKM_EXEC void operator()(vtkm::Id& comp, const InPortalType& rootNumbers) const
+    {
+      comp = rootNumbers.Get(comp);
+    }
+  };
+
+  static void Run(vtkm::cont::ArrayHandle<vtkm::Id>& componentsInOut)
+  {
+    vtkm::cont::Invoker invoke;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> isRoot;
+    invoke(IsRoot{}, componentsInOut, isRoot);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> rootNumbers;
+    vtkm::cont::Algorithm::ScanExclusive(isRoot, rootNumbers);
+
+    invoke(Relabel{}, componentsInOut, rootNumbers);
+  }
+};
 }
 }
 } // vtkm::worklet::connectivity
@@ -41,6 +41,31 @@ public:
     return index;
   }
 
+  // This is findRoot() with path halving, which points every node it visits
+  // to its grandparent and continues from there. This shortens the trees for
+  // every later search. It only ever replaces the parent of a non-root node
+  // with one of its ancestors, so the forest keeps its structure and roots
+  // are never changed. A non-root node never becomes a root again, so it is
+  // safe to run concurrently with Unite() and other searches. The atomic
+  // Compare and Swap keeps it from replacing a parent that another thread has
+  // just moved closer to the root with a farther one.
+  template <typename Parents>
+  static VTKM_EXEC vtkm::Id findRootCompress(Parents& parents, vtkm::Id index)
+  {
+    vtkm::Id parent = parents.Get(index);
+    while (parent != index)
+    {
+      vtkm::Id grandparent = parents.Get(parent);
+      if (grandparent != parent)
+      {
+        parents.CompareExchange(index, &parent, grandparent);
+      }
+      index = grandparent;
+      parent = parents.Get(index);
+    }
+    return index;
+  }
+
   template <typename Parents>
   static VTKM_EXEC void Unite(Parents& parents, vtkm::Id u, vtkm::Id v)
   {
@@ -106,8 +131,11 @@ public:
     // We can use this return "new root" as is without calling findRoot() to
     // find the "new root". The while loop terminates when both u and v have
     // the same root (thus united).
-    vtkm::Id root_u = UnionFind::findRoot(parents, u);
-    vtkm::Id root_v = UnionFind::findRoot(parents, v);
+
+    // The roots are found with path halving so that repeated calls for nodes
+    // of large components do not walk long paths over and over.
+    vtkm::Id root_u = UnionFind::findRootCompress(parents, u);
+    vtkm::Id root_v = UnionFind::findRootCompress(parents, v);
 
     while (root_u != root_v)
     {
@@ -11,6 +11,8 @@
 #ifndef vtk_m_filter_contour_AbstractContour_h
 #define vtk_m_filter_contour_AbstractContour_h
 
+#include <vtkm/cont/CellValueRangeIndex.h>
+#include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/filter/FilterField.h>
 #include <vtkm/filter/MapFieldPermutation.h>
 #include <vtkm/filter/contour/vtkm_filter_contour_export.h>
@@ -146,6 +148,42 @@ public:
   VTKM_CONT
   bool GetMergeDuplicatePoints() { return this->MergeDuplicatedPoints; }
 
+  /// @brief Use an index of the field values to skip cells that cannot cross an isovalue.
+  ///
+  /// A `vtkm::cont::CellValueRangeIndex` built over the cells of the input and the active
+  /// field lets the contour visit only the cells near the isovalues, which is much faster
+  /// when the same field is contoured many times. The index is built the first time it is
+  /// used and kept by the filter for later executions. An index that does not match the
+  /// input (a different field or number of cells) causes an error when the filter executes.
+  ///
+  /// Only marching cells uses the index. `Contour` uses marching cells for every type of
+  /// cell set when an index is given.
+  VTKM_CONT
+  void SetCellValueRangeIndex(const vtkm::cont::CellValueRangeIndex& index)
+  {
+    this->ValueRangeIndex = index;
+    this->UseValueRangeIndex = true;
+  }
+
+  /// Stop using an index of the field values.
+  VTKM_CONT
+  void ClearCellValueRangeIndex()
+  {
+    this->ValueRangeIndex = vtkm::cont::CellValueRangeIndex{};
+    this->UseValueRangeIndex = false;
+  }
+
+  /// Get the index of the field values set with `SetCellValueRangeIndex`.
+  VTKM_CONT
+  const vtkm::cont::CellValueRangeIndex& GetCellValueRangeIndex() const
+  {
+    return this->ValueRangeIndex;
+  }
+
+  /// Get whether an index of the field values is used.
+  VTKM_CONT
+  bool GetUseCellValueRangeIndex() const { return this->UseValueRangeIndex; }
+
 protected:
   /// \brief Map a given field to the output \c DataSet , depending on its type.
   ///
@@ -215,6 +253,22 @@ protected:
     }
   }
 
+  /// Find the cells that may cross an isovalue using the index of the field values.
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> FindCandidateCells(
+    const vtkm::cont::DataSet& input)
+  {
+    const vtkm::cont::Field& field = this->GetFieldFromDataSet(input);
+    const vtkm::cont::Field& indexedField = this->ValueRangeIndex.GetField();
+    if ((indexedField.GetName() != field.GetName()) ||
+        (indexedField.GetAssociation() != field.GetAssociation()) ||
+        (this->ValueRangeIndex.GetCellSet().GetNumberOfCells() != input.GetNumberOfCells()))
+    {
+      throw vtkm::cont::ErrorFilterExecution(
+        "The cell value range index does not match the input cells and field.");
+    }
+    return this->ValueRangeIndex.FindCandidateCells(this->IsoValues);
+  }
+
   VTKM_CONT
   virtual vtkm::cont::DataSet DoExecute(
     const vtkm::cont::DataSet& result) = 0; // Needs to be overridden by contour implementations
@@ -227,6 +281,9 @@ protected:
   bool MergeDuplicatedPoints = true;
   std::string NormalArrayName = "normals";
   std::string InterpolationEdgeIdsArrayName = "edgeIds";
+
+  vtkm::cont::CellValueRangeIndex ValueRangeIndex;
+  bool UseValueRangeIndex = false;
 };
 } // namespace contour
 } // namespace filter
@@ -34,8 +34,10 @@ vtkm::cont::DataSet Contour::DoExecute(const vtkm::cont::DataSet& inDataSet)
   auto inCoords = inDataSet.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex()).GetData();
   std::unique_ptr<vtkm::filter::contour::AbstractContour> implementation;
 
-  // Flying Edges is only used for 3D Structured CellSets
-  if (inCellSet.template IsType<vtkm::cont::CellSetStructured<3>>())
+  // Flying Edges is only used for 3D Structured CellSets. It does not use the index of the
+  // field values.
+  if (inCellSet.template IsType<vtkm::cont::CellSetStructured<3>>() &&
+      !this->UseValueRangeIndex)
   {
     VTKM_LOG_S(vtkm::cont::LogLevel::Info, "Using flying edges");
     implementation.reset(new vtkm::filter::contour::ContourFlyingEdges);
@@ -54,6 +56,12 @@ vtkm::cont::DataSet Contour::DoExecute(const vtkm::cont::DataSet& inDataSet)
   implementation->SetNormalArrayName(this->GetNormalArrayName());
   implementation->SetActiveField(this->GetActiveFieldName());
   implementation->SetFieldsToPass(this->GetFieldsToPass());
+  if (this->UseValueRangeIndex)
+  {
+    // Build the index here so that it is kept for the next execution of this filter.
+    this->ValueRangeIndex.Update();
+    implementation->SetCellValueRangeIndex(this->ValueRangeIndex);
+  }
   implementation->SetNumberOfIsoValues(this->GetNumberOfIsoValues());
   for (int i = 0; i < this->GetNumberOfIsoValues(); i++)
   {
@@ -10,6 +10,7 @@
 #include <vtkm/cont/CellSetSingleType.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
+#include <vtkm/cont/Logging.h>
 #include <vtkm/cont/UnknownCellSet.h>
 
 #include <vtkm/filter/contour/ContourFlyingEdges.h>
@@ -40,6 +41,12 @@ vtkm::cont::DataSet ContourFlyingEdges::DoExecute(const vtkm::cont::DataSet& inD
     throw vtkm::cont::ErrorFilterExecution("No iso-values provided.");
   }
 
+  if (this->UseValueRangeIndex)
+  {
+    VTKM_LOG_S(vtkm::cont::LogLevel::Info,
+               "Flying edges does not use the cell value range index. It is ignored.");
+  }
+
   vtkm::cont::UnknownCellSet inCellSet = inDataSet.GetCellSet();
   const vtkm::cont::CoordinateSystem& inCoords =
     inDataSet.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
@@ -37,6 +37,11 @@ vtkm::cont::DataSet ContourMarchingCells::DoExecute(const vtkm::cont::DataSet& i
     throw vtkm::cont::ErrorFilterExecution("No iso-values provided.");
   }
 
+  if (this->UseValueRangeIndex)
+  {
+    worklet.SetCandidateCells(this->FindCandidateCells(inDataSet));
+  }
+
   //get the inputCells and coordinates of the dataset
   const vtkm::cont::UnknownCellSet& inputCells = inDataSet.GetCellSet();
   const vtkm::cont::CoordinateSystem& inputCoords =
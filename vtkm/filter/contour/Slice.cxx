@@ -10,7 +10,10 @@
 
 #include <vtkm/cont/ArrayCopyDevice.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/CellSetSingleType.h>
 #include <vtkm/filter/contour/Slice.h>
+#include <vtkm/filter/contour/worklet/ContourMarchingCells.h>
+#include <vtkm/filter/contour/worklet/SliceCandidateCells.h>
 
 namespace vtkm
 {
@@ -22,6 +25,19 @@ vtkm::cont::DataSet Slice::DoExecute(const vtkm::cont::DataSet& input)
 {
   const auto& coords = input.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
 
+  if (this->GetNumberOfIsoValues() < 1)
+  {
+    this->SetIsoValue(0.0);
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> candidateCells;
+  if (!this->GetUseCellValueRangeIndex() &&
+      vtkm::worklet::SliceCandidateCells::Run(
+        input.GetCellSet(), coords, this->Function, this->IsoValues, candidateCells))
+  {
+    return this->DoExecuteCandidateCells(input, candidateCells);
+  }
+
   vtkm::cont::DataSet result;
   auto impFuncEval =
     vtkm::ImplicitFunctionValueFunctor<vtkm::ImplicitFunctionGeneral>(this->Function);
@@ -33,15 +49,61 @@ vtkm::cont::DataSet Slice::DoExecute(const vtkm::cont::DataSet& input)
   vtkm::cont::DataSet clone = input;
   clone.AddField(vtkm::cont::make_FieldPoint("sliceScalars", sliceScalars));
 
-  if (this->GetNumberOfIsoValues() < 1)
-  {
-    this->SetIsoValue(0.0);
-  }
   this->Contour::SetActiveField("sliceScalars");
   result = this->Contour::DoExecute(clone);
 
   return result;
 }
+
+vtkm::cont::DataSet Slice::DoExecuteCandidateCells(
+  const vtkm::cont::DataSet& input,
+  const vtkm::cont::ArrayHandle<vtkm::Id>& candidateCells)
+{
+  const auto& coords = input.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
+
+  vtkm::worklet::ContourMarchingCells worklet;
+  worklet.SetMergeDuplicatePoints(this->GetMergeDuplicatePoints());
+  worklet.SetCandidateCells(candidateCells);
+
+  // Evaluate the function within the contour worklet rather than storing it for every point.
+  auto impFuncEval =
+    vtkm::ImplicitFunctionValueFunctor<vtkm::ImplicitFunctionGeneral>(this->Function);
+  auto sliceScalars =
+    vtkm::cont::make_ArrayHandleTransform(coords.GetDataAsMultiplexer(), impFuncEval);
+  std::vector<vtkm::FloatDefault> isoValues(this->IsoValues.begin(), this->IsoValues.end());
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> vertices;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> normals;
+  vtkm::cont::CellSetSingleType<> outputCells;
+  if (this->GetGenerateNormals() && !this->GetComputeFastNormals())
+  {
+    outputCells =
+      worklet.Run(isoValues, input.GetCellSet(), coords, sliceScalars, vertices, normals);
+  }
+  else
+  {
+    outputCells = worklet.Run(isoValues, input.GetCellSet(), coords, sliceScalars, vertices);
+  }
+
+  auto mapper = [&](auto& result, const auto& f) { this->DoMapField(result, f, worklet); };
+  vtkm::cont::DataSet output =
+    this->CreateResultCoordinateSystem(input, outputCells, coords.GetName(), vertices, mapper);
+
+  // The other path interpolates the function values onto the slice, so give the same field.
+  if (this->GetFieldsToPass().IsFieldSelected("sliceScalars",
+                                              vtkm::cont::Field::Association::Points))
+  {
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> outputScalars;
+    vtkm::cont::ArrayCopyDevice(vtkm::cont::make_ArrayHandleTransform(vertices, impFuncEval),
+                                outputScalars);
+    output.AddPointField("sliceScalars", outputScalars);
+  }
+
+  this->ExecuteGenerateNormals(output, normals);
+  this->ExecuteAddInterpolationEdgeIds(output, worklet);
+
+  return output;
+}
 } // namespace contour
 } // namespace filter
 } // namespace vtkm
@@ -28,6 +28,11 @@ namespace contour
 /// slice on. A `vtkm::Plane` is a common function to use that cuts the mesh
 /// along a plane.
 ///
+/// The function is sliced where it equals each of the isovalues, which default to 0.
+/// When slicing a 3D structured mesh with uniform or rectilinear coordinates by a
+/// `vtkm::Plane` or a `vtkm::Sphere`, only the cells the surface may cross are visited,
+/// and the function is evaluated at their points as they are needed.
+///
 class VTKM_FILTER_CONTOUR_EXPORT Slice : public vtkm::filter::contour::Contour
 {
 public:
@@ -44,6 +49,9 @@ public:
 
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+  VTKM_CONT vtkm::cont::DataSet DoExecuteCandidateCells(
+    const vtkm::cont::DataSet& input,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& candidateCells);
 
   vtkm::ImplicitFunctionGeneral Function;
 };
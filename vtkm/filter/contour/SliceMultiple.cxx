@@ -7,6 +7,7 @@
 //  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
+#include <vtkm/VectorAnalysis.h>
 #include <vtkm/cont/ArrayCopyDevice.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
@@ -36,14 +37,64 @@ public:
   VTKM_EXEC void operator()(vtkm::Id& value) const { value += this->OffsetValue; }
 };
 
+namespace
+{
+
+// Returns true if the planes are parallel. If so, the second plane is where the function of
+// the first plane equals value.
+bool PlanesAreParallel(const vtkm::Plane& plane, const vtkm::Plane& other, vtkm::Float64& value)
+{
+  vtkm::Vec3f_64 normal(plane.GetNormal());
+  vtkm::Vec3f_64 otherNormal(other.GetNormal());
+  vtkm::Float64 crossSquared = vtkm::MagnitudeSquared(vtkm::Cross(normal, otherNormal));
+  if (crossSquared >
+      1e-12 * vtkm::MagnitudeSquared(normal) * vtkm::MagnitudeSquared(otherNormal))
+  {
+    return false;
+  }
+  value = vtkm::Dot(vtkm::Vec3f_64(other.GetOrigin()) - vtkm::Vec3f_64(plane.GetOrigin()), normal);
+  return true;
+}
+
+} // anonymous namespace
+
 vtkm::cont::DataSet SliceMultiple::DoExecute(const vtkm::cont::DataSet& input)
 {
+  // Group the functions so that all parallel planes are sliced together by one function at
+  // several values.
+  std::vector<vtkm::ImplicitFunctionGeneral> functions;
+  std::vector<std::vector<vtkm::Float64>> values;
+  for (const vtkm::ImplicitFunctionGeneral& function : this->FunctionList)
+  {
+    bool grouped = false;
+    if (function.IsType<vtkm::Plane>())
+    {
+      for (std::size_t group = 0; (group < functions.size()) && !grouped; ++group)
+      {
+        vtkm::Float64 value;
+        if (functions[group].IsType<vtkm::Plane>() &&
+            PlanesAreParallel(
+              functions[group].Get<vtkm::Plane>(), function.Get<vtkm::Plane>(), value))
+        {
+          values[group].push_back(value);
+          grouped = true;
+        }
+      }
+    }
+    if (!grouped)
+    {
+      functions.push_back(function);
+      values.push_back({ 0.0 });
+    }
+  }
+
   vtkm::cont::PartitionedDataSet slices;
   //Executing Slice filter several times and merge results together
-  for (vtkm::IdComponent i = 0; i < static_cast<vtkm::IdComponent>(this->FunctionList.size()); i++)
+  for (std::size_t group = 0; group < functions.size(); ++group)
   {
     vtkm::filter::contour::Slice slice;
-    slice.SetImplicitFunction(this->GetImplicitFunction(i));
+    slice.SetImplicitFunction(functions[group]);
+    slice.SetIsoValues(values[group]);
     slice.SetFieldsToPass(this->GetFieldsToPass());
     auto result = slice.Execute(input);
     slices.AppendPartition(result);
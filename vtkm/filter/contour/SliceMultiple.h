@@ -23,6 +23,8 @@ namespace contour
 {
 /// \brief This filter can accept multiple implicit functions used by the slice filter.
 /// It returns a merged data set that contains multiple results returned by the slice filter.
+/// Parallel planes are slices of the same function at different values, so all of the
+/// parallel planes are sliced together in one pass over the mesh.
 class VTKM_FILTER_CONTOUR_EXPORT SliceMultiple : public vtkm::filter::contour::Contour
 {
 public:
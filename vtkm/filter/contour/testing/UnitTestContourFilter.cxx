@@ -10,6 +10,7 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/CellValueRangeIndex.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
@@ -173,6 +174,109 @@ public:
     VTKM_TEST_ASSERT(result.GetNumberOfCells() == 52);
   }
 
+  template <typename ContourFilterType>
+  void TestMultipleIsoValues() const
+  {
+    std::cout << "Testing Contour filter with multiple isovalues" << std::endl;
+
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 8, 8, 8 });
+    vtkm::cont::DataSet dataSet = tangle.Execute();
+
+    // The isovalues are not sorted, and two of them are outside of the range of the field.
+    std::vector<vtkm::Float64> isovalues = { 1.5, -1000.0, 0.2, 0.9, 1000.0, 0.5 };
+
+    vtkm::Id expectedNumberOfCells = 0;
+    vtkm::Id expectedNumberOfPoints = 0;
+    for (vtkm::Float64 isovalue : isovalues)
+    {
+      ContourFilterType filter;
+      filter.SetIsoValue(isovalue);
+      filter.SetActiveField("tangle");
+      vtkm::cont::DataSet single = filter.Execute(dataSet);
+      expectedNumberOfCells += single.GetNumberOfCells();
+      expectedNumberOfPoints += single.GetNumberOfPoints();
+    }
+    VTKM_TEST_ASSERT(expectedNumberOfCells > 0);
+
+    ContourFilterType filter;
+    filter.SetIsoValues(isovalues);
+    filter.SetActiveField("tangle");
+    filter.SetGenerateNormals(true);
+    vtkm::cont::DataSet result = filter.Execute(dataSet);
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() == expectedNumberOfCells,
+                     "Wrong number of cells for multiple isovalues");
+    VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expectedNumberOfPoints,
+                     "Wrong number of points for multiple isovalues");
+
+    // Every point must lie on one of the isosurfaces.
+    vtkm::cont::ArrayHandle<vtkm::Float32> values;
+    result.GetPointField("tangle").GetData().AsArrayHandle(values);
+    auto valuesPortal = values.ReadPortal();
+    for (vtkm::Id i = 0; i < valuesPortal.GetNumberOfValues(); ++i)
+    {
+      bool onSurface = false;
+      for (vtkm::Float64 isovalue : isovalues)
+      {
+        onSurface |= test_equal(valuesPortal.Get(i), isovalue, 0.01);
+      }
+      VTKM_TEST_ASSERT(onSurface, "Point is not on any isosurface");
+    }
+  }
+
+  template <typename ContourFilterType>
+  void TestCellValueRangeIndex() const
+  {
+    std::cout << "Testing Contour filter with a cell value range index" << std::endl;
+
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 16, 16, 16 });
+    vtkm::cont::DataSet dataSet = tangle.Execute();
+
+    vtkm::cont::CellValueRangeIndex index;
+    index.SetCellSet(dataSet.GetCellSet());
+    index.SetField(dataSet.GetField("tangle"));
+
+    ContourFilterType indexed;
+    indexed.SetActiveField("tangle");
+    indexed.SetGenerateNormals(false);
+    indexed.SetCellValueRangeIndex(index);
+
+    // The same field is contoured many times with the same index.
+    for (std::vector<vtkm::Float64> isovalues : std::vector<std::vector<vtkm::Float64>>{
+           { 0.5 }, { 0.1, 1.2 }, { 1000.0 }, { 2.0, 0.3, 0.7 } })
+    {
+      vtkm::filter::contour::ContourMarchingCells plain;
+      plain.SetActiveField("tangle");
+      plain.SetGenerateNormals(false);
+      plain.SetIsoValues(isovalues);
+      vtkm::cont::DataSet expected = plain.Execute(dataSet);
+
+      indexed.SetIsoValues(isovalues);
+      vtkm::cont::DataSet result = indexed.Execute(dataSet);
+      VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                       "Wrong number of cells with index");
+      VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                       "Wrong number of points with index");
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(result.GetCoordinateSystem().GetData(),
+                                               expected.GetCoordinateSystem().GetData()),
+                       "Wrong points with index");
+    }
+    VTKM_TEST_ASSERT(!indexed.GetCellValueRangeIndex().GetModified(), "Index not kept");
+
+    // An index of a different mesh is an error.
+    tangle.SetCellDimensions({ 4, 4, 4 });
+    try
+    {
+      indexed.Execute(tangle.Execute());
+      VTKM_TEST_FAIL("Contour should not use an index of another mesh");
+    }
+    catch (vtkm::cont::ErrorFilterExecution&)
+    {
+      std::cout << "Execution successfully aborted" << std::endl;
+    }
+  }
+
   void TestUnsupportedFlyingEdges() const
   {
     vtkm::cont::testing::MakeTestDataSet maker;
@@ -264,6 +368,13 @@ public:
     this->TestNonUniformStructured<vtkm::filter::contour::ContourFlyingEdges>();
     this->TestNonUniformStructured<vtkm::filter::contour::ContourMarchingCells>();
 
+    this->TestMultipleIsoValues<vtkm::filter::contour::Contour>();
+    this->TestMultipleIsoValues<vtkm::filter::contour::ContourFlyingEdges>();
+    this->TestMultipleIsoValues<vtkm::filter::contour::ContourMarchingCells>();
+
+    this->TestCellValueRangeIndex<vtkm::filter::contour::Contour>();
+    this->TestCellValueRangeIndex<vtkm::filter::contour::ContourMarchingCells>();
+
     this->TestUnsupportedFlyingEdges();
   }
 
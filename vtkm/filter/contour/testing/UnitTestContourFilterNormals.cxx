@@ -74,6 +74,10 @@ void TestNormals(const vtkm::cont::DataSet& dataset, bool structured)
   //the points to be in a different order
   const vtkm::Id fe_y_alg_ordering[numVerts] = { 0, 1,  3,  5,  4, 6,  2,  7,
                                                  9, 12, 10, 13, 8, 14, 11, 15 };
+  //Marching cells numbers the merged points in the order that the
+  //triangles first use them
+  const vtkm::Id mc_ordering[numVerts] = { 0, 3,  2,  4,  5,  1,  6,  7,
+                                           9, 8, 10, 12, 13, 14, 11, 15 };
 
   //Calculated using normals of the output triangles
   const vtkm::Vec3f fast[numVerts] = {
@@ -130,7 +134,16 @@ void TestNormals(const vtkm::cont::DataSet& dataset, bool structured)
     auto normalPotals = normals.ReadPortal();
     for (vtkm::Id i = 0; i < numVerts; ++i)
     {
-      auto expected_v = !using_fe_y_alg_ordering ? expected[i] : expected[fe_y_alg_ordering[i]];
+      vtkm::Id expected_i = i;
+      if (using_fe_y_alg_ordering)
+      {
+        expected_i = fe_y_alg_ordering[i];
+      }
+      else if (!structured)
+      {
+        expected_i = mc_ordering[i];
+      }
+      auto expected_v = expected[expected_i];
       VTKM_TEST_ASSERT(test_equal(normalPotals.Get(i), expected_v, 0.001),
                        "Result (",
                        normalPotals.Get(i),
@@ -166,12 +179,13 @@ void TestNormals(const vtkm::cont::DataSet& dataset, bool structured)
     auto normalPotals = normals.ReadPortal();
     for (vtkm::Id i = 0; i < numVerts; ++i)
     {
-      bool equal = test_equal(normalPotals.Get(i), expected[i], 0.001);
+      auto expected_v = structured ? expected[i] : expected[mc_ordering[i]];
+      bool equal = test_equal(normalPotals.Get(i), expected_v, 0.001);
       VTKM_TEST_ASSERT(equal,
                        "Result (",
                        normalPotals.Get(i),
                        ") does not match expected value (",
-                       expected[i],
+                       expected_v,
                        ") vert ",
                        i);
     }
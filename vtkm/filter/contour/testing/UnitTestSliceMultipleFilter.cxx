@@ -8,9 +8,11 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/Invoker.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/contour/Slice.h>
 #include <vtkm/filter/contour/SliceMultiple.h>
 #include <vtkm/io/VTKDataSetWriter.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -127,8 +129,95 @@ void TestSliceMultipleFilter()
                    "wrong pointV4 values");
   VTKM_TEST_ASSERT(result.GetNumberOfCells() == 24, "wrong number of cells in merged data set");
 }
+
+vtkm::cont::DataSet MakeCurvilinearCopy(const vtkm::cont::DataSet& input)
+{
+  // Explicit coordinates can not be culled, so slicing this copy contours every cell.
+  vtkm::cont::DataSet copy = input;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> coords;
+  vtkm::cont::ArrayCopy(input.GetCoordinateSystem().GetData(), coords);
+  copy.AddCoordinateSystem(
+    vtkm::cont::CoordinateSystem(input.GetCoordinateSystem().GetName(), coords));
+  return copy;
+}
+
+void CheckSameSlice(const vtkm::cont::DataSet& result, const vtkm::cont::DataSet& expected)
+{
+  VTKM_TEST_ASSERT(result.GetNumberOfCells() > 0, "slice is empty");
+  VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                   "wrong number of cells in slice");
+  VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                   "wrong number of points in slice");
+  VTKM_TEST_ASSERT(test_equal(result.GetCoordinateSystem().GetBounds(),
+                              expected.GetCoordinateSystem().GetBounds()),
+                   "wrong bounds of slice");
+  VTKM_TEST_ASSERT(result.HasPointField("pointScalars"), "point field not mapped");
+  VTKM_TEST_ASSERT(result.HasCellField("cellScalars"), "cell field not mapped");
+}
+
+void TestSliceCandidateCells()
+{
+  std::cout << "Testing slicing only the cells near the function" << std::endl;
+  vtkm::cont::DataSet ds = vtkm::cont::DataSetBuilderUniform::Create(
+    vtkm::Id3(17, 13, 11), vtkm::Vec3f(-1.0f, -1.0f, -1.0f), vtkm::Vec3f(0.125f, 0.15f, 0.2f));
+  vtkm::cont::ArrayHandle<vtkm::Float64> pointScalars;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> pointV3;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 4>> pointV4;
+  vtkm::cont::Invoker invoker;
+  invoker(
+    SetPointValuesWorklet{}, ds.GetCoordinateSystem().GetData(), pointScalars, pointV3, pointV4);
+  ds.AddPointField("pointScalars", pointScalars);
+  vtkm::cont::ArrayHandle<vtkm::Float64> cellScalars;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> cellV3;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 4>> cellV4;
+  invoker(SetCellValuesWorklet{}, ds.GetCellSet(), pointScalars, cellScalars, cellV3, cellV4);
+  ds.AddCellField("cellScalars", cellScalars);
+  vtkm::cont::DataSet curvilinear = MakeCurvilinearCopy(ds);
+
+  std::vector<vtkm::ImplicitFunctionGeneral> functions = {
+    vtkm::Plane({ 0.01f, 0.02f, 0.03f }, { 1, 0, 0 }),
+    vtkm::Plane({ 0.01f, 0.02f, 0.03f }, { -0.3f, 0.5f, 0.8f }),
+    vtkm::Sphere({ 0.1f, -0.2f, 0.05f }, 0.73f),
+    vtkm::Sphere({ -1.3f, 0.9f, 0.0f }, 1.1f)
+  };
+  for (const vtkm::ImplicitFunctionGeneral& function : functions)
+  {
+    vtkm::filter::contour::Slice slice;
+    slice.SetImplicitFunction(function);
+    slice.SetIsoValues({ 0.0, 0.11 });
+    vtkm::cont::DataSet result = slice.Execute(ds);
+    CheckSameSlice(result, slice.Execute(curvilinear));
+    VTKM_TEST_ASSERT(result.HasPointField("sliceScalars"), "slice scalars missing");
+  }
+
+  // Parallel planes are sliced together.
+  vtkm::filter::contour::SliceMultiple sliceMultiple;
+  sliceMultiple.AddImplicitFunction(vtkm::Plane({ 0.0f, 0.0f, -0.51f }, { 0.2f, 0.1f, 1.0f }));
+  sliceMultiple.AddImplicitFunction(vtkm::Plane({ 0.0f, 0.0f, 0.03f }, { -0.2f, -0.1f, -1.0f }));
+  sliceMultiple.AddImplicitFunction(vtkm::Plane({ 0.0f, 0.0f, 0.47f }, { 0.4f, 0.2f, 2.0f }));
+  vtkm::cont::DataSet result = sliceMultiple.Execute(ds);
+  vtkm::Id numCells = 0;
+  vtkm::Id numPoints = 0;
+  for (vtkm::Id i = 0; i < 3; ++i)
+  {
+    vtkm::filter::contour::Slice slice;
+    slice.SetImplicitFunction(sliceMultiple.GetImplicitFunction(i));
+    vtkm::cont::DataSet single = slice.Execute(curvilinear);
+    numCells += single.GetNumberOfCells();
+    numPoints += single.GetNumberOfPoints();
+  }
+  VTKM_TEST_ASSERT(result.GetNumberOfCells() == numCells, "wrong number of cells in slices");
+  VTKM_TEST_ASSERT(result.GetNumberOfPoints() == numPoints, "wrong number of points in slices");
+}
+
+void TestSliceMultipleFilters()
+{
+  TestSliceMultipleFilter();
+  TestSliceCandidateCells();
+}
+
 } // anonymous namespace
 int UnitTestSliceMultipleFilter(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(TestSliceMultipleFilter, argc, argv);
+  return vtkm::cont::testing::Testing::Run(TestSliceMultipleFilters, argc, argv);
 }
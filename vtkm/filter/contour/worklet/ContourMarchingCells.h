@@ -106,6 +106,14 @@ public:
   //----------------------------------------------------------------------------
   vtkm::cont::ArrayHandle<vtkm::Id> GetCellIdMap() const { return this->SharedState.CellIdMap; }
 
+  //----------------------------------------------------------------------------
+  // Only classify the given cells, which must include every cell crossing an isovalue.
+  void SetCandidateCells(const vtkm::cont::ArrayHandle<vtkm::Id>& cellIds)
+  {
+    this->SharedState.CandidateCells = cellIds;
+    this->SharedState.UseCandidateCells = true;
+  }
+
   //----------------------------------------------------------------------------
   template <typename InArrayType, typename OutArrayType>
   void ProcessPointField(const InArrayType& input, const OutArrayType& output) const
@@ -0,0 +1,444 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_worklet_SliceCandidateCells_h
+#define vtk_m_worklet_SliceCandidateCells_h
+
+#include <vtkm/ImplicitFunction.h>
+#include <vtkm/Math.h>
+#include <vtkm/VectorAnalysis.h>
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCartesianProduct.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/CoordinateSystem.h>
+#include <vtkm/cont/ConvertNumComponentsToOffsets.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/UnknownCellSet.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace slice
+{
+
+// Finds the cells in one row of a structured grid with axis aligned coordinates that a plane
+// or a sphere may cross at any of a sorted list of function values. A row is the cells with
+// the same j and k index. The rows are independent, so only the rows are visited, and the
+// crossed cells of each row are found by a binary search over the x coordinates.
+class RowCellRanges
+{
+public:
+  VTKM_CONT RowCellRanges(const vtkm::Id3& cellDimensions, const vtkm::Plane& plane)
+    : CellDimensions(cellDimensions)
+    , IsSphere(false)
+    , Origin(plane.GetOrigin())
+    , Normal(plane.GetNormal())
+    , RadiusSquared(0)
+  {
+  }
+
+  VTKM_CONT RowCellRanges(const vtkm::Id3& cellDimensions, const vtkm::Sphere& sphere)
+    : CellDimensions(cellDimensions)
+    , IsSphere(true)
+    , Origin(sphere.GetCenter())
+    , Normal(0)
+    , RadiusSquared(static_cast<vtkm::Float64>(sphere.GetRadius()) * sphere.GetRadius())
+  {
+  }
+
+  // Calls functor(begin, end) for each run of cells [begin, end) in the row that may cross
+  // one of the values. The runs do not overlap and are in increasing order.
+  template <typename AxisPortal, typename ValuesPortal, typename Functor>
+  VTKM_EXEC void ForEachCellRange(vtkm::Id rowId,
+                                  const AxisPortal& xAxis,
+                                  const AxisPortal& yAxis,
+                                  const AxisPortal& zAxis,
+                                  const ValuesPortal& values,
+                                  Functor&& functor) const
+  {
+    vtkm::Id j = rowId % this->CellDimensions[1];
+    vtkm::Id k = rowId / this->CellDimensions[1];
+
+    // The range of the part of the function that does not depend on x over the row.
+    vtkm::Vec2f_64 rest(0, 0);
+    this->AddAxisRange(rest, yAxis.Get(j), yAxis.Get(j + 1), 1);
+    this->AddAxisRange(rest, zAxis.Get(k), zAxis.Get(k + 1), 2);
+
+    // Allow for the rounding of the function values at the points.
+    vtkm::Vec2f_64 xPart(0, 0);
+    this->AddAxisRange(xPart, xAxis.Get(0), xAxis.Get(this->CellDimensions[0]), 0);
+    const vtkm::Float64 scale = vtkm::Abs(rest[0]) + vtkm::Abs(rest[1]) +
+      vtkm::Abs(xPart[0]) + vtkm::Abs(xPart[1]) + this->RadiusSquared + 1;
+
+    vtkm::Id runBegin = 0;
+    vtkm::Id runEnd = -1;
+    auto addRange = [&](vtkm::Float64 xMin, vtkm::Float64 xMax) {
+      vtkm::Id begin = vtkm::Max(LowerBound(xAxis, xMin) - 1, vtkm::Id(0));
+      vtkm::Id end = vtkm::Min(UpperBound(xAxis, xMax), this->CellDimensions[0]);
+      if (begin >= end)
+      {
+        return;
+      }
+      if (begin <= runEnd)
+      {
+        runEnd = vtkm::Max(runEnd, end);
+      }
+      else
+      {
+        if (runEnd > runBegin)
+        {
+          functor(runBegin, runEnd);
+        }
+        runBegin = begin;
+        runEnd = end;
+      }
+    };
+
+    // The x part of the function must be within [low, high] to reach a value.
+    const vtkm::Id numValues = values.GetNumberOfValues();
+    auto xPartBounds = [&](vtkm::Id valueIndex, vtkm::Float64& low, vtkm::Float64& high) {
+      vtkm::Float64 value = static_cast<vtkm::Float64>(values.Get(valueIndex));
+      vtkm::Float64 tolerance = 1e-5 * (scale + vtkm::Abs(value));
+      low = value + this->RadiusSquared - rest[1] - tolerance;
+      high = value + this->RadiusSquared - rest[0] + tolerance;
+    };
+
+    if (!this->IsSphere)
+    {
+      // The x part is Normal[0] * (x - Origin[0]), which is monotonic in x. Visit the values
+      // in the order of the x coordinates they reach.
+      const vtkm::Float64 slope = this->Normal[0];
+      for (vtkm::Id index = 0; index < numValues; ++index)
+      {
+        vtkm::Float64 low, high;
+        xPartBounds((slope < 0) ? (numValues - index - 1) : index, low, high);
+        if (slope == 0)
+        {
+          if ((low <= 0) && (high >= 0))
+          {
+            addRange(vtkm::NegativeInfinity64(), vtkm::Infinity64());
+          }
+        }
+        else if (slope > 0)
+        {
+          addRange(this->Origin[0] + low / slope, this->Origin[0] + high / slope);
+        }
+        else
+        {
+          addRange(this->Origin[0] + high / slope, this->Origin[0] + low / slope);
+        }
+      }
+    }
+    else
+    {
+      // The x part is (x - Origin[0])^2, which is reached on both sides of the center. Visit
+      // the values decreasing on the low side and then increasing on the high side.
+      for (vtkm::Id index = numValues - 1; index >= 0; --index)
+      {
+        vtkm::Float64 low, high;
+        xPartBounds(index, low, high);
+        if (high >= 0)
+        {
+          addRange(this->Origin[0] - vtkm::Sqrt(high),
+                   this->Origin[0] - vtkm::Sqrt(vtkm::Max(low, 0.0)));
+        }
+      }
+      for (vtkm::Id index = 0; index < numValues; ++index)
+      {
+        vtkm::Float64 low, high;
+        xPartBounds(index, low, high);
+        if (high >= 0)
+        {
+          addRange(this->Origin[0] + vtkm::Sqrt(vtkm::Max(low, 0.0)),
+                   this->Origin[0] + vtkm::Sqrt(high));
+        }
+      }
+    }
+
+    if (runEnd > runBegin)
+    {
+      functor(runBegin, runEnd);
+    }
+  }
+
+private:
+  // Adds the range of the part of the function along one axis over [low, high] to range.
+  VTKM_EXEC void AddAxisRange(vtkm::Vec2f_64& range,
+                              vtkm::Float64 low,
+                              vtkm::Float64 high,
+                              vtkm::IdComponent axis) const
+  {
+    vtkm::Float64 lowOffset = low - this->Origin[axis];
+    vtkm::Float64 highOffset = high - this->Origin[axis];
+    if (this->IsSphere)
+    {
+      vtkm::Float64 nearest = ((lowOffset <= 0) && (highOffset >= 0))
+        ? 0
+        : vtkm::Min(vtkm::Abs(lowOffset), vtkm::Abs(highOffset));
+      vtkm::Float64 farthest = vtkm::Max(vtkm::Abs(lowOffset), vtkm::Abs(highOffset));
+      range[0] += nearest * nearest;
+      range[1] += farthest * farthest;
+    }
+    else
+    {
+      vtkm::Float64 lowValue = this->Normal[axis] * lowOffset;
+      vtkm::Float64 highValue = this->Normal[axis] * highOffset;
+      range[0] += vtkm::Min(lowValue, highValue);
+      range[1] += vtkm::Max(lowValue, highValue);
+    }
+  }
+
+  // Finds the first point along the axis with a coordinate not less than value.
+  template <typename AxisPortal>
+  VTKM_EXEC static vtkm::Id LowerBound(const AxisPortal& axis, vtkm::Float64 value)
+  {
+    vtkm::Id low = 0;
+    vtkm::Id high = axis.GetNumberOfValues();
+    while (low < high)
+    {
+      vtkm::Id mid = (low + high) / 2;
+      if (static_cast<vtkm::Float64>(axis.Get(mid)) < value)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  // Finds the first point along the axis with a coordinate greater than value.
+  template <typename AxisPortal>
+  VTKM_EXEC static vtkm::Id UpperBound(const AxisPortal& axis, vtkm::Float64 value)
+  {
+    vtkm::Id low = 0;
+    vtkm::Id high = axis.GetNumberOfValues();
+    while (low < high)
+    {
+      vtkm::Id mid = (low + high) / 2;
+      if (static_cast<vtkm::Float64>(axis.Get(mid)) <= value)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  vtkm::Id3 CellDimensions;
+  bool IsSphere;
+  vtkm::Vec3f_64 Origin;
+  vtkm::Vec3f_64 Normal;
+  vtkm::Float64 RadiusSquared;
+};
+
+class CountRowCells : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn rowId,
+                                WholeArrayIn xAxis,
+                                WholeArrayIn yAxis,
+                                WholeArrayIn zAxis,
+                                WholeArrayIn values,
+                                FieldOut numCells);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  VTKM_CONT explicit CountRowCells(const RowCellRanges& ranges)
+    : Ranges(ranges)
+  {
+  }
+
+  template <typename AxisPortal, typename ValuesPortal>
+  VTKM_EXEC void operator()(vtkm::Id rowId,
+                            const AxisPortal& xAxis,
+                            const AxisPortal& yAxis,
+                            const AxisPortal& zAxis,
+                            const ValuesPortal& values,
+                            vtkm::IdComponent& numCells) const
+  {
+    numCells = 0;
+    this->Ranges.ForEachCellRange(
+      rowId, xAxis, yAxis, zAxis, values, [&](vtkm::Id begin, vtkm::Id end) {
+        numCells += static_cast<vtkm::IdComponent>(end - begin);
+      });
+  }
+
+private:
+  RowCellRanges Ranges;
+};
+
+class ListRowCells : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn rowId,
+                                WholeArrayIn xAxis,
+                                WholeArrayIn yAxis,
+                                WholeArrayIn zAxis,
+                                WholeArrayIn values,
+                                FieldOut cellIds);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  VTKM_CONT ListRowCells(const RowCellRanges& ranges, vtkm::Id numCellsInRow)
+    : Ranges(ranges)
+    , NumCellsInRow(numCellsInRow)
+  {
+  }
+
+  template <typename AxisPortal, typename ValuesPortal, typename CellIdsVecType>
+  VTKM_EXEC void operator()(vtkm::Id rowId,
+                            const AxisPortal& xAxis,
+                            const AxisPortal& yAxis,
+                            const AxisPortal& zAxis,
+                            const ValuesPortal& values,
+                            CellIdsVecType& cellIds) const
+  {
+    vtkm::Id rowStart = rowId * this->NumCellsInRow;
+    vtkm::IdComponent index = 0;
+    this->Ranges.ForEachCellRange(
+      rowId, xAxis, yAxis, zAxis, values, [&](vtkm::Id begin, vtkm::Id end) {
+        for (vtkm::Id i = begin; i < end; ++i)
+        {
+          cellIds[index++] = rowStart + i;
+        }
+      });
+  }
+
+private:
+  RowCellRanges Ranges;
+  vtkm::Id NumCellsInRow;
+};
+
+} // namespace slice
+
+/// \brief Finds the cells that a plane or sphere may cross without visiting every cell.
+///
+/// This only works for a 3D structured cell set with uniform or rectilinear coordinates that
+/// increase along each axis, and only for `vtkm::Plane` and `vtkm::Sphere`. The cells are
+/// found from the coordinates along each axis, so the work is proportional to the number of
+/// rows of cells and the number of cells found rather than to the number of cells.
+class SliceCandidateCells
+{
+public:
+  /// Returns false without finding any cells if the cells, coordinates or function are not
+  /// supported. Otherwise, fills `cellIds` with the cells that may cross any of the values
+  /// of the function in increasing order.
+  VTKM_CONT static bool Run(const vtkm::cont::UnknownCellSet& cellSet,
+                            const vtkm::cont::CoordinateSystem& coords,
+                            const vtkm::ImplicitFunctionGeneral& function,
+                            const std::vector<vtkm::Float64>& values,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& cellIds)
+  {
+    if (!cellSet.IsType<vtkm::cont::CellSetStructured<3>>() ||
+        (!function.IsType<vtkm::Plane>() && !function.IsType<vtkm::Sphere>()))
+    {
+      return false;
+    }
+    vtkm::Id3 pointDimensions =
+      cellSet.AsCellSet<vtkm::cont::CellSetStructured<3>>().GetPointDimensions();
+
+    using AxisArrayType = vtkm::cont::ArrayHandle<vtkm::FloatDefault>;
+    using RectilinearType =
+      vtkm::cont::ArrayHandleCartesianProduct<AxisArrayType, AxisArrayType, AxisArrayType>;
+    AxisArrayType axes[3];
+    auto coordData = coords.GetData();
+    if (coordData.CanConvert<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+    {
+      auto uniform = coordData.AsArrayHandle<vtkm::cont::ArrayHandleUniformPointCoordinates>();
+      vtkm::Vec3f origin = uniform.ReadPortal().GetOrigin();
+      vtkm::Vec3f spacing = uniform.ReadPortal().GetSpacing();
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleCounting(
+                                origin[axis], spacing[axis], pointDimensions[axis]),
+                              axes[axis]);
+      }
+    }
+    else if (coordData.CanConvert<RectilinearType>())
+    {
+      auto rectilinear = coordData.AsArrayHandle<RectilinearType>();
+      axes[0] = rectilinear.GetFirstArray();
+      axes[1] = rectilinear.GetSecondArray();
+      axes[2] = rectilinear.GetThirdArray();
+    }
+    else
+    {
+      return false;
+    }
+
+    // The search along x needs increasing coordinates.
+    for (const AxisArrayType& axis : axes)
+    {
+      auto portal = axis.ReadPortal();
+      for (vtkm::Id index = 1; index < portal.GetNumberOfValues(); ++index)
+      {
+        if (!(portal.Get(index - 1) < portal.Get(index)))
+        {
+          return false;
+        }
+      }
+    }
+
+    vtkm::Id3 cellDimensions = pointDimensions - vtkm::Id3(1);
+    slice::RowCellRanges ranges = function.IsType<vtkm::Plane>()
+      ? slice::RowCellRanges(cellDimensions, function.Get<vtkm::Plane>())
+      : slice::RowCellRanges(cellDimensions, function.Get<vtkm::Sphere>());
+
+    std::vector<vtkm::Float64> sortedValues(values);
+    std::sort(sortedValues.begin(), sortedValues.end());
+    auto valuesHandle = vtkm::cont::make_ArrayHandle(sortedValues, vtkm::CopyFlag::Off);
+
+    vtkm::cont::ArrayHandleIndex rowIds(cellDimensions[1] * cellDimensions[2]);
+    vtkm::cont::Invoker invoke;
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> numCells;
+    invoke(slice::CountRowCells{ ranges },
+           rowIds,
+           axes[0],
+           axes[1],
+           axes[2],
+           valuesHandle,
+           numCells);
+
+    vtkm::Id totalCells;
+    vtkm::cont::ArrayHandle<vtkm::Id> offsets =
+      vtkm::cont::ConvertNumComponentsToOffsets(numCells, totalCells);
+    numCells.ReleaseResources();
+
+    cellIds.Allocate(totalCells);
+    invoke(slice::ListRowCells{ ranges, cellDimensions[0] },
+           rowIds,
+           axes[0],
+           axes[1],
+           axes[2],
+           valuesHandle,
+           vtkm::cont::make_ArrayHandleGroupVecVariable(cellIds, offsets));
+    return true;
+  }
+};
+
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_SliceCandidateCells_h
@@ -33,6 +33,11 @@ struct CommonState
   vtkm::cont::ArrayHandle<vtkm::FloatDefault> InterpolationWeights;
   vtkm::cont::ArrayHandle<vtkm::Id2> InterpolationEdgeIds;
   vtkm::cont::ArrayHandle<vtkm::Id> CellIdMap;
+
+  // When set, only the cells in CandidateCells are classified. All other cells are assumed
+  // not to cross any isovalue.
+  bool UseCandidateCells = false;
+  vtkm::cont::ArrayHandle<vtkm::Id> CandidateCells;
 };
 }
 }
@@ -18,6 +18,7 @@
 #include <vtkm/filter/contour/worklet/contour/FlyingEdgesPass4.h>
 
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayGetValues.h>
 #include <vtkm/cont/ArrayHandleGroupVec.h>
 #include <vtkm/cont/Invoker.h>
 
@@ -30,12 +31,26 @@ namespace flying_edges
 
 namespace detail
 {
+// Grows the array so that it holds at least `size` values, keeping its contents. The array
+// grows geometrically so that appending the output of each isovalue does not copy the output
+// of all of the previous isovalues every time.
 template <typename T, typename S>
-vtkm::Id extend_by(vtkm::cont::ArrayHandle<T, S>& handle, vtkm::Id size)
+void grow_to(vtkm::cont::ArrayHandle<T, S>& handle, vtkm::Id size)
 {
-  vtkm::Id oldLen = handle.GetNumberOfValues();
-  handle.Allocate(oldLen + size, vtkm::CopyFlag::On);
-  return oldLen;
+  vtkm::Id capacity = handle.GetNumberOfValues();
+  if (size > capacity)
+  {
+    handle.Allocate(vtkm::Max(size, 2 * capacity), vtkm::CopyFlag::On);
+  }
+}
+
+template <typename T, typename S>
+void shrink_to(vtkm::cont::ArrayHandle<T, S>& handle, vtkm::Id size)
+{
+  if (handle.GetNumberOfValues() != size)
+  {
+    handle.Allocate(size, vtkm::CopyFlag::On);
+  }
 }
 }
 
@@ -78,12 +93,32 @@ vtkm::cont::CellSetSingleType<> execute(
   sharedState.InterpolationWeights.ReleaseResources();
   sharedState.CellIdMap.ReleaseResources();
 
+  // An isovalue outside of the range of the field generates nothing, so skip its passes.
+  // A point is above the isovalue when its value is not less than the isovalue, so only the
+  // isovalues in (min, max] generate triangles.
+  IVType fieldMin = 0;
+  IVType fieldMax = 0;
+  if (inputField.GetNumberOfValues() > 0)
+  {
+    const vtkm::Vec<ValueType, 2> initValue(vtkm::cont::ArrayGetValue(0, inputField));
+    const vtkm::Vec<ValueType, 2> fieldRange =
+      vtkm::cont::Algorithm::Reduce(inputField, initValue, vtkm::MinAndMax<ValueType>());
+    fieldMin = static_cast<IVType>(fieldRange[0]);
+    fieldMax = static_cast<IVType>(fieldRange[1]);
+  }
+
   vtkm::cont::ArrayHandle<vtkm::Id> triangle_topology;
+  vtkm::Id numberOfCells = 0;
+  vtkm::Id numberOfPoints = 0;
   for (std::size_t i = 0; i < isovalues.size(); ++i)
   {
-    auto multiContourCellOffset = sharedState.CellIdMap.GetNumberOfValues();
-    auto multiContourPointOffset = sharedState.InterpolationWeights.GetNumberOfValues();
+    auto multiContourCellOffset = numberOfCells;
+    auto multiContourPointOffset = numberOfPoints;
     IVType isoval = isovalues[i];
+    if (!(isoval > fieldMin) || (isoval > fieldMax))
+    {
+      continue;
+    }
 
     //----------------------------------------------------------------------------
     // PASS 1: Process all of the voxel edges that compose each row. Determine the
@@ -138,14 +173,15 @@ vtkm::cont::CellSetSingleType<> execute(
       vtkm::cont::ArrayGetValue(metaDataNumTris.GetNumberOfValues() - 1, metaDataNumTris);
     if (sumTris > 0)
     {
-      detail::extend_by(triangle_topology, 3 * sumTris);
-      detail::extend_by(sharedState.CellIdMap, sumTris);
-
+      numberOfCells += sumTris;
+      detail::grow_to(triangle_topology, 3 * numberOfCells);
+      detail::grow_to(sharedState.CellIdMap, numberOfCells);
 
       vtkm::Id newPointSize =
         vtkm::cont::Algorithm::ScanExclusive(metaDataLinearSums, metaDataLinearSums);
-      detail::extend_by(sharedState.InterpolationEdgeIds, newPointSize);
-      detail::extend_by(sharedState.InterpolationWeights, newPointSize);
+      numberOfPoints += newPointSize;
+      detail::grow_to(sharedState.InterpolationEdgeIds, numberOfPoints);
+      detail::grow_to(sharedState.InterpolationWeights, numberOfPoints);
 
       //----------------------------------------------------------------------------
       // PASS 4: Process voxel rows and generate topology, and interpolation state
@@ -154,10 +190,10 @@ vtkm::cont::CellSetSingleType<> execute(
 
         auto pass4 = launchComputePass4(pdims, multiContourCellOffset, multiContourPointOffset);
 
-        detail::extend_by(points, newPointSize);
+        detail::grow_to(points, numberOfPoints);
         if (sharedState.GenerateNormals)
         {
-          detail::extend_by(normals, newPointSize);
+          detail::grow_to(normals, numberOfPoints);
         }
 
         vtkm::cont::TryExecuteOnDevice(invoke.GetDevice(),
@@ -180,6 +216,16 @@ vtkm::cont::CellSetSingleType<> execute(
     }
   }
 
+  detail::shrink_to(triangle_topology, 3 * numberOfCells);
+  detail::shrink_to(sharedState.CellIdMap, numberOfCells);
+  detail::shrink_to(sharedState.InterpolationEdgeIds, numberOfPoints);
+  detail::shrink_to(sharedState.InterpolationWeights, numberOfPoints);
+  detail::shrink_to(points, numberOfPoints);
+  if (sharedState.GenerateNormals)
+  {
+    detail::shrink_to(normals, numberOfPoints);
+  }
+
   vtkm::cont::CellSetSingleType<> outputCells;
   outputCells.Fill(points.GetNumberOfValues(), vtkm::CELL_SHAPE_TRIANGLE, 3, triangle_topology);
   return outputCells;
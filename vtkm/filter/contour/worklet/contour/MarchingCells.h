@@ -26,6 +26,7 @@
 #include <vtkm/cont/Invoker.h>
 
 #include <vtkm/worklet/Keys.h>
+#include <vtkm/worklet/MaskIndices.h>
 #include <vtkm/worklet/ScatterCounting.h>
 #include <vtkm/worklet/ScatterPermutation.h>
 
@@ -36,6 +37,8 @@
 #include <vtkm/filter/vector_analysis/worklet/gradient/StructuredPointGradient.h>
 #include <vtkm/worklet/WorkletReduceByKey.h>
 
+#include <algorithm>
+
 namespace vtkm
 {
 namespace worklet
@@ -72,6 +75,71 @@ make_ScalarField(const vtkm::cont::ArrayHandle<vtkm::Int8, S>& ah)
   return vtkm::cont::make_ArrayHandleCast(ah, vtkm::FloatDefault());
 }
 
+// ---------------------------------------------------------------------------
+// Returns the index of the first of the sorted isovalues that is not below the given value.
+template <typename IsoValuesType, typename FieldType>
+VTKM_EXEC vtkm::IdComponent FirstIsoValueNotBelow(const IsoValuesType& isovalues,
+                                                  const FieldType& value)
+{
+  vtkm::IdComponent low = 0;
+  vtkm::IdComponent high = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
+  while (low < high)
+  {
+    vtkm::IdComponent mid = (low + high) / 2;
+    if (isovalues.Get(mid) < value)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// ---------------------------------------------------------------------------
+// Counts the triangles generated in a cell by all of the (sorted) isovalues.
+template <typename CellShapeType,
+          typename IsoValuesType,
+          typename FieldInType,
+          typename ClassifyTableType>
+VTKM_EXEC vtkm::IdComponent CountTriangles(CellShapeType shape,
+                                           const IsoValuesType& isovalues,
+                                           const FieldInType& fieldIn,
+                                           const ClassifyTableType& classifyTable)
+{
+  using FieldType = typename vtkm::VecTraits<FieldInType>::ComponentType;
+
+  vtkm::IdComponent sum = 0;
+  vtkm::IdComponent numIsoValues = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
+  vtkm::IdComponent numVerticesPerCell = classifyTable.GetNumVerticesPerCell(shape.Id);
+
+  FieldType minValue = fieldIn[0];
+  FieldType maxValue = fieldIn[0];
+  for (vtkm::IdComponent j = 1; j < numVerticesPerCell; ++j)
+  {
+    minValue = vtkm::Min(minValue, static_cast<FieldType>(fieldIn[j]));
+    maxValue = vtkm::Max(maxValue, static_cast<FieldType>(fieldIn[j]));
+  }
+
+  // The isovalues are sorted. Only those in [minValue, maxValue) cross the cell.
+  for (vtkm::IdComponent i = FirstIsoValueNotBelow(isovalues, minValue);
+       (i < numIsoValues) && (isovalues.Get(i) < maxValue);
+       ++i)
+  {
+    const FieldType ivalue = isovalues.Get(i);
+    vtkm::IdComponent caseNumber = 0;
+    for (vtkm::IdComponent j = 0; j < numVerticesPerCell; ++j)
+    {
+      caseNumber |= (fieldIn[j] > ivalue) << j;
+    }
+
+    sum += classifyTable.GetNumTriangles(shape.Id, caseNumber);
+  }
+  return sum;
+}
+
 // ---------------------------------------------------------------------------
 template <typename T>
 class ClassifyCell : public vtkm::worklet::WorkletVisitCellsWithPoints
@@ -95,21 +163,37 @@ public:
                             vtkm::IdComponent& numTriangles,
                             const ClassifyTableType& classifyTable) const
   {
-    vtkm::IdComponent sum = 0;
-    vtkm::IdComponent numIsoValues = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
-    vtkm::IdComponent numVerticesPerCell = classifyTable.GetNumVerticesPerCell(shape.Id);
+    numTriangles = CountTriangles(shape, isovalues, fieldIn, classifyTable);
+  }
+};
 
-    for (vtkm::Id i = 0; i < numIsoValues; ++i)
-    {
-      vtkm::IdComponent caseNumber = 0;
-      for (vtkm::IdComponent j = 0; j < numVerticesPerCell; ++j)
-      {
-        caseNumber |= (fieldIn[j] > isovalues.Get(i)) << j;
-      }
+// ---------------------------------------------------------------------------
+// Like ClassifyCell, but visits only the candidate cells given in the mask. The number of
+// triangles of the other cells is left as it is, which must be 0.
+template <typename T>
+class ClassifyCandidateCell : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+  using ControlSignature = void(WholeArrayIn isoValues,
+                                FieldInPoint fieldIn,
+                                CellSetIn cellSet,
+                                FieldInOutCell numTriangles,
+                                ExecObject classifyTable);
+  using ExecutionSignature = void(CellShape, _1, _2, _4, _5);
+  using InputDomain = _3;
+  using MaskType = vtkm::worklet::MaskIndices;
 
-      sum += classifyTable.GetNumTriangles(shape.Id, caseNumber);
-    }
-    numTriangles = sum;
+  template <typename CellShapeType,
+            typename IsoValuesType,
+            typename FieldInType,
+            typename ClassifyTableType>
+  VTKM_EXEC void operator()(CellShapeType shape,
+                            const IsoValuesType& isovalues,
+                            const FieldInType& fieldIn,
+                            vtkm::IdComponent& numTriangles,
+                            const ClassifyTableType& classifyTable) const
+  {
+    numTriangles = CountTriangles(shape, isovalues, fieldIn, classifyTable);
   }
 };
 
@@ -234,11 +318,18 @@ public:
     using FieldType = typename vtkm::VecTraits<FieldInType>::ComponentType;
 
     vtkm::IdComponent sum = 0, caseNumber = 0;
-    vtkm::IdComponent i = 0,
-                      numIsoValues = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
+    vtkm::IdComponent numIsoValues = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
     vtkm::IdComponent numVerticesPerCell = classifyTable.GetNumVerticesPerCell(shape.Id);
 
-    for (i = 0; i < numIsoValues; ++i)
+    FieldType minValue = fieldIn[0];
+    for (vtkm::IdComponent j = 1; j < numVerticesPerCell; ++j)
+    {
+      minValue = vtkm::Min(minValue, static_cast<FieldType>(fieldIn[j]));
+    }
+
+    // Skip the sorted isovalues below the cell, which ClassifyCell did not count.
+    vtkm::IdComponent i = FirstIsoValueNotBelow(isovalues, minValue);
+    for (; i < numIsoValues; ++i)
     {
       const FieldType ivalue = isovalues.Get(i);
       // Compute the Marching Cubes case number for this cell. We need to iterate
@@ -285,30 +376,6 @@ public:
   }
 };
 
-// ---------------------------------------------------------------------------
-struct MultiContourLess
-{
-  template <typename T>
-  VTKM_EXEC_CONT bool operator()(const T& a, const T& b) const
-  {
-    return a < b;
-  }
-
-  template <typename T, typename U>
-  VTKM_EXEC_CONT bool operator()(const vtkm::Pair<T, U>& a, const vtkm::Pair<T, U>& b) const
-  {
-    return (a.first < b.first) || (!(b.first < a.first) && (a.second < b.second));
-  }
-
-  template <typename T, typename U>
-  VTKM_EXEC_CONT bool operator()(const vtkm::internal::ArrayPortalValueReference<T>& a,
-                                 const U& b) const
-  {
-    U&& t = static_cast<U>(a);
-    return t < b;
-  }
-};
-
 // ---------------------------------------------------------------------------
 struct MergeDuplicateValues : vtkm::worklet::WorkletReduceByKey
 {
@@ -336,6 +403,24 @@ struct MergeDuplicateValues : vtkm::worklet::WorkletReduceByKey
   }
 };
 
+// ---------------------------------------------------------------------------
+// Writes the index of the unique key of every value, which is the index of its merged point.
+struct MapToUniqueKeys : vtkm::worklet::WorkletReduceByKey
+{
+  using ControlSignature = void(KeysIn keys, ValuesOut uniqueIndices);
+  using ExecutionSignature = void(InputIndex, _2);
+  using InputDomain = _1;
+
+  template <typename ValuesOutType>
+  VTKM_EXEC void operator()(vtkm::Id uniqueIndex, ValuesOutType& uniqueIndices) const
+  {
+    for (vtkm::IdComponent i = 0; i < uniqueIndices.GetNumberOfComponents(); ++i)
+    {
+      uniqueIndices[i] = uniqueIndex;
+    }
+  }
+};
+
 // ---------------------------------------------------------------------------
 struct CopyEdgeIds : vtkm::worklet::WorkletMapField
 {
@@ -364,7 +449,10 @@ void MergeDuplicates(const vtkm::cont::Invoker& invoker,
 {
   vtkm::cont::ArrayHandle<KeyType> input_keys;
   vtkm::cont::ArrayCopyDevice(original_keys, input_keys);
-  vtkm::worklet::Keys<KeyType> keys(input_keys);
+  // Group the duplicate edges with a hash table rather than sorting them. The merged points
+  // are ordered by the first triangle using them.
+  vtkm::worklet::Keys<KeyType> keys;
+  keys.BuildArrays(input_keys, vtkm::worklet::KeysSortType::Hashed);
   input_keys.ReleaseResources();
 
   {
@@ -377,8 +465,7 @@ void MergeDuplicates(const vtkm::cont::Invoker& invoker,
 
   //need to build the new connectivity
   auto uniqueKeys = keys.GetUniqueKeys();
-  vtkm::cont::Algorithm::LowerBounds(
-    uniqueKeys, original_keys, connectivity, marching_cells::MultiContourLess());
+  invoker(MapToUniqueKeys{}, keys, connectivity);
 
   //update the edge ids
   invoker(CopyEdgeIds{}, uniqueKeys, edgeIds);
@@ -616,12 +703,29 @@ vtkm::cont::CellSetSingleType<> execute(
   // Setup the invoker
   vtkm::cont::Invoker invoker;
 
+  // Sort the isovalues so that each cell can find the ones crossing it by interval rather
+  // than classifying the cell against every isovalue.
+  std::vector<ValueType> sortedIsoValues(isovalues);
+  std::sort(sortedIsoValues.begin(), sortedIsoValues.end());
   vtkm::cont::ArrayHandle<ValueType> isoValuesHandle =
-    vtkm::cont::make_ArrayHandle(isovalues, vtkm::CopyFlag::Off);
+    vtkm::cont::make_ArrayHandle(sortedIsoValues, vtkm::CopyFlag::Off);
 
   // Call the ClassifyCell functor to compute the Marching Cubes case numbers
   // for each cell, and the number of vertices to be generated
   vtkm::cont::ArrayHandle<vtkm::IdComponent> numOutputTrisPerCell;
+  if (sharedState.UseCandidateCells)
+  {
+    // Only the candidate cells can cross an isovalue. None of the others generate triangles.
+    numOutputTrisPerCell.AllocateAndFill(cells.GetNumberOfCells(), 0);
+    invoker(marching_cells::ClassifyCandidateCell<ValueType>{},
+            vtkm::worklet::MaskIndices(sharedState.CandidateCells),
+            isoValuesHandle,
+            inputField,
+            cells,
+            numOutputTrisPerCell,
+            classTable);
+  }
+  else
   {
     marching_cells::ClassifyCell<ValueType> classifyCell;
     invoker(classifyCell, isoValuesHandle, inputField, cells, numOutputTrisPerCell, classTable);
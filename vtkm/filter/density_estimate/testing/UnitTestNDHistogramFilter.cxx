@@ -11,6 +11,9 @@
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/density_estimate/NDHistogram.h>
 
+#include <array>
+#include <map>
+
 namespace
 {
 
@@ -111,9 +114,70 @@ void RunTest()
   }
 }
 
+void RunTestManyBins()
+{
+  // With this many bins the histogram is far sparser than the data, so it is counted in a hash
+  // table instead of a dense array. Compare against counting on the host.
+  const vtkm::Id numberOfBins = 2048;
+  const char* fieldNames[3] = { "fieldA", "fieldB", "fieldC" };
+
+  vtkm::cont::DataSet ds = MakeTestDataSet();
+
+  vtkm::filter::density_estimate::NDHistogram ndHistFilter;
+  for (const char* fieldName : fieldNames)
+  {
+    ndHistFilter.AddFieldAndBin(fieldName, numberOfBins);
+  }
+  vtkm::cont::DataSet outputData = ndHistFilter.Execute(ds);
+
+  std::map<std::array<vtkm::Id, 3>, vtkm::Id> expected;
+  vtkm::Id numberOfValues = ds.GetNumberOfPoints();
+  for (vtkm::Id i = 0; i < numberOfValues; ++i)
+  {
+    std::array<vtkm::Id, 3> bin;
+    for (std::size_t f = 0; f < 3; ++f)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Float32> field;
+      ds.GetField(fieldNames[f]).GetData().AsArrayHandle(field);
+      vtkm::Range range = ndHistFilter.GetDataRange(f);
+      vtkm::Float64 delta = ndHistFilter.GetBinDelta(f);
+      vtkm::Float64 value = static_cast<vtkm::Float64>(field.ReadPortal().Get(i));
+      bin[f] = vtkm::Min(static_cast<vtkm::Id>((value - range.Min) / delta), numberOfBins - 1);
+    }
+    ++expected[bin];
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> binIds[3];
+  for (std::size_t f = 0; f < 3; ++f)
+  {
+    outputData.GetField(fieldNames[f]).GetData().AsArrayHandle(binIds[f]);
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> freqs;
+  outputData.GetField("Frequency").GetData().AsArrayHandle(freqs);
+
+  VTKM_TEST_ASSERT(freqs.GetNumberOfValues() == static_cast<vtkm::Id>(expected.size()),
+                   "Incorrect number of bins in sparse ND-histogram");
+  vtkm::Id i = 0;
+  for (const auto& bin : expected)
+  {
+    VTKM_TEST_ASSERT(binIds[0].ReadPortal().Get(i) == bin.first[0] &&
+                       binIds[1].ReadPortal().Get(i) == bin.first[1] &&
+                       binIds[2].ReadPortal().Get(i) == bin.first[2] &&
+                       freqs.ReadPortal().Get(i) == bin.second,
+                     "Incorrect sparse ND-histogram Filter results");
+    ++i;
+  }
+}
+
+void TestNDHistogramFilter()
+{
+  RunTest();
+  RunTestManyBins();
+}
+
 } // anonymous namespace
 
 int UnitTestNDHistogramFilter(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(RunTest, argc, argv);
+  return vtkm::cont::testing::Testing::Run(TestNDHistogramFilter, argc, argv);
 }
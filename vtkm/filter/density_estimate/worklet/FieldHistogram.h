@@ -16,6 +16,8 @@
 #include <vtkm/cont/ArrayGetValues.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/filter/density_estimate/worklet/histogram/PrivatizedHistogram.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 
@@ -85,6 +87,26 @@ public:
     }
   };
 
+  // Functor that computes the bin of a value on the fly
+  template <typename FieldType>
+  struct ComputeHistogramBin
+  {
+    vtkm::Id NumberOfBins;
+    FieldType MinValue;
+    FieldType Delta;
+
+    VTKM_EXEC_CONT
+    vtkm::Id operator()(const FieldType& value) const
+    {
+      vtkm::Id binIndex = static_cast<vtkm::Id>((value - this->MinValue) / this->Delta);
+      if (binIndex < 0)
+        binIndex = 0;
+      else if (binIndex >= this->NumberOfBins)
+        binIndex = this->NumberOfBins - 1;
+      return binIndex;
+    }
+  };
+
   // Calculate the adjacent difference between values in ArrayHandle
   class AdjacentDifference : public vtkm::worklet::WorkletMapField
   {
@@ -140,31 +162,13 @@ public:
            FieldType& binDelta,
            vtkm::cont::ArrayHandle<vtkm::Id>& binArray)
   {
-    const vtkm::Id numberOfValues = fieldArray.GetNumberOfValues();
-
     const FieldType fieldDelta = compute_delta(fieldMinValue, fieldMaxValue, numberOfBins);
 
-    // Worklet fills in the bin belonging to each value
-    vtkm::cont::ArrayHandle<vtkm::Id> binIndex;
-    binIndex.Allocate(numberOfValues);
-
-    // Worklet to set the bin number for each data value
-    SetHistogramBin<FieldType> binWorklet(numberOfBins, fieldMinValue, fieldDelta);
-    vtkm::worklet::DispatcherMapField<SetHistogramBin<FieldType>> setHistogramBinDispatcher(
-      binWorklet);
-    setHistogramBinDispatcher.Invoke(fieldArray, binIndex);
-
-    // Sort the resulting bin array for counting
-    vtkm::cont::Algorithm::Sort(binIndex);
-
-    // Get the upper bound of each bin number
-    vtkm::cont::ArrayHandle<vtkm::Id> totalCount;
-    vtkm::cont::ArrayHandleCounting<vtkm::Id> binCounter(0, 1, numberOfBins);
-    vtkm::cont::Algorithm::UpperBounds(binIndex, binCounter, totalCount);
-
-    // Difference between adjacent items is the bin count
-    vtkm::worklet::DispatcherMapField<AdjacentDifference> dispatcher;
-    dispatcher.Invoke(binCounter, totalCount, binArray);
+    // Count the values in each bin directly. The bin of each value is computed as it is read,
+    // so the values are neither copied nor sorted.
+    ComputeHistogramBin<FieldType> computeBin{ numberOfBins, fieldMinValue, fieldDelta };
+    auto binIndex = vtkm::cont::make_ArrayHandleTransform(fieldArray, computeBin);
+    vtkm::worklet::histogram::ComputeDenseHistogram(binIndex, numberOfBins, binArray);
 
     //update the users data
     binDelta = fieldDelta;
@@ -19,11 +19,14 @@
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/filter/density_estimate/worklet/histogram/ComputeNDHistogram.h>
+#include <vtkm/filter/density_estimate/worklet/histogram/PrivatizedHistogram.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 
 #include <vtkm/cont/Field.h>
 
+#include <limits>
+
 namespace vtkm
 {
 namespace worklet
@@ -104,12 +107,24 @@ public:
   {
     binId.resize(NumberOfBins.size());
 
-    // Sort the resulting bin(1D) array for counting
-    vtkm::cont::Algorithm::Sort(Bin1DIndex);
+    // Total number of bins in the 1D representation. Saturate on overflow, which still
+    // selects counting with a hash table.
+    const vtkm::Id maxId = std::numeric_limits<vtkm::Id>::max();
+    vtkm::Id totalNumberOfBins = 1;
+    for (vtkm::Id nFieldBins : NumberOfBins)
+    {
+      if ((nFieldBins > 0) && (totalNumberOfBins > maxId / nFieldBins))
+      {
+        totalNumberOfBins = maxId;
+        break;
+      }
+      totalNumberOfBins *= nFieldBins;
+    }
 
-    // Count frequency of each bin
-    vtkm::cont::ArrayHandleConstant<vtkm::Id> constArray(1, NumDataPoints);
-    vtkm::cont::Algorithm::ReduceByKey(Bin1DIndex, constArray, Bin1DIndex, freqs, vtkm::Add());
+    // Count frequency of each nonempty bin
+    vtkm::cont::ArrayHandle<vtkm::Id> bins;
+    vtkm::worklet::histogram::ComputeSparseHistogram(Bin1DIndex, totalNumberOfBins, bins, freqs);
+    Bin1DIndex = bins;
 
     //convert back to multi variate binId
     for (vtkm::Id i = static_cast<vtkm::Id>(NumberOfBins.size()) - 1; i >= 0; i--)
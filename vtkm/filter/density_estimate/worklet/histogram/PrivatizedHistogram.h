@@ -0,0 +1,247 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_worklet_PrivatizedHistogram_h
+#define vtk_m_worklet_PrivatizedHistogram_h
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleZip.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace histogram
+{
+
+// Number of consecutive values counted by one thread before merging its counts.
+constexpr vtkm::Id PRIVATE_HISTOGRAM_BLOCK_SIZE = 1024;
+
+// Histograms with at most this many bins are counted in a private copy per thread.
+constexpr vtkm::Id PRIVATE_HISTOGRAM_MAX_BINS = 256;
+
+// Histograms with more bins than this (and many more bins than values) are counted in a hash
+// table rather than a dense array.
+constexpr vtkm::Id DENSE_HISTOGRAM_MAX_BINS = vtkm::Id(1) << 20;
+
+// Counts the bin indices in one block of values. Small histograms are counted in a private
+// copy of the bins and merged with one atomic add per bin. Larger ones are added atomically
+// straight into the shared counts.
+class CountBinsDense : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockIndex,
+                                WholeArrayIn binIndices,
+                                AtomicArrayInOut counts);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_CONT explicit CountBinsDense(vtkm::Id numberOfBins)
+    : NumberOfBins(numberOfBins)
+  {
+  }
+
+  template <typename BinPortal, typename CountPortal>
+  VTKM_EXEC void operator()(vtkm::Id blockIndex,
+                            const BinPortal& binIndices,
+                            const CountPortal& counts) const
+  {
+    vtkm::Id begin = blockIndex * PRIVATE_HISTOGRAM_BLOCK_SIZE;
+    vtkm::Id end =
+      vtkm::Min(begin + PRIVATE_HISTOGRAM_BLOCK_SIZE, binIndices.GetNumberOfValues());
+
+    if (this->NumberOfBins <= PRIVATE_HISTOGRAM_MAX_BINS)
+    {
+      vtkm::Id localCounts[PRIVATE_HISTOGRAM_MAX_BINS];
+      for (vtkm::Id bin = 0; bin < this->NumberOfBins; ++bin)
+      {
+        localCounts[bin] = 0;
+      }
+      for (vtkm::Id index = begin; index < end; ++index)
+      {
+        ++localCounts[binIndices.Get(index)];
+      }
+      for (vtkm::Id bin = 0; bin < this->NumberOfBins; ++bin)
+      {
+        if (localCounts[bin] > 0)
+        {
+          counts.Add(bin, localCounts[bin]);
+        }
+      }
+    }
+    else
+    {
+      for (vtkm::Id index = begin; index < end; ++index)
+      {
+        counts.Add(binIndices.Get(index), 1);
+      }
+    }
+  }
+
+private:
+  vtkm::Id NumberOfBins;
+};
+
+// Counts the bin indices in one block of values into an open addressing hash table. Runs of
+// the same bin are counted privately and added to the table together.
+class CountBinsHashed : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn blockIndex,
+                                WholeArrayIn binIndices,
+                                AtomicArrayInOut keys,
+                                AtomicArrayInOut counts);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  template <typename BinPortal, typename KeyPortal, typename CountPortal>
+  VTKM_EXEC void operator()(vtkm::Id blockIndex,
+                            const BinPortal& binIndices,
+                            const KeyPortal& keys,
+                            const CountPortal& counts) const
+  {
+    vtkm::Id begin = blockIndex * PRIVATE_HISTOGRAM_BLOCK_SIZE;
+    vtkm::Id end =
+      vtkm::Min(begin + PRIVATE_HISTOGRAM_BLOCK_SIZE, binIndices.GetNumberOfValues());
+
+    vtkm::Id runBin = -1;
+    vtkm::Id runCount = 0;
+    for (vtkm::Id index = begin; index < end; ++index)
+    {
+      vtkm::Id bin = binIndices.Get(index);
+      if (bin != runBin)
+      {
+        this->Insert(keys, counts, runBin, runCount);
+        runBin = bin;
+        runCount = 0;
+      }
+      ++runCount;
+    }
+    this->Insert(keys, counts, runBin, runCount);
+  }
+
+private:
+  template <typename KeyPortal, typename CountPortal>
+  VTKM_EXEC static void Insert(const KeyPortal& keys,
+                               const CountPortal& counts,
+                               vtkm::Id bin,
+                               vtkm::Id count)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    // The table size is a power of 2.
+    vtkm::Id mask = keys.GetNumberOfValues() - 1;
+    vtkm::UInt64 hash = static_cast<vtkm::UInt64>(bin) * 0x9E3779B97F4A7C15ULL;
+    vtkm::Id slot = static_cast<vtkm::Id>(hash >> 32) & mask;
+    while (true)
+    {
+      vtkm::Id current = -1;
+      if (keys.CompareExchange(slot, &current, bin) || (current == bin))
+      {
+        counts.Add(slot, count);
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+};
+
+struct IsNonZero
+{
+  VTKM_EXEC_CONT bool operator()(vtkm::Id value) const { return value != 0; }
+};
+
+struct IsUsedSlot
+{
+  VTKM_EXEC_CONT bool operator()(vtkm::Id key) const { return key >= 0; }
+};
+
+/// \brief Counts the number of values in each bin of a histogram.
+///
+/// `binIndices` gives the bin of each value and must be in [0, `numberOfBins`). It can be a
+/// fancy array (such as an `ArrayHandleTransform`) that computes the bins on the fly. The
+/// result has one count for every bin. The values are counted in a single pass without
+/// sorting.
+///
+template <typename BinIndexArrayType>
+VTKM_CONT void ComputeDenseHistogram(const BinIndexArrayType& binIndices,
+                                     vtkm::Id numberOfBins,
+                                     vtkm::cont::ArrayHandle<vtkm::Id>& counts)
+{
+  vtkm::Id numberOfBlocks = (binIndices.GetNumberOfValues() + PRIVATE_HISTOGRAM_BLOCK_SIZE - 1) /
+    PRIVATE_HISTOGRAM_BLOCK_SIZE;
+  counts.AllocateAndFill(numberOfBins, 0);
+  vtkm::cont::Invoker{}(CountBinsDense{ numberOfBins },
+                        vtkm::cont::ArrayHandleIndex(numberOfBlocks),
+                        binIndices,
+                        counts);
+}
+
+/// \brief Counts the number of values in each nonempty bin of a histogram.
+///
+/// This is like `ComputeDenseHistogram` except that only the bins holding at least one value
+/// are returned, in increasing order of bin. When there are far more bins than values (as
+/// happens in histograms of many dimensions), the values are counted in a hash table sized
+/// by the number of values rather than by the number of bins. Only the nonempty bins are
+/// sorted. Pass the largest `vtkm::Id` for `numberOfBins` if the count of bins overflows.
+///
+template <typename BinIndexArrayType>
+VTKM_CONT void ComputeSparseHistogram(const BinIndexArrayType& binIndices,
+                                      vtkm::Id numberOfBins,
+                                      vtkm::cont::ArrayHandle<vtkm::Id>& bins,
+                                      vtkm::cont::ArrayHandle<vtkm::Id>& counts)
+{
+  vtkm::Id numberOfValues = binIndices.GetNumberOfValues();
+  auto output = vtkm::cont::make_ArrayHandleZip(bins, counts);
+  if ((numberOfBins <= DENSE_HISTOGRAM_MAX_BINS) || (numberOfBins <= 2 * numberOfValues))
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> denseCounts;
+    ComputeDenseHistogram(binIndices, numberOfBins, denseCounts);
+    vtkm::cont::Algorithm::CopyIf(
+      vtkm::cont::make_ArrayHandleZip(vtkm::cont::ArrayHandleIndex(numberOfBins), denseCounts),
+      denseCounts,
+      output,
+      IsNonZero{});
+    return;
+  }
+
+  // There are at most as many nonempty bins as values. Keep the table at most half full.
+  vtkm::Id tableSize = 1;
+  while (tableSize < 2 * numberOfValues)
+  {
+    tableSize *= 2;
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> keys;
+  vtkm::cont::ArrayHandle<vtkm::Id> tableCounts;
+  keys.AllocateAndFill(tableSize, -1);
+  tableCounts.AllocateAndFill(tableSize, 0);
+
+  vtkm::Id numberOfBlocks =
+    (numberOfValues + PRIVATE_HISTOGRAM_BLOCK_SIZE - 1) / PRIVATE_HISTOGRAM_BLOCK_SIZE;
+  vtkm::cont::Invoker{}(CountBinsHashed{},
+                        vtkm::cont::ArrayHandleIndex(numberOfBlocks),
+                        binIndices,
+                        keys,
+                        tableCounts);
+
+  vtkm::cont::Algorithm::CopyIf(
+    vtkm::cont::make_ArrayHandleZip(keys, tableCounts), keys, output, IsUsedSlot{});
+  vtkm::cont::Algorithm::SortByKey(bins, counts);
+}
+
+}
+}
+} // namespace vtkm::worklet::histogram
+
+#endif // vtk_m_worklet_PrivatizedHistogram_h
@@ -11,6 +11,7 @@
 #include <vtkm/filter/entity_extraction/Threshold.h>
 #include <vtkm/filter/entity_extraction/worklet/Threshold.h>
 
+#include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/cont/Invoker.h>
 
 #include <vtkm/BinaryPredicates.h>
@@ -130,6 +131,24 @@ vtkm::cont::DataSet Threshold::DoExecute(const vtkm::cont::DataSet& input)
   vtkm::worklet::Threshold worklet;
   vtkm::cont::UnknownCellSet cellOut;
 
+  // The index only holds the first component of the field and only finds cells that can pass.
+  bool testsFirstComponent = (this->SelectedComponent == 0) &&
+    ((this->ComponentMode == Component::Selected) ||
+     (field.GetData().GetNumberOfComponents() == 1));
+  if (this->UseValueRangeIndex && !this->Invert && testsFirstComponent)
+  {
+    const vtkm::cont::Field& indexedField = this->ValueRangeIndex.GetField();
+    if ((indexedField.GetName() != field.GetName()) ||
+        (indexedField.GetAssociation() != field.GetAssociation()) ||
+        (this->ValueRangeIndex.GetCellSet().GetNumberOfCells() != cells.GetNumberOfCells()))
+    {
+      throw vtkm::cont::ErrorFilterExecution(
+        "The cell value range index does not match the input cells and field.");
+    }
+    worklet.SetCandidateCellIds(this->ValueRangeIndex.FindCandidateCells(
+      vtkm::Range(this->GetLowerThreshold(), this->GetUpperThreshold())));
+  }
+
   auto callWithArrayBaseComponent = [&](auto baseComp) {
     using ComponentType = decltype(baseComp);
     if (!field.GetData().IsBaseComponentType<ComponentType>())
@@ -11,6 +11,7 @@
 #ifndef vtk_m_filter_entity_extraction_Threshold_h
 #define vtk_m_filter_entity_extraction_Threshold_h
 
+#include <vtkm/cont/CellValueRangeIndex.h>
 #include <vtkm/filter/FilterField.h>
 #include <vtkm/filter/entity_extraction/vtkm_filter_entity_extraction_export.h>
 
@@ -106,6 +107,36 @@ public:
   /// @copydoc SetInvert
   VTKM_CONT bool GetInvert() const { return this->Invert; }
 
+  /// @brief Use an index of the field values to skip cells that cannot pass.
+  ///
+  /// A `vtkm::cont::CellValueRangeIndex` built over the cells of the input and the active
+  /// field lets the filter test only the cells near the threshold range, which is much
+  /// faster when the same field is thresholded many times. The index is built the first time
+  /// it is used and kept by the filter for later executions. An index that does not match
+  /// the input (a different field or number of cells) causes an error when the filter
+  /// executes.
+  ///
+  /// The index holds the values of the first component of the field. It is not used when
+  /// testing other components or when the result is inverted.
+  VTKM_CONT void SetCellValueRangeIndex(const vtkm::cont::CellValueRangeIndex& index)
+  {
+    this->ValueRangeIndex = index;
+    this->UseValueRangeIndex = true;
+  }
+  /// @brief Stop using an index of the field values.
+  VTKM_CONT void ClearCellValueRangeIndex()
+  {
+    this->ValueRangeIndex = vtkm::cont::CellValueRangeIndex{};
+    this->UseValueRangeIndex = false;
+  }
+  /// @copydoc SetCellValueRangeIndex
+  VTKM_CONT const vtkm::cont::CellValueRangeIndex& GetCellValueRangeIndex() const
+  {
+    return this->ValueRangeIndex;
+  }
+  /// @brief Get whether an index of the field values is used.
+  VTKM_CONT bool GetUseCellValueRangeIndex() const { return this->UseValueRangeIndex; }
+
 private:
   VTKM_CONT
   vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
@@ -125,6 +156,9 @@ private:
 
   bool AllInRange = false;
   bool Invert = false;
+
+  vtkm::cont::CellValueRangeIndex ValueRangeIndex;
+  bool UseValueRangeIndex = false;
 };
 } // namespace entity_extraction
 } // namespace filter
@@ -8,6 +8,7 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
@@ -50,6 +51,17 @@ vtkm::cont::DataSet MakeDataTestSet5()
   return MakeTestDataSet().Make3DExplicitDataSet6();
 }
 
+// the 5x5x5 uniform grid with explicit (curvilinear) point coordinates
+vtkm::cont::DataSet MakeDataTestSet6()
+{
+  vtkm::cont::DataSet ds = MakeTestDataSet().Make3DUniformDataSet1();
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> coords;
+  vtkm::cont::ArrayCopy(ds.GetCoordinateSystem().GetData(), coords);
+  ds.AddCoordinateSystem(vtkm::cont::CoordinateSystem(ds.GetCoordinateSystem().GetName(), coords));
+  return ds;
+}
+
 void TestExternalFacesExplicitGrid(const vtkm::cont::DataSet& ds,
                                    bool compactPoints,
                                    vtkm::Id numExpectedExtFaces,
@@ -121,6 +133,16 @@ void TestWithRectilinearMesh()
   TestExternalFacesExplicitGrid(ds, true, 16, 18);
 }
 
+void TestWithCurvilinearMesh()
+{
+  std::cout << "Testing with Curvilinear mesh\n";
+  vtkm::cont::DataSet ds = MakeDataTestSet6();
+  std::cout << "Compact Points Off\n";
+  TestExternalFacesExplicitGrid(ds, false, 16 * 6);
+  std::cout << "Compact Points On\n";
+  TestExternalFacesExplicitGrid(ds, true, 16 * 6, 98);
+}
+
 void TestWithMixed2Dand3DMesh()
 {
   std::cout << "Testing with mixed poly data and 3D mesh\n";
@@ -141,6 +163,7 @@ void TestExternalFacesFilter()
   TestWithHexahedraMesh();
   TestWithUniformMesh();
   TestWithRectilinearMesh();
+  TestWithCurvilinearMesh();
   TestWithMixed2Dand3DMesh();
 }
 
@@ -8,7 +8,9 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/CellValueRangeIndex.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/clean_grid/CleanGrid.h>
@@ -332,6 +334,73 @@ public:
     VTKM_TEST_ASSERT(numOutputCells == 2, "Wrong number of cells in the output");
   }
 
+  static void TestCellValueRangeIndex()
+  {
+    std::cout << "Testing threshold with a cell value range index" << std::endl;
+    vtkm::cont::DataSet dataset = MakeTestDataSet().Make3DUniformDataSet3({ 20, 15, 10 });
+
+    for (const std::string fieldName : { "pointvar", "cellvar" })
+    {
+      vtkm::filter::entity_extraction::Threshold plain;
+      plain.SetActiveField(fieldName);
+      plain.SetFieldsToPass("cellvar");
+
+      vtkm::cont::CellValueRangeIndex index;
+      index.SetCellSet(dataset.GetCellSet());
+      index.SetField(dataset.GetField(fieldName));
+      index.SetBlockSize(8);
+      vtkm::filter::entity_extraction::Threshold indexed = plain;
+      indexed.SetCellValueRangeIndex(index);
+
+      vtkm::Range range = dataset.GetField(fieldName).GetRange().ReadPortal().Get(0);
+      for (bool allInRange : { false, true })
+      {
+        for (bool invert : { false, true })
+        {
+          for (vtkm::Float64 fraction : { 0.1, 0.5, 0.9 })
+          {
+            vtkm::Float64 lower = range.Min + fraction * range.Length();
+            plain.SetThresholdBetween(lower, lower + 0.2 * range.Length());
+            indexed.SetThresholdBetween(lower, lower + 0.2 * range.Length());
+            plain.SetAllInRange(allInRange);
+            indexed.SetAllInRange(allInRange);
+            plain.SetInvert(invert);
+            indexed.SetInvert(invert);
+
+            vtkm::cont::DataSet expected = plain.Execute(dataset);
+            vtkm::cont::DataSet result = indexed.Execute(dataset);
+            VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                             "Wrong number of cells with index");
+            VTKM_TEST_ASSERT(
+              test_equal_ArrayHandles(result.GetField("cellvar").GetData(),
+                                      expected.GetField("cellvar").GetData()),
+              "Wrong cell field with index");
+          }
+        }
+      }
+      VTKM_TEST_ASSERT(!indexed.GetCellValueRangeIndex().GetModified(), "Index not kept");
+    }
+
+    // An index of another field is an error.
+    vtkm::cont::CellValueRangeIndex index;
+    index.SetCellSet(dataset.GetCellSet());
+    index.SetField(dataset.GetField("cellvar"));
+    vtkm::filter::entity_extraction::Threshold threshold;
+    threshold.SetActiveField("pointvar");
+    threshold.SetThresholdBetween(0, 1);
+    threshold.SetCellValueRangeIndex(index);
+    bool threw = false;
+    try
+    {
+      threshold.Execute(dataset);
+    }
+    catch (const vtkm::cont::ErrorFilterExecution&)
+    {
+      threw = true;
+    }
+    VTKM_TEST_ASSERT(threw, "Mismatched index not detected");
+  }
+
   void operator()() const
   {
     TestingThreshold::TestRegular2D(false);
@@ -342,6 +411,7 @@ public:
     TestingThreshold::TestExplicit3DZeroResults();
     TestingThreshold::TestAllOptions();
     TestingThreshold::RegressionTest804();
+    TestingThreshold::TestCellValueRangeIndex();
   }
 };
 }
@@ -28,6 +28,7 @@
 #include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/ArrayHandleView.h>
 #include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/cont/ConvertNumComponentsToOffsets.h>
@@ -336,21 +337,118 @@ struct ExternalFaces
     }
   };
 
+  // Worklet that finds the faces of each cell that might be external. A face that matches
+  // exactly one other face is internal. Such faces are found by looking only at the cells
+  // incident to the first point of the face, so only the remaining faces need to be hashed.
+  // Faces are compared by their canonical ids, just as they are after hashing.
+  class NumCandidateFacesPerCell : public vtkm::worklet::WorkletVisitCellsWithPoints
+  {
+  public:
+    using ControlSignature = void(CellSetIn inCellSet,
+                                  WholeCellSetIn<Cell, Point> cellsToPoints,
+                                  WholeCellSetIn<Point, Cell> pointsToCells,
+                                  FieldOut numCandidateFaces,
+                                  FieldOut candidateFaceMask);
+    using ExecutionSignature = void(CellShape, PointIndices, InputIndex, _2, _3, _4, _5);
+    using InputDomain = _1;
+
+    template <typename IndicesVecType>
+    VTKM_EXEC static bool HasPoint(const IndicesVecType& pointIds, vtkm::Id pointId)
+    {
+      for (vtkm::IdComponent index = 0; index < pointIds.GetNumberOfComponents(); ++index)
+      {
+        if (pointIds[index] == pointId)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <typename CellShapeTag,
+              typename CellNodeVecType,
+              typename CellsToPointsType,
+              typename PointsToCellsType>
+    VTKM_EXEC void operator()(CellShapeTag shape,
+                              const CellNodeVecType& cellNodeIds,
+                              vtkm::Id cellIndex,
+                              const CellsToPointsType& cellsToPoints,
+                              const PointsToCellsType& pointsToCells,
+                              vtkm::IdComponent& numCandidateFaces,
+                              vtkm::UInt8& candidateFaceMask) const
+    {
+      numCandidateFaces = 0;
+      candidateFaceMask = 0;
+
+      vtkm::IdComponent numFaces;
+      vtkm::exec::CellFaceNumberOfFaces(shape, numFaces);
+      VTKM_ASSERT(numFaces <= 8);
+      for (vtkm::IdComponent faceIndex = 0; faceIndex < numFaces; ++faceIndex)
+      {
+        vtkm::Id3 faceId;
+        vtkm::exec::CellFaceCanonicalId(faceIndex, shape, cellNodeIds, faceId);
+
+        // Any face with the same canonical id belongs to a cell that has all three points
+        // of the id, so it is enough to search the cells incident to the first of them.
+        vtkm::IdComponent numMatches = 0;
+        auto incidentCells = pointsToCells.GetIndices(faceId[0]);
+        for (vtkm::IdComponent incidentIndex = 0;
+             incidentIndex < incidentCells.GetNumberOfComponents();
+             ++incidentIndex)
+        {
+          vtkm::Id otherCell = incidentCells[incidentIndex];
+          auto otherNodeIds = cellsToPoints.GetIndices(otherCell);
+          if (!HasPoint(otherNodeIds, faceId[1]) || !HasPoint(otherNodeIds, faceId[2]))
+          {
+            continue;
+          }
+
+          auto otherShape = cellsToPoints.GetCellShape(otherCell);
+          vtkm::IdComponent numOtherFaces;
+          vtkm::exec::CellFaceNumberOfFaces(otherShape, numOtherFaces);
+          for (vtkm::IdComponent otherFace = 0; otherFace < numOtherFaces; ++otherFace)
+          {
+            if ((otherCell == cellIndex) && (otherFace == faceIndex))
+            {
+              continue;
+            }
+            vtkm::Id3 otherFaceId;
+            vtkm::exec::CellFaceCanonicalId(otherFace, otherShape, otherNodeIds, otherFaceId);
+            if (otherFaceId == faceId)
+            {
+              ++numMatches;
+            }
+          }
+        }
+
+        if (numMatches != 1)
+        {
+          ++numCandidateFaces;
+          candidateFaceMask |= static_cast<vtkm::UInt8>(1 << faceIndex);
+        }
+      }
+    }
+  };
+
   //Worklet that identifies a cell face by a hash value. Not necessarily completely unique.
+  //Only the faces flagged in the candidate mask of each cell are visited.
   class FaceHash : public vtkm::worklet::WorkletVisitCellsWithPoints
   {
   public:
     using ControlSignature = void(CellSetIn cellset,
+                                  FieldInCell candidateFaceMask,
                                   FieldOut faceHashes,
                                   FieldOut originCells,
                                   FieldOut originFaces);
-    using ExecutionSignature = void(_2, _3, _4, CellShape, PointIndices, InputIndex, VisitIndex);
+    using ExecutionSignature =
+      void(_2, _3, _4, _5, CellShape, PointIndices, InputIndex, VisitIndex);
     using InputDomain = _1;
 
     using ScatterType = vtkm::worklet::ScatterCounting;
 
     template <typename CellShapeTag, typename CellNodeVecType>
-    VTKM_EXEC void operator()(vtkm::HashType& faceHash,
+    VTKM_EXEC void operator()(vtkm::UInt8 candidateFaceMask,
+                              vtkm::HashType& faceHash,
                               vtkm::Id& cellIndex,
                               vtkm::IdComponent& faceIndex,
                               CellShapeTag shape,
@@ -358,12 +456,25 @@ struct ExternalFaces
                               vtkm::Id inputIndex,
                               vtkm::IdComponent visitIndex) const
     {
+      // Find the face of the visitIndex-th bit set in the mask.
+      faceIndex = 0;
+      for (vtkm::IdComponent numSkipped = 0;; ++faceIndex)
+      {
+        if ((candidateFaceMask & (1 << faceIndex)) != 0)
+        {
+          if (numSkipped == visitIndex)
+          {
+            break;
+          }
+          ++numSkipped;
+        }
+      }
+
       vtkm::Id3 faceId;
-      vtkm::exec::CellFaceCanonicalId(visitIndex, shape, cellNodeIds, faceId);
+      vtkm::exec::CellFaceCanonicalId(faceIndex, shape, cellNodeIds, faceId);
       faceHash = vtkm::Hash(faceId);
 
       cellIndex = inputIndex;
-      faceIndex = visitIndex;
     }
   };
 
@@ -682,8 +793,10 @@ public:
   ///////////////////////////////////////////////////
   /// \brief ExternalFaces: Extract Faces on outside of geometry for regular grids.
   ///
-  /// Faster Run() method for uniform and rectilinear grid types.
-  /// Uses grid extents to find cells on the boundaries of the grid.
+  /// Faster Run() method for structured grids.
+  /// Uses grid extents to find cells on the boundaries of the grid. For uniform and
+  /// rectilinear coordinates the extents are those of the point coordinates. For any other
+  /// (curvilinear) coordinates the extents are those of the logical point indices.
   template <typename ShapeStorage, typename ConnectivityStorage, typename OffsetsStorage>
   VTKM_CONT void Run(
     const vtkm::cont::CellSetStructured<3>& inCellSet,
@@ -708,6 +821,14 @@ public:
       MinPoint = tmp[0];
       MaxPoint = tmp[1];
     }
+    else if (!coordData.CanConvert<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+    {
+      // The boundary of a curvilinear grid is the boundary of its index space.
+      vtkm::cont::ArrayHandleUniformPointCoordinates logicalCoords(PointDimensions);
+      MinPoint = vtkm::Vec3f_64(0.0);
+      MaxPoint = logicalCoords.ReadPortal().Get(logicalCoords.GetNumberOfValues() - 1);
+      coordData = logicalCoords;
+    }
     else
     {
       auto vertices = coordData.AsArrayHandle<vtkm::cont::ArrayHandleUniformPointCoordinates>();
@@ -780,11 +901,13 @@ public:
     using OffsetsArrayType = vtkm::cont::ArrayHandle<vtkm::Id, OffsetsStorage>;
     using ConnectivityArrayType = vtkm::cont::ArrayHandle<vtkm::Id, ConnectivityStorage>;
 
-    //Create a worklet to map the number of faces to each cell
+    //Find the faces of each cell that are not obviously shared with a neighbor. Only these
+    //faces are hashed to find the external faces.
     vtkm::cont::ArrayHandle<vtkm::IdComponent> facesPerCell;
-    vtkm::worklet::DispatcherMapTopology<NumFacesPerCell> numFacesDispatcher;
+    vtkm::cont::ArrayHandle<vtkm::UInt8> candidateFaceMasks;
+    vtkm::worklet::DispatcherMapTopology<NumCandidateFacesPerCell> numFacesDispatcher;
 
-    numFacesDispatcher.Invoke(inCellSet, facesPerCell);
+    numFacesDispatcher.Invoke(inCellSet, inCellSet, inCellSet, facesPerCell, candidateFaceMasks);
 
     vtkm::worklet::ScatterCounting scatterCellToFace(facesPerCell);
     facesPerCell.ReleaseResources();
@@ -833,7 +956,7 @@ public:
     {
       if (!polyDataConnectivitySize)
       {
-        // Data has no faces. Output is empty.
+        // Data has no external faces. Output is empty.
         outCellSet.PrepareToAddCells(0, 0);
         outCellSet.CompleteAddingCells(inCellSet.GetNumberOfPoints());
         return;
@@ -853,9 +976,12 @@ public:
     vtkm::cont::ArrayHandle<vtkm::IdComponent> originFaces;
     vtkm::worklet::DispatcherMapTopology<FaceHash> faceHashDispatcher(scatterCellToFace);
 
-    faceHashDispatcher.Invoke(inCellSet, faceHashes, originCells, originFaces);
+    faceHashDispatcher.Invoke(inCellSet, candidateFaceMasks, faceHashes, originCells, originFaces);
+    candidateFaceMasks.ReleaseResources();
 
-    vtkm::worklet::Keys<vtkm::HashType> faceKeys(faceHashes);
+    // Group the faces with a hash table rather than sorting the hashes.
+    vtkm::worklet::Keys<vtkm::HashType> faceKeys;
+    faceKeys.BuildArrays(faceHashes, vtkm::worklet::KeysSortType::Hashed);
 
     vtkm::cont::ArrayHandle<vtkm::IdComponent> faceOutputCount;
     vtkm::worklet::DispatcherReduceByKey<FaceCounts> faceCountDispatcher;
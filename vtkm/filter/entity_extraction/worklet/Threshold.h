@@ -17,6 +17,7 @@
 #include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
 #include <vtkm/cont/CellSetPermutation.h>
 #include <vtkm/cont/Field.h>
@@ -91,27 +92,30 @@ public:
     using OutputType = vtkm::cont::CellSetPermutation<CellSetType>;
 
     vtkm::cont::ArrayHandle<bool> passFlags;
-    switch (fieldType)
+    if (this->UseCandidateCells && !invert)
     {
-      case vtkm::cont::Field::Association::Points:
+      // Only test the candidate cells. All others are known to fail.
+      OutputType candidateCells(this->CandidateCellIds, cellSet);
+      if (fieldType == vtkm::cont::Field::Association::Cells)
       {
-        using ThresholdWorklet = ThresholdByPointField<UnaryPredicate>;
-
-        ThresholdWorklet worklet(predicate, allPointsMustPass);
-        DispatcherMapTopology<ThresholdWorklet> dispatcher(worklet);
-        dispatcher.Invoke(cellSet, field, passFlags);
-        break;
+        ComputePassFlags(candidateCells,
+                         vtkm::cont::make_ArrayHandlePermutation(this->CandidateCellIds, field),
+                         fieldType,
+                         predicate,
+                         allPointsMustPass,
+                         passFlags);
       }
-      case vtkm::cont::Field::Association::Cells:
+      else
       {
-        vtkm::cont::Algorithm::Copy(vtkm::cont::make_ArrayHandleTransform(field, predicate),
-                                    passFlags);
-        break;
+        ComputePassFlags(
+          candidateCells, field, fieldType, predicate, allPointsMustPass, passFlags);
       }
-      default:
-        throw vtkm::cont::ErrorBadValue("Expecting point or cell field.");
+      vtkm::cont::Algorithm::CopyIf(this->CandidateCellIds, passFlags, this->ValidCellIds);
+      return OutputType(this->ValidCellIds, cellSet);
     }
 
+    ComputePassFlags(cellSet, field, fieldType, predicate, allPointsMustPass, passFlags);
+
     if (invert)
     {
       vtkm::cont::Algorithm::Copy(
@@ -143,8 +147,48 @@ public:
 
   vtkm::cont::ArrayHandle<vtkm::Id> GetValidCellIds() const { return this->ValidCellIds; }
 
+  // Only test the given cells, which must be sorted and include every cell that can pass.
+  // The candidates are not used when the result is inverted.
+  void SetCandidateCellIds(const vtkm::cont::ArrayHandle<vtkm::Id>& cellIds)
+  {
+    this->CandidateCellIds = cellIds;
+    this->UseCandidateCells = true;
+  }
+
 private:
+  template <typename CellSetType, typename FieldArrayType, typename UnaryPredicate>
+  static void ComputePassFlags(const CellSetType& cellSet,
+                               const FieldArrayType& field,
+                               vtkm::cont::Field::Association fieldType,
+                               const UnaryPredicate& predicate,
+                               bool allPointsMustPass,
+                               vtkm::cont::ArrayHandle<bool>& passFlags)
+  {
+    switch (fieldType)
+    {
+      case vtkm::cont::Field::Association::Points:
+      {
+        using ThresholdWorklet = ThresholdByPointField<UnaryPredicate>;
+
+        ThresholdWorklet worklet(predicate, allPointsMustPass);
+        DispatcherMapTopology<ThresholdWorklet> dispatcher(worklet);
+        dispatcher.Invoke(cellSet, field, passFlags);
+        break;
+      }
+      case vtkm::cont::Field::Association::Cells:
+      {
+        vtkm::cont::Algorithm::Copy(vtkm::cont::make_ArrayHandleTransform(field, predicate),
+                                    passFlags);
+        break;
+      }
+      default:
+        throw vtkm::cont::ErrorBadValue("Expecting point or cell field.");
+    }
+  }
+
   vtkm::cont::ArrayHandle<vtkm::Id> ValidCellIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> CandidateCellIds;
+  bool UseCandidateCells = false;
 };
 }
 } // namespace vtkm::worklet
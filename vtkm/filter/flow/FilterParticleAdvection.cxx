@@ -57,6 +57,16 @@ VTKM_CONT void FilterParticleAdvection::ValidateOptions() const
     throw vtkm::cont::ErrorFilterExecution("NumberOfSteps cannot be negative");
   if (this->StepSize < 0)
     throw vtkm::cont::ErrorFilterExecution("StepSize cannot be negative");
+  if (this->ParticleReorderInterval < 0)
+    throw vtkm::cont::ErrorFilterExecution("ParticleReorderInterval cannot be negative");
+  if (this->SolverType == vtkm::filter::flow::IntegrationSolverType::RK45_TYPE)
+  {
+    if (this->ErrorTolerance <= 0)
+      throw vtkm::cont::ErrorFilterExecution("ErrorTolerance must be positive");
+    if (this->MinimumStepSize > 0 && this->MaximumStepSize > 0 &&
+        this->MinimumStepSize > this->MaximumStepSize)
+      throw vtkm::cont::ErrorFilterExecution("MinimumStepSize exceeds MaximumStepSize");
+  }
 }
 
 }
@@ -83,12 +83,80 @@ public:
     this->SolverType = vtkm::filter::flow::IntegrationSolverType::EULER_TYPE;
   }
 
+  /// @brief Use the adaptive Runge-Kutta solver of Dormand and Prince.
+  ///
+  /// This solver estimates the error of each step with an embedded fourth order solution
+  /// and adapts the length of the steps to keep the error within `SetErrorTolerance`.
+  /// The step size set with `SetStepSize` is the length of the first step of each
+  /// particle, and each step counts toward `SetNumberOfSteps`.
+  VTKM_CONT
+  void SetSolverRK45()
+  {
+    this->SolverType = vtkm::filter::flow::IntegrationSolverType::RK45_TYPE;
+  }
+
+  /// @brief Specifies the largest error allowed in one step of an adaptive solver.
+  ///
+  /// The error is the distance between the fifth and fourth order positions at the end
+  /// of a step, in the units of the coordinates. The default is 1e-6.
+  VTKM_CONT void SetErrorTolerance(vtkm::FloatDefault tol) { this->ErrorTolerance = tol; }
+
+  /// @brief Specifies the shortest step an adaptive solver may take.
+  ///
+  /// A step of this length is taken even when its error exceeds the tolerance. If this
+  /// is not positive (the default), it is 1/1000 of the step size.
+  VTKM_CONT void SetMinimumStepSize(vtkm::FloatDefault s) { this->MinimumStepSize = s; }
+
+  /// @brief Specifies the longest step an adaptive solver may take.
+  ///
+  /// If this is not positive (the default), it is 100 times the step size.
+  VTKM_CONT void SetMaximumStepSize(vtkm::FloatDefault s) { this->MaximumStepSize = s; }
+
+  /// @brief Specifies how often the particles are sorted by position during advection.
+  ///
+  /// If this is positive, the particles of each block are sorted along a Morton curve
+  /// through their positions before they are advected, and the particles still moving are
+  /// sorted again after every `interval` steps. Nearby particles are then advected
+  /// together, which makes the cell and field lookups much more cache friendly when the
+  /// seeds are in no particular order. If this is 0 (the default), the particles are
+  /// advected in seed order.
+  VTKM_CONT void SetParticleReorderInterval(vtkm::Id interval)
+  {
+    this->ParticleReorderInterval = interval;
+  }
+  /// @copydoc SetParticleReorderInterval
+  VTKM_CONT vtkm::Id GetParticleReorderInterval() const { return this->ParticleReorderInterval; }
+
   VTKM_CONT
   bool GetUseThreadedAlgorithm() { return this->UseThreadedAlgorithm; }
 
   VTKM_CONT
   void SetUseThreadedAlgorithm(bool val) { this->UseThreadedAlgorithm = val; }
 
+  /// @brief Specifies the number of threads that advect particles in the threaded algorithm.
+  ///
+  /// Each worker thread advects a batch of particles in one block at a time. Idle workers
+  /// take the most loaded queue of particles and share it when there are not enough
+  /// blocks to go around. If this is not positive (the default), one worker per local
+  /// block is used, up to the number of hardware threads. This parameter is ignored unless
+  /// `SetUseThreadedAlgorithm` is on.
+  VTKM_CONT void SetNumberOfWorkerThreads(vtkm::Id n) { this->NumberOfWorkerThreads = n; }
+  /// @copydoc SetNumberOfWorkerThreads
+  VTKM_CONT vtkm::Id GetNumberOfWorkerThreads() const { return this->NumberOfWorkerThreads; }
+
+  /// @brief Specifies whether particles are balanced between the copies of a block.
+  ///
+  /// A block can be given to several ranks with `SetBlockIDs`, for example when many
+  /// particles are expected to gather in it. When this is on, the ranks report how many
+  /// particles they have to advect along with the messages they already exchange, and a
+  /// particle entering a duplicated block goes to the least loaded rank that has it. The
+  /// seeds in a duplicated block are split between its ranks as well. When this is off
+  /// (the default), the seeds go to the first rank of the block and the other particles
+  /// to a random one.
+  VTKM_CONT void SetUseLoadBalancing(bool val) { this->UseLoadBalancing = val; }
+  /// @copydoc SetUseLoadBalancing
+  VTKM_CONT bool GetUseLoadBalancing() const { return this->UseLoadBalancing; }
+
   VTKM_CONT
   void SetUseAsynchronousCommunication() { this->UseAsynchronousCommunication = true; }
   VTKM_CONT
@@ -105,12 +173,18 @@ protected:
   bool BlockIdsSet = false;
   std::vector<vtkm::Id> BlockIds;
 
+  vtkm::FloatDefault ErrorTolerance = static_cast<vtkm::FloatDefault>(1e-6);
+  vtkm::FloatDefault MaximumStepSize = 0;
+  vtkm::FloatDefault MinimumStepSize = 0;
   vtkm::Id NumberOfSteps = 0;
+  vtkm::Id NumberOfWorkerThreads = 0;
+  vtkm::Id ParticleReorderInterval = 0;
   vtkm::cont::UnknownArrayHandle Seeds;
   vtkm::filter::flow::IntegrationSolverType SolverType =
     vtkm::filter::flow::IntegrationSolverType::RK4_TYPE;
   vtkm::FloatDefault StepSize = 0;
   bool UseAsynchronousCommunication = true;
+  bool UseLoadBalancing = false;
   bool UseThreadedAlgorithm = false;
   vtkm::filter::flow::VectorFieldType VecFieldType =
     vtkm::filter::flow::VectorFieldType::VELOCITY_FIELD_TYPE;
@@ -61,6 +61,12 @@ FilterParticleAdvectionSteadyState<Derived>::DoExecutePartitions(
 
 
   vtkm::filter::flow::internal::BoundsMap boundsMap(input);
+  vtkm::filter::flow::internal::AdvectionParameters advectParams;
+  advectParams.ErrorTolerance = this->ErrorTolerance;
+  advectParams.MinimumStepSize = this->MinimumStepSize;
+  advectParams.MaximumStepSize = this->MaximumStepSize;
+  advectParams.ReorderInterval = this->ParticleReorderInterval;
+
   std::vector<DSIType> dsi;
   for (vtkm::Id i = 0; i < input.GetNumberOfPartitions(); i++)
   {
@@ -75,10 +81,16 @@ FilterParticleAdvectionSteadyState<Derived>::DoExecutePartitions(
     AnalysisType analysis = this->GetAnalysis(dataset);
 
     dsi.emplace_back(blockId, field, dataset, this->SolverType, termination, analysis);
+    dsi.back().SetAdvectionParameters(advectParams);
   }
 
   vtkm::filter::flow::internal::ParticleAdvector<DSIType> pav(
-    boundsMap, dsi, this->UseThreadedAlgorithm, this->UseAsynchronousCommunication);
+    boundsMap,
+    dsi,
+    this->UseThreadedAlgorithm,
+    this->UseAsynchronousCommunication,
+    this->NumberOfWorkerThreads,
+    this->UseLoadBalancing);
 
   vtkm::cont::ArrayHandle<ParticleType> particles;
   this->Seeds.AsArrayHandle(particles);
@@ -8,12 +8,15 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/EnvironmentTracker.h>
 #include <vtkm/filter/flow/FilterParticleAdvectionUnsteadyState.h>
 
 #include <vtkm/filter/flow/internal/BoundsMap.h>
 #include <vtkm/filter/flow/internal/DataSetIntegratorUnsteadyState.h>
 #include <vtkm/filter/flow/internal/ParticleAdvector.h>
 
+#include <vtkm/thirdparty/diy/diy.h>
+
 namespace vtkm
 {
 namespace filter
@@ -57,6 +60,15 @@ FilterParticleAdvectionUnsteadyState<Derived>::DoExecutePartitions(
 
   vtkm::filter::flow::internal::BoundsMap boundsMap(input);
 
+  vtkm::filter::flow::internal::AdvectionParameters advectParams;
+  advectParams.ErrorTolerance = this->ErrorTolerance;
+  advectParams.MinimumStepSize = this->MinimumStepSize;
+  advectParams.MaximumStepSize = this->MaximumStepSize;
+  advectParams.ReorderInterval = this->ParticleReorderInterval;
+
+  auto continuing =
+    std::make_shared<vtkm::filter::flow::internal::ParticleCollection<ParticleType>>();
+
   std::vector<DSIType> dsi;
   for (vtkm::Id i = 0; i < input.GetNumberOfPartitions(); i++)
   {
@@ -83,13 +95,89 @@ FilterParticleAdvectionUnsteadyState<Derived>::DoExecutePartitions(
                      this->SolverType,
                      termination,
                      analysis);
+    dsi.back().SetAdvectionParameters(advectParams);
+    dsi.back().SetContinuingParticles(continuing);
   }
   vtkm::filter::flow::internal::ParticleAdvector<DSIType> pav(
-    boundsMap, dsi, this->UseThreadedAlgorithm, this->UseAsynchronousCommunication);
+    boundsMap,
+    dsi,
+    this->UseThreadedAlgorithm,
+    this->UseAsynchronousCommunication,
+    this->NumberOfWorkerThreads,
+    this->UseLoadBalancing);
 
   vtkm::cont::ArrayHandle<ParticleType> particles;
   this->Seeds.AsArrayHandle(particles);
-  return pav.Execute(particles, this->StepSize);
+  auto output = pav.Execute(particles, this->StepSize);
+
+  //Particles that used up their steps at the later time do not continue.
+  std::vector<ParticleType> continuingParticles;
+  for (const auto& p : continuing->Particles)
+    if (p.GetNumberOfSteps() < this->NumberOfSteps)
+      continuingParticles.emplace_back(p);
+  this->ContinuingParticles =
+    vtkm::cont::make_ArrayHandleMove(std::move(continuingParticles));
+  return output;
+}
+
+template <typename Derived>
+VTKM_CONT vtkm::cont::PartitionedDataSet
+FilterParticleAdvectionUnsteadyState<Derived>::ExecuteTimeSteps(TemporalDataCache& data,
+                                                               vtkm::Id firstStep,
+                                                               vtkm::Id lastStep)
+{
+  if (firstStep < 0 || lastStep >= data.GetNumberOfTimeSteps() || firstStep >= lastStep)
+    throw vtkm::cont::ErrorFilterExecution("Invalid range of time steps.");
+
+  //The seeds, times, and next data set are replaced for each interval.
+  auto seeds = this->Seeds;
+  auto input2 = this->Input2;
+  auto time1 = this->Time1;
+  auto time2 = this->Time2;
+
+  vtkm::cont::PartitionedDataSet output;
+  try
+  {
+    for (vtkm::Id step = firstStep; step < lastStep; step++)
+    {
+      auto input = data.GetTimeStep(step);
+      this->Input2 = data.GetTimeStep(step + 1);
+      this->Time1 = data.GetTime(step);
+      this->Time2 = data.GetTime(step + 1);
+
+      //Read the next time step while this interval is advected.
+      data.Prefetch(step + 2);
+
+      auto result = this->Execute(input);
+      for (const auto& partition : result.GetPartitions())
+        output.AppendPartition(partition);
+
+      vtkm::Id numContinuing = this->ContinuingParticles.GetNumberOfValues();
+#ifdef VTKM_ENABLE_MPI
+      vtkmdiy::mpi::communicator comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+      vtkm::Id totalContinuing = 0;
+      vtkmdiy::mpi::all_reduce(comm, numContinuing, totalContinuing, std::plus<vtkm::Id>{});
+      numContinuing = totalContinuing;
+#endif
+      if (numContinuing == 0)
+        break;
+      this->Seeds = this->ContinuingParticles;
+    }
+  }
+  catch (...)
+  {
+    this->Seeds = seeds;
+    this->Input2 = input2;
+    this->Time1 = time1;
+    this->Time2 = time2;
+    throw;
+  }
+
+  this->Seeds = seeds;
+  this->Input2 = input2;
+  this->Time1 = time1;
+  this->Time2 = time2;
+  return output;
 }
 
 }
@@ -12,6 +12,7 @@
 #define vtk_m_filter_flow_FilterParticleAdvectionUnsteadyState_h
 
 #include <vtkm/filter/flow/FilterParticleAdvection.h>
+#include <vtkm/filter/flow/TemporalDataProvider.h>
 #include <vtkm/filter/flow/vtkm_filter_flow_export.h>
 
 namespace vtkm
@@ -51,6 +52,21 @@ public:
   /// @brief Specifies the data for the later time step.
   VTKM_CONT void SetNextDataSet(const vtkm::cont::PartitionedDataSet& pds) { this->Input2 = pds; }
 
+  /// @brief Advects the seeds through a range of time steps.
+  ///
+  /// The particles are advected from time step `firstStep` to time step `lastStep` of
+  /// `data`, through one pair of consecutive time steps after the other. The particles
+  /// that reach the later time step of a pair continue from there through the next pair.
+  /// The cache loads the time step of the next pair in the background while a pair is
+  /// advected. The number of steps set with `SetNumberOfSteps` bounds the total number of
+  /// steps of a particle.
+  ///
+  /// The output has the partitions of the output of each pair of time steps in order. The
+  /// data sets and times given to the filter are not used.
+  VTKM_CONT vtkm::cont::PartitionedDataSet ExecuteTimeSteps(TemporalDataCache& data,
+                                                            vtkm::Id firstStep,
+                                                            vtkm::Id lastStep);
+
 private:
   VTKM_CONT FieldType GetField(const vtkm::cont::DataSet& data) const;
 
@@ -61,6 +77,7 @@ private:
   VTKM_CONT vtkm::cont::PartitionedDataSet DoExecutePartitions(
     const vtkm::cont::PartitionedDataSet& input);
 
+  vtkm::cont::UnknownArrayHandle ContinuingParticles;
   vtkm::cont::PartitionedDataSet Input2;
   vtkm::FloatDefault Time1 = -1;
   vtkm::FloatDefault Time2 = -1;
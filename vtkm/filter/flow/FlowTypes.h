@@ -20,6 +20,7 @@ enum class IntegrationSolverType
 {
   RK4_TYPE = 0,
   EULER_TYPE,
+  RK45_TYPE,
 };
 
 enum class VectorFieldType
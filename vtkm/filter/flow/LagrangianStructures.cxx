@@ -80,6 +80,42 @@ public:
   }
 };
 
+class ComputeDisplacement : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn start, FieldIn end, FieldOut displacement);
+  using ExecutionSignature = void(_1, _2, _3);
+  using InputDomain = _1;
+
+  VTKM_EXEC void operator()(const vtkm::Vec3f& start,
+                            const vtkm::Vec3f& end,
+                            vtkm::Vec3f& displacement) const
+  {
+    displacement = end - start;
+  }
+};
+
+/// Composes a flow map with the flow map of the first window: each point moves on by the
+/// displacement of the first window interpolated at the point.
+class ComposeFlowMap : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn position, ExecObject displacement, FieldOut next);
+  using ExecutionSignature = void(_1, _2, _3);
+  using InputDomain = _1;
+
+  template <typename EvaluatorType>
+  VTKM_EXEC void operator()(const vtkm::Vec3f& pt,
+                            const EvaluatorType& displacement,
+                            vtkm::Vec3f& next) const
+  {
+    vtkm::VecVariable<vtkm::Vec3f, 2> value;
+    auto status = displacement.Evaluate(pt, 0, value);
+    //A point that left the grid stays where it left.
+    next = status.CheckOk() ? pt + value[0] : pt;
+  }
+};
+
 } //detail
 
 
@@ -127,6 +163,9 @@ VTKM_CONT vtkm::cont::DataSet LagrangianStructures::DoExecute(const vtkm::cont::
         "Provided data is not structured, provide parameters for an auxiliary grid.");
     lcsInput = input;
   }
+  if (this->GetNumberOfTimeWindows() < 1)
+    throw vtkm::cont::ErrorFilterExecution("Number of time windows must be at least 1.");
+
   vtkm::cont::ArrayHandle<vtkm::Vec3f> lcsInputPoints, lcsOutputPoints;
   vtkm::cont::ArrayCopy(lcsInput.GetCoordinateSystem().GetData(), lcsInputPoints);
   if (this->GetUseFlowMapOutput())
@@ -156,25 +195,27 @@ VTKM_CONT vtkm::cont::DataSet LagrangianStructures::DoExecute(const vtkm::cont::
     particles.Run(integrator, advectionPoints, termination, analysis);
     invoke(detail::ExtractParticlePosition{}, analysis.Particles, lcsOutputPoints);
   }
-  // FTLE output field
-  vtkm::cont::ArrayHandle<vtkm::FloatDefault> outputField;
-  vtkm::FloatDefault advectionTime = this->GetAdvectionTime();
-
   vtkm::cont::UnknownCellSet lcsCellSet = lcsInput.GetCellSet();
-  if (lcsCellSet.IsType<Structured2DType>())
-  {
-    using AnalysisType = vtkm::worklet::flow::LagrangianStructures<2>;
-    AnalysisType ftleCalculator(advectionTime, lcsCellSet);
-    vtkm::worklet::DispatcherMapField<AnalysisType> dispatcher(ftleCalculator);
-    dispatcher.Invoke(lcsInputPoints, lcsOutputPoints, outputField);
-  }
-  else if (lcsCellSet.IsType<Structured3DType>())
-  {
-    using AnalysisType = vtkm::worklet::flow::LagrangianStructures<3>;
-    AnalysisType ftleCalculator(advectionTime, lcsCellSet);
-    vtkm::worklet::DispatcherMapField<AnalysisType> dispatcher(ftleCalculator);
-    dispatcher.Invoke(lcsInputPoints, lcsOutputPoints, outputField);
-  }
+  auto computeFTLE = [&](vtkm::FloatDefault advectionTime,
+                         const vtkm::cont::ArrayHandle<vtkm::Vec3f>& outputPoints) {
+    // FTLE output field
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> outputField;
+    if (lcsCellSet.IsType<Structured2DType>())
+    {
+      using AnalysisType = vtkm::worklet::flow::LagrangianStructures<2>;
+      AnalysisType ftleCalculator(advectionTime, lcsCellSet);
+      vtkm::worklet::DispatcherMapField<AnalysisType> dispatcher(ftleCalculator);
+      dispatcher.Invoke(lcsInputPoints, outputPoints, outputField);
+    }
+    else if (lcsCellSet.IsType<Structured3DType>())
+    {
+      using AnalysisType = vtkm::worklet::flow::LagrangianStructures<3>;
+      AnalysisType ftleCalculator(advectionTime, lcsCellSet);
+      vtkm::worklet::DispatcherMapField<AnalysisType> dispatcher(ftleCalculator);
+      dispatcher.Invoke(lcsInputPoints, outputPoints, outputField);
+    }
+    return outputField;
+  };
 
 
   auto fieldmapper = [&](vtkm::cont::DataSet& dataset, const vtkm::cont::Field& field) {
@@ -182,7 +223,38 @@ VTKM_CONT vtkm::cont::DataSet LagrangianStructures::DoExecute(const vtkm::cont::
   };
   vtkm::cont::DataSet output = this->CreateResultCoordinateSystem(
     input, lcsInput.GetCellSet(), lcsInput.GetCoordinateSystem(), fieldmapper);
-  output.AddPointField(this->GetOutputFieldName(), outputField);
+
+  vtkm::FloatDefault advectionTime = this->GetAdvectionTime();
+  vtkm::Id numberOfWindows = this->GetNumberOfTimeWindows();
+  if (numberOfWindows == 1)
+  {
+    output.AddPointField(this->GetOutputFieldName(),
+                         computeFTLE(advectionTime, lcsOutputPoints));
+    return output;
+  }
+
+  // The flow does not change over time, so the flow map of a window that is k times as long
+  // as the first is the flow map of the first window applied k times.
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> displacement;
+  invoke(detail::ComputeDisplacement{}, lcsInputPoints, lcsOutputPoints, displacement);
+  FieldType displacementField(displacement, vtkm::cont::Field::Association::Points);
+  GridEvaluator displacementEvaluator(
+    lcsInput.GetCoordinateSystem(), lcsCellSet, displacementField);
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> windowPoints = lcsOutputPoints;
+  for (vtkm::Id window = 1; window <= numberOfWindows; window++)
+  {
+    if (window > 1)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Vec3f> nextPoints;
+      invoke(detail::ComposeFlowMap{}, windowPoints, displacementEvaluator, nextPoints);
+      windowPoints = nextPoints;
+    }
+    output.AddPointField(this->GetOutputFieldName() + "_" + std::to_string(window),
+                         computeFTLE(advectionTime * static_cast<vtkm::FloatDefault>(window),
+                                     windowPoints));
+  }
   return output;
 }
 
@@ -87,6 +87,20 @@ public:
   /// @copydoc SetUseFlowMapOutput
   bool GetUseFlowMapOutput() { return this->UseFlowMapOutput; }
 
+  /// @brief Specify the number of time windows to compute the FTLE for.
+  ///
+  /// With n windows, the FTLE is computed for advection times of 1, 2, ..., n times the
+  /// advection time. The particles are only advected for the first window. Because the
+  /// vector field does not change over time, the flow map of the k-th window is the flow
+  /// map of the first window applied k times, which is interpolated from the first flow
+  /// map instead of advected. This also works with a flow map given by `SetFlowMapOutput`.
+  ///
+  /// When there is more than one window, the output has one field per window, named by
+  /// the output field name followed by `_1`, `_2`, and so on. By default there is 1 window.
+  void SetNumberOfTimeWindows(vtkm::Id n) { this->NumberOfTimeWindows = n; }
+  /// @copydoc SetNumberOfTimeWindows
+  vtkm::Id GetNumberOfTimeWindows() { return this->NumberOfTimeWindows; }
+
   /// @brief Specify the name of the output field in the data set returned.
   ///
   /// By default, the field will be named `FTLE`.
@@ -111,6 +125,7 @@ private:
   std::string OutputFieldName = "FTLE";
   vtkm::FloatDefault StepSize = 1.0f;
   vtkm::Id NumberOfSteps = 0;
+  vtkm::Id NumberOfTimeWindows = 1;
   bool UseAuxiliaryGrid = false;
   bool UseFlowMapOutput = false;
 };
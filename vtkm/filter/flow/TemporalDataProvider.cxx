@@ -0,0 +1,148 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/filter/flow/TemporalDataProvider.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace flow
+{
+
+TemporalDataProvider::~TemporalDataProvider() = default;
+
+VTKM_CONT TemporalDataCache::TemporalDataCache(
+  const std::shared_ptr<TemporalDataProvider>& provider,
+  vtkm::Id capacity)
+  : Provider(provider)
+{
+  if (!this->Provider)
+    throw vtkm::cont::ErrorBadValue("TemporalDataCache needs a provider.");
+  this->SetCapacity(capacity);
+}
+
+VTKM_CONT TemporalDataCache::~TemporalDataCache()
+{
+  //Destroying the future of a prefetch blocks until the load finishes. The load takes the
+  //lock, so the entries are destroyed outside of it.
+  std::list<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    entries.swap(this->Entries);
+  }
+  entries.clear();
+}
+
+VTKM_CONT void TemporalDataCache::SetCapacity(vtkm::Id capacity)
+{
+  if (capacity < 1)
+    throw vtkm::cont::ErrorBadValue("TemporalDataCache capacity must be at least 1.");
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Capacity = capacity;
+  this->Evict();
+}
+
+VTKM_CONT vtkm::cont::PartitionedDataSet TemporalDataCache::GetTimeStep(vtkm::Id step)
+{
+  this->CheckStep(step);
+
+  std::shared_future<vtkm::cont::PartitionedDataSet> data;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    auto it = std::find_if(this->Entries.begin(),
+                           this->Entries.end(),
+                           [step](const Entry& entry) { return entry.Step == step; });
+    if (it != this->Entries.end())
+    {
+      this->Entries.splice(this->Entries.begin(), this->Entries, it);
+      data = it->Data;
+    }
+    else
+      data = this->Insert(step, std::launch::deferred);
+  }
+
+  //Load outside of the lock so other time steps can still be looked up.
+  return data.get();
+}
+
+VTKM_CONT void TemporalDataCache::Prefetch(vtkm::Id step)
+{
+  if (step < 0 || step >= this->GetNumberOfTimeSteps())
+    return;
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  auto it = std::find_if(this->Entries.begin(),
+                         this->Entries.end(),
+                         [step](const Entry& entry) { return entry.Step == step; });
+  if (it == this->Entries.end())
+    this->Insert(step, std::launch::async);
+}
+
+VTKM_CONT bool TemporalDataCache::IsCached(vtkm::Id step) const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return std::any_of(this->Entries.begin(), this->Entries.end(), [step](const Entry& entry) {
+    return entry.Step == step;
+  });
+}
+
+VTKM_CONT vtkm::Id TemporalDataCache::GetNumberOfLoads() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->NumberOfLoads;
+}
+
+VTKM_CONT std::shared_future<vtkm::cont::PartitionedDataSet> TemporalDataCache::Insert(
+  vtkm::Id step,
+  std::launch policy)
+{
+  auto load = [this, step]() {
+    std::lock_guard<std::mutex> loadLock(this->LoadMutex);
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->NumberOfLoads++;
+    }
+    return this->Provider->LoadTimeStep(step);
+  };
+
+  this->Entries.push_front({ step, std::async(policy, load).share() });
+  this->Evict();
+  return this->Entries.front().Data;
+}
+
+VTKM_CONT void TemporalDataCache::Evict()
+{
+  //Remove the least recently used time steps that are not being loaded.
+  auto it = this->Entries.end();
+  while (static_cast<vtkm::Id>(this->Entries.size()) > this->Capacity &&
+         it != this->Entries.begin())
+  {
+    --it;
+    if (it->Data.wait_for(std::chrono::seconds(0)) == std::future_status::timeout)
+      continue;
+    it = this->Entries.erase(it);
+  }
+}
+
+VTKM_CONT void TemporalDataCache::CheckStep(vtkm::Id step) const
+{
+  if (step < 0 || step >= this->GetNumberOfTimeSteps())
+    throw vtkm::cont::ErrorBadValue("Time step " + std::to_string(step) + " does not exist.");
+}
+
+}
+}
+} // namespace vtkm::filter::flow
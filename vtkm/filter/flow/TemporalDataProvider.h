@@ -0,0 +1,129 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_filter_flow_TemporalDataProvider_h
+#define vtk_m_filter_flow_TemporalDataProvider_h
+
+#include <vtkm/cont/PartitionedDataSet.h>
+#include <vtkm/filter/flow/vtkm_filter_flow_export.h>
+
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace flow
+{
+
+/// @brief Source of the time steps of a flow that changes over time.
+///
+/// Subclasses give the number of time steps, the time of each step, and load the data of
+/// a step on demand, typically by reading it from disk. It is used through a
+/// `TemporalDataCache`, which keeps the recently used time steps in memory.
+class VTKM_FILTER_FLOW_EXPORT TemporalDataProvider
+{
+public:
+  virtual ~TemporalDataProvider();
+
+  /// @brief The number of time steps the provider can load.
+  VTKM_CONT virtual vtkm::Id GetNumberOfTimeSteps() const = 0;
+
+  /// @brief The time value of the given time step.
+  ///
+  /// The times must increase with the time step.
+  VTKM_CONT virtual vtkm::FloatDefault GetTime(vtkm::Id step) const = 0;
+
+  /// @brief Loads the data of the given time step.
+  ///
+  /// This may be called from a background thread, but never for two time steps at once.
+  VTKM_CONT virtual vtkm::cont::PartitionedDataSet LoadTimeStep(vtkm::Id step) = 0;
+};
+
+/// @brief Least recently used cache of the time steps of a `TemporalDataProvider`.
+///
+/// The cache keeps up to `GetCapacity()` time steps in memory. `Prefetch` starts loading a
+/// time step on a background thread, so the data of the next time step can be read while
+/// the current one is used. `GetTimeStep` returns a cached time step, waits for one that is
+/// being prefetched, or loads it in the calling thread.
+class VTKM_FILTER_FLOW_EXPORT TemporalDataCache
+{
+public:
+  VTKM_CONT TemporalDataCache(const std::shared_ptr<TemporalDataProvider>& provider,
+                              vtkm::Id capacity = 3);
+
+  /// Waits for the time steps still being loaded.
+  VTKM_CONT ~TemporalDataCache();
+
+  TemporalDataCache(const TemporalDataCache&) = delete;
+  TemporalDataCache& operator=(const TemporalDataCache&) = delete;
+
+  VTKM_CONT const std::shared_ptr<TemporalDataProvider>& GetProvider() const
+  {
+    return this->Provider;
+  }
+
+  VTKM_CONT vtkm::Id GetNumberOfTimeSteps() const { return this->Provider->GetNumberOfTimeSteps(); }
+
+  VTKM_CONT vtkm::FloatDefault GetTime(vtkm::Id step) const
+  {
+    return this->Provider->GetTime(step);
+  }
+
+  /// @brief Specifies the largest number of time steps kept in memory.
+  ///
+  /// A time step that is being prefetched is not evicted, so the cache may briefly hold more.
+  VTKM_CONT void SetCapacity(vtkm::Id capacity);
+  /// @copydoc SetCapacity
+  VTKM_CONT vtkm::Id GetCapacity() const { return this->Capacity; }
+
+  /// @brief Returns the data of a time step, loading it if it is not in the cache.
+  VTKM_CONT vtkm::cont::PartitionedDataSet GetTimeStep(vtkm::Id step);
+
+  /// @brief Starts loading a time step on a background thread.
+  ///
+  /// Does nothing if the time step is cached, is being loaded, or does not exist.
+  VTKM_CONT void Prefetch(vtkm::Id step);
+
+  /// @brief Returns whether a time step is cached or being loaded.
+  VTKM_CONT bool IsCached(vtkm::Id step) const;
+
+  /// @brief The number of time steps loaded from the provider so far.
+  VTKM_CONT vtkm::Id GetNumberOfLoads() const;
+
+private:
+  struct Entry
+  {
+    vtkm::Id Step;
+    std::shared_future<vtkm::cont::PartitionedDataSet> Data;
+  };
+
+  VTKM_CONT std::shared_future<vtkm::cont::PartitionedDataSet> Insert(vtkm::Id step,
+                                                                      std::launch policy);
+  VTKM_CONT void Evict();
+  VTKM_CONT void CheckStep(vtkm::Id step) const;
+
+  vtkm::Id Capacity;
+  std::shared_ptr<TemporalDataProvider> Provider;
+  std::mutex LoadMutex;
+  mutable std::mutex Mutex;
+  vtkm::Id NumberOfLoads = 0;
+  // The most recently used time step is first.
+  std::list<Entry> Entries;
+};
+
+}
+}
+} // namespace vtkm::filter::flow
+
+#endif // vtk_m_filter_flow_TemporalDataProvider_h
@@ -16,6 +16,8 @@
 #include <vtkm/filter/flow/internal/DataSetIntegrator.h>
 #include <vtkm/filter/flow/internal/ParticleMessenger.h>
 
+#include <limits>
+
 namespace vtkm
 {
 namespace filter
@@ -63,6 +65,11 @@ public:
 
   void SetStepSize(vtkm::FloatDefault stepSize) { this->StepSize = stepSize; }
 
+  /// When a block is duplicated on several ranks, send the particles that enter it to the
+  /// rank with the fewest particles to advect, instead of a random one. The seeds in a
+  /// duplicated block are also split between its ranks.
+  void SetUseLoadBalancing(bool useLoadBalancing) { this->UseLoadBalancing = useLoadBalancing; }
+
   void SetSeeds(const vtkm::cont::ArrayHandle<ParticleType>& seeds)
   {
     this->ClearParticles();
@@ -77,11 +84,15 @@ public:
       const ParticleType p = portal.Get(i);
       std::vector<vtkm::Id> ids = this->BoundsMap.FindBlocks(p.GetPosition());
 
-      //Note: For duplicate blocks, this will give the seeds to the rank that are first in the list.
+      //Note: For duplicate blocks, this will give the seeds to the rank that are first in the list,
+      //unless load balancing is on. Then each rank of the block gets a share of the seeds.
       if (!ids.empty())
       {
         auto ranks = this->BoundsMap.FindRank(ids[0]);
-        if (!ranks.empty() && this->Rank == ranks[0])
+        std::size_t idx = 0;
+        if (this->UseLoadBalancing && !ranks.empty())
+          idx = static_cast<std::size_t>(p.GetID()) % ranks.size();
+        if (!ranks.empty() && this->Rank == ranks[idx])
         {
           particles.emplace_back(p);
           blockIDs.emplace_back(ids);
@@ -95,7 +106,7 @@ public:
   virtual void Go()
   {
     vtkm::filter::flow::internal::ParticleMessenger<ParticleType> messenger(
-      this->Comm, this->UseAsynchronousCommunication, this->BoundsMap, 1, 128);
+      this->Comm, this->UseAsynchronousCommunication, this->BoundsMap, 2, 128);
 
     this->ComputeTotalNumParticles();
 
@@ -220,7 +231,8 @@ public:
     std::vector<ParticleType> outgoing;
     std::vector<vtkm::Id> outgoingRanks;
 
-    this->GetOutgoingParticles(outgoing, outgoingRanks);
+    this->GetOutgoingParticles(outgoing, outgoingRanks, messenger.GetRankLoads());
+    messenger.SetLocalLoad(this->GetNumberOfActiveParticles());
 
     std::vector<ParticleType> incoming;
     std::unordered_map<vtkm::Id, std::vector<vtkm::Id>> incomingBlockIDs;
@@ -240,14 +252,24 @@ public:
                        block);
 
     //Cleanup what was sent.
-    for (const auto& p : outgoing)
-      this->ParticleBlockIDsMap.erase(p.GetID());
+    if (!outgoing.empty())
+    {
+      std::vector<vtkm::Id> outgoingIds;
+      outgoingIds.reserve(outgoing.size());
+      for (const auto& p : outgoing)
+        outgoingIds.emplace_back(p.GetID());
+      this->EraseParticleBlockIDs(outgoingIds);
+    }
 
     this->UpdateActive(incoming, incomingBlockIDs);
   }
 
+  /// `rankLoads` is the estimated number of particles on each rank. It is used to pick
+  /// the rank of a duplicated block when load balancing is on, and is updated with the
+  /// particles sent.
   void GetOutgoingParticles(std::vector<ParticleType>& outgoing,
-                            std::vector<vtkm::Id>& outgoingRanks)
+                            std::vector<vtkm::Id>& outgoingRanks,
+                            std::vector<vtkm::Id>& rankLoads)
   {
     outgoing.clear();
     outgoingRanks.clear();
@@ -257,10 +279,13 @@ public:
 
     std::vector<ParticleType> particlesStaying;
     std::unordered_map<vtkm::Id, std::vector<vtkm::Id>> particlesStayingBlockIDs;
+    if (this->UseLoadBalancing && !this->Inactive.empty())
+      rankLoads[static_cast<std::size_t>(this->Rank)] = this->GetNumberOfActiveParticles();
+
     //Send out Everything.
     for (const auto& p : this->Inactive)
     {
-      const auto& bid = this->ParticleBlockIDsMap[p.GetID()];
+      const auto& bid = this->ParticleBlockIDsMap.at(p.GetID());
       VTKM_ASSERT(!bid.empty());
 
       auto ranks = this->BoundsMap.FindRank(bid[0]);
@@ -271,7 +296,7 @@ public:
         if (ranks[0] == this->Rank)
         {
           particlesStaying.emplace_back(p);
-          particlesStayingBlockIDs[p.GetID()] = this->ParticleBlockIDsMap[p.GetID()];
+          particlesStayingBlockIDs[p.GetID()] = bid;
         }
         else
         {
@@ -282,12 +307,32 @@ public:
       else
       {
         //Decide where it should go...
+        vtkm::Id outRank;
+        if (this->UseLoadBalancing)
+        {
+          //The least loaded rank. On a tie, keep the particle here to save a message.
+          outRank = this->Rank;
+          vtkm::Id minLoad = std::numeric_limits<vtkm::Id>::max();
+          for (auto r : ranks)
+          {
+            vtkm::Id load = rankLoads[static_cast<std::size_t>(r)];
+            if (load < minLoad || (load == minLoad && r == this->Rank))
+            {
+              minLoad = load;
+              outRank = r;
+            }
+          }
+          rankLoads[static_cast<std::size_t>(outRank)]++;
+        }
+        else
+        {
+          //Random selection:
+          outRank = ranks[static_cast<std::size_t>(std::rand()) % ranks.size()];
+        }
 
-        //Random selection:
-        vtkm::Id outRank = std::rand() % ranks.size();
         if (outRank == this->Rank)
         {
-          particlesStayingBlockIDs[p.GetID()] = this->ParticleBlockIDsMap[p.GetID()];
+          particlesStayingBlockIDs[p.GetID()] = bid;
           particlesStaying.emplace_back(p);
         }
         else
@@ -306,6 +351,15 @@ public:
       this->UpdateActive(particlesStaying, particlesStayingBlockIDs);
   }
 
+  //The number of particles waiting to be advected on this rank.
+  virtual vtkm::Id GetNumberOfActiveParticles()
+  {
+    vtkm::Id num = 0;
+    for (const auto& it : this->Active)
+      num += static_cast<vtkm::Id>(it.second.size());
+    return num;
+  }
+
   virtual void UpdateActive(const std::vector<ParticleType>& particles,
                             const std::unordered_map<vtkm::Id, std::vector<vtkm::Id>>& idsMap)
   {
@@ -342,14 +396,17 @@ public:
     vtkm::Id numTerm = static_cast<vtkm::Id>(stuff.TermID.size());
     //Update terminated particles.
     if (numTerm > 0)
-    {
-      for (const auto& id : stuff.TermID)
-        this->ParticleBlockIDsMap.erase(id);
-    }
+      this->EraseParticleBlockIDs(stuff.TermID);
 
     return numTerm;
   }
 
+  virtual void EraseParticleBlockIDs(const std::vector<vtkm::Id>& particleIds)
+  {
+    for (const auto& id : particleIds)
+      this->ParticleBlockIDsMap.erase(id);
+  }
+
 
   virtual bool GetBlockAndWait(const bool& syncComm, const vtkm::Id& numLocalTerm)
   {
@@ -391,6 +448,7 @@ public:
   vtkm::Id TotalNumParticles = 0;
   vtkm::Id TotalNumTerminatedParticles = 0;
   bool UseAsynchronousCommunication = true;
+  bool UseLoadBalancing = false;
 };
 
 }
@@ -17,6 +17,11 @@
 #include <vtkm/filter/flow/internal/DataSetIntegrator.h>
 #include <vtkm/filter/flow/internal/ParticleMessenger.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace vtkm
@@ -28,47 +33,140 @@ namespace flow
 namespace internal
 {
 
+/// Advects the particles of the local blocks on a pool of worker threads.
+///
+/// The calling thread manages the algorithm: it collects the results of the workers,
+/// queues the particles that stay on this rank and exchanges the others with the other
+/// ranks. Each worker repeatedly takes a batch of queued particles and advects it in its
+/// block. A worker prefers the most loaded block that no other worker is advecting. When
+/// there are more idle workers than such blocks, the idle workers split the most loaded
+/// queue between them, even if that block is already being advected.
 template <typename DSIType>
 class AdvectAlgorithmThreaded : public AdvectAlgorithm<DSIType>
 {
 public:
   using ParticleType = typename DSIType::PType;
 
+  /// If `numWorkers` is not positive, one worker per local block is used, but no more
+  /// than the number of hardware threads.
   AdvectAlgorithmThreaded(const vtkm::filter::flow::internal::BoundsMap& bm,
                           std::vector<DSIType>& blocks,
-                          bool useAsyncComm)
+                          bool useAsyncComm,
+                          vtkm::Id numWorkers = 0)
     : AdvectAlgorithm<DSIType>(bm, blocks, useAsyncComm)
     , Done(false)
-    , WorkerActivate(false)
+    , NumWorkers(numWorkers)
   {
     //For threaded algorithm, the particles go out of scope in the Work method.
     //When this happens, they are destructed by the time the Manage thread gets them.
     //Set the copy flag so the std::vector is copied into the ArrayHandle
     for (auto& block : this->Blocks)
       block.SetCopySeedFlag(true);
+
+    if (this->NumWorkers <= 0)
+    {
+      vtkm::Id numThreads = static_cast<vtkm::Id>(std::thread::hardware_concurrency());
+      this->NumWorkers = std::min(static_cast<vtkm::Id>(this->Blocks.size()),
+                                  std::max(numThreads, vtkm::Id{ 1 }));
+      this->NumWorkers = std::max(this->NumWorkers, vtkm::Id{ 1 });
+    }
   }
 
+  vtkm::Id GetNumberOfWorkers() const { return this->NumWorkers; }
+
   void Go() override
   {
     this->ComputeTotalNumParticles();
 
     std::vector<std::thread> workerThreads;
-    workerThreads.emplace_back(std::thread(AdvectAlgorithmThreaded::Worker, this));
-    this->Manage();
+    for (vtkm::Id i = 0; i < this->NumWorkers; i++)
+      workerThreads.emplace_back(std::thread(AdvectAlgorithmThreaded::Worker, this));
+
+    try
+    {
+      this->Manage();
+    }
+    catch (...)
+    {
+      this->SetDone();
+      for (auto& t : workerThreads)
+        t.join();
+      throw;
+    }
 
-    //This will only work for 1 thread. For > 1, the Blocks will need a mutex.
-    VTKM_ASSERT(workerThreads.size() == 1);
     for (auto& t : workerThreads)
       t.join();
   }
 
 protected:
+  //Takes a batch of particles for a worker. Called with the mutex locked.
+  bool GetWorkerParticles(std::vector<ParticleType>& particles, vtkm::Id& blockId)
+  {
+    particles.clear();
+    blockId = -1;
+
+    //Find the most loaded queue overall and the most loaded queue of a block that no
+    //worker is advecting.
+    auto maxIt = this->Active.end();
+    auto maxFreeIt = this->Active.end();
+    std::size_t numFree = 0;
+    for (auto it = this->Active.begin(); it != this->Active.end(); it++)
+    {
+      if (it->second.empty())
+        continue;
+      if (maxIt == this->Active.end() || it->second.size() > maxIt->second.size())
+        maxIt = it;
+
+      auto busy = this->BusyBlocks.find(it->first);
+      if (busy == this->BusyBlocks.end() || busy->second == 0)
+      {
+        numFree++;
+        if (maxFreeIt == this->Active.end() || it->second.size() > maxFreeIt->second.size())
+          maxFreeIt = it;
+      }
+    }
+    if (maxIt == this->Active.end())
+    {
+      this->Active.clear();
+      return false;
+    }
+
+    //This worker is idle and counted in numIdle.
+    std::size_t numIdle = static_cast<std::size_t>(this->NumWorkers - this->NumBusyWorkers);
+    if (maxFreeIt != this->Active.end() && numFree >= numIdle)
+    {
+      //There is a free block for every idle worker, so take a whole queue.
+      blockId = maxFreeIt->first;
+      particles = std::move(maxFreeIt->second);
+      this->Active.erase(maxFreeIt);
+    }
+    else
+    {
+      //Split the largest queue between the idle workers that have no block of their own.
+      std::size_t numShare = std::max(numIdle - numFree + 1, std::size_t{ 1 });
+      auto& queue = maxIt->second;
+      std::size_t num = (queue.size() + numShare - 1) / numShare;
+      blockId = maxIt->first;
+      if (num == queue.size())
+      {
+        particles = std::move(queue);
+        this->Active.erase(maxIt);
+      }
+      else
+      {
+        auto first = std::next(queue.begin(), static_cast<std::ptrdiff_t>(queue.size() - num));
+        particles.assign(first, queue.end());
+        queue.erase(first, queue.end());
+      }
+    }
+
+    return !particles.empty();
+  }
+
   bool GetActiveParticles(std::vector<ParticleType>& particles, vtkm::Id& blockId) override
   {
     std::lock_guard<std::mutex> lock(this->Mutex);
-    bool val = this->AdvectAlgorithm<DSIType>::GetActiveParticles(particles, blockId);
-    this->WorkerActivate = val;
-    return val;
+    return this->GetWorkerParticles(particles, blockId);
   }
 
   void UpdateActive(const std::vector<ParticleType>& particles,
@@ -81,10 +179,30 @@ protected:
 
       //Let workers know there is new work
       this->WorkerActivateCondition.notify_all();
-      this->WorkerActivate = true;
     }
   }
 
+  vtkm::Id GetNumberOfActiveParticles() override
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->AdvectAlgorithm<DSIType>::GetNumberOfActiveParticles();
+  }
+
+  //The workers read ParticleBlockIDsMap while the mutex is locked, so every change the
+  //manager makes to it must be made with the mutex locked too.
+  void UpdateInactive(const std::vector<ParticleType>& particles,
+                      const std::unordered_map<vtkm::Id, std::vector<vtkm::Id>>& idsMap) override
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->AdvectAlgorithm<DSIType>::UpdateInactive(particles, idsMap);
+  }
+
+  void EraseParticleBlockIDs(const std::vector<vtkm::Id>& particleIds) override
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->AdvectAlgorithm<DSIType>::EraseParticleBlockIDs(particleIds);
+  }
+
   bool CheckDone()
   {
     std::lock_guard<std::mutex> lock(this->Mutex);
@@ -96,21 +214,45 @@ protected:
     std::lock_guard<std::mutex> lock(this->Mutex);
     this->Done = true;
     this->WorkerActivateCondition.notify_all();
+    this->WorkerResultsCondition.notify_all();
   }
 
   static void Worker(AdvectAlgorithmThreaded* algo) { algo->Work(); }
 
-  void WorkerWait()
+  //Waits until there is work or the algorithm is done. On success, the worker is counted
+  //as busy and the block ids of the particles are copied into `info`.
+  bool WaitForWork(std::vector<ParticleType>& particles,
+                   vtkm::Id& blockId,
+                   std::unique_ptr<DSIHelperInfo<ParticleType>>& info)
   {
     std::unique_lock<std::mutex> lock(this->Mutex);
-    this->WorkerActivateCondition.wait(lock, [this] { return WorkerActivate || Done; });
+    this->WorkerActivateCondition.wait(lock, [this] { return !this->Active.empty() || Done; });
+    if (this->Done || !this->GetWorkerParticles(particles, blockId))
+      return false;
+
+    std::unordered_map<vtkm::Id, std::vector<vtkm::Id>> blockIDs;
+    for (const auto& p : particles)
+    {
+      const auto& it = this->ParticleBlockIDsMap.find(p.GetID());
+      VTKM_ASSERT(it != this->ParticleBlockIDsMap.end());
+      blockIDs[p.GetID()] = it->second;
+    }
+    info.reset(new DSIHelperInfo<ParticleType>(particles, this->BoundsMap, blockIDs));
+
+    this->NumBusyWorkers++;
+    this->BusyBlocks[blockId]++;
+    return true;
   }
 
   void UpdateWorkerResult(vtkm::Id blockId, DSIHelperInfo<ParticleType>& b)
   {
     std::lock_guard<std::mutex> lock(this->Mutex);
     auto& it = this->WorkerResults[blockId];
-    it.emplace_back(b);
+    it.emplace_back(std::move(b));
+
+    this->NumBusyWorkers--;
+    this->BusyBlocks[blockId]--;
+    this->WorkerResultsCondition.notify_all();
   }
 
   void Work()
@@ -119,15 +261,13 @@ protected:
     {
       std::vector<ParticleType> v;
       vtkm::Id blockId = -1;
-      if (this->GetActiveParticles(v, blockId))
+      std::unique_ptr<DSIHelperInfo<ParticleType>> bb;
+      if (this->WaitForWork(v, blockId, bb))
       {
         auto& block = this->GetDataSet(blockId);
-        DSIHelperInfo<ParticleType> bb(v, this->BoundsMap, this->ParticleBlockIDsMap);
-        block.Advect(bb, this->StepSize);
-        this->UpdateWorkerResult(blockId, bb);
+        block.Advect(*bb, this->StepSize);
+        this->UpdateWorkerResult(blockId, *bb);
       }
-      else
-        this->WorkerWait();
     }
   }
 
@@ -142,12 +282,14 @@ protected:
 
     bool useAsync = true;
     vtkm::filter::flow::internal::ParticleMessenger<ParticleType> messenger(
-      this->Comm, useAsync, this->BoundsMap, 1, 128);
+      this->Comm, useAsync, this->BoundsMap, 2, 128);
 
     while (this->TotalNumTerminatedParticles < this->TotalNumParticles)
     {
       std::unordered_map<vtkm::Id, std::vector<DSIHelperInfo<ParticleType>>> workerResults;
-      this->GetWorkerResults(workerResults);
+      //With a single rank, particles only come from the workers, so sleep until they
+      //have results. Otherwise, keep polling for messages from the other ranks.
+      this->GetWorkerResults(workerResults, this->NumRanks == 1);
 
       vtkm::Id numTerm = 0;
       for (auto& it : workerResults)
@@ -175,26 +317,35 @@ protected:
       return true;
 
     return (this->AdvectAlgorithm<DSIType>::GetBlockAndWait(syncComm, numLocalTerm) &&
-            !this->WorkerActivate && this->WorkerResults.empty());
+            this->NumBusyWorkers == 0 && this->WorkerResults.empty());
   }
 
   void GetWorkerResults(
-    std::unordered_map<vtkm::Id, std::vector<DSIHelperInfo<ParticleType>>>& results)
+    std::unordered_map<vtkm::Id, std::vector<DSIHelperInfo<ParticleType>>>& results,
+    bool wait)
   {
     results.clear();
 
-    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    if (wait)
+      this->WorkerResultsCondition.wait(
+        lock, [this] { return !this->WorkerResults.empty() || this->Done; });
+
     if (!this->WorkerResults.empty())
     {
-      results = this->WorkerResults;
+      results = std::move(this->WorkerResults);
       this->WorkerResults.clear();
     }
   }
 
+  //{blockId, number of workers advecting particles in the block}
+  std::unordered_map<vtkm::Id, vtkm::Id> BusyBlocks;
   std::atomic<bool> Done;
   std::mutex Mutex;
-  bool WorkerActivate;
+  vtkm::Id NumBusyWorkers = 0;
+  vtkm::Id NumWorkers;
   std::condition_variable WorkerActivateCondition;
+  std::condition_variable WorkerResultsCondition;
   std::unordered_map<vtkm::Id, std::vector<DSIHelperInfo<ParticleType>>> WorkerResults;
 };
 
@@ -19,11 +19,15 @@
 #include <vtkm/filter/flow/worklet/EulerIntegrator.h>
 #include <vtkm/filter/flow/worklet/IntegratorStatus.h>
 #include <vtkm/filter/flow/worklet/ParticleAdvection.h>
+#include <vtkm/filter/flow/worklet/RK45Integrator.h>
 #include <vtkm/filter/flow/worklet/RK4Integrator.h>
 #include <vtkm/filter/flow/worklet/Stepper.h>
 
 #include <vtkm/cont/Variant.h>
 
+#include <memory>
+#include <mutex>
+
 namespace vtkm
 {
 namespace filter
@@ -33,6 +37,17 @@ namespace flow
 namespace internal
 {
 
+/// Options of the advection in a block besides the solver and the step size.
+struct AdvectionParameters
+{
+  // Error control of the adaptive integration solvers.
+  vtkm::FloatDefault ErrorTolerance = static_cast<vtkm::FloatDefault>(1e-6);
+  vtkm::FloatDefault MinimumStepSize = 0;
+  vtkm::FloatDefault MaximumStepSize = 0;
+  // Number of steps between Morton reorderings of the particles, or 0 for none.
+  vtkm::Id ReorderInterval = 0;
+};
+
 template <typename ParticleType>
 class DSIHelperInfo
 {
@@ -116,6 +131,10 @@ public:
 
   VTKM_CONT vtkm::Id GetID() const { return this->Id; }
   VTKM_CONT void SetCopySeedFlag(bool val) { this->CopySeedArray = val; }
+  VTKM_CONT void SetAdvectionParameters(const AdvectionParameters& params)
+  {
+    this->AdvectionParams = params;
+  }
 
   VTKM_CONT
   void Advect(DSIHelperInfo<ParticleType>& b,
@@ -138,9 +157,12 @@ protected:
   //Data members.
   vtkm::Id Id;
   vtkm::filter::flow::IntegrationSolverType SolverType;
+  AdvectionParameters AdvectionParams;
   vtkmdiy::mpi::communicator Comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
   vtkm::Id Rank;
   bool CopySeedArray = false;
+  // Guards the results of the derived class. Copies of an integrator share it.
+  std::shared_ptr<std::mutex> ResultMutex = std::make_shared<std::mutex>();
 };
 
 template <typename Derived, typename ParticleType>
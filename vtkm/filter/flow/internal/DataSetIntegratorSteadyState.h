@@ -40,14 +40,18 @@ public:
                        const vtkm::cont::DataSet& dataset,
                        const TerminationType& termination,
                        vtkm::FloatDefault stepSize,
+                       const AdvectionParameters& advectParams,
                        AnalysisType& analysis)
   {
     using StepperType =
       vtkm::worklet::flow::Stepper<SolverType<SteadyStateGridEvalType>, SteadyStateGridEvalType>;
     SteadyStateGridEvalType eval(dataset, field);
     StepperType stepper(eval, stepSize);
+    stepper.SetErrorTolerance(advectParams.ErrorTolerance);
+    stepper.SetStepSizeRange(advectParams.MinimumStepSize, advectParams.MaximumStepSize);
 
     WorkletType worklet;
+    worklet.SetReorderInterval(advectParams.ReorderInterval);
     worklet.Run(stepper, seedArray, termination, analysis);
   }
 
@@ -57,17 +61,23 @@ public:
                      const TerminationType& termination,
                      const IntegrationSolverType& solverType,
                      vtkm::FloatDefault stepSize,
+                     const AdvectionParameters& advectParams,
                      AnalysisType& analysis)
   {
     if (solverType == IntegrationSolverType::RK4_TYPE)
     {
       DoAdvect<vtkm::worklet::flow::RK4Integrator>(
-        seedArray, field, dataset, termination, stepSize, analysis);
+        seedArray, field, dataset, termination, stepSize, advectParams, analysis);
     }
     else if (solverType == IntegrationSolverType::EULER_TYPE)
     {
       DoAdvect<vtkm::worklet::flow::EulerIntegrator>(
-        seedArray, field, dataset, termination, stepSize, analysis);
+        seedArray, field, dataset, termination, stepSize, advectParams, analysis);
+    }
+    else if (solverType == IntegrationSolverType::RK45_TYPE)
+    {
+      DoAdvect<vtkm::worklet::flow::RK45Integrator>(
+        seedArray, field, dataset, termination, stepSize, advectParams, analysis);
     }
     else
       throw vtkm::cont::ErrorFilterExecution("Unsupported Integrator type");
@@ -124,6 +134,7 @@ public:
                             this->Termination,
                             this->SolverType,
                             stepSize,
+                            this->AdvectionParams,
                             analysis);
 
     this->UpdateResult(analysis, block);
@@ -142,12 +153,11 @@ public:
       vtkm::cont::ArrayHandle<ParticleType> termParticles;
       vtkm::cont::Algorithm::Copy(termPerm, termParticles);
       analysis.FinalizeAnalysis(termParticles);
-      this->Analyses.emplace_back(analysis);
-    }
-    else
-    {
-      this->Analyses.emplace_back(analysis);
     }
+
+    //Several threads may advect particles in this block at once.
+    std::lock_guard<std::mutex> lock(*this->ResultMutex);
+    this->Analyses.emplace_back(analysis);
   }
 
   VTKM_CONT bool GetOutput(vtkm::cont::DataSet& ds) const
@@ -45,14 +45,18 @@ public:
                        vtkm::FloatDefault t2,
                        const TerminationType& termination,
                        vtkm::FloatDefault stepSize,
+                       const AdvectionParameters& advectParams,
                        AnalysisType& analysis)
 
   {
     using StepperType = vtkm::worklet::flow::Stepper<SolverType<UnsteadyStateGridEvalType>,
                                                      UnsteadyStateGridEvalType>;
     WorkletType worklet;
+    worklet.SetReorderInterval(advectParams.ReorderInterval);
     UnsteadyStateGridEvalType eval(ds1, t1, field1, ds2, t2, field2);
     StepperType stepper(eval, stepSize);
+    stepper.SetErrorTolerance(advectParams.ErrorTolerance);
+    stepper.SetStepSizeRange(advectParams.MinimumStepSize, advectParams.MaximumStepSize);
     worklet.Run(stepper, seedArray, termination, analysis);
   }
 
@@ -66,17 +70,23 @@ public:
                      const TerminationType& termination,
                      const IntegrationSolverType& solverType,
                      vtkm::FloatDefault stepSize,
+                     const AdvectionParameters& advectParams,
                      AnalysisType& analysis)
   {
     if (solverType == IntegrationSolverType::RK4_TYPE)
     {
       DoAdvect<vtkm::worklet::flow::RK4Integrator>(
-        seedArray, field1, ds1, t1, field2, ds2, t2, termination, stepSize, analysis);
+        seedArray, field1, ds1, t1, field2, ds2, t2, termination, stepSize, advectParams, analysis);
     }
     else if (solverType == IntegrationSolverType::EULER_TYPE)
     {
       DoAdvect<vtkm::worklet::flow::EulerIntegrator>(
-        seedArray, field1, ds1, t1, field2, ds2, t2, termination, stepSize, analysis);
+        seedArray, field1, ds1, t1, field2, ds2, t2, termination, stepSize, advectParams, analysis);
+    }
+    else if (solverType == IntegrationSolverType::RK45_TYPE)
+    {
+      DoAdvect<vtkm::worklet::flow::RK45Integrator>(
+        seedArray, field1, ds1, t1, field2, ds2, t2, termination, stepSize, advectParams, analysis);
     }
     else
       throw vtkm::cont::ErrorFilterExecution("Unsupported Integrator type");
@@ -84,6 +94,14 @@ public:
 };
 } //namespace detail
 
+/// Particles collected from all the blocks of an advection.
+template <typename ParticleType>
+struct ParticleCollection
+{
+  std::mutex Mutex;
+  std::vector<ParticleType> Particles;
+};
+
 template <typename ParticleType,
           typename FieldType,
           typename TerminationType,
@@ -145,14 +163,25 @@ public:
                             this->Termination,
                             this->SolverType,
                             stepSize,
+                            this->AdvectionParams,
                             analysis);
     this->UpdateResult(analysis, block);
   }
 
+  /// Collects the particles that stop at the later time step, so that they can be advected
+  /// further through the next pair of time steps.
+  VTKM_CONT void SetContinuingParticles(
+    const std::shared_ptr<ParticleCollection<ParticleType>>& particles)
+  {
+    this->ContinuingParticles = particles;
+  }
+
   VTKM_CONT void UpdateResult(AnalysisType& analysis,
                               vtkm::filter::flow::internal::DSIHelperInfo<ParticleType>& dsiInfo)
   {
     this->ClassifyParticles(analysis.Particles, dsiInfo);
+    if (this->ContinuingParticles && !dsiInfo.TermIdx.empty())
+      this->CollectContinuingParticles(analysis.Particles, dsiInfo.TermIdx);
     if (std::is_same<AnalysisType, vtkm::worklet::flow::NoAnalysis<ParticleType>>::value)
     {
       if (dsiInfo.TermIdx.empty())
@@ -162,12 +191,11 @@ public:
       vtkm::cont::ArrayHandle<ParticleType> termParticles;
       vtkm::cont::Algorithm::Copy(termPerm, termParticles);
       analysis.FinalizeAnalysis(termParticles);
-      this->Analyses.emplace_back(analysis);
-    }
-    else
-    {
-      this->Analyses.emplace_back(analysis);
     }
+
+    //Several threads may advect particles in this block at once.
+    std::lock_guard<std::mutex> lock(*this->ResultMutex);
+    this->Analyses.emplace_back(analysis);
   }
 
   VTKM_CONT bool GetOutput(vtkm::cont::DataSet& ds) const
@@ -179,6 +207,28 @@ public:
   }
 
 private:
+  VTKM_CONT void CollectContinuingParticles(const vtkm::cont::ArrayHandle<ParticleType>& particles,
+                                            const std::vector<vtkm::Id>& termIdx)
+  {
+    //The particles that reach the later time fail to step past it. Their status is reset
+    //when no other block takes them, so they are told apart from the others by their time.
+    const vtkm::FloatDefault endTime =
+      this->Time2 - (this->Time2 - this->Time1) / static_cast<vtkm::FloatDefault>(1000);
+
+    auto portal = particles.ReadPortal();
+    std::lock_guard<std::mutex> lock(this->ContinuingParticles->Mutex);
+    for (const auto& idx : termIdx)
+    {
+      ParticleType p = portal.Get(idx);
+      if (p.GetTime() >= endTime && !p.GetStatus().CheckZeroVelocity())
+      {
+        p.GetStatus() = vtkm::ParticleStatus();
+        this->ContinuingParticles->Particles.emplace_back(p);
+      }
+    }
+  }
+
+  std::shared_ptr<ParticleCollection<ParticleType>> ContinuingParticles;
   FieldType Field1;
   FieldType Field2;
   vtkm::cont::DataSet DataSet1;
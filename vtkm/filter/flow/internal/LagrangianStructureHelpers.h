@@ -11,7 +11,6 @@
 #define vtkm_filter_flow_internal_LagrangianStructureHelpers_h
 
 #include <vtkm/Matrix.h>
-#include <vtkm/Swap.h>
 #include <vtkm/Types.h>
 
 namespace vtkm
@@ -65,7 +64,7 @@ VTKM_EXEC_CONT void ComputeLeftCauchyGreenTensor(vtkm::Matrix<T, 3, 3>& jacobian
 
   vtkm::MatrixSetRow(jacobian, 0, vtkm::Vec<T, 3>(a, b, c));
   vtkm::MatrixSetRow(jacobian, 1, vtkm::Vec<T, 3>(b, d, e));
-  vtkm::MatrixSetRow(jacobian, 2, vtkm::Vec<T, 3>(d, e, f));
+  vtkm::MatrixSetRow(jacobian, 2, vtkm::Vec<T, 3>(c, e, f));
 }
 
 template <typename T>
@@ -153,47 +152,28 @@ VTKM_EXEC_CONT void Jacobi(vtkm::Matrix<T, 3, 3> tensor, vtkm::Vec<T, 3>& eigen)
   T e = j2[2];
   T f = j3[2];
 
+  // Closed form eigenvalues of a symmetric 3x3 matrix. The matrix is shifted by a third of
+  // its trace and scaled so that the angle of the eigenvalues is an arc cosine of its
+  // half determinant. There are no iterations and no data dependent branches.
   T x = (a + d + f) / 3.0f; // trace
-
   a -= x;
   d -= x;
   f -= x;
 
-  // Det / 2;
-  T q = (a * d * f + b * e * c + c * b * e - c * d * c - e * e * a - f * b * b) / 2.0f;
-  T r = (a * a + b * b + c * c + b * b + d * d + e * e + c * c + e * e + f * f) / 6.0f;
-
-  T D = (r * r * r - q * q);
-  T phi = 0.0f;
-
-  if (D < vtkm::Epsilon<T>())
-    phi = 0.0f;
-  else
-  {
-    phi = vtkm::ATan(vtkm::Sqrt(D) / q) / 3.0f;
-
-    if (phi < 0)
-      phi += static_cast<T>(vtkm::Pi());
-  }
-
-  const T sqrt3 = vtkm::Sqrt(3.0f);
-  const T sqrtr = vtkm::Sqrt(r);
+  T p = vtkm::Sqrt((a * a + d * d + f * f + 2.0f * (b * b + c * c + e * e)) / 6.0f);
+  T invP = p > 0 ? 1.0f / p : 0.0f;
 
-  T sinphi = 0.0f, cosphi = 0.0f;
-  sinphi = vtkm::Sin(phi);
-  cosphi = vtkm::Cos(phi);
+  // Half the determinant of the scaled matrix.
+  T q = (a * d * f + 2.0f * b * c * e - a * e * e - d * c * c - f * b * b) * invP * invP * invP /
+    2.0f;
+  q = vtkm::Min(vtkm::Max(q, static_cast<T>(-1.0f)), static_cast<T>(1.0f));
 
-  T w0 = x + 2.0f * sqrtr * cosphi;
-  T w1 = x - sqrtr * (cosphi - sqrt3 * sinphi);
-  T w2 = x - sqrtr * (cosphi + sqrt3 * sinphi);
+  T phi = vtkm::ACos(q) / 3.0f;
 
   // Arrange eigen values from largest to smallest.
-  if (w1 > w0)
-    vtkm::Swap(w0, w1);
-  if (w2 > w0)
-    vtkm::Swap(w0, w2);
-  if (w2 > w1)
-    vtkm::Swap(w1, w2);
+  T w0 = x + 2.0f * p * vtkm::Cos(phi);
+  T w2 = x + 2.0f * p * vtkm::Cos(phi + static_cast<T>(2.0 * vtkm::Pi() / 3.0));
+  T w1 = 3.0f * x - w0 - w2;
 
   eigen[0] = w0;
   eigen[1] = w1;
@@ -34,11 +34,15 @@ public:
   ParticleAdvector(const vtkm::filter::flow::internal::BoundsMap& bm,
                    const std::vector<DSIType>& blocks,
                    const bool& useThreaded,
-                   const bool& useAsyncComm)
+                   const bool& useAsyncComm,
+                   vtkm::Id numWorkerThreads = 0,
+                   bool useLoadBalancing = false)
     : Blocks(blocks)
     , BoundsMap(bm)
+    , NumberOfWorkerThreads(numWorkerThreads)
     , UseThreadedAlgorithm(useThreaded)
     , UseAsynchronousCommunication(useAsyncComm)
+    , UseLoadBalancing(useLoadBalancing)
   {
   }
 
@@ -47,30 +51,38 @@ public:
   {
     if (!this->UseThreadedAlgorithm)
     {
-      using AlgorithmType = vtkm::filter::flow::internal::AdvectAlgorithm<DSIType>;
-      return this->RunAlgo<AlgorithmType>(seeds, stepSize);
+      vtkm::filter::flow::internal::AdvectAlgorithm<DSIType> algo(
+        this->BoundsMap, this->Blocks, this->UseAsynchronousCommunication);
+      return this->RunAlgo(algo, seeds, stepSize);
     }
     else
     {
-      using AlgorithmType = vtkm::filter::flow::internal::AdvectAlgorithmThreaded<DSIType>;
-      return this->RunAlgo<AlgorithmType>(seeds, stepSize);
+      vtkm::filter::flow::internal::AdvectAlgorithmThreaded<DSIType> algo(
+        this->BoundsMap,
+        this->Blocks,
+        this->UseAsynchronousCommunication,
+        this->NumberOfWorkerThreads);
+      return this->RunAlgo(algo, seeds, stepSize);
     }
   }
 
 private:
   template <typename AlgorithmType>
-  vtkm::cont::PartitionedDataSet RunAlgo(const vtkm::cont::ArrayHandle<ParticleType>& seeds,
+  vtkm::cont::PartitionedDataSet RunAlgo(AlgorithmType& algo,
+                                         const vtkm::cont::ArrayHandle<ParticleType>& seeds,
                                          vtkm::FloatDefault stepSize)
   {
-    AlgorithmType algo(this->BoundsMap, this->Blocks, this->UseAsynchronousCommunication);
+    algo.SetUseLoadBalancing(this->UseLoadBalancing);
     algo.Execute(seeds, stepSize);
     return algo.GetOutput();
   }
 
   std::vector<DSIType> Blocks;
   vtkm::filter::flow::internal::BoundsMap BoundsMap;
+  vtkm::Id NumberOfWorkerThreads = 0;
   bool UseThreadedAlgorithm;
   bool UseAsynchronousCommunication = true;
+  bool UseLoadBalancing = false;
 };
 
 }
@@ -16,6 +16,8 @@
 #include <vtkm/filter/flow/internal/Messenger.h>
 #include <vtkm/filter/flow/vtkm_filter_flow_export.h>
 
+#include <algorithm>
+#include <limits>
 #include <list>
 #include <map>
 #include <set>
@@ -60,7 +62,23 @@ public:
                           vtkm::Id& numTerminateMessages,
                           bool blockAndWait = false);
 
+  /// @brief Specifies the number of particles this rank has to advect.
+  ///
+  /// The load is sent along with the particles and termination messages of `Exchange`, so
+  /// it costs no extra messages.
+  VTKM_CONT void SetLocalLoad(vtkm::Id load) { this->LocalLoad = load; }
+
+  /// @brief The last known number of particles each rank has to advect.
+  ///
+  /// The entries are updated as the other ranks report their load in `Exchange`. Between
+  /// reports, the caller may add the particles it sends to a rank to keep the estimate
+  /// current.
+  VTKM_CONT std::vector<vtkm::Id>& GetRankLoads() { return this->RankLoads; }
+
 protected:
+  vtkm::Id LocalLoad = 0;
+  std::vector<vtkm::Id> RankLoads;
+
 #ifdef VTKM_ENABLE_MPI
   static constexpr int MSG_TERMINATE = 1;
 
@@ -124,6 +142,7 @@ ParticleMessenger<ParticleType>::ParticleMessenger(
   , BoundsMap(boundsMap)
 #endif
 {
+  this->RankLoads.resize(static_cast<std::size_t>(this->GetNumRanks()), 0);
 #ifdef VTKM_ENABLE_MPI
   this->RegisterMessages(msgSz, numParticles, numBlockIds);
 #else
@@ -154,6 +173,8 @@ std::size_t ParticleMessenger<ParticleType>::CalcParticleBufferSize(std::size_t
   return
     // rank
     sizeof(int)
+    // load of the rank
+    + sizeof(vtkm::Id)
     //std::vector<ParticleType> p;
     //p.size()
     + sizeof(std::size_t)
@@ -220,7 +241,11 @@ void ParticleMessenger<ParticleType>::Exchange(
 
   //Do all the sends first.
   if (numLocalTerm > 0)
-    this->SendAllMsg({ MSG_TERMINATE, static_cast<int>(numLocalTerm) });
+  {
+    int load = static_cast<int>(
+      std::min(this->LocalLoad, static_cast<vtkm::Id>(std::numeric_limits<int>::max())));
+    this->SendAllMsg({ MSG_TERMINATE, static_cast<int>(numLocalTerm), load });
+  }
   this->SendParticles(sendData);
   this->CheckPendingSendRequests();
 
@@ -241,7 +266,11 @@ void ParticleMessenger<ParticleType>::Exchange(
     for (const auto& m : msgData)
     {
       if (m.second[0] == MSG_TERMINATE)
+      {
         numTerminateMessages += static_cast<vtkm::Id>(m.second[1]);
+        if (m.second.size() > 2)
+          this->RankLoads[static_cast<std::size_t>(m.first)] = static_cast<vtkm::Id>(m.second[2]);
+      }
     }
   }
 #endif
@@ -325,10 +354,13 @@ bool ParticleMessenger<ParticleType>::RecvAny(std::vector<MsgCommType>* msgs,
     else if (buff.first == ParticleMessenger::PARTICLE_TAG)
     {
       int sendRank;
+      vtkm::Id load;
       std::vector<ParticleCommType> particles;
 
       vtkmdiy::load(buff.second, sendRank);
+      vtkmdiy::load(buff.second, load);
       vtkmdiy::load(buff.second, particles);
+      this->RankLoads[static_cast<std::size_t>(sendRank)] = load;
       recvParticles->emplace_back(std::make_pair(sendRank, particles));
     }
   }
@@ -352,6 +384,7 @@ inline void ParticleMessenger<ParticleType>::SendParticles(int dst,
 
   vtkmdiy::MemoryBuffer bb;
   vtkmdiy::save(bb, this->GetRank());
+  vtkmdiy::save(bb, this->LocalLoad);
   vtkmdiy::save(bb, c);
   this->SendData(dst, ParticleMessenger::PARTICLE_TAG, bb);
 }
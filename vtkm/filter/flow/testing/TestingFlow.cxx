@@ -144,7 +144,8 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
                             bool useThreaded,
                             bool useAsyncComm,
                             bool useBlockIds,
-                            bool duplicateBlocks)
+                            bool duplicateBlocks,
+                            bool useLoadBalancing)
 {
   auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
   if (comm.rank() == 0)
@@ -175,6 +176,8 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
       std::cout << " - using block IDs";
     if (duplicateBlocks)
       std::cout << " - with duplicate blocks";
+    if (useLoadBalancing)
+      std::cout << " - using load balancing";
     std::cout << " - on a partitioned data set" << std::endl;
   }
 
@@ -231,7 +234,8 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
                 useThreaded,
                 useAsyncComm,
                 useBlockIds,
-                blockIds);
+                blockIds,
+                useLoadBalancing);
       auto out = streamline.Execute(pds);
 
       vtkm::Id numOutputs = out.GetNumberOfPartitions();
@@ -257,7 +261,8 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
                 useThreaded,
                 useAsyncComm,
                 useBlockIds,
-                blockIds);
+                blockIds,
+                useLoadBalancing);
 
       auto out = particleAdvection.Execute(pds);
 
@@ -292,7 +297,8 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
                 useThreaded,
                 useAsyncComm,
                 useBlockIds,
-                blockIds);
+                blockIds,
+                useLoadBalancing);
 
       pathline.SetPreviousTime(time0);
       pathline.SetNextTime(time1);
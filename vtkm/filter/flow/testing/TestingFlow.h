@@ -48,13 +48,15 @@ void SetFilter(FilterType& filter,
                bool useThreaded,
                bool useAsyncComm,
                bool useBlockIds,
-               const std::vector<vtkm::Id>& blockIds)
+               const std::vector<vtkm::Id>& blockIds,
+               bool useLoadBalancing = false)
 {
   filter.SetStepSize(stepSize);
   filter.SetNumberOfSteps(numSteps);
   filter.SetSeeds(seedArray);
   filter.SetActiveField(fieldName);
   filter.SetUseThreadedAlgorithm(useThreaded);
+  filter.SetUseLoadBalancing(useLoadBalancing);
   if (useAsyncComm)
     filter.SetUseAsynchronousCommunication();
   else
@@ -77,6 +79,7 @@ void TestPartitionedDataSet(vtkm::Id nPerRank,
                             bool useThreaded,
                             bool useAsyncComm,
                             bool useBlockIds,
-                            bool duplicateBlocks);
+                            bool duplicateBlocks,
+                            bool useLoadBalancing = false);
 
 #endif // vtk_m_filter_flow_testing_TestingFlow_h
@@ -393,10 +393,59 @@ void Test3DLCS()
   }
 }
 
+void TestTimeWindows()
+{
+  //A saddle flow stretches by exp(t) along x, so the FTLE of every window is 1.
+  const vtkm::Id3 dims(21, 21, 3);
+  vtkm::cont::DataSet input = vtkm::cont::DataSetBuilderUniform::Create(
+    dims, vtkm::Vec3f(-1, -1, 0), vtkm::Vec3f(.1f, .1f, .5f));
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  vtkm::cont::ArrayCopy(input.GetCoordinateSystem().GetData(), points);
+  std::vector<vtkm::Vec3f> velocities;
+  auto pointsPortal = points.ReadPortal();
+  for (vtkm::Id i = 0; i < points.GetNumberOfValues(); i++)
+  {
+    vtkm::Vec3f pt = pointsPortal.Get(i);
+    velocities.emplace_back(pt[0], -pt[1], 0);
+  }
+  input.AddPointField("velocity", velocities);
+
+  const vtkm::Id numWindows = 3;
+  vtkm::filter::flow::LagrangianStructures lagrangianStructures;
+  lagrangianStructures.SetStepSize(0.01f);
+  lagrangianStructures.SetNumberOfSteps(10);
+  lagrangianStructures.SetAdvectionTime(0.01f * 10);
+  lagrangianStructures.SetActiveField("velocity");
+  vtkm::cont::DataSet single = lagrangianStructures.Execute(input);
+
+  lagrangianStructures.SetNumberOfTimeWindows(numWindows);
+  vtkm::cont::DataSet windows = lagrangianStructures.Execute(input);
+  VTKM_TEST_ASSERT(!windows.HasField("FTLE"), "Unexpected single window field");
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(single.GetField("FTLE").GetData(),
+                                           windows.GetField("FTLE_1").GetData()),
+                   "First window differs from the single window");
+
+  for (vtkm::Id window = 1; window <= numWindows; window++)
+  {
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> ftle;
+    windows.GetField("FTLE_" + std::to_string(window)).GetData().AsArrayHandle(ftle);
+    auto ftlePortal = ftle.ReadPortal();
+    for (vtkm::Id i = 0; i < ftle.GetNumberOfValues(); i++)
+    {
+      //Points near the ends of the x axis leave the grid.
+      if (vtkm::Abs(pointsPortal.Get(i)[0]) > .5f)
+        continue;
+      VTKM_TEST_ASSERT(test_equal(ftlePortal.Get(i), 1.0f, 1e-3), "Wrong FTLE of time window");
+    }
+  }
+}
+
 void TestLagrangianStructures()
 {
   Test2DLCS();
   Test3DLCS();
+  TestTimeWindows();
 }
 
 int UnitTestLagrangianStructuresFilter(int argc, char* argv[])
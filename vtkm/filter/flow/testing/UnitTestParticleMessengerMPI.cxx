@@ -278,8 +278,10 @@ void TestBufferSizes()
           particleData.push_back(std::make_pair(p, bids));
         }
 
+        vtkm::Id load = 0;
         vtkmdiy::MemoryBuffer mbP;
         vtkmdiy::save(mbP, rank);
+        vtkmdiy::save(mbP, load);
         vtkmdiy::save(mbP, particleData);
         VTKM_TEST_ASSERT(mbP.size() == pSize, "Particle buffer sizes not equal");
       }
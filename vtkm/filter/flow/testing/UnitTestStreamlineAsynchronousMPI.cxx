@@ -39,6 +39,8 @@ void DoTest()
               nPerRank, useGhost, filterType, useThreaded, useAsyncComm, useBlockIds, false);
             TestPartitionedDataSet(
               nPerRank, useGhost, filterType, useThreaded, useAsyncComm, useBlockIds, true);
+            TestPartitionedDataSet(
+              nPerRank, useGhost, filterType, useThreaded, useAsyncComm, useBlockIds, true, true);
           }
           else
           {
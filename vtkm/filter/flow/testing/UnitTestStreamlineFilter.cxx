@@ -17,6 +17,7 @@
 #include <vtkm/filter/flow/PathParticle.h>
 #include <vtkm/filter/flow/Pathline.h>
 #include <vtkm/filter/flow/Streamline.h>
+#include <vtkm/filter/flow/TemporalDataProvider.h>
 #include <vtkm/io/VTKDataSetReader.h>
 #include <vtkm/worklet/testing/GenerateTestDataSets.h>
 
@@ -87,6 +88,48 @@ void TestStreamline()
   }
 }
 
+void TestAdaptiveSolver()
+{
+  const vtkm::Id3 dims(5, 5, 5);
+  const vtkm::Bounds bounds(0, 4, 0, 4, 0, 4);
+  std::string fieldName = "vec";
+
+  auto dataSets = vtkm::worklet::testing::CreateAllDataSets(bounds, dims, false);
+  for (auto& ds : dataSets)
+  {
+    auto vecField = CreateConstantVectorField(ds.GetNumberOfPoints(), vtkm::Vec3f(1, 0, 0));
+    ds.AddPointField(fieldName, vecField);
+    vtkm::cont::ArrayHandle<vtkm::Particle> seedArray =
+      vtkm::cont::make_ArrayHandle({ vtkm::Particle(vtkm::Vec3f(.2f, 1.0f, .2f), 0),
+                                     vtkm::Particle(vtkm::Vec3f(.2f, 2.0f, .2f), 1) });
+
+    vtkm::filter::flow::Streamline streamline;
+    streamline.SetSolverRK45();
+    streamline.SetStepSize(0.01f);
+    streamline.SetMaximumStepSize(0.5f);
+    streamline.SetNumberOfSteps(1000);
+    streamline.SetSeeds(seedArray);
+    streamline.SetActiveField(fieldName);
+    auto output = streamline.Execute(ds);
+
+    //A constant field has no error, so the steps grow to the maximum and the streamlines
+    //cross the dataset in a few steps.
+    VTKM_TEST_ASSERT(output.GetNumberOfCells() == 2, "Wrong number of cells");
+    VTKM_TEST_ASSERT(output.GetNumberOfPoints() < 40, "Adaptive steps did not grow");
+
+    auto coords = output.GetCoordinateSystem().GetDataAsMultiplexer();
+    auto cells = output.GetCellSet().AsCellSet<vtkm::cont::CellSetExplicit<>>();
+    for (vtkm::Id i = 0; i < 2; i++)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Id> indices;
+      cells.GetIndices(i, indices);
+      vtkm::Vec3f lastPt =
+        coords.ReadPortal().Get(indices.ReadPortal().Get(indices.GetNumberOfValues() - 1));
+      VTKM_TEST_ASSERT(lastPt[0] >= 4 && lastPt[0] < 4.5, "Wrong end point for seed");
+    }
+  }
+}
+
 void TestPathline()
 {
   const vtkm::Id3 dims(5, 5, 5);
@@ -162,6 +205,106 @@ void TestPathline()
   }
 }
 
+class ConstantFlowProvider : public vtkm::filter::flow::TemporalDataProvider
+{
+public:
+  ConstantFlowProvider(vtkm::Id numSteps, const std::string& fieldName)
+    : FieldName(fieldName)
+    , NumberOfSteps(numSteps)
+  {
+  }
+
+  vtkm::Id GetNumberOfTimeSteps() const override { return this->NumberOfSteps; }
+
+  vtkm::FloatDefault GetTime(vtkm::Id step) const override
+  {
+    return static_cast<vtkm::FloatDefault>(step) / 2;
+  }
+
+  vtkm::cont::PartitionedDataSet LoadTimeStep(vtkm::Id step) override
+  {
+    VTKM_TEST_ASSERT(step >= 0 && step < this->NumberOfSteps, "Loading a wrong time step");
+    const vtkm::Id3 dims(5, 5, 5);
+    auto ds = vtkm::cont::DataSetBuilderUniform::Create(dims);
+    ds.AddPointField(this->FieldName,
+                     CreateConstantVectorField(ds.GetNumberOfPoints(), vtkm::Vec3f(.5f, 0, 0)));
+    return vtkm::cont::PartitionedDataSet(ds);
+  }
+
+private:
+  std::string FieldName;
+  vtkm::Id NumberOfSteps;
+};
+
+void TestTemporalDataCache()
+{
+  const std::string fieldName = "vec";
+  auto provider = std::make_shared<ConstantFlowProvider>(5, fieldName);
+
+  //The least recently used time step is evicted.
+  {
+    vtkm::filter::flow::TemporalDataCache cache(provider, 2);
+    cache.GetTimeStep(0);
+    cache.GetTimeStep(1);
+    cache.GetTimeStep(0);
+    cache.GetTimeStep(2);
+    VTKM_TEST_ASSERT(cache.IsCached(0) && cache.IsCached(2) && !cache.IsCached(1),
+                     "Wrong time steps in cache");
+    cache.Prefetch(3);
+    VTKM_TEST_ASSERT(cache.IsCached(3) && !cache.IsCached(0), "Wrong time steps in cache");
+    cache.GetTimeStep(3);
+    cache.GetTimeStep(2);
+    VTKM_TEST_ASSERT(cache.GetNumberOfLoads() == 4, "Wrong number of loads");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Particle> seedArray =
+    vtkm::cont::make_ArrayHandle({ vtkm::Particle(vtkm::Vec3f(.2f, 1.0f, .2f), 0),
+                                   vtkm::Particle(vtkm::Vec3f(.2f, 2.0f, .2f), 1),
+                                   vtkm::Particle(vtkm::Vec3f(.2f, 3.0f, .2f), 2) });
+
+  for (int fType = 0; fType < 2; fType++)
+  {
+    vtkm::filter::flow::TemporalDataCache cache(provider);
+    vtkm::cont::PartitionedDataSet output;
+    if (fType == 0)
+    {
+      vtkm::filter::flow::Pathline filt;
+      filt.SetActiveField(fieldName);
+      filt.SetStepSize(0.1f);
+      filt.SetNumberOfSteps(1000);
+      filt.SetSeeds(seedArray);
+      output = filt.ExecuteTimeSteps(cache, 0, 4);
+    }
+    else
+    {
+      vtkm::filter::flow::PathParticle filt;
+      filt.SetActiveField(fieldName);
+      filt.SetStepSize(0.1f);
+      filt.SetNumberOfSteps(1000);
+      filt.SetSeeds(seedArray);
+      output = filt.ExecuteTimeSteps(cache, 0, 4);
+    }
+
+    VTKM_TEST_ASSERT(cache.GetNumberOfLoads() == 5, "Time steps loaded more than once");
+    VTKM_TEST_ASSERT(output.GetNumberOfPartitions() == 4, "Wrong number of partitions");
+    //The flow moves the particles by .25 in each interval of time steps.
+    for (vtkm::Id i = 0; i < 4; i++)
+    {
+      auto ds = output.GetPartition(i);
+      VTKM_TEST_ASSERT(ds.GetCellSet().GetNumberOfCells() == 3, "Wrong number of cells");
+
+      vtkm::cont::ArrayHandle<vtkm::Vec3f> pts;
+      vtkm::cont::ArrayCopyShallowIfPossible(ds.GetCoordinateSystem().GetData(), pts);
+      auto portal = pts.ReadPortal();
+      vtkm::FloatDefault xMax = 0;
+      for (vtkm::Id j = 0; j < portal.GetNumberOfValues(); j++)
+        xMax = vtkm::Max(xMax, portal.Get(j)[0]);
+      vtkm::FloatDefault xEnd = .2f + .25f * static_cast<vtkm::FloatDefault>(i + 1);
+      VTKM_TEST_ASSERT(test_equal(xMax, xEnd), "Wrong end point for seed");
+    }
+  }
+}
+
 void TestAMRStreamline(bool useSL)
 {
   vtkm::Bounds outerBounds(0, 10, 0, 10, 0, 10);
@@ -490,6 +633,62 @@ void TestPartitionedDataSet(vtkm::Id num, bool useGhost, FilterType fType)
   }
 }
 
+void TestThreadedAlgorithm(vtkm::Id numWorkers)
+{
+  const vtkm::Id numBlocks = 3;
+  const vtkm::Id3 dims(5, 5, 5);
+  std::vector<vtkm::Bounds> bounds;
+  for (vtkm::Id i = 0; i < numBlocks; i++)
+  {
+    vtkm::FloatDefault x0 = static_cast<vtkm::FloatDefault>(4 * i);
+    bounds.push_back(vtkm::Bounds(x0, x0 + 4, 0, 4, 0, 4));
+  }
+
+  std::string fieldName = "vec";
+  auto pds = vtkm::worklet::testing::CreateAllDataSets(bounds, dims, false)[0];
+  AddVectorFields(pds, fieldName, vtkm::Vec3f(1, 0, 0));
+
+  //Seed the first and the last block so that some particles cross blocks.
+  std::vector<vtkm::Particle> seeds;
+  vtkm::Id id = 0;
+  for (vtkm::FloatDefault x : { 0.2f, 8.2f })
+    for (vtkm::Id j = 0; j < 5; j++)
+      for (vtkm::Id k = 0; k < 5; k++)
+      {
+        vtkm::Vec3f pt(x, 0.5f + 0.75f * j, 0.5f + 0.75f * k);
+        seeds.push_back(vtkm::Particle(pt, id++));
+      }
+  vtkm::Id numSeeds = static_cast<vtkm::Id>(seeds.size());
+
+  vtkm::cont::PartitionedDataSet out[2];
+  for (int useThreaded = 0; useThreaded < 2; useThreaded++)
+  {
+    vtkm::filter::flow::Streamline streamline;
+    streamline.SetStepSize(0.1f);
+    streamline.SetNumberOfSteps(100000);
+    streamline.SetSeeds(seeds);
+    streamline.SetActiveField(fieldName);
+    streamline.SetUseThreadedAlgorithm(useThreaded == 1);
+    streamline.SetNumberOfWorkerThreads(numWorkers);
+    out[useThreaded] = streamline.Execute(pds);
+  }
+
+  VTKM_TEST_ASSERT(out[1].GetNumberOfPartitions() == numBlocks, "Wrong number of partitions");
+  vtkm::Id numCells = 0;
+  for (vtkm::Id i = 0; i < numBlocks; i++)
+  {
+    auto expected = out[0].GetPartition(i);
+    auto result = out[1].GetPartition(i);
+    VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                     "Wrong number of points in threaded streamlines");
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                     "Wrong number of cells in threaded streamlines");
+    numCells += result.GetNumberOfCells();
+  }
+  //Seeds in the first block cross all three blocks; seeds in the last block stay there.
+  VTKM_TEST_ASSERT(numCells == numSeeds * 2, "Wrong number of streamline pieces");
+}
+
 template <typename CellSetType, typename CoordsType>
 void ValidateEndPoints(const CellSetType& cellSet,
                        const CoordsType& coords,
@@ -595,8 +794,13 @@ void TestStreamlineFilters()
         TestPartitionedDataSet(n, useGhost, ft);
   }
 
+  for (vtkm::Id numWorkers : { 0, 1, 4 })
+    TestThreadedAlgorithm(numWorkers);
+
   TestStreamline();
+  TestAdaptiveSolver();
   TestPathline();
+  TestTemporalDataCache();
 
   for (auto useSL : flags)
     TestAMRStreamline(useSL);
@@ -13,6 +13,7 @@
 #include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/flow/worklet/Analysis.h>
 #include <vtkm/filter/flow/worklet/EulerIntegrator.h>
@@ -20,6 +21,7 @@
 #include <vtkm/filter/flow/worklet/GridEvaluators.h>
 #include <vtkm/filter/flow/worklet/ParticleAdvection.h>
 #include <vtkm/filter/flow/worklet/Particles.h>
+#include <vtkm/filter/flow/worklet/RK45Integrator.h>
 #include <vtkm/filter/flow/worklet/RK4Integrator.h>
 #include <vtkm/filter/flow/worklet/Stepper.h>
 #include <vtkm/filter/flow/worklet/Termination.h>
@@ -524,6 +526,77 @@ void TestIntegrators()
       //res = pa.Run(euler, seeds, maxSteps);
       //ValidateParticleAdvectionResult(res, nSeeds, maxSteps);
     }
+    {
+      auto seeds = vtkm::cont::make_ArrayHandle(points, vtkm::CopyFlag::On);
+      using IntegratorType = vtkm::worklet::flow::RK45Integrator<GridEvalType>;
+      using Stepper = vtkm::worklet::flow::Stepper<IntegratorType, GridEvalType>;
+      Stepper rk45(eval, stepSize);
+      pa.Run(rk45, seeds, termination, analysis);
+      ValidateParticleAdvectionResult(analysis, nSeeds, maxSteps);
+    }
+  }
+}
+
+void TestAdaptiveIntegrator()
+{
+  using FieldHandle = vtkm::cont::ArrayHandle<vtkm::Vec3f>;
+  using FieldType = vtkm::worklet::flow::VelocityField<FieldHandle>;
+  using GridEvalType = vtkm::worklet::flow::GridEvaluator<FieldType>;
+  using Termination = vtkm::worklet::flow::NormalTermination;
+  using Analysis = vtkm::worklet::flow::NoAnalysis<vtkm::Particle>;
+
+  //A rotation about the z axis. The field is linear, so it is interpolated exactly and
+  //a particle starting at (r, 0, 0) is at (r cos t, r sin t, 0) at time t.
+  const vtkm::Id3 dims(21, 21, 3);
+  const vtkm::Vec3f origin(-2, -2, -1);
+  const vtkm::Vec3f spacing(0.2f, 0.2f, 1.0f);
+  vtkm::cont::DataSet ds = vtkm::cont::DataSetBuilderUniform::Create(dims, origin, spacing);
+  std::vector<vtkm::Vec3f> fieldData;
+  for (vtkm::Id k = 0; k < dims[2]; k++)
+    for (vtkm::Id j = 0; j < dims[1]; j++)
+      for (vtkm::Id i = 0; i < dims[0]; i++)
+      {
+        vtkm::FloatDefault x = origin[0] + static_cast<vtkm::FloatDefault>(i) * spacing[0];
+        vtkm::FloatDefault y = origin[1] + static_cast<vtkm::FloatDefault>(j) * spacing[1];
+        fieldData.push_back(vtkm::Vec3f(-y, x, 0));
+      }
+  FieldType velocities(vtkm::cont::make_ArrayHandle(fieldData, vtkm::CopyFlag::On));
+  GridEvalType eval(ds, velocities);
+
+  std::vector<vtkm::Particle> points;
+  points.push_back(vtkm::Particle(vtkm::Vec3f(1.0f, 0, 0), 0));
+  points.push_back(vtkm::Particle(vtkm::Vec3f(0, 1.5f, 0), 1));
+
+  const vtkm::Id maxSteps = 200;
+  const vtkm::FloatDefault stepSize = 0.001f;
+  const vtkm::FloatDefault tolerance = 1e-6f;
+
+  using IntegratorType = vtkm::worklet::flow::RK45Integrator<GridEvalType>;
+  using Stepper = vtkm::worklet::flow::Stepper<IntegratorType, GridEvalType>;
+  Stepper rk45(eval, stepSize);
+  rk45.SetErrorTolerance(tolerance);
+  rk45.SetStepSizeRange(0, 0.5f);
+
+  vtkm::worklet::flow::ParticleAdvection pa;
+  Termination termination(maxSteps);
+  Analysis analysis;
+  auto seeds = vtkm::cont::make_ArrayHandle(points, vtkm::CopyFlag::On);
+  pa.Run(rk45, seeds, termination, analysis);
+
+  auto portal = analysis.Particles.ReadPortal();
+  for (vtkm::Id i = 0; i < portal.GetNumberOfValues(); i++)
+  {
+    vtkm::Particle p = portal.Get(i);
+    VTKM_TEST_ASSERT(p.GetNumberOfSteps() == maxSteps, "Wrong number of steps");
+    //The steps grow from the first one, so fixed steps would only reach t = 0.2.
+    vtkm::FloatDefault t = p.GetTime();
+    VTKM_TEST_ASSERT(t > 10, "Adaptive steps did not grow");
+
+    vtkm::Vec3f start = points[static_cast<std::size_t>(i)].GetPosition();
+    vtkm::FloatDefault c = vtkm::Cos(t), s = vtkm::Sin(t);
+    vtkm::Vec3f expected(c * start[0] - s * start[1], s * start[0] + c * start[1], 0);
+    VTKM_TEST_ASSERT(vtkm::Magnitude(p.GetPosition() - expected) < 1e-3f,
+                     "Adaptive integration is not accurate");
   }
 }
 
@@ -726,7 +799,11 @@ void TestWorkletsBasic()
     Stepper rk4(eval, stepSize);
 
     vtkm::Id maxSteps = 83;
-    std::vector<std::string> workletTypes = { "particleAdvection", "streamline" };
+    std::vector<std::string> workletTypes = { "particleAdvection",
+                                              "particleAdvectionReordered",
+                                              "streamline",
+                                              "streamlineSmallChunks",
+                                              "streamlineReordered" };
     vtkm::FloatDefault endT = stepSize * static_cast<vtkm::FloatDefault>(maxSteps);
 
     for (auto w : workletTypes)
@@ -759,9 +836,13 @@ void TestWorkletsBasic()
 
       auto seedsArray = vtkm::cont::make_ArrayHandle(particles, vtkm::CopyFlag::On);
 
-      if (w == "particleAdvection")
+      //Reordering the particles between rounds of steps must not change the results.
+      vtkm::worklet::flow::ParticleAdvection pa;
+      if (w == "particleAdvectionReordered" || w == "streamlineReordered")
+        pa.SetReorderInterval(10);
+
+      if (w == "particleAdvection" || w == "particleAdvectionReordered")
       {
-        vtkm::worklet::flow::ParticleAdvection pa;
         Termination termination(maxSteps);
         PAnalysis analysis;
         pa.Run(rk4, seedsArray, termination, analysis);
@@ -784,11 +865,15 @@ void TestWorkletsBasic()
                            "Particle advection particle did not terminate");
         }
       }
-      else if (w == "streamline")
+      else
       {
-        vtkm::worklet::flow::ParticleAdvection pa;
         Termination termination(maxSteps);
         SAnalysis analysis(maxSteps);
+        if (w == "streamlineSmallChunks" || w == "streamlineReordered")
+        {
+          // The streamlines need more chunks than the initial pool holds.
+          analysis.SetChunkSize(5);
+        }
         pa.Run(rk4, seedsArray, termination, analysis);
 
         vtkm::Id numRequiredPoints = static_cast<vtkm::Id>(samplePts.size());
@@ -944,6 +1029,7 @@ void TestParticleAdvectionFile(const std::string& fileName,
 void TestParticleAdvection()
 {
   TestIntegrators();
+  TestAdaptiveIntegrator();
   TestEvaluators();
   TestGhostCellEvaluators();
 
@@ -15,6 +15,7 @@
 
 #include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleView.h>
 #include <vtkm/cont/ConvertNumComponentsToOffsets.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/Invoker.h>
@@ -61,60 +62,157 @@ VTKM_CONT bool NoAnalysis<ParticleType>::MakeDataSet(
 
 namespace detail
 {
-class GetSteps : public vtkm::worklet::WorkletMapField
+struct IsStalled
+{
+  VTKM_EXEC_CONT bool operator()(const vtkm::Id& currentChunk) const
+  {
+    return currentChunk == StreamlineAnalysisExec<vtkm::Particle>::Stalled;
+  }
+};
+
+class AssignChunks : public vtkm::worklet::WorkletMapField
 {
 public:
   VTKM_CONT
-  GetSteps() {}
-  using ControlSignature = void(FieldIn, FieldOut);
-  using ExecutionSignature = void(_1, _2);
-
-  template <typename ParticleType>
-  VTKM_EXEC void operator()(const ParticleType& p, vtkm::Id& numSteps) const
+  AssignChunks(vtkm::Id firstChunk, vtkm::Id chunkSize)
+    : FirstChunk(firstChunk)
+    , ChunkSize(chunkSize)
+  {
+  }
+  using ControlSignature = void(FieldIn particleIds,
+                                WholeArrayIn streamLengths,
+                                WholeArrayInOut currentChunks,
+                                WholeArrayInOut chunkOwners,
+                                WholeArrayInOut chunkSequence);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5);
+
+  template <typename LengthsPortal, typename ChunksPortal, typename OwnersPortal>
+  VTKM_EXEC void operator()(vtkm::Id workIndex,
+                            vtkm::Id particleId,
+                            const LengthsPortal& streamLengths,
+                            const ChunksPortal& currentChunks,
+                            const OwnersPortal& chunkOwners,
+                            const OwnersPortal& chunkSequence) const
   {
-    numSteps = p.GetNumberOfSteps();
+    const vtkm::Id chunk = this->FirstChunk + workIndex;
+    chunkOwners.Set(chunk, particleId);
+    chunkSequence.Set(chunk, streamLengths.Get(particleId) / this->ChunkSize);
+    currentChunks.Set(particleId, chunk);
   }
+
+private:
+  vtkm::Id FirstChunk;
+  vtkm::Id ChunkSize;
 };
 
-class ComputeNumPoints : public vtkm::worklet::WorkletMapField
+// Copies the points of each chunk to their place in the streamline of its particle.
+class GatherChunks : public vtkm::worklet::WorkletMapField
 {
 public:
   VTKM_CONT
-  ComputeNumPoints() {}
-  using ControlSignature = void(FieldIn, FieldIn, FieldOut);
-  using ExecutionSignature = void(_1, _2, _3);
-
-  // Offset is number of points in streamline.
-  // 1 (inital point) + number of steps taken (p.NumSteps - initalNumSteps)
-  template <typename ParticleType>
-  VTKM_EXEC void operator()(const ParticleType& p,
-                            const vtkm::Id& initialNumSteps,
-                            vtkm::Id& diff) const
+  GatherChunks(vtkm::Id chunkSize)
+    : ChunkSize(chunkSize)
   {
-    diff = 1 + p.GetNumberOfSteps() - initialNumSteps;
   }
+  using ControlSignature = void(FieldIn chunkOwners,
+                                FieldIn chunkSequence,
+                                WholeArrayIn chunkPoints,
+                                WholeArrayIn streamLengths,
+                                WholeArrayIn streamOffsets,
+                                WholeArrayInOut streams);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5, _6);
+
+  template <typename PointsPortal, typename IdPortal, typename StreamsPortal>
+  VTKM_EXEC void operator()(vtkm::Id chunk,
+                            vtkm::Id owner,
+                            vtkm::Id sequence,
+                            const PointsPortal& chunkPoints,
+                            const IdPortal& streamLengths,
+                            const IdPortal& streamOffsets,
+                            const StreamsPortal& streams) const
+  {
+    const vtkm::Id first = sequence * this->ChunkSize;
+    const vtkm::Id count = vtkm::Min(this->ChunkSize, streamLengths.Get(owner) - first);
+    const vtkm::Id outStart = streamOffsets.Get(owner) + first;
+    for (vtkm::Id i = 0; i < count; ++i)
+    {
+      streams.Set(outStart + i, chunkPoints.Get(chunk * this->ChunkSize + i));
+    }
+  }
+
+private:
+  vtkm::Id ChunkSize;
 };
 
 } // namespace detail
 
+template <typename ParticleType>
+VTKM_CONT void StreamlineAnalysis<ParticleType>::AllocateChunks(vtkm::Id numChunks)
+{
+  this->ChunkPoints.Allocate(numChunks * this->UsedChunkSize, vtkm::CopyFlag::On);
+  this->ChunkOwners.Allocate(numChunks, vtkm::CopyFlag::On);
+  this->ChunkSequence.Allocate(numChunks, vtkm::CopyFlag::On);
+}
+
 template <typename ParticleType>
 VTKM_CONT void StreamlineAnalysis<ParticleType>::InitializeAnalysis(
   const vtkm::cont::ArrayHandle<ParticleType>& particles)
 {
   this->NumParticles = particles.GetNumberOfValues();
 
-  //Create ValidPointArray initialized to zero.
-  vtkm::cont::ArrayHandleConstant<vtkm::Id> validity(0, this->NumParticles * (this->MaxSteps + 1));
-  vtkm::cont::ArrayCopy(validity, this->Validity);
-  //Create StepCountArray initialized to zero.
-  vtkm::cont::ArrayHandleConstant<vtkm::Id> streamLengths(0, this->NumParticles);
-  vtkm::cont::ArrayCopy(streamLengths, this->StreamLengths);
+  // A chunk never needs to be longer than the longest streamline, and it must
+  // hold at least the seed point and the first step.
+  this->UsedChunkSize =
+    vtkm::Max(vtkm::Id(2), vtkm::Min(this->ChunkSize, this->MaxSteps + 1));
+
+  // Every particle starts in the chunk with its own index. If streamlines can
+  // need more than one chunk, start with a second chunk for each particle.
+  vtkm::Id numChunks = this->NumParticles;
+  if (this->UsedChunkSize < this->MaxSteps + 1)
+  {
+    numChunks *= 2;
+  }
+
+  this->ChunkPoints.ReleaseResources();
+  this->ChunkSequence.AllocateAndFill(numChunks, 0);
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(this->NumParticles), this->ChunkOwners);
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(this->NumParticles), this->CurrentChunks);
+  this->AllocateChunks(numChunks);
+  this->NextChunk.AllocateAndFill(1, this->NumParticles);
+  this->StreamLengths.AllocateAndFill(this->NumParticles, 0);
+}
+
+template <typename ParticleType>
+VTKM_CONT bool StreamlineAnalysis<ParticleType>::MakeRoomForStalledParticles(
+  vtkm::cont::ArrayHandle<vtkm::Id>& stalledIds)
+{
+  vtkm::cont::Algorithm::CopyIf(vtkm::cont::ArrayHandleIndex(this->NumParticles),
+                                this->CurrentChunks,
+                                stalledIds,
+                                detail::IsStalled{});
+  const vtkm::Id numStalled = stalledIds.GetNumberOfValues();
+  if (numStalled == 0)
+  {
+    return false;
+  }
+
+  // Chunks are taken in order, so the used ones are all at the front. Failed
+  // attempts still bumped the counter past the end.
+  const vtkm::Id numChunks = this->ChunkOwners.GetNumberOfValues();
+  const vtkm::Id usedChunks = vtkm::Min(this->NextChunk.ReadPortal().Get(0), numChunks);
+
+  // Grow geometrically so that long streamlines only stall a few times.
+  this->AllocateChunks(vtkm::Max(2 * numChunks, usedChunks + numStalled));
 
-  // Initialize InitLengths
-  vtkm::Id numSeeds = static_cast<vtkm::Id>(particles.GetNumberOfValues());
-  vtkm::cont::ArrayHandleIndex idxArray(numSeeds);
   vtkm::cont::Invoker invoker;
-  invoker(detail::GetSteps{}, particles, this->InitialLengths);
+  invoker(detail::AssignChunks{ usedChunks, this->UsedChunkSize },
+          stalledIds,
+          this->StreamLengths,
+          this->CurrentChunks,
+          this->ChunkOwners,
+          this->ChunkSequence);
+  this->NextChunk.Fill(usedChunks + numStalled);
+  return true;
 }
 
 template <typename ParticleType>
@@ -122,17 +220,32 @@ VTKM_CONT void StreamlineAnalysis<ParticleType>::FinalizeAnalysis(
   vtkm::cont::ArrayHandle<ParticleType>& particles)
 {
   vtkm::Id numSeeds = particles.GetNumberOfValues();
-  vtkm::cont::ArrayHandle<vtkm::Vec3f> positions;
-  vtkm::cont::Algorithm::CopyIf(this->Streams, this->Validity, positions, IsOne());
-  vtkm::cont::Algorithm::Copy(positions, this->Streams);
 
-  // Create the cells
-  vtkm::cont::ArrayHandle<vtkm::Id> numPoints;
+  vtkm::cont::ArrayHandle<vtkm::Id> offsets;
+  vtkm::Id connectivityLen;
+  vtkm::cont::ConvertNumComponentsToOffsets(this->StreamLengths, offsets, connectivityLen);
+
+  // Gather the chunks into contiguous streamlines.
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> streams;
+  streams.Allocate(connectivityLen);
+  const vtkm::Id usedChunks =
+    vtkm::Min(this->NextChunk.ReadPortal().Get(0), this->ChunkOwners.GetNumberOfValues());
   vtkm::cont::Invoker invoker;
-  invoker(detail::ComputeNumPoints{}, particles, this->InitialLengths, numPoints);
+  invoker(detail::GatherChunks{ this->UsedChunkSize },
+          vtkm::cont::make_ArrayHandleView(this->ChunkOwners, 0, usedChunks),
+          vtkm::cont::make_ArrayHandleView(this->ChunkSequence, 0, usedChunks),
+          this->ChunkPoints,
+          this->StreamLengths,
+          offsets,
+          streams);
+  this->Streams = streams;
+
+  this->ChunkPoints.ReleaseResources();
+  this->ChunkOwners.ReleaseResources();
+  this->ChunkSequence.ReleaseResources();
+  this->CurrentChunks.ReleaseResources();
 
-  vtkm::cont::ArrayHandle<vtkm::Id> cellIndex;
-  vtkm::Id connectivityLen = vtkm::cont::Algorithm::ScanExclusive(numPoints, cellIndex);
+  // Create the cells
   vtkm::cont::ArrayHandleIndex connCount(connectivityLen);
   vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
   vtkm::cont::ArrayCopy(connCount, connectivity);
@@ -142,9 +255,7 @@ VTKM_CONT void StreamlineAnalysis<ParticleType>::FinalizeAnalysis(
     vtkm::cont::make_ArrayHandleConstant<vtkm::UInt8>(vtkm::CELL_SHAPE_POLY_LINE, numSeeds);
   vtkm::cont::ArrayCopy(polyLineShape, cellTypes);
 
-  auto offsets = vtkm::cont::ConvertNumComponentsToOffsets(numPoints);
-
-  this->PolyLines.Fill(this->Streams.GetNumberOfValues(), cellTypes, connectivity, offsets);
+  this->PolyLines.Fill(connectivityLen, cellTypes, connectivity, offsets);
   this->Particles = particles;
 }
 
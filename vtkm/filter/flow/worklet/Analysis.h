@@ -16,6 +16,7 @@
 #include <vtkm/Particle.h>
 #include <vtkm/Types.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/AtomicArray.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/ExecutionObjectBase.h>
 #include <vtkm/filter/flow/vtkm_filter_flow_export.h>
@@ -50,6 +51,12 @@ public:
     (void)oldParticle;
     (void)newParticle;
   }
+
+  VTKM_EXEC bool CanContinue(const vtkm::Id index)
+  {
+    (void)index;
+    return true;
+  }
 };
 
 template <typename ParticleType>
@@ -75,6 +82,13 @@ public:
     (void)particles;
   }
 
+  VTKM_CONT
+  bool MakeRoomForStalledParticles(vtkm::cont::ArrayHandle<vtkm::Id>& stalledIds)
+  {
+    (void)stalledIds;
+    return false;
+  }
+
   VTKM_CONT
   //template <typename ParticleType>
   void FinalizeAnalysis(vtkm::cont::ArrayHandle<ParticleType>& particles)
@@ -102,39 +116,44 @@ class VTKM_FILTER_FLOW_EXPORT StreamlineAnalysisExec
 public:
   VTKM_EXEC_CONT
   StreamlineAnalysisExec()
-    : NumParticles(0)
-    , MaxSteps(0)
-    , Streams()
+    : ChunkSize(0)
+    , NumChunks(0)
+    , ChunkPoints()
+    , ChunkOwners()
+    , ChunkSequence()
+    , NextChunk()
     , StreamLengths()
-    , Validity()
+    , CurrentChunks()
   {
   }
 
   VTKM_CONT
-  StreamlineAnalysisExec(vtkm::Id numParticles,
-                         vtkm::Id maxSteps,
-                         const vtkm::cont::ArrayHandle<vtkm::Vec3f>& streams,
+  StreamlineAnalysisExec(vtkm::Id chunkSize,
+                         const vtkm::cont::ArrayHandle<vtkm::Vec3f>& chunkPoints,
+                         const vtkm::cont::ArrayHandle<vtkm::Id>& chunkOwners,
+                         const vtkm::cont::ArrayHandle<vtkm::Id>& chunkSequence,
+                         const vtkm::cont::ArrayHandle<vtkm::Id>& nextChunk,
                          const vtkm::cont::ArrayHandle<vtkm::Id>& streamLengths,
-                         const vtkm::cont::ArrayHandle<vtkm::Id>& validity,
+                         const vtkm::cont::ArrayHandle<vtkm::Id>& currentChunks,
                          vtkm::cont::DeviceAdapterId device,
                          vtkm::cont::Token& token)
-    : NumParticles(numParticles)
-    , MaxSteps(maxSteps + 1)
+    : ChunkSize(chunkSize)
+    , NumChunks(chunkOwners.GetNumberOfValues())
   {
-    Streams = streams.PrepareForOutput(this->NumParticles * this->MaxSteps, device, token);
+    ChunkPoints = chunkPoints.PrepareForInPlace(device, token);
+    ChunkOwners = chunkOwners.PrepareForInPlace(device, token);
+    ChunkSequence = chunkSequence.PrepareForInPlace(device, token);
+    NextChunk = vtkm::cont::AtomicArray<vtkm::Id>(nextChunk).PrepareForExecution(device, token);
     StreamLengths = streamLengths.PrepareForInPlace(device, token);
-    Validity = validity.PrepareForInPlace(device, token);
+    CurrentChunks = currentChunks.PrepareForInPlace(device, token);
   }
 
   VTKM_EXEC void PreStepAnalyze(const vtkm::Id index, const ParticleType& particle)
   {
-    vtkm::Id streamLength = this->StreamLengths.Get(index);
-    if (streamLength == 0)
+    // A particle that resumes after waiting for a chunk already has its first point.
+    if (this->StreamLengths.Get(index) == 0)
     {
-      this->StreamLengths.Set(index, 1);
-      vtkm::Id loc = index * MaxSteps;
-      this->Streams.Set(loc, particle.GetPosition());
-      this->Validity.Set(loc, 1);
+      this->AddPoint(index, particle.GetPosition());
     }
   }
 
@@ -144,24 +163,74 @@ public:
                          const ParticleType& newParticle)
   {
     (void)oldParticle;
-    vtkm::Id streamLength = this->StreamLengths.Get(index);
-    vtkm::Id loc = index * MaxSteps + streamLength;
-    this->StreamLengths.Set(index, ++streamLength);
-    this->Streams.Set(loc, newParticle.GetPosition());
-    this->Validity.Set(loc, 1);
+    this->AddPoint(index, newParticle.GetPosition());
   }
 
+  /// Makes sure there is room for the next point of the streamline. If the
+  /// pool is out of chunks, the particle is marked as stalled and stops.
+  VTKM_EXEC bool CanContinue(const vtkm::Id index)
+  {
+    if (this->CurrentChunks.Get(index) != NeedsChunk)
+    {
+      return true;
+    }
+
+    const vtkm::Id chunk = this->NextChunk.Add(0, 1);
+    if (chunk >= this->NumChunks)
+    {
+      this->CurrentChunks.Set(index, Stalled);
+      return false;
+    }
+    this->ChunkOwners.Set(chunk, index);
+    this->ChunkSequence.Set(chunk, this->StreamLengths.Get(index) / this->ChunkSize);
+    this->CurrentChunks.Set(index, chunk);
+    return true;
+  }
+
+  /// The current chunk of a particle whose last chunk is full.
+  static constexpr vtkm::Id NeedsChunk = -1;
+  /// The current chunk of a particle that stopped because there was no free chunk.
+  static constexpr vtkm::Id Stalled = -2;
+
 private:
+  VTKM_EXEC void AddPoint(const vtkm::Id index, const vtkm::Vec3f& point)
+  {
+    const vtkm::Id streamLength = this->StreamLengths.Get(index);
+    const vtkm::Id chunk = this->CurrentChunks.Get(index);
+    this->ChunkPoints.Set(chunk * this->ChunkSize + streamLength % this->ChunkSize, point);
+    this->StreamLengths.Set(index, streamLength + 1);
+    if ((streamLength + 1) % this->ChunkSize == 0)
+    {
+      this->CurrentChunks.Set(index, NeedsChunk);
+    }
+  }
+
   using IdPortal = typename vtkm::cont::ArrayHandle<vtkm::Id>::WritePortalType;
   using VecPortal = typename vtkm::cont::ArrayHandle<vtkm::Vec3f>::WritePortalType;
 
-  vtkm::Id NumParticles;
-  vtkm::Id MaxSteps;
-  VecPortal Streams;
+  vtkm::Id ChunkSize;
+  vtkm::Id NumChunks;
+  VecPortal ChunkPoints;
+  IdPortal ChunkOwners;
+  IdPortal ChunkSequence;
+  vtkm::exec::AtomicArrayExecutionObject<vtkm::Id> NextChunk;
   IdPortal StreamLengths;
-  IdPortal Validity;
+  IdPortal CurrentChunks;
 };
 
+template <typename ParticleType>
+constexpr vtkm::Id StreamlineAnalysisExec<ParticleType>::NeedsChunk;
+template <typename ParticleType>
+constexpr vtkm::Id StreamlineAnalysisExec<ParticleType>::Stalled;
+
+/// \brief Records the path of each particle as a polyline.
+///
+/// The points of the streamlines are written into chunks of `ChunkSize` points
+/// that particles take from a shared pool as they advance. A particle that finds
+/// the pool empty stops, and the pool is grown before the stopped particles
+/// resume (see `MakeRoomForStalledParticles`). This way the memory used follows
+/// the number of steps actually taken rather than the maximum number of steps.
+/// `FinalizeAnalysis` gathers the chunks into contiguous streamlines.
 template <typename ParticleType>
 class StreamlineAnalysis : public vtkm::cont::ExecutionObjectBase
 {
@@ -171,15 +240,8 @@ public:
   vtkm::cont::ArrayHandle<vtkm::Vec3f> Streams;
   vtkm::cont::CellSetExplicit<> PolyLines;
 
-  //Helper functor for compacting history
-  struct IsOne
-  {
-    template <typename T>
-    VTKM_EXEC_CONT bool operator()(const T& x) const
-    {
-      return x == T(1);
-    }
-  };
+  /// The default number of points in each chunk of the streamline storage.
+  static constexpr vtkm::Id DefaultChunkSize = 64;
 
   VTKM_CONT
   StreamlineAnalysis()
@@ -196,17 +258,30 @@ public:
   }
 
   VTKM_CONT
-  void UseAsTemplate(const StreamlineAnalysis& other) { this->MaxSteps = other.MaxSteps; }
+  void UseAsTemplate(const StreamlineAnalysis& other)
+  {
+    this->MaxSteps = other.MaxSteps;
+    this->ChunkSize = other.ChunkSize;
+  }
+
+  /// Set the number of points in each chunk of the streamline storage. Larger
+  /// chunks waste more memory at the end of short streamlines, smaller chunks
+  /// take more allocations for long streamlines. The chunks never get larger
+  /// than the longest possible streamline.
+  VTKM_CONT void SetChunkSize(vtkm::Id chunkSize) { this->ChunkSize = chunkSize; }
+  VTKM_CONT vtkm::Id GetChunkSize() const { return this->ChunkSize; }
 
   VTKM_CONT StreamlineAnalysisExec<ParticleType> PrepareForExecution(
     vtkm::cont::DeviceAdapterId device,
     vtkm::cont::Token& token) const
   {
-    return StreamlineAnalysisExec<ParticleType>(this->NumParticles,
-                                                this->MaxSteps,
-                                                this->Streams,
+    return StreamlineAnalysisExec<ParticleType>(this->UsedChunkSize,
+                                                this->ChunkPoints,
+                                                this->ChunkOwners,
+                                                this->ChunkSequence,
+                                                this->NextChunk,
                                                 this->StreamLengths,
-                                                this->Validity,
+                                                this->CurrentChunks,
                                                 device,
                                                 token);
   }
@@ -216,6 +291,10 @@ public:
   VTKM_CONT
   void InitializeAnalysis(const vtkm::cont::ArrayHandle<ParticleType>& particles);
 
+  /// Grows the chunk pool and gives a new chunk to each particle that stopped
+  /// because the pool was empty. Returns false if no particle is waiting.
+  VTKM_CONT bool MakeRoomForStalledParticles(vtkm::cont::ArrayHandle<vtkm::Id>& stalledIds);
+
   VTKM_CONT
   //template <typename ParticleType>
   void FinalizeAnalysis(vtkm::cont::ArrayHandle<ParticleType>& particles);
@@ -225,14 +304,24 @@ public:
                                     const std::vector<StreamlineAnalysis>& results);
 
 private:
+  VTKM_CONT void AllocateChunks(vtkm::Id numChunks);
+
   vtkm::Id NumParticles;
   vtkm::Id MaxSteps;
+  vtkm::Id ChunkSize = DefaultChunkSize;
+  vtkm::Id UsedChunkSize = 0;
 
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> ChunkPoints;
+  vtkm::cont::ArrayHandle<vtkm::Id> ChunkOwners;
+  vtkm::cont::ArrayHandle<vtkm::Id> ChunkSequence;
+  vtkm::cont::ArrayHandle<vtkm::Id> NextChunk;
   vtkm::cont::ArrayHandle<vtkm::Id> StreamLengths;
-  vtkm::cont::ArrayHandle<vtkm::Id> InitialLengths;
-  vtkm::cont::ArrayHandle<vtkm::Id> Validity;
+  vtkm::cont::ArrayHandle<vtkm::Id> CurrentChunks;
 };
 
+template <typename ParticleType>
+constexpr vtkm::Id StreamlineAnalysis<ParticleType>::DefaultChunkSize;
+
 #ifndef vtk_m_filter_flow_worklet_Analysis_cxx
 extern template class VTKM_FILTER_FLOW_TEMPLATE_EXPORT NoAnalysis<vtkm::Particle>;
 extern template class VTKM_FILTER_FLOW_TEMPLATE_EXPORT NoAnalysis<vtkm::ChargedParticle>;
@@ -64,7 +64,7 @@ public:
     vtkm::Id cellId = -1;
     Point parametric;
 
-    this->Locator.FindCell(point, cellId, parametric);
+    this->Locator.FindCell(point, cellId, parametric, this->LastCellHint);
 
     if (cellId == -1)
       return false;
@@ -102,7 +102,7 @@ public:
       status.SetTemporalBounds();
     }
 
-    this->Locator.FindCell(point, cellId, parametric);
+    this->Locator.FindCell(point, cellId, parametric, this->LastCellHint);
     if (cellId == -1)
     {
       status.SetFail();
@@ -186,6 +186,9 @@ private:
   bool HaveGhostCells;
   vtkm::exec::CellInterpolationHelper InterpolationHelper;
   typename vtkm::cont::CellLocatorGeneral::ExecObjType Locator;
+  // The cell of the last point found. A worklet gets its own copy of an execution object
+  // for each invocation, so the hint follows one particle from step to step.
+  mutable typename vtkm::cont::CellLocatorGeneral::LastCell LastCellHint;
 };
 
 template <typename FieldType>
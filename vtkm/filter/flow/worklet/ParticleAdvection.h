@@ -53,6 +53,10 @@ class ParticleAdvection
 public:
   ParticleAdvection() {}
 
+  /// @copydoc ParticleAdvectionWorklet::SetReorderInterval
+  VTKM_CONT void SetReorderInterval(vtkm::Id interval) { this->ReorderInterval = interval; }
+  VTKM_CONT vtkm::Id GetReorderInterval() const { return this->ReorderInterval; }
+
   template <typename IntegratorType,
             typename ParticleType,
             typename ParticleStorage,
@@ -66,6 +70,7 @@ public:
     vtkm::worklet::flow::
       ParticleAdvectionWorklet<IntegratorType, ParticleType, TerminationType, AnalysisType>
         worklet;
+    worklet.SetReorderInterval(this->ReorderInterval);
     worklet.Run(it, particles, termination, analysis);
   }
 
@@ -82,6 +87,7 @@ public:
     vtkm::worklet::flow::
       ParticleAdvectionWorklet<IntegratorType, ParticleType, TerminationType, AnalysisType>
         worklet;
+    worklet.SetReorderInterval(this->ReorderInterval);
 
     vtkm::cont::ArrayHandle<ParticleType> particles;
     vtkm::cont::ArrayHandle<vtkm::Id> step, ids;
@@ -101,6 +107,9 @@ public:
 
     worklet.Run(it, particles, termination, analysis);
   }
+
+private:
+  vtkm::Id ReorderInterval = 0;
 };
 
 }
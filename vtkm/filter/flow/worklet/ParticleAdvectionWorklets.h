@@ -12,11 +12,14 @@
 #define vtk_m_filter_flow_worklet_ParticleAdvectionWorklets_h
 
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayRangeCompute.h>
 #include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/cont/ConvertNumComponentsToOffsets.h>
 #include <vtkm/cont/ExecutionObjectBase.h>
 #include <vtkm/cont/Invoker.h>
 
+#include <vtkm/MortonCodes.h>
 #include <vtkm/Particle.h>
 #include <vtkm/filter/flow/worklet/Particles.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -47,6 +50,25 @@ public:
   {
   }
 
+  /// When `resume` is on, the particles continue an advection that the analysis
+  /// stopped, so they keep the record of the steps they took before.
+  VTKM_EXEC_CONT
+  ParticleAdvectWorklet(bool pushOutOfBounds, bool resume)
+    : PushOutOfBounds(pushOutOfBounds)
+    , Resume(resume)
+  {
+  }
+
+  /// If `maxRoundSteps` is positive, a particle stops after this many steps even if it
+  /// could continue. It continues in a later invocation with `resume` on.
+  VTKM_EXEC_CONT
+  ParticleAdvectWorklet(bool pushOutOfBounds, bool resume, vtkm::Id maxRoundSteps)
+    : PushOutOfBounds(pushOutOfBounds)
+    , Resume(resume)
+    , MaxRoundSteps(maxRoundSteps)
+  {
+  }
+
   using ControlSignature = void(FieldIn idx, ExecObject integrator, ExecObject integralCurve);
   using ExecutionSignature = void(_1 idx, _2 integrator, _3 integralCurve);
   using InputDomain = _1;
@@ -59,6 +81,9 @@ public:
     auto particle = integralCurve.GetParticle(idx);
     vtkm::FloatDefault time = particle.GetTime();
     bool tookAnySteps = false;
+    //Adaptive integrators change the step length from one step to the next.
+    vtkm::FloatDefault stepLength = integrator.GetStepLength();
+    vtkm::Id roundSteps = 0;
 
     //the integrator status needs to be more robust:
     // 1. you could have success AND at temporal boundary.
@@ -69,7 +94,7 @@ public:
     {
       particle = integralCurve.GetParticle(idx);
       vtkm::Vec3f outpos;
-      auto status = integrator.Step(particle, time, outpos);
+      auto status = integrator.Step(particle, time, outpos, stepLength);
       if (status.CheckOk())
       {
         integralCurve.StepUpdate(idx, particle, time, outpos);
@@ -80,7 +105,7 @@ public:
       //Try and take a step just past the boundary.
       else if (status.CheckSpatialBounds() && this->PushOutOfBounds)
       {
-        status = integrator.SmallStep(particle, time, outpos);
+        status = integrator.SmallStep(particle, time, outpos, stepLength);
         if (status.CheckOk())
         {
           integralCurve.StepUpdate(idx, particle, time, outpos);
@@ -88,16 +113,95 @@ public:
         }
       }
       integralCurve.StatusUpdate(idx, status);
-    } while (integralCurve.CanContinue(idx));
+    } while (integralCurve.CanContinue(idx) &&
+             (this->MaxRoundSteps <= 0 || ++roundSteps < this->MaxRoundSteps));
 
     //Mark if any steps taken
-    integralCurve.UpdateTookSteps(idx, tookAnySteps);
+    integralCurve.UpdateTookSteps(idx, tookAnySteps || this->Resume);
   }
 
 private:
   bool PushOutOfBounds;
+  bool Resume = false;
+  vtkm::Id MaxRoundSteps = 0;
 };
 
+namespace detail
+{
+class CanContinueStencil : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn particle, FieldOut canContinue);
+  using ExecutionSignature = void(_1, _2);
+
+  template <typename ParticleType>
+  VTKM_EXEC void operator()(const ParticleType& particle, bool& canContinue) const
+  {
+    canContinue = particle.GetStatus().CanContinue();
+  }
+};
+
+class GetParticlePosition : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn idx, WholeArrayIn particles, FieldOut position);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename ParticlePortal>
+  VTKM_EXEC void operator()(vtkm::Id idx,
+                            const ParticlePortal& particles,
+                            vtkm::Vec3f& position) const
+  {
+    position = particles.Get(idx).GetPosition();
+  }
+};
+
+class ComputeMortonCodes : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn position, FieldOut code);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_CONT ComputeMortonCodes(const vtkm::cont::ArrayHandle<vtkm::Range>& ranges)
+  {
+    auto portal = ranges.ReadPortal();
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      vtkm::Range range = portal.Get(i);
+      this->Origin[i] = static_cast<vtkm::Float32>(range.Min);
+      this->InvLength[i] =
+        (range.Length() > 0) ? static_cast<vtkm::Float32>(1.0 / range.Length()) : 0.0f;
+    }
+  }
+
+  VTKM_EXEC void operator()(const vtkm::Vec3f& position, vtkm::UInt32& code) const
+  {
+    code = vtkm::MortonCode32((vtkm::Vec3f_32(position) - this->Origin) * this->InvLength);
+  }
+
+private:
+  vtkm::Vec3f_32 Origin;
+  vtkm::Vec3f_32 InvLength;
+};
+
+// Sorts the particle indices `ids` along a Morton curve through the particle positions.
+template <typename ParticleType>
+VTKM_CONT void SortByMortonCode(const vtkm::cont::ArrayHandle<ParticleType>& particles,
+                                vtkm::cont::ArrayHandle<vtkm::Id>& ids)
+{
+  if (ids.GetNumberOfValues() < 2)
+    return;
+
+  vtkm::cont::Invoker invoker;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> positions;
+  invoker(GetParticlePosition{}, ids, particles, positions);
+
+  vtkm::cont::ArrayHandle<vtkm::UInt32> codes;
+  invoker(ComputeMortonCodes{ vtkm::cont::ArrayRangeCompute(positions) }, positions, codes);
+  vtkm::cont::Algorithm::SortByKey(codes, ids);
+}
+} // namespace detail
+
 
 template <typename IntegratorType,
           typename ParticleType,
@@ -140,15 +244,73 @@ public:
     analysis.InitializeAnalysis(particles);
 
     ParticleArrayType particlesObj(particles, termination, analysis);
+    bool pushOutOfBounds = analysis.SupportPushOutOfBounds();
+    vtkm::cont::Invoker invoker;
 
-    vtkm::worklet::flow::ParticleAdvectWorklet worklet(analysis.SupportPushOutOfBounds());
+    if (this->ReorderInterval <= 0)
+    {
+      vtkm::worklet::flow::ParticleAdvectWorklet worklet(pushOutOfBounds);
+      invoker(worklet, idxArray, integrator, particlesObj);
+      this->ResumeStalledParticles(integrator, particlesObj, analysis, 0);
+    }
+    else
+    {
+      // Advect in rounds of ReorderInterval steps. Before each round, the particles that
+      // can continue are ordered along a Morton curve through their positions, so that
+      // neighboring invocations look up nearby cells and field values.
+      vtkm::cont::ArrayHandle<vtkm::Id> ids;
+      vtkm::cont::ArrayCopy(idxArray, ids);
+      bool resume = false;
+      while (ids.GetNumberOfValues() > 0)
+      {
+        detail::SortByMortonCode(particles, ids);
+        vtkm::worklet::flow::ParticleAdvectWorklet worklet(
+          pushOutOfBounds, resume, this->ReorderInterval);
+        invoker(worklet, ids, integrator, particlesObj);
+        this->ResumeStalledParticles(integrator, particlesObj, analysis, this->ReorderInterval);
 
-    vtkm::cont::Invoker invoker;
-    invoker(worklet, idxArray, integrator, particlesObj);
+        vtkm::cont::ArrayHandle<bool> canContinue;
+        invoker(detail::CanContinueStencil{}, particles, canContinue);
+        vtkm::cont::Algorithm::CopyIf(idxArray, canContinue, ids);
+        resume = true;
+      }
+    }
 
     // Finalize the analysis and clear intermittant arrays.
     analysis.FinalizeAnalysis(particles);
   }
+
+  /// @brief Advects the particles in rounds, reordering them between rounds.
+  ///
+  /// When `interval` is positive, the particles are sorted along a Morton curve through
+  /// their positions, advected by at most `interval` steps, and the particles that can
+  /// continue are sorted again before the next round. Particles that start close
+  /// together are then advected by neighboring invocations, which makes the cell and
+  /// field lookups much more cache friendly. By default (0) the particles are advected
+  /// in seed order in a single round.
+  VTKM_CONT void SetReorderInterval(vtkm::Id interval) { this->ReorderInterval = interval; }
+  VTKM_CONT vtkm::Id GetReorderInterval() const { return this->ReorderInterval; }
+
+private:
+  // The analysis may stop particles when it runs out of storage. Let it make
+  // room, then continue the advection of these particles.
+  template <typename ParticleArrayType>
+  void ResumeStalledParticles(const IntegratorType& integrator,
+                              ParticleArrayType& particlesObj,
+                              AnalysisType& analysis,
+                              vtkm::Id maxRoundSteps)
+  {
+    vtkm::cont::Invoker invoker;
+    vtkm::cont::ArrayHandle<vtkm::Id> stalledIds;
+    while (analysis.MakeRoomForStalledParticles(stalledIds))
+    {
+      vtkm::worklet::flow::ParticleAdvectWorklet resumeWorklet(
+        analysis.SupportPushOutOfBounds(), true, maxRoundSteps);
+      invoker(resumeWorklet, stalledIds, integrator, particlesObj);
+    }
+  }
+
+  vtkm::Id ReorderInterval = 0;
 };
 
 }
@@ -98,7 +98,9 @@ public:
     ParticleType particle(this->GetParticle(idx));
     auto terminate = this->Termination.CheckTermination(particle);
     this->Particles.Set(idx, particle);
-    return terminate;
+    // The analysis can stop a particle that would continue if it has no room
+    // to record the next step.
+    return terminate && this->Analysis.CanContinue(idx);
   }
 
   VTKM_EXEC
@@ -0,0 +1,194 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//=============================================================================
+
+#ifndef vtk_m_filter_flow_worklet_RK45Integrator_h
+#define vtk_m_filter_flow_worklet_RK45Integrator_h
+
+#include <vtkm/filter/flow/worklet/GridEvaluatorStatus.h>
+#include <vtkm/filter/flow/worklet/IntegratorStatus.h>
+
+#include <type_traits>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace flow
+{
+
+/// Runge-Kutta integrator with the embedded 5(4) pair of Dormand and Prince.
+///
+/// The step is advanced with the fifth order solution. The difference to the fourth
+/// order solution estimates the error of the step, which `StepperImpl` uses to adapt
+/// the step length.
+template <typename ExecEvaluatorType>
+class ExecRK45Integrator
+{
+public:
+  /// Tells `StepperImpl` that `CheckStep` can estimate the error of a step.
+  using IsEmbedded = std::true_type;
+
+  VTKM_EXEC_CONT
+  ExecRK45Integrator(const ExecEvaluatorType& evaluator)
+    : Evaluator(evaluator)
+  {
+  }
+
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus CheckStep(const Particle& particle,
+                                       vtkm::FloatDefault stepLength,
+                                       vtkm::Vec3f& velocity) const
+  {
+    vtkm::Vec3f stages[6];
+    return this->ComputeStages(particle, stepLength, stages, velocity);
+  }
+
+  /// Takes a step like the other `CheckStep` and sets `error` to the length of the
+  /// difference between the fifth and fourth order positions.
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus CheckStep(const Particle& particle,
+                                       vtkm::FloatDefault stepLength,
+                                       vtkm::Vec3f& velocity,
+                                       vtkm::FloatDefault& error) const
+  {
+    vtkm::Vec3f stages[6];
+    IntegratorStatus status = this->ComputeStages(particle, stepLength, stages, velocity);
+    if (!status.CheckOk())
+      return status;
+
+    //The last stage is the derivative at the end of the step.
+    vtkm::VecVariable<vtkm::Vec3f, 2> k7;
+    auto inpos = particle.GetEvaluationPosition(stepLength);
+    GridEvaluatorStatus evalStatus = this->Evaluator.Evaluate(
+      inpos + stepLength * velocity, particle.GetTime() + stepLength, k7);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    vtkm::Vec3f v7 = particle.Velocity(k7, stepLength);
+
+    //Difference of the fifth and fourth order weights.
+    const vtkm::FloatDefault e1 = static_cast<vtkm::FloatDefault>(71.0 / 57600.0);
+    const vtkm::FloatDefault e3 = static_cast<vtkm::FloatDefault>(-71.0 / 16695.0);
+    const vtkm::FloatDefault e4 = static_cast<vtkm::FloatDefault>(71.0 / 1920.0);
+    const vtkm::FloatDefault e5 = static_cast<vtkm::FloatDefault>(-17253.0 / 339200.0);
+    const vtkm::FloatDefault e6 = static_cast<vtkm::FloatDefault>(22.0 / 525.0);
+    const vtkm::FloatDefault e7 = static_cast<vtkm::FloatDefault>(-1.0 / 40.0);
+    vtkm::Vec3f diff = e1 * stages[0] + e3 * stages[2] + e4 * stages[3] + e5 * stages[4] +
+      e6 * stages[5] + e7 * v7;
+    error = vtkm::Abs(stepLength) * vtkm::Magnitude(diff);
+
+    return status;
+  }
+
+private:
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus ComputeStages(const Particle& particle,
+                                           vtkm::FloatDefault stepLength,
+                                           vtkm::Vec3f (&v)[6],
+                                           vtkm::Vec3f& velocity) const
+  {
+    auto time = particle.GetTime();
+    auto inpos = particle.GetEvaluationPosition(stepLength);
+    vtkm::FloatDefault boundary = this->Evaluator.GetTemporalBoundary(static_cast<vtkm::Id>(1));
+    if ((time + stepLength + vtkm::Epsilon<vtkm::FloatDefault>() - boundary) > 0.0)
+      stepLength = boundary - time;
+
+    using T = vtkm::FloatDefault;
+    const vtkm::FloatDefault h = stepLength;
+    vtkm::VecVariable<vtkm::Vec3f, 2> k;
+    GridEvaluatorStatus evalStatus;
+
+    evalStatus = this->Evaluator.Evaluate(inpos, time, k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[0] = particle.Velocity(k, h);
+
+    evalStatus =
+      this->Evaluator.Evaluate(inpos + h * (T(1.0 / 5.0) * v[0]), time + T(1.0 / 5.0) * h, k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[1] = particle.Velocity(k, h);
+
+    evalStatus = this->Evaluator.Evaluate(
+      inpos + h * (T(3.0 / 40.0) * v[0] + T(9.0 / 40.0) * v[1]), time + T(3.0 / 10.0) * h, k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[2] = particle.Velocity(k, h);
+
+    evalStatus = this->Evaluator.Evaluate(
+      inpos + h * (T(44.0 / 45.0) * v[0] - T(56.0 / 15.0) * v[1] + T(32.0 / 9.0) * v[2]),
+      time + T(4.0 / 5.0) * h,
+      k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[3] = particle.Velocity(k, h);
+
+    evalStatus = this->Evaluator.Evaluate(
+      inpos +
+        h * (T(19372.0 / 6561.0) * v[0] - T(25360.0 / 2187.0) * v[1] +
+             T(64448.0 / 6561.0) * v[2] - T(212.0 / 729.0) * v[3]),
+      time + T(8.0 / 9.0) * h,
+      k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[4] = particle.Velocity(k, h);
+
+    evalStatus = this->Evaluator.Evaluate(
+      inpos +
+        h * (T(9017.0 / 3168.0) * v[0] - T(355.0 / 33.0) * v[1] + T(46732.0 / 5247.0) * v[2] +
+             T(49.0 / 176.0) * v[3] - T(5103.0 / 18656.0) * v[4]),
+      time + h,
+      k);
+    if (evalStatus.CheckFail())
+      return IntegratorStatus(evalStatus, false);
+    v[5] = particle.Velocity(k, h);
+
+    velocity = T(35.0 / 384.0) * v[0] + T(500.0 / 1113.0) * v[2] + T(125.0 / 192.0) * v[3] -
+      T(2187.0 / 6784.0) * v[4] + T(11.0 / 84.0) * v[5];
+
+    return IntegratorStatus(
+      evalStatus, vtkm::MagnitudeSquared(velocity) <= vtkm::Epsilon<vtkm::FloatDefault>());
+  }
+
+  ExecEvaluatorType Evaluator;
+};
+
+template <typename EvaluatorType>
+class RK45Integrator
+{
+private:
+  EvaluatorType Evaluator;
+
+public:
+  VTKM_CONT
+  RK45Integrator() = default;
+
+  VTKM_CONT
+  RK45Integrator(const EvaluatorType& evaluator)
+    : Evaluator(evaluator)
+  {
+  }
+
+  VTKM_CONT auto PrepareForExecution(vtkm::cont::DeviceAdapterId device,
+                                     vtkm::cont::Token& token) const
+    -> ExecRK45Integrator<decltype(this->Evaluator.PrepareForExecution(device, token))>
+  {
+    auto evaluator = this->Evaluator.PrepareForExecution(device, token);
+    using ExecEvaluatorType = decltype(evaluator);
+    return ExecRK45Integrator<ExecEvaluatorType>(evaluator);
+  }
+};
+
+}
+}
+} //vtkm::worklet::flow
+
+#endif // vtk_m_filter_flow_worklet_RK45Integrator_h
@@ -18,6 +18,7 @@
 #include <vtkm/filter/flow/worklet/Particles.h>
 
 #include <limits>
+#include <type_traits>
 
 namespace vtkm
 {
@@ -26,6 +27,22 @@ namespace worklet
 namespace flow
 {
 
+namespace detail
+{
+// Integrators that estimate the error of a step declare `IsEmbedded` as `std::true_type`.
+template <typename ExecIntegratorType, typename = void>
+struct IsEmbeddedIntegrator : std::false_type
+{
+};
+
+template <typename ExecIntegratorType>
+struct IsEmbeddedIntegrator<
+  ExecIntegratorType,
+  typename std::enable_if<ExecIntegratorType::IsEmbedded::value>::type> : std::true_type
+{
+};
+} // namespace detail
+
 template <typename ExecIntegratorType, typename ExecEvaluatorType>
 class StepperImpl
 {
@@ -34,6 +51,108 @@ private:
   ExecEvaluatorType Evaluator;
   vtkm::FloatDefault DeltaT;
   vtkm::FloatDefault Tolerance;
+  vtkm::FloatDefault ErrorTolerance;
+  vtkm::FloatDefault MinStep;
+  vtkm::FloatDefault MaxStep;
+
+  VTKM_EXEC vtkm::FloatDefault GetEndTime() const
+  {
+    return this->Evaluator.GetTemporalBoundary(static_cast<vtkm::Id>(1));
+  }
+
+  /// Shortens a step of length `h` that would go past the last time slice, so that the
+  /// step ends exactly at it. Returns false if the particle is already at the last time
+  /// slice.
+  template <typename Particle>
+  VTKM_EXEC bool ClampToTemporalBoundary(const Particle& particle,
+                                         vtkm::FloatDefault& h,
+                                         bool& toBoundary) const
+  {
+    vtkm::FloatDefault boundary = this->GetEndTime();
+    toBoundary = particle.GetTime() + h + vtkm::Epsilon<vtkm::FloatDefault>() > boundary;
+    if (toBoundary)
+      h = boundary - particle.GetTime();
+    return h > 0;
+  }
+
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus DoStep(Particle& particle,
+                                    vtkm::FloatDefault& time,
+                                    vtkm::Vec3f& outpos,
+                                    vtkm::FloatDefault& vtkmNotUsed(stepLength),
+                                    std::false_type) const
+  {
+    vtkm::FloatDefault h = this->DeltaT;
+    bool toBoundary = false;
+    if (!this->ClampToTemporalBoundary(particle, h, toBoundary))
+    {
+      outpos = particle.GetPosition();
+      return IntegratorStatus(false, false, true, false, false);
+    }
+
+    vtkm::Vec3f velocity(0, 0, 0);
+    auto status = this->Integrator.CheckStep(particle, h, velocity);
+    if (status.CheckOk())
+    {
+      outpos = particle.GetPosition() + h * velocity;
+      time = toBoundary ? this->GetEndTime() : time + h;
+    }
+    else
+      outpos = particle.GetPosition();
+
+    return status;
+  }
+
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus DoStep(Particle& particle,
+                                    vtkm::FloatDefault& time,
+                                    vtkm::Vec3f& outpos,
+                                    vtkm::FloatDefault& stepLength,
+                                    std::true_type) const
+  {
+    using T = vtkm::FloatDefault;
+    vtkm::FloatDefault h = vtkm::Min(vtkm::Max(stepLength, this->MinStep), this->MaxStep);
+
+    bool toBoundary = false;
+    if (!this->ClampToTemporalBoundary(particle, h, toBoundary))
+    {
+      outpos = particle.GetPosition();
+      return IntegratorStatus(false, false, true, false, false);
+    }
+
+    //Shrink the step until the error is within the tolerance. A step of the smallest
+    //length is always taken.
+    while (true)
+    {
+      vtkm::Vec3f velocity(0, 0, 0);
+      vtkm::FloatDefault error = 0;
+      auto status = this->Integrator.CheckStep(particle, h, velocity, error);
+      if (!status.CheckOk())
+      {
+        outpos = particle.GetPosition();
+        stepLength = h;
+        return status;
+      }
+
+      vtkm::FloatDefault ratio = error / this->ErrorTolerance;
+      if (ratio <= 1 || h <= this->MinStep)
+      {
+        outpos = particle.GetPosition() + h * velocity;
+        time = toBoundary ? this->GetEndTime() : time + h;
+
+        //Grow the next step by at most a factor of 5.
+        vtkm::FloatDefault scale = T(5);
+        if (ratio > 0)
+          scale = vtkm::Min(T(0.9) * vtkm::Pow(ratio, T(-0.2)), T(5));
+        stepLength = vtkm::Min(vtkm::Max(h * scale, this->MinStep), this->MaxStep);
+        return status;
+      }
+
+      vtkm::FloatDefault scale = vtkm::Max(T(0.9) * vtkm::Pow(ratio, T(-0.25)), T(0.2));
+      h = vtkm::Max(h * scale, this->MinStep);
+      toBoundary = false;
+    }
+  }
 
 public:
   VTKM_EXEC_CONT
@@ -45,25 +164,53 @@ public:
     , Evaluator(evaluator)
     , DeltaT(deltaT)
     , Tolerance(tolerance)
+    , ErrorTolerance(tolerance)
+    , MinStep(deltaT)
+    , MaxStep(deltaT)
   {
   }
 
+  VTKM_EXEC_CONT
+  StepperImpl(const ExecIntegratorType& integrator,
+              const ExecEvaluatorType& evaluator,
+              const vtkm::FloatDefault deltaT,
+              const vtkm::FloatDefault tolerance,
+              const vtkm::FloatDefault errorTolerance,
+              const vtkm::FloatDefault minStep,
+              const vtkm::FloatDefault maxStep)
+    : Integrator(integrator)
+    , Evaluator(evaluator)
+    , DeltaT(deltaT)
+    , Tolerance(tolerance)
+    , ErrorTolerance(errorTolerance)
+    , MinStep(minStep)
+    , MaxStep(maxStep)
+  {
+  }
+
+  /// The length of the first step of a particle.
+  VTKM_EXEC vtkm::FloatDefault GetStepLength() const { return this->DeltaT; }
+
   template <typename Particle>
   VTKM_EXEC IntegratorStatus Step(Particle& particle,
                                   vtkm::FloatDefault& time,
                                   vtkm::Vec3f& outpos) const
   {
-    vtkm::Vec3f velocity(0, 0, 0);
-    auto status = this->Integrator.CheckStep(particle, this->DeltaT, velocity);
-    if (status.CheckOk())
-    {
-      outpos = particle.GetPosition() + this->DeltaT * velocity;
-      time += this->DeltaT;
-    }
-    else
-      outpos = particle.GetPosition();
+    vtkm::FloatDefault stepLength = this->DeltaT;
+    return this->Step(particle, time, outpos, stepLength);
+  }
 
-    return status;
+  /// Takes a step of `stepLength`. An embedded integrator adapts the step to the error
+  /// tolerance: it may take a shorter step and sets `stepLength` to the length to try
+  /// next. Other integrators always step by the step size of the stepper.
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus Step(Particle& particle,
+                                  vtkm::FloatDefault& time,
+                                  vtkm::Vec3f& outpos,
+                                  vtkm::FloatDefault& stepLength) const
+  {
+    return this->DoStep(
+      particle, time, outpos, stepLength, detail::IsEmbeddedIntegrator<ExecIntegratorType>{});
   }
 
   template <typename Particle>
@@ -71,17 +218,27 @@ public:
                                        vtkm::FloatDefault& time,
                                        vtkm::Vec3f& outpos) const
   {
-    //Stepping by this->DeltaT goes beyond the bounds of the dataset.
+    return this->SmallStep(particle, time, outpos, this->DeltaT);
+  }
+
+  /// Steps just past the spatial boundary when a step of `stepLength` leaves the dataset.
+  template <typename Particle>
+  VTKM_EXEC IntegratorStatus SmallStep(Particle& particle,
+                                       vtkm::FloatDefault& time,
+                                       vtkm::Vec3f& outpos,
+                                       vtkm::FloatDefault stepLength) const
+  {
+    //Stepping by stepLength goes beyond the bounds of the dataset.
     //We need to take an Euler step that goes outside of the dataset.
     //Use a binary search to find the largest step INSIDE the dataset.
     //Binary search uses a shrinking bracket of inside / outside, so when
     //we terminate, the outside value is the stepsize that will nudge
     //the particle outside the dataset.
 
-    //The binary search will be between {0, this->DeltaT}
-    vtkm::FloatDefault stepRange[2] = { 0, this->DeltaT };
+    //The binary search will be between {0, stepLength}
+    vtkm::FloatDefault stepRange[2] = { 0, stepLength };
 
-    vtkm::Vec3f currPos(particle.GetEvaluationPosition(this->DeltaT));
+    vtkm::Vec3f currPos(particle.GetEvaluationPosition(stepLength));
     vtkm::Vec3f currVelocity(0, 0, 0);
     vtkm::VecVariable<vtkm::Vec3f, 2> currValue, tmp;
     auto evalStatus = this->Evaluator.Evaluate(currPos, particle.GetTime(), currValue);
@@ -94,7 +251,7 @@ public:
     {
       //Try a step midway between stepRange[0] and stepRange[1]
       div *= 2;
-      vtkm::FloatDefault currStep = stepRange[0] + (this->DeltaT / div);
+      vtkm::FloatDefault currStep = stepRange[0] + (stepLength / div);
 
       //See if we can step by currStep
       IntegratorStatus status = this->Integrator.CheckStep(particle, currStep, currVelocity);
@@ -156,6 +313,9 @@ private:
   vtkm::FloatDefault DeltaT;
   vtkm::FloatDefault Tolerance =
     std::numeric_limits<vtkm::FloatDefault>::epsilon() * static_cast<vtkm::FloatDefault>(100.0f);
+  vtkm::FloatDefault ErrorTolerance = static_cast<vtkm::FloatDefault>(1e-6);
+  vtkm::FloatDefault MinStep = 0;
+  vtkm::FloatDefault MaxStep = 0;
 
 public:
   VTKM_CONT
@@ -172,6 +332,24 @@ public:
   VTKM_CONT
   void SetTolerance(vtkm::FloatDefault tolerance) { this->Tolerance = tolerance; }
 
+  /// @brief Sets the largest error allowed in a step of an embedded integrator.
+  ///
+  /// The error is measured in the units of the coordinates. Integrators that do not
+  /// estimate their error ignore this and the step size range.
+  VTKM_CONT
+  void SetErrorTolerance(vtkm::FloatDefault tolerance) { this->ErrorTolerance = tolerance; }
+
+  /// @brief Sets the shortest and longest steps an embedded integrator may take.
+  ///
+  /// A bound that is not positive defaults to 1/1000 (minimum) or 100 times (maximum)
+  /// the step size.
+  VTKM_CONT
+  void SetStepSizeRange(vtkm::FloatDefault minStep, vtkm::FloatDefault maxStep)
+  {
+    this->MinStep = minStep;
+    this->MaxStep = maxStep;
+  }
+
 public:
   /// Return the StepperImpl object
   /// Prepares the execution object of Stepper
@@ -184,8 +362,17 @@ public:
     auto evaluator = this->Evaluator.PrepareForExecution(device, token);
     using ExecIntegratorType = decltype(integrator);
     using ExecEvaluatorType = decltype(evaluator);
-    return StepperImpl<ExecIntegratorType, ExecEvaluatorType>(
-      integrator, evaluator, this->DeltaT, this->Tolerance);
+    vtkm::FloatDefault minStep =
+      this->MinStep > 0 ? this->MinStep : this->DeltaT / static_cast<vtkm::FloatDefault>(1000);
+    vtkm::FloatDefault maxStep =
+      this->MaxStep > 0 ? this->MaxStep : this->DeltaT * static_cast<vtkm::FloatDefault>(100);
+    return StepperImpl<ExecIntegratorType, ExecEvaluatorType>(integrator,
+                                                              evaluator,
+                                                              this->DeltaT,
+                                                              this->Tolerance,
+                                                              this->ErrorTolerance,
+                                                              minStep,
+                                                              vtkm::Max(minStep, maxStep));
   }
 };
 
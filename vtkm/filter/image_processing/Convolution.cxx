@@ -0,0 +1,143 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/VecTraits.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/filter/image_processing/Convolution.h>
+#include <vtkm/filter/image_processing/worklet/Convolution.h>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace image_processing
+{
+
+VTKM_CONT void Convolution::SetKernel(const std::vector<vtkm::FloatDefault>& kernel)
+{
+  for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+  {
+    this->SetKernel(axis, kernel);
+  }
+}
+
+VTKM_CONT void Convolution::SetKernel(vtkm::IdComponent axis,
+                                      const std::vector<vtkm::FloatDefault>& kernel)
+{
+  if ((axis < 0) || (axis > 2))
+  {
+    throw vtkm::cont::ErrorBadValue("Convolution axis must be 0, 1 or 2.");
+  }
+  if ((kernel.size() % 2) == 0 && !kernel.empty())
+  {
+    throw vtkm::cont::ErrorBadValue("Convolution kernels must have an odd number of weights.");
+  }
+  this->Kernels[static_cast<std::size_t>(axis)] = kernel;
+}
+
+VTKM_CONT void Convolution::SetGaussianKernel(vtkm::FloatDefault standardDeviation,
+                                              vtkm::IdComponent radius)
+{
+  if (standardDeviation <= 0)
+  {
+    throw vtkm::cont::ErrorBadValue("Gaussian standard deviation must be positive.");
+  }
+  if (radius < 0)
+  {
+    radius = static_cast<vtkm::IdComponent>(vtkm::Ceil(3 * standardDeviation));
+  }
+
+  std::vector<vtkm::FloatDefault> kernel;
+  vtkm::Float64 sum = 0;
+  for (vtkm::IdComponent offset = -radius; offset <= radius; ++offset)
+  {
+    vtkm::Float64 x = static_cast<vtkm::Float64>(offset) / standardDeviation;
+    vtkm::Float64 weight = vtkm::Exp(-0.5 * x * x);
+    kernel.push_back(static_cast<vtkm::FloatDefault>(weight));
+    sum += weight;
+  }
+  for (vtkm::FloatDefault& weight : kernel)
+  {
+    weight = static_cast<vtkm::FloatDefault>(weight / sum);
+  }
+  this->SetKernel(kernel);
+}
+
+VTKM_CONT void Convolution::SetBoxKernel(vtkm::IdComponent radius)
+{
+  if (radius < 0)
+  {
+    throw vtkm::cont::ErrorBadValue("Box kernel radius must not be negative.");
+  }
+  std::size_t size = static_cast<std::size_t>(2 * radius + 1);
+  this->SetKernel(std::vector<vtkm::FloatDefault>(size, vtkm::FloatDefault(1) / size));
+}
+
+VTKM_CONT vtkm::cont::DataSet Convolution::DoExecute(const vtkm::cont::DataSet& input)
+{
+  const auto& field = this->GetFieldFromDataSet(input);
+  if (!field.IsPointField() && !field.IsCellField())
+  {
+    throw vtkm::cont::ErrorBadValue("Active field for Convolution must be a point or cell field.");
+  }
+
+  vtkm::Id3 dimensions(1);
+  input.GetCellSet().CastAndCallForTypes<vtkm::cont::CellSetListStructured>(
+    [&](const auto& cells) {
+      auto dims = field.IsPointField() ? cells.GetPointDimensions() : cells.GetCellDimensions();
+      using DimsTraits = vtkm::VecTraits<decltype(dims)>;
+      for (vtkm::IdComponent d = 0; d < DimsTraits::NUM_COMPONENTS; ++d)
+      {
+        dimensions[d] = DimsTraits::GetComponent(dims, d);
+      }
+    });
+
+  vtkm::worklet::Convolution worklet;
+  for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+  {
+    worklet.SetKernel(axis, this->Kernels[static_cast<std::size_t>(axis)]);
+  }
+  worklet.SetFFTKernelSize(this->FFTKernelSize);
+
+  // Convolve each component of the field in its floating point type.
+  vtkm::cont::UnknownArrayHandle inArray = field.GetData();
+  if (!inArray.IsBaseComponentType<vtkm::Float32>() &&
+      !inArray.IsBaseComponentType<vtkm::Float64>())
+  {
+    vtkm::cont::UnknownArrayHandle floatArray = inArray.NewInstanceFloatBasic();
+    vtkm::cont::ArrayCopy(inArray, floatArray);
+    inArray = floatArray;
+  }
+  vtkm::cont::UnknownArrayHandle outArray = inArray.NewInstanceBasic();
+  outArray.Allocate(inArray.GetNumberOfValues());
+
+  auto resolveType = [&](auto t) {
+    using T = decltype(t);
+    if (inArray.IsBaseComponentType<T>())
+    {
+      for (vtkm::IdComponent c = 0; c < inArray.GetNumberOfComponentsFlat(); ++c)
+      {
+        auto outComponent = outArray.ExtractComponent<T>(c, vtkm::CopyFlag::Off);
+        worklet.Run(dimensions, inArray.ExtractComponent<T>(c), outComponent);
+      }
+    }
+  };
+  vtkm::ListForEach(resolveType, vtkm::List<vtkm::Float32, vtkm::Float64>{});
+
+  std::string name = this->GetOutputFieldName();
+  if (name.empty())
+  {
+    name = field.GetName();
+  }
+  return this->CreateResultField(input, name, field.GetAssociation(), outArray);
+}
+} // namespace image_processing
+} // namespace filter
+} // namespace vtkm
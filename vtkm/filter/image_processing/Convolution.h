@@ -0,0 +1,83 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_filter_image_processing_Convolution_h
+#define vtk_m_filter_image_processing_Convolution_h
+
+#include <vtkm/filter/FilterField.h>
+#include <vtkm/filter/image_processing/vtkm_filter_image_processing_export.h>
+
+#include <array>
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace image_processing
+{
+/// \brief Convolve a field on a structured image with a separable kernel.
+///
+/// The kernel is a product of one 1D kernel per axis, so the field is convolved
+/// along the x, y and z axes in turn and the cost per value grows with the sum
+/// rather than the product of the kernel sizes. Each 1D kernel has an odd number
+/// of weights. The weight at index `r + d`, where `r` is the radius of the kernel,
+/// multiplies the value `d` points away along the axis. Distances are counted in
+/// points (or cells for a cell field), not in the units of the coordinates.
+/// Values outside of the image repeat the nearest value on the boundary.
+///
+/// Kernels with more weights than `FFTKernelSize` are applied by multiplying
+/// the Fourier transforms of the lines of the image and of the kernel, which
+/// costs a time per value that grows with the logarithm of the size of the image
+/// rather than with the size of the kernel.
+///
+/// Every component of a vector field is convolved separately. Integer fields
+/// produce floating point results. Ghost points and cells are convolved like
+/// any other. When the ghost layers of a partition are at least as wide as the
+/// kernel radius, the values of its owned points are the same as those for the
+/// whole image.
+class VTKM_FILTER_IMAGE_PROCESSING_EXPORT Convolution : public vtkm::filter::FilterField
+{
+public:
+  VTKM_CONT Convolution() { this->SetOutputFieldName("convolution"); }
+
+  /// Use the same kernel for all axes.
+  VTKM_CONT void SetKernel(const std::vector<vtkm::FloatDefault>& kernel);
+  /// Set the kernel for one axis. An empty kernel leaves that axis alone.
+  VTKM_CONT void SetKernel(vtkm::IdComponent axis, const std::vector<vtkm::FloatDefault>& kernel);
+  VTKM_CONT const std::vector<vtkm::FloatDefault>& GetKernel(vtkm::IdComponent axis) const
+  {
+    return this->Kernels[static_cast<std::size_t>(axis)];
+  }
+
+  /// Use a normalized Gaussian kernel for all axes. The standard deviation is
+  /// in points. A negative radius selects `ceil(3 * standardDeviation)`.
+  VTKM_CONT void SetGaussianKernel(vtkm::FloatDefault standardDeviation,
+                                   vtkm::IdComponent radius = -1);
+
+  /// Use a box kernel of `2 * radius + 1` equal weights summing to one for all
+  /// axes.
+  VTKM_CONT void SetBoxKernel(vtkm::IdComponent radius);
+
+  /// Kernels with more weights than this are applied with the FFT. Defaults to 127.
+  VTKM_CONT void SetFFTKernelSize(vtkm::Id size) { this->FFTKernelSize = size; }
+  VTKM_CONT vtkm::Id GetFFTKernelSize() const { return this->FFTKernelSize; }
+
+private:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+
+  std::array<std::vector<vtkm::FloatDefault>, 3> Kernels;
+  vtkm::Id FFTKernelSize = 127;
+};
+} // namespace image_processing
+} // namespace filter
+} // namespace vtkm
+
+#endif //vtk_m_filter_image_processing_Convolution_h
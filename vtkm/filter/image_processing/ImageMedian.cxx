@@ -8,81 +8,12 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/VecTraits.h>
 #include <vtkm/filter/image_processing/ImageMedian.h>
-#include <vtkm/worklet/WorkletPointNeighborhood.h>
-
-// NOTE BIEN!!! This line has to come last!!! Otherwise CUDA complains!!! NEIB ETON
-#include <vtkm/Swap.h>
+#include <vtkm/filter/image_processing/worklet/ImageMedian.h>
 
 namespace vtkm
 {
-namespace worklet
-{
-// An implementation of the quickselect/Hoare's selection algorithm to find medians
-// inplace, generally fairly fast for reasonable sized data.
-//
-template <typename T>
-VTKM_EXEC inline T find_median(T* values, std::size_t mid, std::size_t size)
-{
-  std::size_t begin = 0;
-  std::size_t end = size - 1;
-  while (begin < end)
-  {
-    T x = values[mid];
-    std::size_t i = begin;
-    std::size_t j = end;
-    do
-    {
-      for (; values[i] < x; i++)
-      {
-      }
-      for (; x < values[j]; j--)
-      {
-      }
-      if (i <= j)
-      {
-        vtkm::Swap(values[i], values[j]);
-        i++;
-        j--;
-      }
-    } while (i <= j);
-
-    begin = (j < mid) ? i : begin;
-    end = (mid < i) ? j : end;
-  }
-  return values[mid];
-}
-struct ImageMedian : public vtkm::worklet::WorkletPointNeighborhood
-{
-  int Neighborhood;
-  ImageMedian(int neighborhoodSize)
-    : Neighborhood(neighborhoodSize)
-  {
-  }
-  using ControlSignature = void(CellSetIn, FieldInNeighborhood, FieldOut);
-  using ExecutionSignature = void(_2, _3);
-
-  template <typename InNeighborhoodT, typename T>
-  VTKM_EXEC void operator()(const InNeighborhoodT& input, T& out) const
-  {
-    vtkm::Vec<T, 25> values;
-    int index = 0;
-    for (int x = -this->Neighborhood; x <= this->Neighborhood; ++x)
-    {
-      for (int y = -this->Neighborhood; y <= this->Neighborhood; ++y)
-      {
-        values[index++] = input.Get(x, y, 0);
-      }
-    }
-
-    std::size_t len =
-      static_cast<std::size_t>((this->Neighborhood * 2 + 1) * (this->Neighborhood * 2 + 1));
-    std::size_t mid = len / 2;
-    out = find_median(&values[0], mid, len);
-  }
-};
-}
-
 namespace filter
 {
 namespace image_processing
@@ -95,7 +26,21 @@ VTKM_CONT vtkm::cont::DataSet ImageMedian::DoExecute(const vtkm::cont::DataSet&
     throw vtkm::cont::ErrorBadValue("Active field for ImageMedian must be a point field.");
   }
 
+  if (this->Neighborhood < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("ImageMedian neighborhood radius must be at least 1.");
+  }
+
   const vtkm::cont::UnknownCellSet& inputCellSet = input.GetCellSet();
+  vtkm::Id3 pointDimensions(1);
+  inputCellSet.CastAndCallForTypes<vtkm::cont::CellSetListStructured>([&](const auto& cells) {
+    auto dims = cells.GetPointDimensions();
+    using DimsTraits = vtkm::VecTraits<decltype(dims)>;
+    for (vtkm::IdComponent d = 0; d < DimsTraits::NUM_COMPONENTS; ++d)
+    {
+      pointDimensions[d] = DimsTraits::GetComponent(dims, d);
+    }
+  });
   vtkm::cont::UnknownArrayHandle outArray;
 
   auto resolveType = [&](const auto& concrete) {
@@ -103,8 +48,15 @@ VTKM_CONT vtkm::cont::DataSet ImageMedian::DoExecute(const vtkm::cont::DataSet&
     using T = typename std::decay_t<decltype(concrete)>::ValueType;
     vtkm::cont::ArrayHandle<T> result;
 
-    VTKM_ASSERT((this->Neighborhood == 1) || (this->Neighborhood == 2));
-    this->Invoke(worklet::ImageMedian{ this->Neighborhood }, inputCellSet, concrete, result);
+    if (this->Neighborhood <= 2)
+    {
+      this->Invoke(worklet::ImageMedian{ this->Neighborhood }, inputCellSet, concrete, result);
+    }
+    else
+    {
+      vtkm::worklet::SlidingImageMedian median;
+      median.Run(pointDimensions, this->Neighborhood, concrete, result);
+    }
 
     outArray = result;
   };
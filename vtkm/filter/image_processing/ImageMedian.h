@@ -30,6 +30,15 @@ namespace filter
 {
 namespace image_processing
 {
+/// \brief Median filter of a point field on a structured image.
+///
+/// Each value is replaced by the median of a square window of values around it
+/// in the x-y plane. Values outside of the image repeat the nearest value on the
+/// boundary. The 3x3 and 5x5 windows are sorted in place for every point. Larger
+/// windows slide a histogram of the window along each row when the field has at
+/// most 65536 different values (or is made of whole numbers over such a range),
+/// which makes the cost per point grow with the radius rather than the area of
+/// the window. Other fields fall back to selecting the median of every window.
 class VTKM_FILTER_IMAGE_PROCESSING_EXPORT ImageMedian : public vtkm::filter::FilterField
 {
 public:
@@ -38,10 +47,14 @@ public:
   VTKM_CONT void Perform3x3() { this->Neighborhood = 1; };
   VTKM_CONT void Perform5x5() { this->Neighborhood = 2; };
 
+  /// The window of a radius `r` has `2r+1` points on each side.
+  VTKM_CONT void SetNeighborhoodRadius(vtkm::IdComponent radius) { this->Neighborhood = radius; }
+  VTKM_CONT vtkm::IdComponent GetNeighborhoodRadius() const { return this->Neighborhood; }
+
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 
-  int Neighborhood = 1;
+  vtkm::IdComponent Neighborhood = 1;
 };
 } // namespace image_processing
 } // namespace filter
@@ -0,0 +1,232 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/image_processing/Convolution.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+using Convolution = vtkm::filter::image_processing::Convolution;
+
+std::vector<vtkm::Float64> MakeValues(const vtkm::Id3& dims)
+{
+  std::vector<vtkm::Float64> values;
+  for (vtkm::Id index = 0; index < dims[0] * dims[1] * dims[2]; ++index)
+  {
+    values.push_back(static_cast<vtkm::Float64>((index * 7919 + 13) % 101) / 10.0);
+  }
+  return values;
+}
+
+// Convolves the values along each axis on the host.
+std::vector<vtkm::Float64> ExpectedConvolution(std::vector<vtkm::Float64> values,
+                                               const vtkm::Id3& dims,
+                                               const Convolution& filter)
+{
+  vtkm::Id3 strides(1, dims[0], dims[0] * dims[1]);
+  for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+  {
+    const std::vector<vtkm::FloatDefault>& kernel = filter.GetKernel(axis);
+    if (kernel.empty() || dims[axis] == 1)
+    {
+      continue;
+    }
+    vtkm::Id radius = static_cast<vtkm::Id>(kernel.size() / 2);
+    std::vector<vtkm::Float64> result(values.size());
+    for (vtkm::Id index = 0; index < static_cast<vtkm::Id>(values.size()); ++index)
+    {
+      vtkm::Id position = (index / strides[axis]) % dims[axis];
+      vtkm::Float64 sum = 0;
+      for (vtkm::Id offset = -radius; offset <= radius; ++offset)
+      {
+        vtkm::Id neighbor = std::min(std::max(position + offset, vtkm::Id(0)), dims[axis] - 1);
+        sum += kernel[static_cast<std::size_t>(offset + radius)] *
+          values[static_cast<std::size_t>(index + (neighbor - position) * strides[axis])];
+      }
+      result[static_cast<std::size_t>(index)] = sum;
+    }
+    values = result;
+  }
+  return values;
+}
+
+void CheckField(const vtkm::cont::DataSet& result,
+                const std::string& name,
+                const std::vector<vtkm::Float64>& expected)
+{
+  vtkm::cont::ArrayHandle<vtkm::Float64> values;
+  result.GetField(name).GetData().AsArrayHandle(values);
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(values, vtkm::cont::make_ArrayHandle(expected, vtkm::CopyFlag::Off)),
+    "Wrong convolution of ",
+    name);
+}
+
+void TestKernels()
+{
+  std::cout << "Separable kernels" << std::endl;
+  vtkm::Id3 dims(13, 11, 7);
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  std::vector<vtkm::Float64> values = MakeValues(dims);
+  dataSet.AddPointField("values", values);
+
+  Convolution filter;
+  filter.SetActiveField("values");
+  filter.SetKernel(0, { 0.25f, 0.5f, 0.25f });
+  filter.SetKernel(1, { -1.0f, 0.0f, 2.0f, 0.5f, 0.1f });
+  filter.SetKernel(2, { 1.0f });
+  CheckField(filter.Execute(dataSet), "convolution", ExpectedConvolution(values, dims, filter));
+
+  filter.SetKernel(1, {});
+  CheckField(filter.Execute(dataSet), "convolution", ExpectedConvolution(values, dims, filter));
+
+  filter.SetGaussianKernel(1.5f);
+  VTKM_TEST_ASSERT(filter.GetKernel(2).size() == 11, "Wrong Gaussian radius");
+  CheckField(filter.Execute(dataSet), "convolution", ExpectedConvolution(values, dims, filter));
+
+  filter.SetBoxKernel(3);
+  filter.SetOutputFieldName("");
+  CheckField(filter.Execute(dataSet), "values", ExpectedConvolution(values, dims, filter));
+}
+
+void TestFFT()
+{
+  std::cout << "FFT" << std::endl;
+  vtkm::Id3 dims(37, 20, 9);
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  std::vector<vtkm::Float64> values = MakeValues(dims);
+  dataSet.AddPointField("values", values);
+
+  Convolution filter;
+  filter.SetActiveField("values");
+  filter.SetFFTKernelSize(0);
+  filter.SetKernel(0, { 0.1f, 0.2f, 0.4f, 0.2f, 0.1f });
+  filter.SetKernel(1, { 1.0f });
+  filter.SetKernel(2, { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f });
+  CheckField(filter.Execute(dataSet), "convolution", ExpectedConvolution(values, dims, filter));
+
+  // A kernel that is larger than the image.
+  filter.SetGaussianKernel(8.0f);
+  CheckField(filter.Execute(dataSet), "convolution", ExpectedConvolution(values, dims, filter));
+}
+
+void TestFieldTypes()
+{
+  std::cout << "Vector, integer and cell fields" << std::endl;
+  vtkm::Id3 dims(9, 8, 1);
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  std::vector<vtkm::Float64> values = MakeValues(dims);
+  std::vector<vtkm::Vec3f_64> vectors;
+  std::vector<vtkm::Int32> integers;
+  for (vtkm::Float64 value : values)
+  {
+    vectors.push_back({ value, 2 * value, -value });
+    integers.push_back(static_cast<vtkm::Int32>(value * 10));
+  }
+  dataSet.AddPointField("vectors", vectors);
+  dataSet.AddPointField("integers", integers);
+  vtkm::Id3 cellDims(8, 7, 1);
+  std::vector<vtkm::Float64> cellValues = MakeValues(cellDims);
+  dataSet.AddCellField("cells", cellValues);
+
+  Convolution filter;
+  filter.SetBoxKernel(1);
+
+  filter.SetActiveField("vectors");
+  vtkm::cont::DataSet result = filter.Execute(dataSet);
+  std::vector<vtkm::Float64> expected = ExpectedConvolution(values, dims, filter);
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> vectorResult;
+  result.GetField("convolution").GetData().AsArrayHandle(vectorResult);
+  auto vectorPortal = vectorResult.ReadPortal();
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    vtkm::Vec3f_64 expectedVector(expected[i], 2 * expected[i], -expected[i]);
+    VTKM_TEST_ASSERT(test_equal(vectorPortal.Get(static_cast<vtkm::Id>(i)), expectedVector),
+                     "Wrong convolution of vectors");
+  }
+
+  filter.SetActiveField("integers");
+  result = filter.Execute(dataSet);
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> integerResult;
+  result.GetField("convolution").GetData().AsArrayHandle(integerResult);
+  std::vector<vtkm::Float64> integerValues(integers.begin(), integers.end());
+  expected = ExpectedConvolution(integerValues, dims, filter);
+  auto integerPortal = integerResult.ReadPortal();
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(integerPortal.Get(static_cast<vtkm::Id>(i)), expected[i]),
+                     "Wrong convolution of integers");
+  }
+
+  filter.SetActiveField("cells");
+  result = filter.Execute(dataSet);
+  VTKM_TEST_ASSERT(result.GetField("convolution").IsCellField(), "Output should be a cell field");
+  CheckField(result, "convolution", ExpectedConvolution(cellValues, cellDims, filter));
+}
+
+void TestGhostLayers()
+{
+  std::cout << "Ghost layers" << std::endl;
+  vtkm::Id3 dims(30, 24, 1);
+  std::vector<vtkm::Float64> values = MakeValues(dims);
+  Convolution filter;
+  filter.SetGaussianKernel(1.0f);
+  std::vector<vtkm::Float64> whole = ExpectedConvolution(values, dims, filter);
+
+  // A partition owning points [10, 20) x [8, 16) with ghost layers 3 points wide.
+  vtkm::Id ghost = 3;
+  vtkm::Id3 start(10 - ghost, 8 - ghost, 0);
+  vtkm::Id3 partDims(10 + 2 * ghost, 8 + 2 * ghost, 1);
+  std::vector<vtkm::Float64> partValues;
+  for (vtkm::Id j = 0; j < partDims[1]; ++j)
+  {
+    for (vtkm::Id i = 0; i < partDims[0]; ++i)
+    {
+      partValues.push_back(
+        values[static_cast<std::size_t>((start[1] + j) * dims[0] + start[0] + i)]);
+    }
+  }
+  vtkm::cont::DataSet partition = vtkm::cont::DataSetBuilderUniform::Create(partDims);
+  partition.AddPointField("values", partValues);
+  filter.SetActiveField("values");
+  vtkm::cont::ArrayHandle<vtkm::Float64> result;
+  filter.Execute(partition).GetField("convolution").GetData().AsArrayHandle(result);
+  auto portal = result.ReadPortal();
+  for (vtkm::Id j = ghost; j < partDims[1] - ghost; ++j)
+  {
+    for (vtkm::Id i = ghost; i < partDims[0] - ghost; ++i)
+    {
+      vtkm::Float64 expected =
+        whole[static_cast<std::size_t>((start[1] + j) * dims[0] + start[0] + i)];
+      VTKM_TEST_ASSERT(test_equal(portal.Get(j * partDims[0] + i), expected),
+                       "Partition does not match the whole image");
+    }
+  }
+}
+
+void TestConvolution()
+{
+  TestKernels();
+  TestFFT();
+  TestFieldTypes();
+  TestGhostLayers();
+}
+
+} // anonymous namespace
+
+int UnitTestConvolutionFilter(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(TestConvolution, argc, argv);
+}
@@ -8,10 +8,14 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/image_processing/ImageMedian.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace
 {
 
@@ -44,9 +48,86 @@ void TestImageMedian()
     VTKM_TEST_ASSERT(test_equal(expected_median, 2.82843), "incorrect median value");
   }
 }
+
+// Computes the median of every window on the host by sorting it.
+std::vector<vtkm::Float32> ExpectedMedian(const std::vector<vtkm::Float32>& values,
+                                          const vtkm::Id3& dims,
+                                          vtkm::Id radius)
+{
+  auto clamp = [](vtkm::Id index, vtkm::Id size) {
+    return std::min(std::max(index, vtkm::Id(0)), size - 1);
+  };
+  std::vector<vtkm::Float32> medians;
+  for (vtkm::Id k = 0; k < dims[2]; ++k)
+  {
+    for (vtkm::Id j = 0; j < dims[1]; ++j)
+    {
+      for (vtkm::Id i = 0; i < dims[0]; ++i)
+      {
+        std::vector<vtkm::Float32> window;
+        for (vtkm::Id dy = -radius; dy <= radius; ++dy)
+        {
+          for (vtkm::Id dx = -radius; dx <= radius; ++dx)
+          {
+            vtkm::Id index = (k * dims[1] + clamp(j + dy, dims[1])) * dims[0];
+            window.push_back(values[static_cast<std::size_t>(index + clamp(i + dx, dims[0]))]);
+          }
+        }
+        std::sort(window.begin(), window.end());
+        medians.push_back(window[window.size() / 2]);
+      }
+    }
+  }
+  return medians;
+}
+
+void TestImageMedianRadius(const vtkm::Id3& dims,
+                           vtkm::IdComponent radius,
+                           vtkm::Float32 scale,
+                           vtkm::Id numberOfValues)
+{
+  std::cout << "Radius " << radius << " on " << dims << " points with " << numberOfValues
+            << " values" << std::endl;
+
+  std::vector<vtkm::Float32> values;
+  for (vtkm::Id index = 0; index < dims[0] * dims[1] * dims[2]; ++index)
+  {
+    values.push_back(scale * static_cast<vtkm::Float32>((index * 7919 + 13) % numberOfValues));
+  }
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform::Create(dims);
+  dataSet.AddPointField("values", values);
+
+  vtkm::filter::image_processing::ImageMedian median;
+  median.SetNeighborhoodRadius(radius);
+  median.SetActiveField("values");
+  auto result = median.Execute(dataSet);
+
+  vtkm::cont::ArrayHandle<vtkm::Float32> resultArrayHandle;
+  result.GetPointField("median").GetData().AsArrayHandle(resultArrayHandle);
+  std::vector<vtkm::Float32> expected = ExpectedMedian(values, dims, radius);
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(resultArrayHandle,
+                            vtkm::cont::make_ArrayHandle(expected, vtkm::CopyFlag::Off)),
+    "incorrect median values");
+}
+
+void TestImageMedianFilter()
+{
+  TestImageMedian();
+
+  // Sorting networks and selection.
+  TestImageMedianRadius({ 17, 13, 3 }, 1, 0.37f, 1000);
+  TestImageMedianRadius({ 17, 13, 3 }, 2, 0.37f, 1000);
+  // Sliding histogram over whole numbers and over a few different values.
+  TestImageMedianRadius({ 31, 23, 3 }, 3, 1.0f, 700);
+  TestImageMedianRadius({ 31, 23, 1 }, 5, 0.1f, 40000);
+  TestImageMedianRadius({ 40, 9, 2 }, 7, 1.0f, 3);
+  // Too many different values for a histogram.
+  TestImageMedianRadius({ 300, 250, 1 }, 4, 0.25f, 1000003);
+}
 }
 
 int UnitTestImageMedianFilter(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(TestImageMedian, argc, argv);
+  return vtkm::cont::testing::Testing::Run(TestImageMedianFilter, argc, argv);
 }
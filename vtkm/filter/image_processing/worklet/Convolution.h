@@ -0,0 +1,408 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_worklet_Convolution_h
+#define vtk_m_worklet_Convolution_h
+
+#include <vtkm/Math.h>
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <array>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace convolution
+{
+
+VTKM_EXEC_CONT inline vtkm::Id ClampIndex(vtkm::Id index, vtkm::Id size)
+{
+  return vtkm::Min(vtkm::Max(index, vtkm::Id(0)), size - 1);
+}
+
+// The points along one axis of a structured image form lines. This finds the
+// first point of a line and the distance between its points.
+struct ImageLines
+{
+  vtkm::Id3 Dimensions;
+  vtkm::IdComponent Axis;
+
+  VTKM_EXEC_CONT vtkm::Id GetStride() const
+  {
+    return (this->Axis == 0) ? 1
+                             : ((this->Axis == 1) ? this->Dimensions[0]
+                                                  : this->Dimensions[0] * this->Dimensions[1]);
+  }
+
+  VTKM_EXEC_CONT vtkm::Id GetLineStart(vtkm::Id line) const
+  {
+    const vtkm::Id3& dims = this->Dimensions;
+    switch (this->Axis)
+    {
+      case 0:
+        return line * dims[0];
+      case 1:
+        return (line / dims[0]) * dims[0] * dims[1] + line % dims[0];
+      default:
+        return line;
+    }
+  }
+
+  VTKM_EXEC_CONT vtkm::Id GetNumberOfLines() const
+  {
+    return (this->Dimensions[0] * this->Dimensions[1] * this->Dimensions[2]) /
+      this->Dimensions[this->Axis];
+  }
+};
+
+// Weights the values along one axis around each point. The points are visited
+// in memory order, so the values read for neighboring points are neighbors in
+// memory for every axis. Values past the ends of the line repeat the value at
+// the end.
+class ConvolveAxis : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn index, WholeArrayIn input, WholeArrayIn kernel, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  VTKM_CONT ConvolveAxis(const ImageLines& lines, vtkm::Id radius)
+    : Lines(lines)
+    , Radius(radius)
+  {
+  }
+
+  template <typename InPortalType, typename KernelPortalType, typename T>
+  VTKM_EXEC void operator()(vtkm::Id index,
+                            const InPortalType& input,
+                            const KernelPortalType& kernel,
+                            T& output) const
+  {
+    const vtkm::Id3& dims = this->Lines.Dimensions;
+    const vtkm::Id stride = this->Lines.GetStride();
+    const vtkm::Id size = dims[this->Lines.Axis];
+    const vtkm::Id position = (index / stride) % size;
+    const vtkm::Id lineStart = index - position * stride;
+
+    T sum = 0;
+    for (vtkm::Id offset = -this->Radius; offset <= this->Radius; ++offset)
+    {
+      vtkm::Id neighbor = lineStart + ClampIndex(position + offset, size) * stride;
+      sum += static_cast<T>(kernel.Get(offset + this->Radius)) * input.Get(neighbor);
+    }
+    output = sum;
+  }
+
+private:
+  ImageLines Lines;
+  vtkm::Id Radius;
+};
+
+// Convolves whole lines with a kernel by multiplying their discrete Fourier
+// transforms. The cost per point grows with the logarithm of the length of
+// the line rather than with the size of the kernel. Each line is padded with
+// the values at its ends to a power of two long enough that the circular
+// convolution does not wrap around, and is transformed in its own slice of
+// `scratch`.
+class ConvolveAxisFFT : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn line,
+                                WholeArrayIn input,
+                                WholeArrayIn kernelSpectrum,
+                                WholeArrayIn twiddles,
+                                WholeArrayInOut scratch,
+                                WholeArrayInOut output);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5, _6);
+
+  VTKM_CONT ConvolveAxisFFT(const ImageLines& lines, vtkm::Id radius, vtkm::Id transformSize)
+    : Lines(lines)
+    , Radius(radius)
+    , TransformSize(transformSize)
+  {
+  }
+
+  template <typename InPortalType,
+            typename SpectrumPortalType,
+            typename TwiddlePortalType,
+            typename ScratchPortalType,
+            typename OutPortalType>
+  VTKM_EXEC void operator()(vtkm::Id workIndex,
+                            vtkm::Id line,
+                            const InPortalType& input,
+                            const SpectrumPortalType& kernelSpectrum,
+                            const TwiddlePortalType& twiddles,
+                            ScratchPortalType& scratch,
+                            OutPortalType& output) const
+  {
+    using Complex = typename ScratchPortalType::ValueType;
+    using T = typename Complex::ComponentType;
+
+    const vtkm::Id size = this->Lines.Dimensions[this->Lines.Axis];
+    const vtkm::Id stride = this->Lines.GetStride();
+    const vtkm::Id lineStart = this->Lines.GetLineStart(line);
+    const vtkm::Id paddedSize = size + 2 * this->Radius;
+    const vtkm::Id start = workIndex * this->TransformSize;
+
+    for (vtkm::Id i = 0; i < this->TransformSize; ++i)
+    {
+      T value = (i < paddedSize)
+        ? static_cast<T>(input.Get(lineStart + ClampIndex(i - this->Radius, size) * stride))
+        : T(0);
+      scratch.Set(start + i, Complex(value, T(0)));
+    }
+
+    this->Transform(scratch, start, twiddles, false);
+    for (vtkm::Id i = 0; i < this->TransformSize; ++i)
+    {
+      scratch.Set(start + i, Multiply(scratch.Get(start + i), kernelSpectrum.Get(i)));
+    }
+    this->Transform(scratch, start, twiddles, true);
+
+    const T scale = T(1) / static_cast<T>(this->TransformSize);
+    for (vtkm::Id i = 0; i < size; ++i)
+    {
+      output.Set(lineStart + i * stride, scratch.Get(start + i + this->Radius)[0] * scale);
+    }
+  }
+
+private:
+  template <typename Complex>
+  VTKM_EXEC static Complex Multiply(const Complex& a, const Complex& b)
+  {
+    return Complex(a[0] * b[0] - a[1] * b[1], a[0] * b[1] + a[1] * b[0]);
+  }
+
+  // In place iterative radix-2 transform. `twiddles` holds the first half of the
+  // roots of unity exp(-2 pi i k / TransformSize). The inverse transform is not
+  // scaled.
+  template <typename ScratchPortalType, typename TwiddlePortalType>
+  VTKM_EXEC void Transform(ScratchPortalType& values,
+                           vtkm::Id start,
+                           const TwiddlePortalType& twiddles,
+                           bool inverse) const
+  {
+    using Complex = typename ScratchPortalType::ValueType;
+    const vtkm::Id n = this->TransformSize;
+
+    for (vtkm::Id i = 1, j = 0; i < n; ++i)
+    {
+      vtkm::Id bit = n >> 1;
+      for (; j & bit; bit >>= 1)
+      {
+        j ^= bit;
+      }
+      j ^= bit;
+      if (i < j)
+      {
+        Complex value = values.Get(start + i);
+        values.Set(start + i, values.Get(start + j));
+        values.Set(start + j, value);
+      }
+    }
+
+    for (vtkm::Id length = 2; length <= n; length <<= 1)
+    {
+      const vtkm::Id half = length / 2;
+      const vtkm::Id twiddleStep = n / length;
+      for (vtkm::Id i = 0; i < n; i += length)
+      {
+        for (vtkm::Id j = 0; j < half; ++j)
+        {
+          Complex w = twiddles.Get(j * twiddleStep);
+          if (inverse)
+          {
+            w[1] = -w[1];
+          }
+          Complex u = values.Get(start + i + j);
+          Complex v = Multiply(values.Get(start + i + j + half), w);
+          values.Set(start + i + j, u + v);
+          values.Set(start + i + j + half, u - v);
+        }
+      }
+    }
+  }
+
+  ImageLines Lines;
+  vtkm::Id Radius;
+  vtkm::Id TransformSize;
+};
+} // namespace convolution
+
+/// Convolves a field on a structured image with a separable kernel, one axis
+/// at a time. Each axis has its own odd sized kernel of weights for the
+/// values from `-radius` to `radius` points away along that axis. Values
+/// outside of the image repeat the nearest value on the boundary.
+class Convolution
+{
+public:
+  /// Axes with an empty kernel, or with a single point, are not convolved.
+  VTKM_CONT void SetKernel(vtkm::IdComponent axis, const std::vector<vtkm::FloatDefault>& kernel)
+  {
+    if ((axis < 0) || (axis > 2))
+    {
+      throw vtkm::cont::ErrorBadValue("Convolution axis must be 0, 1 or 2.");
+    }
+    if (((kernel.size() % 2) == 0) && !kernel.empty())
+    {
+      throw vtkm::cont::ErrorBadValue("Convolution kernels must have an odd number of weights.");
+    }
+    this->Kernels[static_cast<std::size_t>(axis)] = kernel;
+  }
+
+  /// Kernels with more weights than this use the FFT.
+  VTKM_CONT void SetFFTKernelSize(vtkm::Id size) { this->FFTKernelSize = size; }
+
+  template <typename T, typename InStorage, typename OutStorage>
+  VTKM_CONT void Run(const vtkm::Id3& dimensions,
+                     const vtkm::cont::ArrayHandle<T, InStorage>& input,
+                     vtkm::cont::ArrayHandle<T, OutStorage>& output) const
+  {
+    std::vector<vtkm::IdComponent> axes;
+    for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+    {
+      if (!this->Kernels[static_cast<std::size_t>(axis)].empty() && (dimensions[axis] > 1))
+      {
+        axes.push_back(axis);
+      }
+    }
+    if (axes.empty())
+    {
+      vtkm::cont::ArrayCopy(input, output);
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<T> buffers[2];
+    for (std::size_t pass = 0; pass < axes.size(); ++pass)
+    {
+      convolution::ImageLines lines{ dimensions, axes[pass] };
+      bool first = (pass == 0);
+      bool last = (pass + 1 == axes.size());
+      if (first && last)
+      {
+        this->RunAxis(lines, input, output);
+      }
+      else if (first)
+      {
+        this->RunAxis(lines, input, buffers[0]);
+      }
+      else if (last)
+      {
+        this->RunAxis(lines, buffers[(pass - 1) % 2], output);
+      }
+      else
+      {
+        this->RunAxis(lines, buffers[(pass - 1) % 2], buffers[pass % 2]);
+      }
+    }
+  }
+
+private:
+  // Limits the number of lines transformed at once so that the scratch space
+  // stays within this many complex values.
+  static constexpr vtkm::Id MaxScratchSize = vtkm::Id(1) << 24;
+
+  template <typename T, typename InStorage, typename OutStorage>
+  VTKM_CONT void RunAxis(const convolution::ImageLines& lines,
+                         const vtkm::cont::ArrayHandle<T, InStorage>& input,
+                         vtkm::cont::ArrayHandle<T, OutStorage>& output) const
+  {
+    const std::vector<vtkm::FloatDefault>& kernel =
+      this->Kernels[static_cast<std::size_t>(lines.Axis)];
+    vtkm::Id radius = static_cast<vtkm::Id>(kernel.size() / 2);
+    vtkm::cont::Invoker invoke;
+
+    if (static_cast<vtkm::Id>(kernel.size()) <= this->FFTKernelSize)
+    {
+      invoke(convolution::ConvolveAxis{ lines, radius },
+             vtkm::cont::ArrayHandleIndex(input.GetNumberOfValues()),
+             input,
+             vtkm::cont::make_ArrayHandle(kernel, vtkm::CopyFlag::Off),
+             output);
+      return;
+    }
+
+    using Complex = vtkm::Vec<T, 2>;
+    vtkm::Id size = lines.Dimensions[lines.Axis];
+    vtkm::Id transformSize = 1;
+    while (transformSize < size + 2 * radius)
+    {
+      transformSize *= 2;
+    }
+
+    // The kernel is stored reversed and wrapped around so that the circular
+    // convolution weights the value `d` points away with kernel[radius + d].
+    vtkm::cont::ArrayHandle<Complex> kernelSpectrum;
+    kernelSpectrum.Allocate(transformSize);
+    vtkm::cont::ArrayHandle<Complex> twiddles;
+    twiddles.Allocate(transformSize / 2);
+    {
+      auto spectrumPortal = kernelSpectrum.WritePortal();
+      for (vtkm::Id frequency = 0; frequency < transformSize; ++frequency)
+      {
+        vtkm::Float64 real = 0;
+        vtkm::Float64 imaginary = 0;
+        for (vtkm::Id offset = -radius; offset <= radius; ++offset)
+        {
+          vtkm::Float64 angle = vtkm::TwoPi<vtkm::Float64>() *
+            static_cast<vtkm::Float64>((frequency * offset) % transformSize) /
+            static_cast<vtkm::Float64>(transformSize);
+          vtkm::Float64 weight = kernel[static_cast<std::size_t>(offset + radius)];
+          real += weight * vtkm::Cos(angle);
+          imaginary += weight * vtkm::Sin(angle);
+        }
+        spectrumPortal.Set(frequency, Complex(static_cast<T>(real), static_cast<T>(imaginary)));
+      }
+      auto twiddlePortal = twiddles.WritePortal();
+      for (vtkm::Id k = 0; k < transformSize / 2; ++k)
+      {
+        vtkm::Float64 angle = -vtkm::TwoPi<vtkm::Float64>() * static_cast<vtkm::Float64>(k) /
+          static_cast<vtkm::Float64>(transformSize);
+        twiddlePortal.Set(
+          k, Complex(static_cast<T>(vtkm::Cos(angle)), static_cast<T>(vtkm::Sin(angle))));
+      }
+    }
+
+    output.Allocate(input.GetNumberOfValues());
+    vtkm::Id numberOfLines = lines.GetNumberOfLines();
+    vtkm::Id linesPerBatch =
+      vtkm::Max(vtkm::Id(1), vtkm::Min(numberOfLines, MaxScratchSize / transformSize));
+    vtkm::cont::ArrayHandle<Complex> scratch;
+    scratch.Allocate(linesPerBatch * transformSize);
+    convolution::ConvolveAxisFFT worklet(lines, radius, transformSize);
+    for (vtkm::Id start = 0; start < numberOfLines; start += linesPerBatch)
+    {
+      vtkm::Id count = vtkm::Min(linesPerBatch, numberOfLines - start);
+      invoke(worklet,
+             vtkm::cont::make_ArrayHandleCounting(start, vtkm::Id(1), count),
+             input,
+             kernelSpectrum,
+             twiddles,
+             scratch,
+             output);
+    }
+  }
+
+  std::array<std::vector<vtkm::FloatDefault>, 3> Kernels;
+  vtkm::Id FFTKernelSize = 127;
+};
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_Convolution_h
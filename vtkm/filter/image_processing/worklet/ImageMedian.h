@@ -0,0 +1,551 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_worklet_ImageMedian_h
+#define vtk_m_worklet_ImageMedian_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Swap.h>
+#include <vtkm/VecTraits.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/WorkletPointNeighborhood.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+template <typename T>
+VTKM_EXEC inline T find_median(T* values, std::size_t mid, std::size_t size)
+{
+  std::size_t begin = 0;
+  std::size_t end = size - 1;
+  while (begin < end)
+  {
+    T x = values[mid];
+    std::size_t i = begin;
+    std::size_t j = end;
+    do
+    {
+      for (; values[i] < x; i++)
+      {
+      }
+      for (; x < values[j]; j--)
+      {
+      }
+      if (i <= j)
+      {
+        vtkm::Swap(values[i], values[j]);
+        i++;
+        j--;
+      }
+    } while (i <= j);
+
+    begin = (j < mid) ? i : begin;
+    end = (mid < i) ? j : end;
+  }
+  return values[mid];
+}
+
+namespace image_median
+{
+template <typename T>
+VTKM_EXEC inline void SortPair(T& a, T& b)
+{
+  T low = vtkm::Min(a, b);
+  b = vtkm::Max(a, b);
+  a = low;
+}
+
+// Median of 9 values with the 19 exchange network of Paeth ("Graphics Gems",
+// 1990). It has no data dependent branches, so the compiler can vectorize it.
+template <typename T>
+VTKM_EXEC inline T Median9(vtkm::Vec<T, 9>& p)
+{
+  SortPair(p[1], p[2]);
+  SortPair(p[4], p[5]);
+  SortPair(p[7], p[8]);
+  SortPair(p[0], p[1]);
+  SortPair(p[3], p[4]);
+  SortPair(p[6], p[7]);
+  SortPair(p[1], p[2]);
+  SortPair(p[4], p[5]);
+  SortPair(p[7], p[8]);
+  SortPair(p[0], p[3]);
+  SortPair(p[5], p[8]);
+  SortPair(p[4], p[7]);
+  SortPair(p[3], p[6]);
+  SortPair(p[1], p[4]);
+  SortPair(p[2], p[5]);
+  SortPair(p[4], p[7]);
+  SortPair(p[4], p[2]);
+  SortPair(p[6], p[4]);
+  SortPair(p[4], p[2]);
+  return p[4];
+}
+
+VTKM_EXEC_CONT inline vtkm::Id ClampIndex(vtkm::Id index, vtkm::Id size)
+{
+  return vtkm::Min(vtkm::Max(index, vtkm::Id(0)), size - 1);
+}
+} // namespace image_median
+
+struct ImageMedian : public vtkm::worklet::WorkletPointNeighborhood
+{
+  int Neighborhood;
+  ImageMedian(int neighborhoodSize)
+    : Neighborhood(neighborhoodSize)
+  {
+  }
+  using ControlSignature = void(CellSetIn, FieldInNeighborhood, FieldOut);
+  using ExecutionSignature = void(_2, _3);
+
+  template <typename InNeighborhoodT, typename T>
+  VTKM_EXEC void operator()(const InNeighborhoodT& input, T& out) const
+  {
+    if (this->Neighborhood == 1)
+    {
+      vtkm::Vec<T, 9> values;
+      int index = 0;
+      for (int x = -1; x <= 1; ++x)
+      {
+        for (int y = -1; y <= 1; ++y)
+        {
+          values[index++] = input.Get(x, y, 0);
+        }
+      }
+      out = image_median::Median9(values);
+      return;
+    }
+
+    vtkm::Vec<T, 25> values;
+    int index = 0;
+    for (int x = -this->Neighborhood; x <= this->Neighborhood; ++x)
+    {
+      for (int y = -this->Neighborhood; y <= this->Neighborhood; ++y)
+      {
+        values[index++] = input.Get(x, y, 0);
+      }
+    }
+
+    std::size_t len =
+      static_cast<std::size_t>((this->Neighborhood * 2 + 1) * (this->Neighborhood * 2 + 1));
+    std::size_t mid = len / 2;
+    out = find_median(&values[0], mid, len);
+  }
+};
+
+namespace image_median
+{
+// Finds the bin of each value by binary search in the sorted values of the bins.
+struct ValueToBin : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn value, WholeArrayIn binValues, FieldOut bin);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename T, typename BinValuePortal>
+  VTKM_EXEC void operator()(const T& value,
+                            const BinValuePortal& binValues,
+                            vtkm::UInt16& bin) const
+  {
+    vtkm::Id low = 0;
+    vtkm::Id high = binValues.GetNumberOfValues() - 1;
+    while (low < high)
+    {
+      vtkm::Id middle = (low + high) / 2;
+      if (binValues.Get(middle) < value)
+      {
+        low = middle + 1;
+      }
+      else
+      {
+        high = middle;
+      }
+    }
+    bin = static_cast<vtkm::UInt16>(low);
+  }
+};
+
+struct IsNotWholeNumber
+{
+  template <typename T>
+  VTKM_EXEC_CONT vtkm::Id operator()(const T& value) const
+  {
+    return (vtkm::Floor(value) == value) ? 0 : 1;
+  }
+};
+
+// Computes the median of each row of an image with a sliding histogram
+// (T. S. Huang, "A fast two-dimensional median filtering algorithm", 1979).
+// Moving the window by one pixel removes one column of the window from the
+// histogram and adds another, and the median bin is found by walking from the
+// median bin of the previous pixel. A second level of coarse bins, each
+// counting 256 bins, lets the walk skip over empty parts of the histogram
+// (S. Perreault and P. Hébert, "Median Filtering in Constant Time", 2007).
+//
+// Each thread filters one row and owns a slice of `histograms`, which must be
+// all zero. The thread removes its last window before returning, so the
+// histograms can be used again without clearing them.
+class SlidingHistogramMedian : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn row,
+                                WholeArrayIn bins,
+                                WholeArrayIn binValues,
+                                WholeArrayInOut histograms,
+                                WholeArrayInOut medians);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5);
+
+  static constexpr vtkm::Id CoarseShift = 8;
+
+  VTKM_CONT SlidingHistogramMedian(const vtkm::Id3& pointDimensions,
+                                   vtkm::IdComponent radius,
+                                   vtkm::Id numberOfBins)
+    : PointDimensions(pointDimensions)
+    , Radius(radius)
+    , NumberOfBins(numberOfBins)
+  {
+  }
+
+  VTKM_EXEC_CONT static vtkm::Id GetHistogramSize(vtkm::Id numberOfBins)
+  {
+    return numberOfBins + (numberOfBins >> CoarseShift) + 1;
+  }
+
+  template <typename BinPortal,
+            typename BinValuePortal,
+            typename HistogramPortal,
+            typename MedianPortal>
+  VTKM_EXEC void operator()(vtkm::Id workIndex,
+                            vtkm::Id row,
+                            const BinPortal& bins,
+                            const BinValuePortal& binValues,
+                            HistogramPortal& histograms,
+                            MedianPortal& medians) const
+  {
+    const vtkm::Id3& dims = this->PointDimensions;
+    const vtkm::Id r = this->Radius;
+    Window window;
+    window.Fine = workIndex * GetHistogramSize(this->NumberOfBins);
+    window.Coarse = window.Fine + this->NumberOfBins;
+    window.RowStart = row * dims[0];
+    window.SliceStart = (row / dims[1]) * dims[0] * dims[1];
+    window.Row = row % dims[1];
+
+    // The median is the value at this position in the sorted window.
+    const vtkm::Id mid = ((2 * r + 1) * (2 * r + 1)) / 2;
+
+    for (vtkm::Id dx = -r; dx <= r; ++dx)
+    {
+      this->UpdateColumn(window, ClampIndex(dx, dims[0]), 1, bins, histograms);
+    }
+    for (vtkm::Id x = 0; x < dims[0]; ++x)
+    {
+      this->FindMedian(window, mid, histograms);
+      medians.Set(window.RowStart + x, binValues.Get(window.MedianBin));
+      if (x + 1 < dims[0])
+      {
+        this->UpdateColumn(window, ClampIndex(x - r, dims[0]), -1, bins, histograms);
+        this->UpdateColumn(window, ClampIndex(x + 1 + r, dims[0]), 1, bins, histograms);
+      }
+    }
+    for (vtkm::Id dx = -r; dx <= r; ++dx)
+    {
+      this->UpdateColumn(window, ClampIndex(dims[0] - 1 + dx, dims[0]), -1, bins, histograms);
+    }
+  }
+
+private:
+  struct Window
+  {
+    vtkm::Id Fine;
+    vtkm::Id Coarse;
+    vtkm::Id RowStart;
+    vtkm::Id SliceStart;
+    vtkm::Id Row;
+    vtkm::Id MedianBin = 0;
+    // Number of values in the window in bins below MedianBin.
+    vtkm::Id CountBelow = 0;
+  };
+
+  template <typename BinPortal, typename HistogramPortal>
+  VTKM_EXEC void UpdateColumn(Window& window,
+                              vtkm::Id x,
+                              vtkm::Int32 delta,
+                              const BinPortal& bins,
+                              HistogramPortal& histograms) const
+  {
+    const vtkm::Id3& dims = this->PointDimensions;
+    for (vtkm::Id dy = -this->Radius; dy <= this->Radius; ++dy)
+    {
+      vtkm::Id y = ClampIndex(window.Row + dy, dims[1]);
+      vtkm::Id bin = static_cast<vtkm::Id>(bins.Get(window.SliceStart + y * dims[0] + x));
+      histograms.Set(window.Fine + bin, histograms.Get(window.Fine + bin) + delta);
+      vtkm::Id coarse = window.Coarse + (bin >> CoarseShift);
+      histograms.Set(coarse, histograms.Get(coarse) + delta);
+      if (bin < window.MedianBin)
+      {
+        window.CountBelow += delta;
+      }
+    }
+  }
+
+  template <typename HistogramPortal>
+  VTKM_EXEC void FindMedian(Window& window,
+                            vtkm::Id mid,
+                            const HistogramPortal& histograms) const
+  {
+    constexpr vtkm::Id coarseSize = vtkm::Id(1) << CoarseShift;
+    vtkm::Id& bin = window.MedianBin;
+    vtkm::Id& below = window.CountBelow;
+    while (below > mid)
+    {
+      vtkm::Id coarse = (bin >> CoarseShift) - 1;
+      if ((bin % coarseSize == 0) && (below - histograms.Get(window.Coarse + coarse) > mid))
+      {
+        below -= histograms.Get(window.Coarse + coarse);
+        bin -= coarseSize;
+      }
+      else
+      {
+        --bin;
+        below -= histograms.Get(window.Fine + bin);
+      }
+    }
+    while (true)
+    {
+      vtkm::Id coarse = bin >> CoarseShift;
+      if ((bin % coarseSize == 0) && (below + histograms.Get(window.Coarse + coarse) <= mid))
+      {
+        below += histograms.Get(window.Coarse + coarse);
+        bin += coarseSize;
+      }
+      else if (below + histograms.Get(window.Fine + bin) <= mid)
+      {
+        below += histograms.Get(window.Fine + bin);
+        ++bin;
+      }
+      else
+      {
+        break;
+      }
+    }
+  }
+
+  vtkm::Id3 PointDimensions;
+  vtkm::Id Radius;
+  vtkm::Id NumberOfBins;
+};
+
+// Computes the median of each row of an image by selection when the values
+// do not fit in a histogram. Each thread gathers the windows of its row in its
+// own slice of `scratch`.
+class SelectionMedian : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn row,
+                                WholeArrayIn values,
+                                WholeArrayInOut scratch,
+                                WholeArrayInOut medians);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4);
+
+  VTKM_CONT SelectionMedian(const vtkm::Id3& pointDimensions, vtkm::IdComponent radius)
+    : PointDimensions(pointDimensions)
+    , Radius(radius)
+  {
+  }
+
+  template <typename ValuePortal, typename ScratchPortal, typename MedianPortal>
+  VTKM_EXEC void operator()(vtkm::Id workIndex,
+                            vtkm::Id row,
+                            const ValuePortal& values,
+                            ScratchPortal& scratch,
+                            MedianPortal& medians) const
+  {
+    using T = typename ScratchPortal::ValueType;
+    const vtkm::Id3& dims = this->PointDimensions;
+    const vtkm::Id r = this->Radius;
+    const vtkm::Id size = (2 * r + 1) * (2 * r + 1);
+    const vtkm::Id sliceStart = (row / dims[1]) * dims[0] * dims[1];
+    const vtkm::Id j = row % dims[1];
+
+    const vtkm::Id windowStart = workIndex * size;
+    for (vtkm::Id x = 0; x < dims[0]; ++x)
+    {
+      vtkm::Id index = windowStart;
+      for (vtkm::Id dx = -r; dx <= r; ++dx)
+      {
+        for (vtkm::Id dy = -r; dy <= r; ++dy)
+        {
+          vtkm::Id pointId = sliceStart + ClampIndex(j + dy, dims[1]) * dims[0] +
+            ClampIndex(x + dx, dims[0]);
+          scratch.Set(index++, static_cast<T>(values.Get(pointId)));
+        }
+      }
+      medians.Set(row * dims[0] + x, Select(scratch, windowStart, windowStart + size / 2, size));
+    }
+  }
+
+private:
+  // The selection of find_median on a range of a portal.
+  template <typename ScratchPortal>
+  VTKM_EXEC static typename ScratchPortal::ValueType Select(ScratchPortal& values,
+                                                            vtkm::Id begin,
+                                                            vtkm::Id mid,
+                                                            vtkm::Id size)
+  {
+    using T = typename ScratchPortal::ValueType;
+    vtkm::Id end = begin + size - 1;
+    while (begin < end)
+    {
+      T x = values.Get(mid);
+      vtkm::Id i = begin;
+      vtkm::Id j = end;
+      do
+      {
+        for (; values.Get(i) < x; i++)
+        {
+        }
+        for (; x < values.Get(j); j--)
+        {
+        }
+        if (i <= j)
+        {
+          T value = values.Get(i);
+          values.Set(i, values.Get(j));
+          values.Set(j, value);
+          i++;
+          j--;
+        }
+      } while (i <= j);
+
+      begin = (j < mid) ? i : begin;
+      end = (mid < i) ? j : end;
+    }
+    return values.Get(mid);
+  }
+
+private:
+  vtkm::Id3 PointDimensions;
+  vtkm::Id Radius;
+};
+} // namespace image_median
+
+/// Median filter with a square window of any radius in the x-y plane of a
+/// structured image. Values outside the image repeat the nearest value on the
+/// boundary, as in the `ImageMedian` worklet. The rows of the image are
+/// filtered in parallel with a sliding histogram when the field has at most
+/// `MaxNumberOfBins` different values, or whole numbers over that range, and
+/// by selection otherwise.
+class SlidingImageMedian
+{
+public:
+  static constexpr vtkm::Id MaxNumberOfBins = 65536;
+  // Limits the number of rows filtered at once so that the per-row scratch
+  // space stays within this many values.
+  static constexpr vtkm::Id MaxScratchSize = vtkm::Id(1) << 26;
+
+  template <typename T, typename S>
+  VTKM_CONT void Run(const vtkm::Id3& pointDimensions,
+                     vtkm::IdComponent radius,
+                     const vtkm::cont::ArrayHandle<T, S>& values,
+                     vtkm::cont::ArrayHandle<T>& medians) const
+  {
+    medians.Allocate(values.GetNumberOfValues());
+    if (values.GetNumberOfValues() == 0)
+    {
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<T> binValues;
+    if (this->FindBinValues(values, binValues))
+    {
+      vtkm::cont::Invoker invoke;
+      vtkm::cont::ArrayHandle<vtkm::UInt16> bins;
+      invoke(image_median::ValueToBin{}, values, binValues, bins);
+
+      vtkm::Id numberOfBins = binValues.GetNumberOfValues();
+      vtkm::Id histogramSize =
+        image_median::SlidingHistogramMedian::GetHistogramSize(numberOfBins);
+      image_median::SlidingHistogramMedian worklet(pointDimensions, radius, numberOfBins);
+      this->ForEachRowBatch(pointDimensions, histogramSize, [&](const auto& rows) {
+        vtkm::cont::ArrayHandle<vtkm::Int32> histograms;
+        histograms.AllocateAndFill(rows.GetNumberOfValues() * histogramSize, 0);
+        invoke(worklet, rows, bins, binValues, histograms, medians);
+      });
+    }
+    else
+    {
+      vtkm::cont::Invoker invoke;
+      vtkm::Id windowSize = (2 * radius + 1) * (2 * radius + 1);
+      image_median::SelectionMedian worklet(pointDimensions, radius);
+      this->ForEachRowBatch(pointDimensions, windowSize, [&](const auto& rows) {
+        vtkm::cont::ArrayHandle<T> scratch;
+        scratch.Allocate(rows.GetNumberOfValues() * windowSize);
+        invoke(worklet, rows, values, scratch, medians);
+      });
+    }
+  }
+
+private:
+  // The bins are all the whole numbers over the range of the values when the
+  // values are whole numbers, and the sorted unique values otherwise.
+  template <typename T, typename S>
+  VTKM_CONT bool FindBinValues(const vtkm::cont::ArrayHandle<T, S>& values,
+                               vtkm::cont::ArrayHandle<T>& binValues) const
+  {
+    T minValue = vtkm::cont::Algorithm::Reduce(values, values.ReadPortal().Get(0), vtkm::Minimum{});
+    T maxValue = vtkm::cont::Algorithm::Reduce(values, minValue, vtkm::Maximum{});
+    vtkm::Id numberOfNotWhole = vtkm::cont::Algorithm::Reduce(
+      vtkm::cont::make_ArrayHandleTransform(values, image_median::IsNotWholeNumber{}),
+      vtkm::Id(0));
+    if ((numberOfNotWhole == 0) && (static_cast<vtkm::Float64>(maxValue) -
+                                      static_cast<vtkm::Float64>(minValue) <
+                                    static_cast<vtkm::Float64>(MaxNumberOfBins)))
+    {
+      vtkm::Id numberOfBins = static_cast<vtkm::Id>(maxValue - minValue) + 1;
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleCounting(minValue, T(1), numberOfBins),
+                            binValues);
+      return true;
+    }
+
+    vtkm::cont::Algorithm::Copy(values, binValues);
+    vtkm::cont::Algorithm::Sort(binValues);
+    vtkm::cont::Algorithm::Unique(binValues);
+    return binValues.GetNumberOfValues() <= MaxNumberOfBins;
+  }
+
+  template <typename Functor>
+  VTKM_CONT void ForEachRowBatch(const vtkm::Id3& pointDimensions,
+                                 vtkm::Id scratchPerRow,
+                                 Functor&& functor) const
+  {
+    vtkm::Id numberOfRows = pointDimensions[1] * pointDimensions[2];
+    vtkm::Id rowsPerBatch =
+      vtkm::Max(vtkm::Id(1), vtkm::Min(numberOfRows, MaxScratchSize / scratchPerRow));
+    for (vtkm::Id start = 0; start < numberOfRows; start += rowsPerBatch)
+    {
+      vtkm::Id count = vtkm::Min(rowsPerBatch, numberOfRows - start);
+      functor(vtkm::cont::make_ArrayHandleCounting(start, vtkm::Id(1), count));
+    }
+  }
+};
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_ImageMedian_h
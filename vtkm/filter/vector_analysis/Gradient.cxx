@@ -11,6 +11,10 @@
 #include <vtkm/cont/UnknownCellSet.h>
 #include <vtkm/filter/vector_analysis/Gradient.h>
 #include <vtkm/filter/vector_analysis/worklet/Gradient.h>
+#include <vtkm/filter/vector_analysis/worklet/gradient/PointGradientStencil.h>
+
+#include <mutex>
+#include <vector>
 
 namespace
 {
@@ -36,6 +40,64 @@ namespace filter
 {
 namespace vector_analysis
 {
+//-----------------------------------------------------------------------------
+struct Gradient::StencilCache
+{
+  std::mutex Mutex;
+  std::vector<vtkm::worklet::gradient::PointGradientStencil> Stencils;
+};
+
+//-----------------------------------------------------------------------------
+void Gradient::SetCachePointGradientStencils(bool enable)
+{
+  if (!enable)
+  {
+    this->Stencils.reset();
+  }
+  else if (!this->Stencils)
+  {
+    this->Stencils = std::make_shared<StencilCache>();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Gradient::ClearPointGradientStencils()
+{
+  if (this->Stencils)
+  {
+    this->Stencils = std::make_shared<StencilCache>();
+  }
+}
+
+//-----------------------------------------------------------------------------
+vtkm::worklet::gradient::PointGradientStencil Gradient::FindPointGradientStencil(
+  const vtkm::cont::UnknownCellSet& cellSet,
+  const vtkm::cont::CoordinateSystem& coords)
+{
+  // Keep our own reference so that clearing the cache while another thread
+  // executes the filter does not pull the cache out from under it.
+  std::shared_ptr<StencilCache> cache = this->Stencils;
+  {
+    std::lock_guard<std::mutex> lock(cache->Mutex);
+    for (const auto& stencil : cache->Stencils)
+    {
+      if (stencil.IsBuiltFor(cellSet, coords))
+      {
+        return stencil;
+      }
+    }
+  }
+
+  // Build without holding the lock so that partitions executing on other
+  // threads are not blocked.
+  vtkm::worklet::gradient::PointGradientStencil stencil;
+  stencil.Build(cellSet, coords);
+
+  std::lock_guard<std::mutex> lock(cache->Mutex);
+  cache->Stencils.push_back(stencil);
+  return stencil;
+}
+
 //-----------------------------------------------------------------------------
 vtkm::cont::DataSet Gradient::DoExecute(const vtkm::cont::DataSet& inputDataSet)
 {
@@ -59,6 +121,19 @@ vtkm::cont::DataSet Gradient::DoExecute(const vtkm::cont::DataSet& inputDataSet)
   const vtkm::cont::CoordinateSystem& coords =
     inputDataSet.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
 
+  bool useStencil = this->ComputePointGradient && this->Stencils;
+  vtkm::ListForEach(
+    [&](auto structured) {
+      useStencil = useStencil && !inputCellSet.IsType<decltype(structured)>();
+    },
+    VTKM_DEFAULT_CELL_SET_LIST_STRUCTURED{});
+
+  vtkm::worklet::gradient::PointGradientStencil stencil;
+  if (useStencil)
+  {
+    stencil = this->FindPointGradientStencil(inputCellSet, coords);
+  }
+
   vtkm::cont::UnknownArrayHandle gradientArray;
   vtkm::cont::UnknownArrayHandle divergenceArray;
   vtkm::cont::UnknownArrayHandle vorticityArray;
@@ -76,7 +151,11 @@ vtkm::cont::DataSet Gradient::DoExecute(const vtkm::cont::DataSet& inputDataSet)
                                                           this->GetComputeQCriterion());
 
     vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>> result;
-    if (this->ComputePointGradient)
+    if (useStencil)
+    {
+      result = stencil.Run(concrete, gradientfields);
+    }
+    else if (this->ComputePointGradient)
     {
       vtkm::worklet::PointGradient gradient;
       result = gradient.Run(inputCellSet, coords, concrete, gradientfields);
@@ -14,8 +14,18 @@
 #include <vtkm/filter/FilterField.h>
 #include <vtkm/filter/vector_analysis/vtkm_filter_vector_analysis_export.h>
 
+#include <memory>
+
 namespace vtkm
 {
+namespace worklet
+{
+namespace gradient
+{
+class PointGradientStencil;
+}
+} // namespace worklet
+
 namespace filter
 {
 namespace vector_analysis
@@ -43,6 +53,23 @@ public:
   /// @copydoc SetComputePointGradient
   bool GetComputePointGradient() const { return ComputePointGradient; }
 
+  /// @brief Specify whether to keep the point gradient weights between executions.
+  ///
+  /// The point gradient of a field is a weighted sum of the field values at the
+  /// neighboring points, and the weights only depend on the mesh. When this flag is on
+  /// (default is off), point gradients of unstructured cell sets compute these weights
+  /// once for each cell set, keep them in a sparse matrix and compute the gradient of
+  /// every field as a product with this matrix. This is much faster when gradients of
+  /// many fields or time steps are computed on the same mesh. The weights are only reused
+  /// for the very same cell set and coordinate array objects. Call
+  /// `ClearPointGradientStencils()` when these are modified in place.
+  void SetCachePointGradientStencils(bool enable);
+  /// @copydoc SetCachePointGradientStencils
+  bool GetCachePointGradientStencils() const { return static_cast<bool>(this->Stencils); }
+
+  /// Release the point gradient weights kept by `SetCachePointGradientStencils()`.
+  void ClearPointGradientStencils();
+
   /// Add divergence field to the output data. The input array must have 3 components
   /// to compute this. The default is off.
   void SetComputeDivergence(bool enable) { ComputeDivergence = enable; }
@@ -103,6 +130,13 @@ public:
 private:
   vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& inputDataSet) override;
 
+  vtkm::worklet::gradient::PointGradientStencil FindPointGradientStencil(
+    const vtkm::cont::UnknownCellSet& cellSet,
+    const vtkm::cont::CoordinateSystem& coords);
+
+  struct StencilCache;
+  std::shared_ptr<StencilCache> Stencils;
+
   bool ComputePointGradient = false;
   bool ComputeDivergence = false;
   bool ComputeVorticity = false;
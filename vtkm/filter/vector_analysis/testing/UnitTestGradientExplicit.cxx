@@ -10,6 +10,7 @@
 
 #include <vtkm/filter/vector_analysis/Gradient.h>
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
@@ -68,11 +69,107 @@ void TestPointGradientExplicit()
   }
 }
 
+vtkm::cont::ArrayHandle<vtkm::Vec3f_64> MakeVectorField(const vtkm::cont::DataSet& dataSet,
+                                                        vtkm::Float64 time)
+{
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> coords;
+  vtkm::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), coords);
+  auto coordsPortal = coords.ReadPortal();
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> field;
+  field.Allocate(coords.GetNumberOfValues());
+  auto fieldPortal = field.WritePortal();
+  for (vtkm::Id i = 0; i < coords.GetNumberOfValues(); ++i)
+  {
+    const vtkm::Vec3f_64 p = coordsPortal.Get(i);
+    fieldPortal.Set(i, { p[0] * p[1] + time, p[1] + p[2] * p[2] * time, p[0] * p[2] - p[1] });
+  }
+  return field;
+}
+
+void CheckSameFields(const vtkm::cont::DataSet& expected, const vtkm::cont::DataSet& result)
+{
+  for (const std::string name : { "gradient", "Divergence", "Vorticity", "QCriterion" })
+  {
+    VTKM_TEST_ASSERT(result.HasPointField(name), "Result field missing.");
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(expected.GetPointField(name).GetData(),
+                                             result.GetPointField(name).GetData()),
+                     "Wrong ", name, " from the cached point gradient stencil");
+  }
+}
+
+void TestPointGradientStencil(vtkm::cont::DataSet dataSet)
+{
+  vtkm::filter::vector_analysis::Gradient direct;
+  direct.SetComputePointGradient(true);
+  direct.SetComputeDivergence(true);
+  direct.SetComputeVorticity(true);
+  direct.SetComputeQCriterion(true);
+  direct.SetOutputFieldName("gradient");
+  direct.SetActiveField("velocity");
+
+  vtkm::filter::vector_analysis::Gradient cached = direct;
+  cached.SetCachePointGradientStencils(true);
+  VTKM_TEST_ASSERT(cached.GetCachePointGradientStencils());
+
+  // Several time steps on the same mesh reuse the stencil.
+  for (vtkm::Float64 time : { 0.0, 0.5, 2.0 })
+  {
+    dataSet.AddPointField("velocity", MakeVectorField(dataSet, time));
+    CheckSameFields(direct.Execute(dataSet), cached.Execute(dataSet));
+  }
+
+  // Scalar fields use the same stencil.
+  cached.SetActiveField("pointvar");
+  cached.SetComputeDivergence(false);
+  cached.SetComputeVorticity(false);
+  cached.SetComputeQCriterion(false);
+  direct.SetActiveField("pointvar");
+  direct.SetComputeDivergence(false);
+  direct.SetComputeVorticity(false);
+  direct.SetComputeQCriterion(false);
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(direct.Execute(dataSet).GetPointField("gradient").GetData(),
+                            cached.Execute(dataSet).GetPointField("gradient").GetData()),
+    "Wrong scalar gradient from the cached point gradient stencil");
+
+  // New coordinates for the same cell set must not use the old stencil.
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> coords;
+  vtkm::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), coords);
+  auto coordsPortal = coords.WritePortal();
+  for (vtkm::Id i = 0; i < coords.GetNumberOfValues(); ++i)
+  {
+    const vtkm::Vec3f p = coordsPortal.Get(i);
+    coordsPortal.Set(i, { 2 * p[0], p[1] + 0.25f * p[0], p[2] });
+  }
+  dataSet.AddCoordinateSystem(vtkm::cont::CoordinateSystem("coords", coords));
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(direct.Execute(dataSet).GetPointField("gradient").GetData(),
+                            cached.Execute(dataSet).GetPointField("gradient").GetData()),
+    "Cached point gradient stencil used with other coordinates");
+
+  cached.ClearPointGradientStencils();
+  VTKM_TEST_ASSERT(cached.GetCachePointGradientStencils());
+  cached.SetCachePointGradientStencils(false);
+  VTKM_TEST_ASSERT(!cached.GetCachePointGradientStencils());
+}
+
+void TestPointGradientStencil()
+{
+  std::cout << "Testing Gradient Filter with cached point stencils on Explicit data" << std::endl;
+
+  vtkm::cont::testing::MakeTestDataSet testDataSet;
+  TestPointGradientStencil(testDataSet.Make3DExplicitDataSet0());
+  TestPointGradientStencil(testDataSet.Make3DExplicitDataSet5());
+  TestPointGradientStencil(testDataSet.Make3DExplicitDataSetZoo());
+  TestPointGradientStencil(testDataSet.Make3DExplicitDataSetPolygonal());
+}
 
 void TestGradient()
 {
   TestCellGradientExplicit();
   TestPointGradientExplicit();
+  TestPointGradientStencil();
 }
 }
 
@@ -0,0 +1,356 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_worklet_gradient_PointGradientStencil_h
+#define vtk_m_worklet_gradient_PointGradientStencil_h
+
+#include <vtkm/VecFromPortalPermute.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
+#include <vtkm/cont/ConvertNumComponentsToOffsets.h>
+#include <vtkm/cont/CoordinateSystem.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/UnknownCellSet.h>
+#include <vtkm/exec/CellDerivative.h>
+#include <vtkm/exec/ParametricCoordinates.h>
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+#include <vtkm/filter/vector_analysis/worklet/gradient/GradientOutput.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+template <typename T>
+struct GradientOutputFields;
+
+namespace gradient
+{
+
+namespace stencil
+{
+
+/// A field over the points of a cell that is one at a single point and zero
+/// at all others. The derivative of this field is the weight of that point in
+/// the derivative of any other field over the cell.
+template <typename T>
+struct UnitPointField
+{
+  using ComponentType = T;
+
+  VTKM_EXEC_CONT vtkm::IdComponent GetNumberOfComponents() const { return this->NumberOfPoints; }
+
+  VTKM_EXEC_CONT ComponentType operator[](vtkm::IdComponent index) const
+  {
+    return (index == this->Point) ? ComponentType(1) : ComponentType(0);
+  }
+
+  vtkm::IdComponent NumberOfPoints;
+  vtkm::IdComponent Point;
+};
+
+/// Returns true when point `pointIndex` of incident cell `cellIndex` is the
+/// first appearance of its point id in the points of all incident cells.
+template <typename CellSetInType, typename CellIdsType>
+VTKM_EXEC bool IsFirstOccurrence(const CellSetInType& geometry,
+                                 const CellIdsType& cellIds,
+                                 vtkm::IdComponent cellIndex,
+                                 vtkm::IdComponent pointIndex)
+{
+  const auto points = geometry.GetIndices(cellIds[cellIndex]);
+  const vtkm::Id pointId = points[pointIndex];
+  for (vtkm::IdComponent i = 0; i < pointIndex; ++i)
+  {
+    if (points[i] == pointId)
+    {
+      return false;
+    }
+  }
+  for (vtkm::IdComponent c = 0; c < cellIndex; ++c)
+  {
+    const auto otherPoints = geometry.GetIndices(cellIds[c]);
+    for (vtkm::IdComponent i = 0; i < otherPoints.GetNumberOfComponents(); ++i)
+    {
+      if (otherPoints[i] == pointId)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Counts the distinct points of the cells incident to each point, which is
+/// the number of entries in the row of the point in the stencil.
+struct CountStencil : public vtkm::worklet::WorkletVisitPointsWithCells
+{
+  using ControlSignature = void(CellSetIn, WholeCellSetIn<Cell, Point>, FieldOutPoint count);
+  using ExecutionSignature = void(CellCount, CellIndices, _2, _3);
+  using InputDomain = _1;
+
+  template <typename CellIdsType, typename CellSetInType>
+  VTKM_EXEC void operator()(vtkm::IdComponent numCells,
+                            const CellIdsType& cellIds,
+                            const CellSetInType& geometry,
+                            vtkm::IdComponent& count) const
+  {
+    count = 0;
+    for (vtkm::IdComponent c = 0; c < numCells; ++c)
+    {
+      const vtkm::IdComponent numPoints = geometry.GetNumberOfIndices(cellIds[c]);
+      for (vtkm::IdComponent i = 0; i < numPoints; ++i)
+      {
+        if (IsFirstOccurrence(geometry, cellIds, c, i))
+        {
+          ++count;
+        }
+      }
+    }
+  }
+};
+
+/// Computes the row of each point in the stencil. This follows the
+/// `PointGradient` worklet: the derivative of every incident cell is
+/// evaluated at the point and the results are averaged. As the derivative is
+/// linear in the field, it is evaluated once for each point of the cell with
+/// a field that is one at that point, which gives the weight of the point.
+struct BuildStencil : public vtkm::worklet::WorkletVisitPointsWithCells
+{
+  using ControlSignature = void(CellSetIn,
+                                WholeCellSetIn<Cell, Point>,
+                                WholeArrayIn pointCoordinates,
+                                FieldOutPoint columns,
+                                FieldOutPoint weights);
+  using ExecutionSignature = void(CellCount, CellIndices, WorkIndex, _2, _3, _4, _5);
+  using InputDomain = _1;
+
+  template <typename CellIdsType,
+            typename CellSetInType,
+            typename CoordinatesPortalType,
+            typename ColumnsVecType,
+            typename WeightsVecType>
+  VTKM_EXEC void operator()(vtkm::IdComponent numCells,
+                            const CellIdsType& cellIds,
+                            vtkm::Id pointId,
+                            const CellSetInType& geometry,
+                            const CoordinatesPortalType& pointCoordinates,
+                            ColumnsVecType& columns,
+                            WeightsVecType& weights) const
+  {
+    using WeightType = typename WeightsVecType::ComponentType;
+
+    vtkm::IdComponent numEntries = 0;
+    for (vtkm::IdComponent c = 0; c < numCells; ++c)
+    {
+      const vtkm::Id cellId = cellIds[c];
+      const auto points = geometry.GetIndices(cellId);
+      const auto wCoords = vtkm::make_VecFromPortalPermute(&points, pointCoordinates);
+      const vtkm::IdComponent numPoints = points.GetNumberOfComponents();
+
+      vtkm::IdComponent pointIndexForCell = 0;
+      for (vtkm::IdComponent i = 0; i < numPoints; ++i)
+      {
+        if (points[i] == pointId)
+        {
+          pointIndexForCell = i;
+        }
+      }
+
+      vtkm::Vec3f pCoords;
+      vtkm::exec::ParametricCoordinatesPoint(
+        numPoints, pointIndexForCell, geometry.GetCellShape(cellId), pCoords);
+
+      for (vtkm::IdComponent i = 0; i < numPoints; ++i)
+      {
+        vtkm::IdComponent entry = 0;
+        while ((entry < numEntries) && (vtkm::Id(columns[entry]) != points[i]))
+        {
+          ++entry;
+        }
+        if (entry == numEntries)
+        {
+          columns[entry] = points[i];
+          weights[entry] = WeightType(0);
+          ++numEntries;
+        }
+
+        const UnitPointField<vtkm::Float64> field{ numPoints, i };
+        vtkm::Vec3f_64 weight;
+        auto status = vtkm::exec::CellDerivative(
+          field, wCoords, pCoords, geometry.GetCellShape(cellId), weight);
+        if (status == vtkm::ErrorCode::Success)
+        {
+          weights[entry] = WeightType(weights[entry]) + weight;
+        }
+      }
+    }
+
+    if (numCells != 0)
+    {
+      const vtkm::Float64 invNumCells = 1.0 / static_cast<vtkm::Float64>(numCells);
+      for (vtkm::IdComponent entry = 0; entry < numEntries; ++entry)
+      {
+        weights[entry] = WeightType(weights[entry]) * invNumCells;
+      }
+    }
+  }
+};
+
+/// Multiplies a field by the stencil to get the gradient at each point.
+struct ApplyStencil : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn columns,
+                                FieldIn weights,
+                                WholeArrayIn inputField,
+                                GradientOutputs outputFields);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  template <typename ColumnsVecType,
+            typename WeightsVecType,
+            typename FieldPortalType,
+            typename GradientOutType>
+  VTKM_EXEC void operator()(const ColumnsVecType& columns,
+                            const WeightsVecType& weights,
+                            const FieldPortalType& inputField,
+                            GradientOutType& outputGradient) const
+  {
+    using ValueType = typename FieldPortalType::ValueType;
+    using BaseComponentType = typename vtkm::VecTraits<ValueType>::BaseComponentType;
+
+    vtkm::Vec<ValueType, 3> gradient(ValueType(0.0));
+    for (vtkm::IdComponent entry = 0; entry < columns.GetNumberOfComponents(); ++entry)
+    {
+      const ValueType value = inputField.Get(vtkm::Id(columns[entry]));
+      const vtkm::Vec3f_64 weight = weights[entry];
+      gradient[0] = gradient[0] + value * static_cast<BaseComponentType>(weight[0]);
+      gradient[1] = gradient[1] + value * static_cast<BaseComponentType>(weight[1]);
+      gradient[2] = gradient[2] + value * static_cast<BaseComponentType>(weight[2]);
+    }
+    outputGradient = gradient;
+  }
+};
+
+} // namespace stencil
+
+/// \brief Point gradients of unstructured meshes as a sparse matrix.
+///
+/// The point gradient of a field is a linear combination of the field values
+/// at the points of the incident cells, with weights that only depend on the
+/// mesh. `PointGradientStencil` computes these weights once and stores them in
+/// compressed sparse rows (one row of point ids and `vtkm::Vec3f_64` weights
+/// for each point). `Run` then computes the gradient of any point field on the
+/// same mesh with a single sparse matrix-vector product, which gives the same
+/// result as the `PointGradient` worklet.
+class PointGradientStencil
+{
+public:
+  /// Computes the stencil of an unstructured cell set with the given coordinates.
+  VTKM_CONT void Build(const vtkm::cont::UnknownCellSet& cellSet,
+                       const vtkm::cont::CoordinateSystem& coords)
+  {
+    cellSet.CastAndCallForTypes<VTKM_DEFAULT_CELL_SET_LIST_UNSTRUCTURED>(
+      [&](const auto& concreteCellSet) {
+        vtkm::cont::Invoker invoke;
+
+        vtkm::cont::ArrayHandle<vtkm::IdComponent> counts;
+        invoke(stencil::CountStencil{}, concreteCellSet, concreteCellSet, counts);
+
+        vtkm::Id numEntries;
+        vtkm::cont::ConvertNumComponentsToOffsets(counts, this->Offsets, numEntries);
+        counts.ReleaseResources();
+
+        this->Columns.Allocate(numEntries);
+        this->Weights.Allocate(numEntries);
+        invoke(stencil::BuildStencil{},
+               concreteCellSet,
+               concreteCellSet,
+               coords,
+               vtkm::cont::make_ArrayHandleGroupVecVariable(this->Columns, this->Offsets),
+               vtkm::cont::make_ArrayHandleGroupVecVariable(this->Weights, this->Offsets));
+      });
+
+    this->CellSet = cellSet;
+    this->Coordinates = coords;
+  }
+
+  /// Returns true if the stencil was built for this very cell set and
+  /// coordinate array (not just equal ones).
+  VTKM_CONT bool IsBuiltFor(const vtkm::cont::UnknownCellSet& cellSet,
+                            const vtkm::cont::CoordinateSystem& coords) const
+  {
+    if (!this->CellSet.IsValid() || (this->CellSet.GetCellSetBase() != cellSet.GetCellSetBase()))
+    {
+      return false;
+    }
+
+    bool sameCoordinates = false;
+    this->Coordinates.GetData().CastAndCall([&](const auto& array) {
+      using ArrayType = std::decay_t<decltype(array)>;
+      sameCoordinates = coords.GetData().IsType<ArrayType>() &&
+        (coords.GetData().AsArrayHandle<ArrayType>() == array);
+    });
+    return sameCoordinates;
+  }
+
+  /// Computes the gradient of `field`, which must be a point field of the
+  /// mesh the stencil was built for.
+  template <typename T, typename S>
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>> Run(
+    const vtkm::cont::ArrayHandle<T, S>& field,
+    GradientOutputFields<T>& extraOutput) const
+  {
+    if (field.GetNumberOfValues() != this->GetNumberOfPoints())
+    {
+      throw vtkm::cont::ErrorBadValue("Field does not match the points of the gradient stencil.");
+    }
+
+    vtkm::cont::Invoker invoke;
+    invoke(stencil::ApplyStencil{},
+           vtkm::cont::make_ArrayHandleGroupVecVariable(this->Columns, this->Offsets),
+           vtkm::cont::make_ArrayHandleGroupVecVariable(this->Weights, this->Offsets),
+           field,
+           extraOutput);
+    return extraOutput.Gradient;
+  }
+
+  VTKM_CONT vtkm::Id GetNumberOfPoints() const
+  {
+    return (this->Offsets.GetNumberOfValues() > 0) ? this->Offsets.GetNumberOfValues() - 1 : 0;
+  }
+
+  /// The offsets of the rows of each point in `GetColumns()` and `GetWeights()`.
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Id>& GetOffsets() const { return this->Offsets; }
+  /// The ids of the points that contribute to the gradient of each point.
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Id>& GetColumns() const { return this->Columns; }
+  /// The derivatives of the gradient of each point by the values in `GetColumns()`.
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Vec3f_64>& GetWeights() const
+  {
+    return this->Weights;
+  }
+
+private:
+  vtkm::cont::ArrayHandle<vtkm::Id> Offsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> Columns;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> Weights;
+
+  // Kept so that the cell set cannot be freed and its address reused by
+  // another cell set while the stencil exists.
+  vtkm::cont::UnknownCellSet CellSet;
+  vtkm::cont::CoordinateSystem Coordinates;
+};
+
+}
+}
+} // namespace vtkm::worklet::gradient
+
+#endif
@@ -10,6 +10,7 @@
 #ifndef vtk_m_rendering_raytracing_MortonCodes_h
 #define vtk_m_rendering_raytracing_MortonCodes_h
 
+#include <vtkm/MortonCodes.h>
 #include <vtkm/VectorAnalysis.h>
 
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
@@ -30,59 +31,29 @@ namespace raytracing
 {
 
 
-//Note: if this takes a long time. we could use a lookup table
 //expands 10-bit unsigned int into 30 bits
 VTKM_EXEC inline vtkm::UInt32 ExpandBits32(vtkm::UInt32 x32)
 {
-  x32 = (x32 | (x32 << 16)) & 0x030000FF;
-  x32 = (x32 | (x32 << 8)) & 0x0300F00F;
-  x32 = (x32 | (x32 << 4)) & 0x030C30C3;
-  x32 = (x32 | (x32 << 2)) & 0x09249249;
-  return x32;
+  return vtkm::MortonExpandBits32(x32);
 }
 
 VTKM_EXEC inline vtkm::UInt64 ExpandBits64(vtkm::UInt32 x)
 {
-  vtkm::UInt64 x64 = x & 0x1FFFFF;
-  x64 = (x64 | x64 << 32) & 0x1F00000000FFFF;
-  x64 = (x64 | x64 << 16) & 0x1F0000FF0000FF;
-  x64 = (x64 | x64 << 8) & 0x100F00F00F00F00F;
-  x64 = (x64 | x64 << 4) & 0x10c30c30c30c30c3;
-  x64 = (x64 | x64 << 2) & 0x1249249249249249;
-
-  return x64;
+  return vtkm::MortonExpandBits64(x);
 }
 
 //Returns 30 bit morton code for coordinates for
 //coordinates in the unit cude
 VTKM_EXEC inline vtkm::UInt32 Morton3D(vtkm::Float32& x, vtkm::Float32& y, vtkm::Float32& z)
 {
-  //take the first 10 bits
-  x = vtkm::Min(vtkm::Max(x * 1024.0f, 0.0f), 1023.0f);
-  y = vtkm::Min(vtkm::Max(y * 1024.0f, 0.0f), 1023.0f);
-  z = vtkm::Min(vtkm::Max(z * 1024.0f, 0.0f), 1023.0f);
-  //expand the 10 bits to 30
-  vtkm::UInt32 xx = ExpandBits32((vtkm::UInt32)x);
-  vtkm::UInt32 yy = ExpandBits32((vtkm::UInt32)y);
-  vtkm::UInt32 zz = ExpandBits32((vtkm::UInt32)z);
-  //interleave coordinates
-  return (zz << 2 | yy << 1 | xx);
+  return vtkm::MortonCode32(vtkm::make_Vec(x, y, z));
 }
 
-//Returns 30 bit morton code for coordinates for
+//Returns 63 bit morton code for coordinates for
 //coordinates in the unit cude
 VTKM_EXEC inline vtkm::UInt64 Morton3D64(vtkm::Float32& x, vtkm::Float32& y, vtkm::Float32& z)
 {
-  //take the first 21 bits
-  x = vtkm::Min(vtkm::Max(x * 2097152.0f, 0.0f), 2097151.0f);
-  y = vtkm::Min(vtkm::Max(y * 2097152.0f, 0.0f), 2097151.0f);
-  z = vtkm::Min(vtkm::Max(z * 2097152.0f, 0.0f), 2097151.0f);
-  //expand the 10 bits to 30
-  vtkm::UInt64 xx = ExpandBits64((vtkm::UInt32)x);
-  vtkm::UInt64 yy = ExpandBits64((vtkm::UInt32)y);
-  vtkm::UInt64 zz = ExpandBits64((vtkm::UInt32)z);
-  //interleave coordinates
-  return (zz << 2 | yy << 1 | xx);
+  return vtkm::MortonCode64(vtkm::make_Vec(x, y, z));
 }
 
 class MortonCodeFace : public vtkm::worklet::WorkletVisitCellsWithPoints
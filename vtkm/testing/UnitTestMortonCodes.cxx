@@ -0,0 +1,62 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/MortonCodes.h>
+
+#include <vtkm/testing/Testing.h>
+
+namespace
+{
+
+void TestExpandBits()
+{
+  std::cout << "Test expanding bits." << std::endl;
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits32(0x0) == 0x0);
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits32(0x1) == 0x1);
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits32(0x3) == 0x9);
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits32(0x3FF) == 0x09249249);
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits64(0x3) == 0x9);
+  VTKM_TEST_ASSERT(vtkm::MortonExpandBits64(0x1FFFFF) == 0x1249249249249249);
+}
+
+void TestCodes()
+{
+  std::cout << "Test Morton codes." << std::endl;
+  VTKM_TEST_ASSERT(vtkm::MortonCode32(vtkm::Vec3f_32(0.0f)) == 0);
+  VTKM_TEST_ASSERT(vtkm::MortonCode32(vtkm::Vec3f_32(1.0f)) == 0x3FFFFFFF);
+  VTKM_TEST_ASSERT(vtkm::MortonCode64(vtkm::Vec3f_32(1.0f)) == 0x7FFFFFFFFFFFFFFF);
+
+  // The lowest bit comes from x, then y, then z.
+  constexpr vtkm::Float32 step = 1.0f / 1024.0f;
+  VTKM_TEST_ASSERT(vtkm::MortonCode32({ step, 0.0f, 0.0f }) == 0x1);
+  VTKM_TEST_ASSERT(vtkm::MortonCode32({ 0.0f, step, 0.0f }) == 0x2);
+  VTKM_TEST_ASSERT(vtkm::MortonCode32({ 0.0f, 0.0f, step }) == 0x4);
+
+  // Values outside of the unit cube are clamped.
+  VTKM_TEST_ASSERT(vtkm::MortonCode32(vtkm::Vec3f_32(-1.0f)) == 0);
+  VTKM_TEST_ASSERT(vtkm::MortonCode32(vtkm::Vec3f_32(2.0f)) == 0x3FFFFFFF);
+
+  // Points in the same octant share the highest bits.
+  VTKM_TEST_ASSERT((vtkm::MortonCode32({ 0.6f, 0.7f, 0.1f }) >> 27) ==
+                   (vtkm::MortonCode32({ 0.9f, 0.55f, 0.4f }) >> 27));
+}
+
+void TestMortonCodes()
+{
+  TestExpandBits();
+  TestCodes();
+}
+
+} // anonymous namespace
+
+int UnitTestMortonCodes(int argc, char* argv[])
+{
+  return vtkm::testing::Testing::Run(TestMortonCodes, argc, argv);
+}
@@ -122,10 +122,17 @@ protected:
 /// Select the type of sort for BuildArrays calls. Unstable sorting is faster
 /// but will not produce consistent ordering for equal keys. Stable sorting
 /// is slower, but keeps equal keys in their original order.
+///
+/// Hashed grouping does not sort at all. Equal keys are found by inserting every
+/// key in a hash table, which takes linear time. The unique keys are ordered by
+/// their first appearance in the input rather than by value. The first value of
+/// each group is the first value with that key, but the order of the remaining
+/// values in a group is not consistent.
 enum class KeysSortType
 {
   Unstable = 0,
-  Stable = 1
+  Stable = 1,
+  Hashed = 2
 };
 
 /// \brief Manage keys for a `vtkm::worklet::WorkletReduceByKey`.
@@ -242,6 +249,10 @@ private:
   template <typename KeyArrayType>
   VTKM_CONT void BuildArraysInternalStable(const KeyArrayType& keys,
                                            vtkm::cont::DeviceAdapterId device);
+
+  template <typename KeyArrayType>
+  VTKM_CONT void BuildArraysInternalHashed(const KeyArrayType& keys,
+                                           vtkm::cont::DeviceAdapterId device);
   /// @endcond
 };
 
@@ -12,10 +12,143 @@
 
 #include <vtkm/worklet/Keys.h>
 
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
 namespace vtkm
 {
 namespace worklet
 {
+namespace internal
+{
+namespace keys_hash
+{
+
+// Mixes the components of a key into a 64-bit hash. The upper bits are the best mixed.
+template <typename T>
+VTKM_EXEC_CONT vtkm::UInt64 HashKey(const T& key)
+{
+  using Traits = vtkm::VecTraits<T>;
+  vtkm::UInt64 hash = 0;
+  for (vtkm::IdComponent index = 0; index < Traits::GetNumberOfComponents(key); ++index)
+  {
+    hash = (hash ^ static_cast<vtkm::UInt64>(Traits::GetComponent(key, index))) *
+      0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+  }
+  return hash * 0xBF58476D1CE4E5B9ULL;
+}
+
+template <typename T1, typename T2>
+VTKM_EXEC_CONT vtkm::UInt64 HashKey(const vtkm::Pair<T1, T2>& key)
+{
+  return (HashKey(key.first) ^ (HashKey(key.second) >> 1)) * 0x9E3779B97F4A7C15ULL;
+}
+
+// Inserts every key in an open addressing hash table. Each slot of the table holds the index
+// of the first input with the key stored there.
+struct InsertKeys : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn key,
+                                WholeArrayIn keys,
+                                AtomicArrayInOut table,
+                                FieldOut slot);
+  using ExecutionSignature = void(_1, InputIndex, _2, _3, _4);
+
+  template <typename KeyType, typename KeyPortal, typename TablePortal>
+  VTKM_EXEC void operator()(const KeyType& key,
+                            vtkm::Id index,
+                            const KeyPortal& keys,
+                            const TablePortal& table,
+                            vtkm::Id& slot) const
+  {
+    // The table size is a power of 2.
+    const vtkm::Id mask = table.GetNumberOfValues() - 1;
+    slot = static_cast<vtkm::Id>(HashKey(key) >> 32) & mask;
+    while (true)
+    {
+      vtkm::Id owner = -1;
+      if (table.CompareExchange(slot, &owner, index))
+      {
+        return;
+      }
+      if (keys.Get(owner) == key)
+      {
+        // A slot only ever holds inputs with the same key. Keep the first of them.
+        while ((index < owner) && !table.CompareExchange(slot, &owner, index))
+        {
+        }
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+};
+
+// Flags the first input with each key.
+struct MarkFirstKeys : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn slot, WholeArrayIn table, FieldOut isFirst);
+  using ExecutionSignature = void(_1, InputIndex, _2, _3);
+
+  template <typename TablePortal>
+  VTKM_EXEC void operator()(vtkm::Id slot,
+                            vtkm::Id index,
+                            const TablePortal& table,
+                            vtkm::Id& isFirst) const
+  {
+    isFirst = (table.Get(slot) == index) ? 1 : 0;
+  }
+};
+
+// Replaces the slot of each input with the index of its unique key and counts the inputs with
+// each unique key.
+struct FindUniqueKeyIndices : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldInOut slotToUniqueIndex,
+                                WholeArrayIn table,
+                                WholeArrayIn firstRanks,
+                                AtomicArrayInOut counts);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  template <typename TablePortal, typename RankPortal, typename CountPortal>
+  VTKM_EXEC void operator()(vtkm::Id& slotToUniqueIndex,
+                            const TablePortal& table,
+                            const RankPortal& firstRanks,
+                            const CountPortal& counts) const
+  {
+    slotToUniqueIndex = firstRanks.Get(table.Get(slotToUniqueIndex));
+    counts.Add(slotToUniqueIndex, 1);
+  }
+};
+
+// Places each input in the group of its key. The first input with a key goes first.
+struct GroupValues : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn uniqueIndex,
+                                FieldIn isFirst,
+                                WholeArrayIn offsets,
+                                AtomicArrayInOut cursors,
+                                WholeArrayOut sortedValuesMap);
+  using ExecutionSignature = void(_1, _2, InputIndex, _3, _4, _5);
+
+  template <typename OffsetPortal, typename CursorPortal, typename MapPortal>
+  VTKM_EXEC void operator()(vtkm::Id uniqueIndex,
+                            vtkm::Id isFirst,
+                            vtkm::Id index,
+                            const OffsetPortal& offsets,
+                            const CursorPortal& cursors,
+                            const MapPortal& sortedValuesMap) const
+  {
+    vtkm::Id position =
+      isFirst ? offsets.Get(uniqueIndex) : offsets.Get(uniqueIndex) + cursors.Add(uniqueIndex, 1);
+    sortedValuesMap.Set(position, index);
+  }
+};
+
+} // namespace keys_hash
+} // namespace internal
+
 /// Build the internal arrays without modifying the input. This is more
 /// efficient for stable sorted arrays, but requires an extra copy of the
 /// keys for unstable sorting.
@@ -40,6 +173,9 @@ VTKM_CONT void Keys<T>::BuildArrays(const KeyArrayType& keys,
     case KeysSortType::Stable:
       this->BuildArraysInternalStable(keys, device);
       break;
+    case KeysSortType::Hashed:
+      this->BuildArraysInternalHashed(keys, device);
+      break;
   }
 }
 
@@ -60,8 +196,16 @@ VTKM_CONT void Keys<T>::BuildArraysInPlace(KeyArrayType& keys,
       this->BuildArraysInternal(keys, device);
       break;
     case KeysSortType::Stable:
+    case KeysSortType::Hashed:
     {
-      this->BuildArraysInternalStable(keys, device);
+      if (sort == KeysSortType::Stable)
+      {
+        this->BuildArraysInternalStable(keys, device);
+      }
+      else
+      {
+        this->BuildArraysInternalHashed(keys, device);
+      }
       KeyArrayHandleType tmp;
       // Copy into a temporary array so that the permutation array copy
       // won't alias input/output memory:
@@ -132,6 +276,59 @@ VTKM_CONT void Keys<T>::BuildArraysInternalStable(const KeyArrayType& keys,
   VTKM_ASSERT(numKeys ==
               vtkm::cont::ArrayGetValue(this->Offsets.GetNumberOfValues() - 1, this->Offsets));
 }
+
+template <typename T>
+template <typename KeyArrayType>
+VTKM_CONT void Keys<T>::BuildArraysInternalHashed(const KeyArrayType& keys,
+                                                  vtkm::cont::DeviceAdapterId device)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "Keys::BuildArraysInternalHashed");
+
+  namespace keys_hash = vtkm::worklet::internal::keys_hash;
+  const vtkm::Id numKeys = keys.GetNumberOfValues();
+  vtkm::cont::Invoker invoke(device);
+
+  // Keep the table at most half full so that probe sequences stay short.
+  vtkm::Id tableSize = 1;
+  while (tableSize < 2 * numKeys)
+  {
+    tableSize *= 2;
+  }
+  vtkm::cont::ArrayHandle<vtkm::Id> table;
+  table.AllocateAndFill(tableSize, -1);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> uniqueIndices;
+  invoke(keys_hash::InsertKeys{}, keys, keys, table, uniqueIndices);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> isFirst;
+  invoke(keys_hash::MarkFirstKeys{}, uniqueIndices, table, isFirst);
+
+  // The unique keys are numbered in the order they first appear.
+  vtkm::cont::ArrayHandle<vtkm::Id> firstRanks;
+  const vtkm::Id numUniqueKeys = vtkm::cont::Algorithm::ScanExclusive(device, isFirst, firstRanks);
+  vtkm::cont::Algorithm::CopyIf(device, keys, isFirst, this->UniqueKeys);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> counts;
+  counts.AllocateAndFill(numUniqueKeys, 0);
+  invoke(keys_hash::FindUniqueKeyIndices{}, uniqueIndices, table, firstRanks, counts);
+  table.ReleaseResources();
+  firstRanks.ReleaseResources();
+
+  vtkm::cont::Algorithm::ScanExtended(device, counts, this->Offsets);
+
+  // Reuse the counts as the position of the next value in each group after the first.
+  counts.AllocateAndFill(numUniqueKeys, 1);
+  this->SortedValuesMap.Allocate(numKeys);
+  invoke(keys_hash::GroupValues{},
+         uniqueIndices,
+         isFirst,
+         this->Offsets,
+         counts,
+         this->SortedValuesMap);
+
+  VTKM_ASSERT(numKeys ==
+              vtkm::cont::ArrayGetValue(this->Offsets.GetNumberOfValues() - 1, this->Offsets));
+}
 }
 }
 #endif
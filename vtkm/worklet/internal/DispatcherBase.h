@@ -597,6 +597,13 @@ public:
   VTKM_CONT vtkm::cont::DeviceAdapterId GetDevice() const { return this->Device; }
   ///@}
 
+  /// Setting a token will make the invoke attach all of its arguments to the given token
+  /// rather than to a token local to the invoke. This allows the caller to extend the
+  /// scope of the execution objects and to use a place in the `ArrayHandle` access queues
+  /// reserved earlier with `ArrayHandle::Enqueue`. The token must outlive the invoke.
+  ///
+  VTKM_CONT void SetToken(vtkm::cont::Token& token) { this->ExternalToken = &token; }
+
   using ScatterType = typename WorkletType::ScatterType;
   using MaskType = typename WorkletType::MaskType;
 
@@ -714,6 +721,7 @@ private:
   void operator=(const MyType&) = delete;
 
   vtkm::cont::DeviceAdapterId Device;
+  vtkm::cont::Token* ExternalToken = nullptr;
 
   template <typename Invocation,
             typename InputRangeType,
@@ -727,8 +735,11 @@ private:
                                            DeviceAdapter device) const
   {
     // This token represents the scope of the execution objects. It should
-    // exist as long as things run on the device.
-    vtkm::cont::Token token;
+    // exist as long as things run on the device. If the caller provided its
+    // own token, that one is used so the caller controls the scope.
+    vtkm::cont::Token localToken;
+    vtkm::cont::Token& token =
+      (this->ExternalToken != nullptr) ? *this->ExternalToken : localToken;
 
     // The first step in invoking a worklet is to transport the arguments to
     // the execution environment. The invocation object passed to this function
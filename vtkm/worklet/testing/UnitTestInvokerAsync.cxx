@@ -0,0 +1,271 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/MaskIndices.h>
+#include <vtkm/worklet/ScatterCounting.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <chrono>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 1000;
+
+struct AddValue : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  vtkm::Id Value;
+
+  VTKM_CONT AddValue(vtkm::Id value)
+    : Value(value)
+  {
+  }
+
+  VTKM_EXEC void operator()(vtkm::Id in, vtkm::Id& out) const { out = in + this->Value; }
+};
+
+struct CopyVisit : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, VisitIndex, _2);
+  using ScatterType = vtkm::worklet::ScatterCounting;
+
+  VTKM_EXEC void operator()(vtkm::Id in, vtkm::IdComponent visit, vtkm::Id& out) const
+  {
+    out = 10 * in + visit;
+  }
+};
+
+struct CopyMasked : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldInOut);
+  using ExecutionSignature = void(_1, _2);
+  using MaskType = vtkm::worklet::MaskIndices;
+
+  VTKM_EXEC void operator()(vtkm::Id in, vtkm::Id& out) const { out = in; }
+};
+
+struct FailOnOdd : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_EXEC void operator()(vtkm::Id in, vtkm::Id& out) const
+  {
+    if ((in % 2) == 1)
+    {
+      this->RaiseError("Odd value.");
+    }
+    out = in;
+  }
+};
+
+void TestDependentChain()
+{
+  std::cout << "Testing chain of dependent asynchronous invokes." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Id> first;
+  vtkm::cont::ArrayHandle<vtkm::Id> second;
+  vtkm::cont::ArrayHandle<vtkm::Id> third;
+
+  // Each invoke reads the output of the previous one, so they must run in order even
+  // though they are launched without waiting.
+  auto f1 = invoke.Async(AddValue{ 1 }, vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), first);
+  auto f2 = invoke.Async(AddValue{ 10 }, first, second);
+  auto f3 = invoke.Async(AddValue{ 100 }, second, third);
+
+  f3.get();
+  f2.get();
+  f1.get();
+
+  auto portal = third.ReadPortal();
+  VTKM_TEST_ASSERT(portal.GetNumberOfValues() == ARRAY_SIZE);
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == index + 111);
+  }
+}
+
+void TestIndependent()
+{
+  std::cout << "Testing independent asynchronous invokes." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Id> input;
+  input.AllocateAndFill(ARRAY_SIZE, 5);
+
+  // All of these only read the input array, so they are free to overlap.
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Id>> outputs(4);
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < outputs.size(); ++i)
+  {
+    futures.push_back(invoke.Async(AddValue{ static_cast<vtkm::Id>(i) }, input, outputs[i]));
+  }
+  for (auto& f : futures)
+  {
+    f.get();
+  }
+
+  for (std::size_t i = 0; i < outputs.size(); ++i)
+  {
+    auto portal = outputs[i].ReadPortal();
+    for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+    {
+      VTKM_TEST_ASSERT(portal.Get(index) == 5 + static_cast<vtkm::Id>(i));
+    }
+  }
+}
+
+void TestSharedReaders()
+{
+  std::cout << "Testing asynchronous invokes sharing an input." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Id> shared;
+  shared.AllocateAndFill(ARRAY_SIZE, 5);
+  vtkm::cont::ArrayHandle<vtkm::Id> blocked;
+  blocked.Allocate(ARRAY_SIZE);
+  vtkm::cont::ArrayHandle<vtkm::Id> unblocked;
+
+  // Hold on to the output of the first invoke so that it cannot finish. The second invoke
+  // only reads the shared array as well, so it must not wait for the first.
+  vtkm::cont::Token hostToken;
+  blocked.WritePortal(hostToken);
+  auto f1 = invoke.Async(AddValue{ 1 }, shared, blocked);
+  auto f2 = invoke.Async(AddValue{ 2 }, shared, unblocked);
+  bool overlapped = (f2.wait_for(std::chrono::seconds(60)) == std::future_status::ready);
+  hostToken.DetachFromAll();
+  f1.get();
+  f2.get();
+  VTKM_TEST_ASSERT(overlapped, "Invokes reading the same array were serialized.");
+
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+    blocked, vtkm::cont::make_ArrayHandleConstant<vtkm::Id>(6, ARRAY_SIZE)));
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(unblocked, vtkm::cont::make_ArrayHandleConstant<vtkm::Id>(7, ARRAY_SIZE)));
+}
+
+void TestWriteAfterRead()
+{
+  std::cout << "Testing asynchronous write after read." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Id> shared;
+  shared.AllocateAndFill(ARRAY_SIZE, 5);
+  vtkm::cont::ArrayHandle<vtkm::Id> output;
+  output.Allocate(ARRAY_SIZE);
+
+  // The first invoke cannot finish until the host lets go of its output. The second invoke
+  // overwrites its input, so it must wait for the first even though it was issued later.
+  vtkm::cont::Token hostToken;
+  output.WritePortal(hostToken);
+  auto f1 = invoke.Async(AddValue{ 1 }, shared, output);
+  auto f2 = invoke.Async(AddValue{ 100 }, vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), shared);
+  bool waited = (f2.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+  hostToken.DetachFromAll();
+  f1.get();
+  f2.get();
+  VTKM_TEST_ASSERT(waited, "Write did not wait for an earlier read.");
+
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+    output, vtkm::cont::make_ArrayHandleConstant<vtkm::Id>(6, ARRAY_SIZE)));
+  auto portal = shared.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == index + 100);
+  }
+}
+
+void TestScatterAndMask()
+{
+  std::cout << "Testing asynchronous invokes with scatter and mask." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> counts;
+  counts.AllocateAndFill(ARRAY_SIZE, 2);
+  vtkm::cont::ArrayHandle<vtkm::Id> scattered;
+  auto f1 = invoke.Async(CopyVisit{},
+                         vtkm::worklet::ScatterCounting(counts),
+                         vtkm::cont::ArrayHandleIndex(ARRAY_SIZE),
+                         scattered);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> indices =
+    vtkm::cont::make_ArrayHandle<vtkm::Id>({ 0, 3, 7, 8 });
+  vtkm::cont::ArrayHandle<vtkm::Id> masked;
+  masked.AllocateAndFill(10, -1);
+  auto f2 = invoke.Async(
+    CopyMasked{}, vtkm::worklet::MaskIndices(indices), vtkm::cont::ArrayHandleIndex(10), masked);
+
+  f1.get();
+  f2.get();
+
+  VTKM_TEST_ASSERT(scattered.GetNumberOfValues() == 2 * ARRAY_SIZE);
+  auto scatteredPortal = scattered.ReadPortal();
+  for (vtkm::Id index = 0; index < 2 * ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(scatteredPortal.Get(index) == 10 * (index / 2) + (index % 2));
+  }
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+    masked, vtkm::cont::make_ArrayHandle<vtkm::Id>({ 0, -1, -1, 3, -1, -1, -1, 7, 8, -1 })));
+}
+
+void TestError()
+{
+  std::cout << "Testing error in asynchronous invoke." << std::endl;
+
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Id> output;
+  auto future = invoke.Async(FailOnOdd{}, vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), output);
+
+  bool caughtError = false;
+  try
+  {
+    future.get();
+  }
+  catch (vtkm::cont::ErrorExecution& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    caughtError = true;
+  }
+  VTKM_TEST_ASSERT(caughtError, "Error in worklet was not reported by the future.");
+
+  // The array must still be usable after the failed invoke.
+  output.Allocate(1);
+  VTKM_TEST_ASSERT(output.GetNumberOfValues() == 1);
+}
+
+void Run()
+{
+  TestDependentChain();
+  TestIndependent();
+  TestSharedReaders();
+  TestWriteAfterRead();
+  TestScatterAndMask();
+  TestError();
+}
+
+} // anonymous namespace
+
+int UnitTestInvokerAsync(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -14,6 +14,8 @@
 
 #include <vtkm/cont/testing/Testing.h>
 
+#include <vector>
+
 namespace
 {
 
@@ -47,6 +49,42 @@ void CheckKeyReduce(const KeyPortal& originalKeys,
   }
 }
 
+template <typename KeyType>
+void TryHashedKeys(const vtkm::cont::ArrayHandle<KeyType>& keyArray)
+{
+  vtkm::worklet::Keys<KeyType> keys;
+  keys.BuildArrays(keyArray, vtkm::worklet::KeysSortType::Hashed);
+  VTKM_TEST_ASSERT(keys.GetInputRange() == NUM_UNIQUE, "Hashed keys has bad input range.");
+
+  auto originalKeys = keyArray.ReadPortal();
+  auto uniqueKeys = keys.GetUniqueKeys().ReadPortal();
+  auto sortedValuesMap = keys.GetSortedValuesMap().ReadPortal();
+  auto offsets = keys.GetOffsets().ReadPortal();
+  CheckKeyReduce(originalKeys, uniqueKeys, sortedValuesMap, offsets);
+
+  // Every value is in exactly one group. The unique keys are in the order they first appear,
+  // and each group starts with the first value with its key.
+  std::vector<bool> found(static_cast<std::size_t>(ARRAY_SIZE), false);
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    vtkm::Id originalIndex = sortedValuesMap.Get(index);
+    VTKM_TEST_ASSERT(!found[static_cast<std::size_t>(originalIndex)], "Value grouped twice.");
+    found[static_cast<std::size_t>(originalIndex)] = true;
+  }
+  vtkm::Id previousFirst = -1;
+  for (vtkm::Id uniqueIndex = 0; uniqueIndex < NUM_UNIQUE; ++uniqueIndex)
+  {
+    vtkm::Id first = sortedValuesMap.Get(offsets.Get(uniqueIndex));
+    VTKM_TEST_ASSERT(first > previousFirst, "Unique keys not in order of appearance.");
+    for (vtkm::Id index = 0; index < first; ++index)
+    {
+      VTKM_TEST_ASSERT(originalKeys.Get(index) != uniqueKeys.Get(uniqueIndex),
+                       "Group does not start with first value.");
+    }
+    previousFirst = first;
+  }
+}
+
 template <typename KeyType>
 void TryKeyType(KeyType)
 {
@@ -69,6 +107,8 @@ void TryKeyType(KeyType)
                  keys.GetUniqueKeys().ReadPortal(),
                  keys.GetSortedValuesMap().ReadPortal(),
                  keys.GetOffsets().ReadPortal());
+
+  TryHashedKeys(keyArray);
 }
 
 void TestKeys()
@@ -84,6 +124,9 @@ void TestKeys()
 
   std::cout << "Testing vtkm::Id3 keys." << std::endl;
   TryKeyType(vtkm::Id3());
+
+  std::cout << "Testing vtkm::Pair<vtkm::UInt8, vtkm::Id2> keys." << std::endl;
+  TryKeyType(vtkm::Pair<vtkm::UInt8, vtkm::Id2>());
 }
 
 } // anonymous namespace